@@ -43,6 +43,11 @@ static inline int32_t arch_atomic_sub(atomic_t *a, int32_t value)
 	return __sync_fetch_and_sub(&a->value, value);
 }
 
+static inline void arch_memory_barrier(void)
+{
+	__sync_synchronize();
+}
+
 #endif /* __ARCH_ATOMIC_H__ */
 
 #else
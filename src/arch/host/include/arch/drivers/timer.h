@@ -11,6 +11,7 @@
 #define __ARCH_DRIVERS_TIMER_H__
 
 #include <stdint.h>
+#include <time.h>
 
 struct timer {
 };
@@ -20,7 +21,16 @@ static inline int arch_timer_register(struct timer *timer,
 static inline void arch_timer_unregister(struct timer *timer) {}
 static inline void arch_timer_enable(struct timer *timer) {}
 static inline void arch_timer_disable(struct timer *timer) {}
-static inline uint32_t arch_timer_get_system(struct timer *timer) {return 0; }
+
+/* no cycle counter on host, monotonic time in ns is used instead */
+static inline uint64_t arch_timer_get_system(struct timer *timer)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
 static inline int64_t arch_timer_set(struct timer *timer,
 				     uint64_t ticks) {return 0; }
 static inline void arch_timer_clear(struct timer *timer) {}
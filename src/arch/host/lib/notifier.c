@@ -14,12 +14,11 @@
 #include <sof/lib/alloc.h>
 #include <sof/lib/notifier.h>
 
-static struct notify *host_notify;
+/* per thread, library users may run several firmware instances */
+static __thread struct notify *host_notify;
 
+/* allocated by init_system_notify() and freed with the instance */
 struct notify **arch_notify_get(void)
 {
-	if (!host_notify)
-		host_notify = rzalloc(SOF_MEM_ZONE_SYS, 0, SOF_MEM_CAPS_RAM,
-				      sizeof(*host_notify));
 	return &host_notify;
 }
@@ -65,6 +65,12 @@ static inline int32_t arch_atomic_sub(atomic_t *a, int32_t value)
 	return current;
 }
 
+/* orders all memory accesses issued before against those issued after */
+static inline void arch_memory_barrier(void)
+{
+	__asm__ __volatile__("memw" : : : "memory");
+}
+
 #endif /* __ARCH_ATOMIC_H__ */
 
 #else
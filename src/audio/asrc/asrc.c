@@ -32,12 +32,19 @@
  */
 #define TS_STABLE_DIFF_COUNT	2
 
-/* Low pass filter coefficient for measured drift factor,
- * The low pass function is y(n) = c1 * x(n) + c2 * y(n -1)
- * coefficient c2 needs to be 1 - c1.
+/* Low pass filter for measured drift factor. The low pass function is
+ * y(n) = c1 * x(n) + c2 * y(n -1) where coefficient c2 is 1 - c1. The
+ * coefficient c1 is 2 * pi * bandwidth * control period, the bandwidth
+ * is in mHz and period in us so the Q2.30 scale 2 * pi * 2^30 / 1000
+ * is divided by 10^6. The default 1.592 Hz gives c1 = 0.01 for 1 ms.
  */
-#define COEF_C1		Q_CONVERT_FLOAT(0.01, 30)
-#define COEF_C2		Q_CONVERT_FLOAT(0.99, 30)
+#if CONFIG_ASRC_DRIFT_BANDWIDTH
+#define DRIFT_BANDWIDTH		CONFIG_ASRC_DRIFT_BANDWIDTH
+#else
+#define DRIFT_BANDWIDTH		1592
+#endif
+#define DRIFT_COEF_SCALE	6746519
+#define DRIFT_COEF_ONE		Q_CONVERT_FLOAT(1.0, 30)
 
 typedef void (*asrc_proc_func)(struct comp_dev *dev,
 			       const struct audio_stream *source,
@@ -69,6 +76,7 @@ struct comp_data {
 	int32_t skew;		/* Rate factor in Q2.30 */
 	int32_t skew_min;
 	int32_t skew_max;
+	int32_t skew_c1;	/* Drift low pass coefficient in Q2.30 */
 	int ts_count;
 	int asrc_size;		/* ASRC object size */
 	int buf_size;		/* Samples buffer size */
@@ -681,7 +689,16 @@ static int asrc_prepare(struct comp_dev *dev)
 	cd->skew_min = cd->skew;
 	cd->skew_max = cd->skew;
 
-	comp_info(dev, "asrc_prepare(), skew = %d", cd->skew);
+	/* The control loop runs once per copy so the filter coefficient
+	 * follows from the scheduling period. A too long period for the
+	 * bandwidth just passes the measured skew through.
+	 */
+	cd->skew_c1 = MIN((int64_t)DRIFT_BANDWIDTH * dev->period *
+			  DRIFT_COEF_SCALE / 1000000, DRIFT_COEF_ONE);
+	cd->skew_c1 = MAX(cd->skew_c1, 1);
+
+	comp_info(dev, "asrc_prepare(), skew = %d, c1 = %d", cd->skew,
+		  cd->skew_c1);
 	ret = asrc_update_drift(dev, cd->asrc_obj, cd->skew);
 	if (ret) {
 		comp_err(dev, "asrc_update_drift(), error %d", ret);
@@ -778,7 +795,8 @@ static int asrc_control_loop(struct comp_dev *dev, struct comp_data *cd)
 	skew = q_multsr_sat_32x32(f_ds_dt, f_ck_fs, 13);
 
 	/* tmp is Q4.60, shift and round to Q2.30 */
-	tmp = ((int64_t)COEF_C1) * skew + ((int64_t)COEF_C2) * cd->skew;
+	tmp = (int64_t)cd->skew_c1 * skew +
+		(int64_t)(DRIFT_COEF_ONE - cd->skew_c1) * cd->skew;
 	cd->skew = sat_int32(Q_SHIFT_RND(tmp, 60, 30));
 	asrc_update_drift(dev, cd->asrc_obj, cd->skew);
 
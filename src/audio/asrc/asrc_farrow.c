@@ -213,10 +213,11 @@ static enum asrc_error_code initialise_filter(struct comp_dev *dev,
  * ------------------------------|-------------------------------------|
  * 0x0000                        |asrc_farrow src_obj                  |
  * ------------------------------|-------------------------------------|
- * &src_obj + 1                  |int32 impulse_response[filter_length]|
+ * &src_obj + 1                  |int32 impulse_response[block_length *|
+ *                               |                      filter_length] |
  * ------------------------------|-------------------------------------|
  * &impulse_response[0] +        |int_x *buffer_pointer[num_channels]  |
- * filter_length                 |                                     |
+ * block_length * filter_length  |                                     |
  * ------------------------------|-------------------------------------|
  * &buffer_pointer[0] +          | int_x ring_buffer[num_channels *    |
  * + num_channels*sizeof(int_x *)|               *buffer_size]         |
@@ -224,6 +225,10 @@ static enum asrc_error_code initialise_filter(struct comp_dev *dev,
  *
  * Info:
  *
+ * impulse_response[block_length * filter_length]:
+ * One impulse response for each output frame of a block, see
+ * ASRC_BLOCK_LENGTH.
+ *
  * buffer_pointer[num_channels]:
  * Pointers to each channels data stored internally. ring_buffers_x points to
  * the first of these pointers.
@@ -272,8 +277,8 @@ enum asrc_error_code asrc_get_required_size(struct comp_dev *dev,
 	/* accumulate the size */
 	size = sizeof(struct asrc_farrow);
 
-	/* size of the impulse response */
-	size += ASRC_MAX_FILTER_LENGTH * sizeof(int32_t);
+	/* size of the impulse responses */
+	size += ASRC_BLOCK_LENGTH * ASRC_MAX_FILTER_LENGTH * sizeof(int32_t);
 
 	/* size of pointers to the buffers */
 	size += sizeof(int32_t *) * num_channels;
@@ -393,11 +398,11 @@ enum asrc_error_code asrc_initialise(struct comp_dev *dev,
 	if (src_obj->bit_depth == 32) {
 		src_obj->ring_buffers16 = NULL;
 		src_obj->ring_buffers32 = (int32_t **)(src_obj->impulse_response +
-			src_obj->filter_length);
+			ASRC_BLOCK_LENGTH * src_obj->filter_length);
 	} else if (src_obj->bit_depth == 16) {
 		src_obj->ring_buffers32 = NULL;
 		src_obj->ring_buffers16 = (int16_t **)(src_obj->impulse_response +
-			src_obj->filter_length);
+			ASRC_BLOCK_LENGTH * src_obj->filter_length);
 	}
 
 	/* set the channel pointers and fill buffers with zeros */
@@ -549,16 +554,22 @@ static enum asrc_error_code initialise_buffer(struct comp_dev *dev,
 	/*
 	 * Set buffer_length to filter_length * 2 to compensate for
 	 * missing element wise wrap around while loading but allowing
-	 * aligned loads.
+	 * aligned loads. The frames of a block of impulse responses
+	 * are filtered only after up to ASRC_BLOCK_LENGTH - 1 further
+	 * input frames have been written, so the ring buffer keeps
+	 * that many older samples in addition.
 	 */
-	src_obj->buffer_length = src_obj->filter_length * 2;
+	src_obj->buffer_length = (src_obj->filter_length +
+				  ASRC_BLOCK_LENGTH - 1) * 2;
 	if (src_obj->buffer_length > ASRC_MAX_BUFFER_LENGTH) {
 		comp_err(dev, "initialise_buffer(), buffer_length %d exceeds max.",
 			 src_obj->buffer_length);
 		return ASRC_EC_INVALID_BUFFER_LENGTH;
 	}
 
-	src_obj->buffer_write_position = src_obj->filter_length;
+	src_obj->buffer_write_position = src_obj->buffer_length >> 1;
+	src_obj->block_count = 0;
+	src_obj->block_span = 0;
 
 	/*
 	 * Initialize the dynamically allocated 2D array and clear the
@@ -966,6 +977,137 @@ void asrc_write_to_ring_buffer32(struct asrc_farrow  *src_obj,
 	}
 }
 
+/*
+ * With ASRC_BLOCK_LENGTH > 1 the output frames are not filtered right
+ * away but queued with their time value and ring buffer position. The
+ * impulse responses of the queued frames are then computed together
+ * and the frames are filtered when the block is full, before the next
+ * input frame would overwrite the oldest sample needed by the first
+ * queued frame, and at the end of each process call.
+ */
+static inline void asrc_block_queue(struct asrc_farrow *src_obj,
+				    int index_output_frame)
+{
+	int n = src_obj->block_count++;
+
+	src_obj->block_time[n] = src_obj->time_value;
+	src_obj->block_position[n] = src_obj->buffer_write_position;
+	src_obj->block_frame[n] = index_output_frame;
+}
+
+static void asrc_block_flush16(struct asrc_farrow *src_obj,
+			       int16_t **output_buffers)
+{
+	int n;
+
+	if (!src_obj->block_count)
+		return;
+
+	asrc_calc_impulse_response_block(src_obj, src_obj->block_count);
+	for (n = 0; n < src_obj->block_count; n++)
+		asrc_fir_filter16(src_obj, output_buffers,
+				  src_obj->block_frame[n],
+				  &src_obj->impulse_response[n *
+					src_obj->filter_length],
+				  src_obj->block_position[n]);
+
+	src_obj->block_count = 0;
+	src_obj->block_span = 0;
+}
+
+static void asrc_block_flush32(struct asrc_farrow *src_obj,
+			       int32_t **output_buffers)
+{
+	int n;
+
+	if (!src_obj->block_count)
+		return;
+
+	asrc_calc_impulse_response_block(src_obj, src_obj->block_count);
+	for (n = 0; n < src_obj->block_count; n++)
+		asrc_fir_filter32(src_obj, output_buffers,
+				  src_obj->block_frame[n],
+				  &src_obj->impulse_response[n *
+					src_obj->filter_length],
+				  src_obj->block_position[n]);
+
+	src_obj->block_count = 0;
+	src_obj->block_span = 0;
+}
+
+/* Generate one output frame for each channel, or queue it */
+static inline void asrc_output16(struct asrc_farrow *src_obj,
+				 int16_t **output_buffers,
+				 int index_output_frame)
+{
+#if ASRC_BLOCK_LENGTH > 1
+	asrc_block_queue(src_obj, index_output_frame);
+	if (src_obj->block_count == ASRC_BLOCK_LENGTH)
+		asrc_block_flush16(src_obj, output_buffers);
+#else
+	/* Calculate impulse response */
+	(*src_obj->calc_ir)(src_obj);
+
+	/* Filter and write one output sample for each channel to the
+	 * output_buffer
+	 */
+	asrc_fir_filter16(src_obj, output_buffers, index_output_frame,
+			  src_obj->impulse_response,
+			  src_obj->buffer_write_position);
+#endif
+}
+
+static inline void asrc_output32(struct asrc_farrow *src_obj,
+				 int32_t **output_buffers,
+				 int index_output_frame)
+{
+#if ASRC_BLOCK_LENGTH > 1
+	asrc_block_queue(src_obj, index_output_frame);
+	if (src_obj->block_count == ASRC_BLOCK_LENGTH)
+		asrc_block_flush32(src_obj, output_buffers);
+#else
+	(*src_obj->calc_ir)(src_obj);
+	asrc_fir_filter32(src_obj, output_buffers, index_output_frame,
+			  src_obj->impulse_response,
+			  src_obj->buffer_write_position);
+#endif
+}
+
+/* Consume one input frame, the queued output frames are filtered first
+ * if the ring buffer can't hold their samples after the write.
+ */
+static inline void asrc_input16(struct asrc_farrow *src_obj,
+				int16_t **input_buffers,
+				int16_t **output_buffers,
+				int index_input_frame)
+{
+#if ASRC_BLOCK_LENGTH > 1
+	if (src_obj->block_count) {
+		if (src_obj->block_span == ASRC_BLOCK_LENGTH - 1)
+			asrc_block_flush16(src_obj, output_buffers);
+		else
+			src_obj->block_span++;
+	}
+#endif
+	asrc_write_to_ring_buffer16(src_obj, input_buffers, index_input_frame);
+}
+
+static inline void asrc_input32(struct asrc_farrow *src_obj,
+				int32_t **input_buffers,
+				int32_t **output_buffers,
+				int index_input_frame)
+{
+#if ASRC_BLOCK_LENGTH > 1
+	if (src_obj->block_count) {
+		if (src_obj->block_span == ASRC_BLOCK_LENGTH - 1)
+			asrc_block_flush32(src_obj, output_buffers);
+		else
+			src_obj->block_span++;
+	}
+#endif
+	asrc_write_to_ring_buffer32(src_obj, input_buffers, index_input_frame);
+}
+
 enum asrc_error_code asrc_process_push16(struct comp_dev *dev,
 					 struct asrc_farrow *src_obj,
 					 int16_t **__restrict input_buffers,
@@ -1012,14 +1154,11 @@ enum asrc_error_code asrc_process_push16(struct comp_dev *dev,
 			if (*output_num_frames == max_num_free_frames)
 				break;
 
-			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
-
 			/* Filter and write one output sample for each
 			 * channel to the output_buffer
 			 */
-			asrc_fir_filter16(src_obj, output_buffers,
-					  src_obj->io_buffer_idx);
+			asrc_output16(src_obj, output_buffers,
+				      src_obj->io_buffer_idx);
 
 			/* Update time and buffer index */
 			src_obj->time_value += src_obj->fs_ratio;
@@ -1033,14 +1172,15 @@ enum asrc_error_code asrc_process_push16(struct comp_dev *dev,
 			(*output_num_frames)++;
 		} else {
 			/* Consume one input sample */
-			asrc_write_to_ring_buffer16(src_obj, input_buffers,
-						    index_input_frame);
+			asrc_input16(src_obj, input_buffers, output_buffers,
+				     index_input_frame);
 			index_input_frame++;
 
 			/* Update time */
 			src_obj->time_value -= TIME_VALUE_ONE;
 		}
 	}
+	asrc_block_flush16(src_obj, output_buffers);
 	*write_index = src_obj->io_buffer_idx;
 	*input_num_frames = index_input_frame;
 
@@ -1120,14 +1260,11 @@ enum asrc_error_code asrc_process_push32(struct comp_dev *dev,
 			if (*output_num_frames == max_num_free_frames)
 				break;
 
-			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
-
 			/* Filter and write output sample to
 			 * output_buffer
 			 */
-			asrc_fir_filter32(src_obj, output_buffers,
-					  src_obj->io_buffer_idx);
+			asrc_output32(src_obj, output_buffers,
+				      src_obj->io_buffer_idx);
 
 			/* Update time and index */
 			src_obj->time_value += src_obj->fs_ratio;
@@ -1141,14 +1278,15 @@ enum asrc_error_code asrc_process_push32(struct comp_dev *dev,
 			(*output_num_frames)++;
 		} else {
 			/* Consume input sample */
-			asrc_write_to_ring_buffer32(src_obj, input_buffers,
-						    index_input_frame);
+			asrc_input32(src_obj, input_buffers, output_buffers,
+				     index_input_frame);
 			index_input_frame++;
 
 			/* Update time */
 			src_obj->time_value -= TIME_VALUE_ONE;
 		}
 	}
+	asrc_block_flush32(src_obj, output_buffers);
 	*write_index = src_obj->io_buffer_idx;
 	*input_num_frames = index_input_frame;
 
@@ -1222,9 +1360,8 @@ enum asrc_error_code asrc_process_pull16(struct comp_dev *dev,
 			if (src_obj->io_buffer_idx == write_index)
 				break;
 
-			asrc_write_to_ring_buffer16(src_obj,
-						    input_buffers,
-						    src_obj->io_buffer_idx);
+			asrc_input16(src_obj, input_buffers, output_buffers,
+				     src_obj->io_buffer_idx);
 			src_obj->io_buffer_idx++;
 
 			/* Wrap around */
@@ -1240,12 +1377,9 @@ enum asrc_error_code asrc_process_pull16(struct comp_dev *dev,
 					       src_obj->fs_ratio_inv) >> 27;
 			src_obj->time_value_pull += src_obj->fs_ratio;
 		} else {
-			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
-
 			/* Filter and write output sample to output_buffer */
-			asrc_fir_filter16(src_obj, output_buffers,
-					  index_output_frame);
+			asrc_output16(src_obj, output_buffers,
+				      index_output_frame);
 
 			/* Update time and index */
 			src_obj->time_value += src_obj->fs_ratio_inv;
@@ -1253,6 +1387,7 @@ enum asrc_error_code asrc_process_pull16(struct comp_dev *dev,
 			index_output_frame++;
 		}
 	}
+	asrc_block_flush16(src_obj, output_buffers);
 	*read_index = src_obj->io_buffer_idx;
 	*output_num_frames = index_output_frame;
 
@@ -1326,9 +1461,8 @@ enum asrc_error_code asrc_process_pull32(struct comp_dev *dev,
 			if (src_obj->io_buffer_idx == write_index)
 				break;
 
-			asrc_write_to_ring_buffer32(src_obj,
-						    input_buffers,
-						    src_obj->io_buffer_idx);
+			asrc_input32(src_obj, input_buffers, output_buffers,
+				     src_obj->io_buffer_idx);
 			src_obj->io_buffer_idx++;
 
 			/* Wrap around */
@@ -1344,12 +1478,9 @@ enum asrc_error_code asrc_process_pull32(struct comp_dev *dev,
 					       src_obj->fs_ratio_inv) >> 27;
 			src_obj->time_value_pull += src_obj->fs_ratio;
 		} else {
-			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
-
 			/* Filter and write output sample to output_buffer */
-			asrc_fir_filter32(src_obj, output_buffers,
-					  index_output_frame);
+			asrc_output32(src_obj, output_buffers,
+				      index_output_frame);
 
 			/* Update time and index */
 			src_obj->time_value += src_obj->fs_ratio_inv;
@@ -1357,6 +1488,7 @@ enum asrc_error_code asrc_process_pull32(struct comp_dev *dev,
 			index_output_frame++;
 		}
 	}
+	asrc_block_flush32(src_obj, output_buffers);
 	*read_index = src_obj->io_buffer_idx;
 	*output_num_frames = index_output_frame;
 
@@ -10,12 +10,13 @@
 #include <sof/audio/format.h>
 
 void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
-		       int index_output_frame)
+		       int index_output_frame, const int32_t *impulse_response,
+		       int buffer_position)
 {
 	int64_t prod;
 	int32_t prod32;
 	int16_t prod16;
-	int32_t *filter_p;
+	const int32_t *filter_p;
 	int16_t *buffer_p;
 	int ch;
 	int n;
@@ -29,11 +30,10 @@ void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
 	/* Iterate over each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
 		/* Pointer to the beginning of the impulse response */
-		filter_p = &src_obj->impulse_response[0];
+		filter_p = impulse_response;
 
 		/* Pointer to the buffered input data */
-		buffer_p = &src_obj->ring_buffers16[ch]
-			[src_obj->buffer_write_position];
+		buffer_p = &src_obj->ring_buffers16[ch][buffer_position];
 
 		/* Initialise the accumulator */
 		prod = 0;
@@ -59,7 +59,8 @@ void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
 }
 
 void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
-		       int index_output_frame)
+		       int index_output_frame, const int32_t *impulse_response,
+		       int buffer_position)
 {
 	int64_t prod;
 	int32_t prod32;
@@ -77,11 +78,10 @@ void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
 	/* Iterate over each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
 		/* Pointer to the beginning of the impulse response */
-		filter_p = &src_obj->impulse_response[0];
+		filter_p = impulse_response;
 
 		/* Pointer to the buffered input data */
-		buffer_p = &src_obj->ring_buffers32[ch]
-			[src_obj->buffer_write_position];
+		buffer_p = &src_obj->ring_buffers32[ch][buffer_position];
 
 		/* Initialise the accumulator */
 		prod = 0;
@@ -358,4 +358,56 @@ void asrc_calc_impulse_response_n7(struct asrc_farrow *src_obj)
 	}
 }
 
+void asrc_calc_impulse_response_block(struct asrc_farrow *src_obj,
+				      int num_frames)
+{
+	/*
+	 * Same computation as in 'calc_impulse_response_nX' but the
+	 * polyphase filter coefficients are loaded once for all the
+	 * queued frames.
+	 */
+	int32_t time[ASRC_BLOCK_LENGTH];
+	int32_t coefl[ASRC_MAX_NUM_FILTERS];
+	int32_t coefh[ASRC_MAX_NUM_FILTERS];
+	int32_t accuml;
+	int32_t accumh;
+	const int32_t *filter_P;
+	int32_t *result_P;
+	int num_filters = src_obj->num_filters;
+	int index_filter;
+	int index_limit;
+	int n;
+	int k;
+
+	filter_P = &src_obj->polyphase_filters[0];
+	for (n = 0; n < num_frames; n++)
+		time[n] = sat_int32(((int64_t)src_obj->block_time[n]) << 4);
+
+	index_limit = src_obj->filter_length >> 1;
+	for (index_filter = 0; index_filter < index_limit; index_filter++) {
+		for (k = 0; k < num_filters; k++) {
+			coefl[k] = *filter_P++;
+			coefh[k] = *filter_P++;
+		}
+
+		result_P = &src_obj->impulse_response[2 * index_filter];
+		for (n = 0; n < num_frames; n++) {
+			accuml = coefl[0];
+			accumh = coefh[0];
+			for (k = 1; k < num_filters; k++) {
+				accuml = coefl[k] +
+					q_multsr_sat_32x32(accuml, time[n],
+							   62 - 31);
+				accumh = coefh[k] +
+					q_multsr_sat_32x32(accumh, time[n],
+							   62 - 31);
+			}
+
+			result_P[0] = accuml;
+			result_P[1] = accumh;
+			result_P += src_obj->filter_length;
+		}
+	}
+}
+
 #endif /* ASRC_GENERIC */
@@ -10,7 +10,8 @@
 #include <xtensa/tie/xt_hifi3.h>
 
 void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
-		       int index_output_frame)
+		       int index_output_frame, const int32_t *impulse_response,
+		       int buffer_position)
 {
 	ae_f32x2 prod;
 	ae_f32x2 filter01 = AE_ZERO32(); /* Note: Init is not needed */
@@ -37,12 +38,12 @@ void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
 	/* Iterate over each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
 		/* Pointer to the beginning of the impulse response */
-		filter_p = (ae_f32x2 *)&src_obj->impulse_response[0];
+		filter_p = (ae_f32x2 *)impulse_response;
 
 		/* Pointer to the buffered input data */
 		buffer_p =
 			(ae_f16x4 *)&src_obj->ring_buffers16[ch]
-			[src_obj->buffer_write_position];
+			[buffer_position];
 
 		/* Allows unaligned load of 64 bit per cycle */
 		ae_valign align_filter = AE_LA64_PP(filter_p);
@@ -96,7 +97,8 @@ void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
 }
 
 void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
-		       int index_output_frame)
+		       int index_output_frame, const int32_t *impulse_response,
+		       int buffer_position)
 {
 	ae_f32x2 prod;
 	ae_f32x2 buffer01 = AE_ZERO32(); /* Note: Init is not needed */
@@ -122,12 +124,12 @@ void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
 	/* Iterate over each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
 		/* Pointer to the beginning of the impulse response */
-		filter_p = (ae_f32x2 *)&src_obj->impulse_response[0];
+		filter_p = (ae_f32x2 *)impulse_response;
 
 		/* Pointer to the buffered input data */
 		buffer_p =
 			(ae_f32x2 *)&src_obj->ring_buffers32[ch]
-			[src_obj->buffer_write_position];
+			[buffer_position];
 
 		/* Allows unaligned load of 64 bit per cycle */
 		ae_valign align_filter = AE_LA64_PP(filter_p);
@@ -399,4 +401,60 @@ void asrc_calc_impulse_response_n7(struct asrc_farrow *src_obj)
 	AE_SA64POS_FP(align_out, result_P);
 }
 
+void asrc_calc_impulse_response_block(struct asrc_farrow *src_obj,
+				      int num_frames)
+{
+	/*
+	 * See 'calc_impulse_response_n4' for a detailed description
+	 * of the algorithm and data handling. The coefficient pairs of
+	 * all polyphase filters for two impulse response bins are
+	 * loaded once and kept in registers for all the queued frames.
+	 */
+	ae_f32x2 time_x2[ASRC_BLOCK_LENGTH];
+	ae_f32x2 coef[ASRC_MAX_NUM_FILTERS];
+	ae_f32x2 accum;
+	ae_f32x2 next;
+	ae_f32x2 *filter_P;
+	ae_f32x2 *result_P;
+	ae_valign align_f;
+	ae_valign align_out;
+	int num_filters = src_obj->num_filters;
+	int index_filter;
+	int index_limit;
+	int n;
+	int k;
+
+	filter_P = (ae_f32x2 *)&src_obj->polyphase_filters[0];
+	align_f = AE_LA64_PP(filter_P);
+
+	for (n = 0; n < num_frames; n++) {
+		time_x2[n] = AE_L32_X((ae_f32 *)&src_obj->block_time[n], 0);
+		time_x2[n] = AE_SLAI32S(time_x2[n], 4);
+	}
+
+	index_limit = src_obj->filter_length >> 1;
+	for (index_filter = 0; index_filter < index_limit; index_filter++) {
+		for (k = 0; k < num_filters; k++)
+			AE_LA32X2_IP(coef[k], align_f, filter_P);
+
+		for (n = 0; n < num_frames; n++) {
+			accum = coef[0];
+			for (k = 1; k < num_filters; k++) {
+				next = coef[k];
+				AE_MULAFP32X2RS(next, accum, time_x2[n]);
+				accum = next;
+			}
+
+			/* Store the two bins to the impulse response of
+			 * frame n
+			 */
+			result_P = (ae_f32x2 *)&src_obj->impulse_response
+				[n * src_obj->filter_length + 2 * index_filter];
+			align_out = AE_ZALIGN64();
+			AE_SA32X2_IP(accum, align_out, result_P);
+			AE_SA64POS_FP(align_out, result_P);
+		}
+	}
+}
+
 #endif /* ASRC Hifi3 */
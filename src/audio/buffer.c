@@ -7,6 +7,7 @@
 
 #include <sof/audio/buffer.h>
 #include <sof/audio/component.h>
+#include <sof/common.h>
 #include <sof/drivers/interrupt.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
@@ -14,6 +15,7 @@
 #include <sof/lib/notifier.h>
 #include <sof/list.h>
 #include <sof/spinlock.h>
+#include <sof/string.h>
 #include <ipc/topology.h>
 #include <errno.h>
 #include <stddef.h>
@@ -24,6 +26,13 @@ DECLARE_SOF_RT_UUID("buffer", buffer_uuid, 0x42544c92, 0x8e92, 0x4e41,
 		 0xb6, 0x79, 0x34, 0x51, 0x9f, 0x1c, 0x1d, 0x28);
 DECLARE_TR_CTX(buffer_tr, SOF_UUID(buffer_uuid), LOG_LEVEL_INFO);
 
+/* buffers and their locks are recycled on every topology load/unload */
+static SHARED_DATA struct mm_pool buffer_pool =
+	MM_POOL_DEF(SOF_MEM_POOL_BUFFER, sizeof(struct comp_buffer), 4, 0);
+static SHARED_DATA struct mm_pool buffer_lock_pool =
+	MM_POOL_DEF(SOF_MEM_POOL_BUFFER_LOCK, sizeof(spinlock_t), 16,
+		    SOF_MEM_FLAG_SHARED);
+
 struct comp_buffer *buffer_alloc(uint32_t size, uint32_t caps, uint32_t align)
 {
 	struct comp_buffer *buffer;
@@ -38,24 +47,23 @@ struct comp_buffer *buffer_alloc(uint32_t size, uint32_t caps, uint32_t align)
 	}
 
 	/* allocate new buffer */
-	buffer = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
-			 sizeof(*buffer));
+	buffer = rpool_zalloc(&buffer_pool);
 	if (!buffer) {
 		tr_err(&buffer_tr, "buffer_alloc(): could not alloc structure");
 		return NULL;
 	}
 
-	buffer->lock = rzalloc(SOF_MEM_ZONE_RUNTIME, SOF_MEM_FLAG_SHARED,
-			       SOF_MEM_CAPS_RAM, sizeof(*buffer->lock));
+	buffer->lock = rpool_zalloc(&buffer_lock_pool);
 	if (!buffer->lock) {
-		rfree(buffer);
+		rpool_free(&buffer_pool, buffer);
 		tr_err(&buffer_tr, "buffer_alloc(): could not alloc lock");
 		return NULL;
 	}
 
 	buffer->stream.addr = rballoc_align(0, caps, size, align);
 	if (!buffer->stream.addr) {
-		rfree(buffer);
+		rpool_free(&buffer_lock_pool, buffer->lock);
+		rpool_free(&buffer_pool, buffer);
 		tr_err(&buffer_tr, "buffer_alloc(): could not alloc size = %u bytes of type = %u",
 		       size, caps);
 		return NULL;
@@ -63,6 +71,9 @@ struct comp_buffer *buffer_alloc(uint32_t size, uint32_t caps, uint32_t align)
 
 	buffer_init(buffer, size, caps);
 
+	buffer->tick_produce.buffer = buffer;
+	buffer->tick_consume.buffer = buffer;
+
 	list_init(&buffer->source_list);
 	list_init(&buffer->sink_list);
 	spinlock_init(buffer->lock);
@@ -89,6 +100,10 @@ struct comp_buffer *buffer_new(struct sof_ipc_buffer *desc)
 						    SOF_BUF_UNDERRUN_PERMITTED;
 		buffer->stream.overrun_permitted = desc->flags &
 						   SOF_BUF_OVERRUN_PERMITTED;
+#if CONFIG_BUFFER_SPSC
+		buffer->spsc = !buffer->stream.underrun_permitted &&
+			       !buffer->stream.overrun_permitted;
+#endif
 
 		memcpy_s(&buffer->tctx, sizeof(struct tr_ctx),
 			 &buffer_tr, sizeof(struct tr_ctx));
@@ -145,12 +160,265 @@ void buffer_free(struct comp_buffer *buffer)
 
 	/* In case some listeners didn't unregister from buffer's callbacks */
 	notifier_unregister_all(NULL, buffer);
+	notifier_unregister_all(buffer, NULL);
+
+	/* graph changed, copy schedules have to be compiled again */
+	if (buffer->source)
+		pipeline_schedule_invalidate(buffer->source->pipeline);
+	if (buffer->sink)
+		pipeline_schedule_invalidate(buffer->sink->pipeline);
 
 	list_item_del(&buffer->source_list);
 	list_item_del(&buffer->sink_list);
-	rfree(buffer->stream.addr);
-	rfree(buffer->lock);
-	rfree(buffer);
+	rfree(buffer->alias ? buffer->own_addr : buffer->stream.addr);
+	rpool_free(&buffer_lock_pool, buffer->lock);
+	rpool_free(&buffer_pool, buffer);
+}
+
+int buffer_alias(struct comp_buffer *sink, struct comp_buffer *source)
+{
+	struct audio_stream *stream = &sink->stream;
+	uint32_t offset;
+
+	if (sink->stream.size != source->stream.size)
+		return -EINVAL;
+
+	buffer_spsc_sync(sink);
+	buffer_spsc_sync(source);
+
+	/* memory of an aliased buffer can't be lent further and data
+	 * already in the sink has to be drained first
+	 */
+	if (sink->alias || source->alias ||
+	    audio_stream_get_avail_bytes(stream))
+		return -EBUSY;
+
+	buf_dbg(sink, "buffer_alias(), source->id = %u", source->id);
+
+	/* sink starts empty at the read position of the source */
+	offset = (char *)source->stream.r_ptr - (char *)source->stream.addr;
+
+	sink->own_addr = stream->addr;
+	sink->alias = source;
+	stream->addr = source->stream.addr;
+	stream->end_addr = source->stream.end_addr;
+
+	if (sink->spsc) {
+		atomic_set(&sink->produced.pos, offset);
+		atomic_set(&sink->consumed.pos, offset);
+		buffer_spsc_sync(sink);
+	} else {
+		stream->r_ptr = (char *)stream->addr + offset;
+		stream->w_ptr = stream->r_ptr;
+		stream->avail = 0;
+		stream->free = stream->size;
+	}
+
+	return 0;
+}
+
+void buffer_alias_sync(struct comp_buffer *sink)
+{
+	struct comp_buffer *source = sink->alias;
+	uint32_t bytes;
+
+	buffer_spsc_sync(sink);
+	buffer_spsc_sync(source);
+
+	/* everything read from the sink is already consumed from the source,
+	 * so the difference is what has been produced since the last sync
+	 */
+	bytes = audio_stream_get_avail_bytes(&source->stream) -
+		audio_stream_get_avail_bytes(&sink->stream);
+	if (bytes)
+		comp_update_buffer_produce(sink, bytes);
+}
+
+void buffer_unalias(struct comp_buffer *sink, bool keep)
+{
+	struct comp_buffer *source = sink->alias;
+	struct audio_stream *stream = &sink->stream;
+	uint32_t r_offset;
+	uint32_t w_offset;
+	uint32_t avail;
+	uint32_t head;
+
+	if (!source)
+		return;
+
+	buf_dbg(sink, "buffer_unalias(), keep = %d", keep);
+
+	buffer_spsc_sync(sink);
+	r_offset = (char *)stream->r_ptr - (char *)stream->addr;
+	w_offset = (char *)stream->w_ptr - (char *)stream->addr;
+	avail = keep ? audio_stream_get_avail_bytes(stream) : 0;
+
+	/* unread data is moved to the same offsets of own memory */
+	if (avail) {
+		head = MIN(avail, stream->size - r_offset);
+		memcpy_s((char *)sink->own_addr + r_offset,
+			 stream->size - r_offset, stream->r_ptr, head);
+		if (avail > head)
+			memcpy_s(sink->own_addr, stream->size, stream->addr,
+				 avail - head);
+	}
+
+	stream->addr = sink->own_addr;
+	stream->end_addr = (char *)stream->addr + stream->size;
+	sink->own_addr = NULL;
+	sink->alias = NULL;
+
+	if (!keep) {
+		audio_stream_reset(stream);
+		buffer_spsc_reset(sink);
+		return;
+	}
+
+	if (sink->spsc) {
+		buffer_spsc_sync(sink);
+	} else {
+		stream->r_ptr = (char *)stream->addr + r_offset;
+		stream->w_ptr = (char *)stream->addr + w_offset;
+	}
+
+	/* the moved data isn't in the source anymore */
+	if (avail)
+		comp_update_buffer_consume(source, avail);
+}
+
+static const enum notify_id buffer_notify_ids[] = {
+	NOTIFIER_ID_BUFFER_PRODUCE,
+	NOTIFIER_ID_BUFFER_CONSUME,
+	NOTIFIER_ID_BUFFER_PRODUCE_TICK,
+	NOTIFIER_ID_BUFFER_CONSUME_TICK,
+};
+
+/* sends transactions coalesced during the LL tick that has just finished */
+static void buffer_notify_tick(void *arg, enum notify_id type, void *data)
+{
+	struct comp_buffer *buffer = arg;
+	struct buffer_cb_transact produce;
+	struct buffer_cb_transact consume;
+	uint32_t flags = 0;
+
+	buffer_lock(buffer, &flags);
+
+	produce = buffer->tick_produce;
+	consume = buffer->tick_consume;
+	buffer->tick_produce.transaction_amount = 0;
+	buffer->tick_consume.transaction_amount = 0;
+
+	buffer_unlock(buffer, flags);
+
+	if (produce.transaction_amount)
+		notifier_event(buffer, NOTIFIER_ID_BUFFER_PRODUCE_TICK,
+			       NOTIFIER_TARGET_CORE_LOCAL, &produce,
+			       sizeof(produce));
+
+	if (consume.transaction_amount)
+		notifier_event(buffer, NOTIFIER_ID_BUFFER_CONSUME_TICK,
+			       NOTIFIER_TARGET_CORE_LOCAL, &consume,
+			       sizeof(consume));
+}
+
+/* recalculates the subscriber mask checked on every produce/consume */
+static int buffer_notify_update(struct comp_buffer *buffer)
+{
+	uint32_t old_mask = buffer->notify_mask;
+	uint32_t mask = 0;
+	int ret = 0;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(buffer_notify_ids); i++)
+		if (notifier_has_callbacks(buffer, buffer_notify_ids[i]))
+			mask |= BIT(buffer_notify_ids[i]);
+
+	/* coalesced events are flushed at the end of every LL tick */
+	if (!(old_mask & BUFFER_NOTIFY_TICK_MASK) &&
+	    mask & BUFFER_NOTIFY_TICK_MASK) {
+		buffer->tick_produce.transaction_amount = 0;
+		buffer->tick_consume.transaction_amount = 0;
+		ret = notifier_register(buffer, NULL, NOTIFIER_ID_LL_POST_RUN,
+					buffer_notify_tick, 0);
+		if (ret < 0)
+			mask &= ~BUFFER_NOTIFY_TICK_MASK;
+	} else if (old_mask & BUFFER_NOTIFY_TICK_MASK &&
+		   !(mask & BUFFER_NOTIFY_TICK_MASK)) {
+		notifier_unregister(buffer, NULL, NOTIFIER_ID_LL_POST_RUN);
+	}
+
+	buffer->notify_mask = mask;
+
+	return ret;
+}
+
+int buffer_notifier_register(void *receiver, struct comp_buffer *buffer,
+			     enum notify_id type,
+			     void (*cb)(void *arg, enum notify_id type,
+					void *data),
+			     uint32_t flags)
+{
+	int ret;
+
+	ret = notifier_register(receiver, buffer, type, cb, flags);
+	if (ret < 0)
+		return ret;
+
+	ret = buffer_notify_update(buffer);
+	if (ret < 0) {
+		buf_err(buffer, "buffer_notifier_register(): LL tick hook failed");
+		notifier_unregister(receiver, buffer, type);
+	}
+
+	return ret;
+}
+
+void buffer_notifier_unregister(void *receiver, struct comp_buffer *buffer,
+				enum notify_id type)
+{
+	notifier_unregister(receiver, buffer, type);
+	buffer_notify_update(buffer);
+}
+
+/* adds a transaction to the amount reported at the end of LL tick */
+static inline void buffer_tick_add(struct buffer_cb_transact *tick,
+				   void *begin, uint32_t bytes)
+{
+	if (!tick->transaction_amount)
+		tick->transaction_begin_address = begin;
+	tick->transaction_amount += bytes;
+}
+
+/* publishes data written by the source of a lock-free buffer */
+static void *buffer_spsc_produce(struct comp_buffer *buffer, uint32_t bytes)
+{
+	uint32_t pos = atomic_read(&buffer->produced.pos);
+
+	buffer_spsc_store(buffer, &buffer->produced,
+			  buffer_spsc_advance(buffer, pos, bytes));
+	buffer_spsc_sync(buffer);
+
+	return buffer_spsc_ptr(buffer, pos);
+}
+
+/* releases data read by the sink of a lock-free buffer */
+static void *buffer_spsc_consume(struct comp_buffer *buffer, uint32_t bytes)
+{
+	uint32_t pos = atomic_read(&buffer->consumed.pos);
+
+	buffer_spsc_store(buffer, &buffer->consumed,
+			  buffer_spsc_advance(buffer, pos, bytes));
+	buffer_spsc_sync(buffer);
+
+	return buffer_spsc_ptr(buffer, pos);
+}
+
+/* subscribed on this buffer or listened to with a NULL caller */
+static inline bool buffer_notify_wanted(struct comp_buffer *buffer,
+					enum notify_id type)
+{
+	return (buffer->notify_mask & BIT(type)) ||
+		notifier_has_wildcard(type);
 }
 
 void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
@@ -173,14 +441,30 @@ void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes)
 		return;
 	}
 
-	buffer_lock(buffer, &flags);
+	if (buffer->spsc) {
+		/* only the source moves this position, no need to lock */
+		cb_data.transaction_begin_address =
+			buffer_spsc_produce(buffer, bytes);
+	} else {
+		buffer_lock(buffer, &flags);
+		audio_stream_produce(&buffer->stream, bytes);
+	}
 
-	audio_stream_produce(&buffer->stream, bytes);
+	comp_perf_frames(buffer->source, &buffer->stream, bytes);
 
-	notifier_event(buffer, NOTIFIER_ID_BUFFER_PRODUCE,
-		       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
+	if (buffer_notify_wanted(buffer, NOTIFIER_ID_BUFFER_PRODUCE))
+		notifier_event(buffer, NOTIFIER_ID_BUFFER_PRODUCE,
+			       NOTIFIER_TARGET_CORE_LOCAL, &cb_data,
+			       sizeof(cb_data));
 
-	buffer_unlock(buffer, flags);
+	if (buffer->notify_mask & BIT(NOTIFIER_ID_BUFFER_PRODUCE_TICK))
+		buffer_tick_add(&buffer->tick_produce,
+				cb_data.transaction_begin_address, bytes);
+
+	if (buffer->spsc)
+		buffer_spsc_commit(buffer);
+	else
+		buffer_unlock(buffer, flags);
 
 	addr = buffer->stream.addr;
 
@@ -213,14 +497,34 @@ void comp_update_buffer_consume(struct comp_buffer *buffer, uint32_t bytes)
 		return;
 	}
 
-	buffer_lock(buffer, &flags);
+	if (buffer->spsc) {
+		/* only the sink moves this position, no need to lock */
+		cb_data.transaction_begin_address =
+			buffer_spsc_consume(buffer, bytes);
+	} else {
+		buffer_lock(buffer, &flags);
+		audio_stream_consume(&buffer->stream, bytes);
+	}
 
-	audio_stream_consume(&buffer->stream, bytes);
+	comp_perf_frames(buffer->sink, &buffer->stream, bytes);
 
-	notifier_event(buffer, NOTIFIER_ID_BUFFER_CONSUME,
-		       NOTIFIER_TARGET_CORE_LOCAL, &cb_data, sizeof(cb_data));
+	if (buffer_notify_wanted(buffer, NOTIFIER_ID_BUFFER_CONSUME))
+		notifier_event(buffer, NOTIFIER_ID_BUFFER_CONSUME,
+			       NOTIFIER_TARGET_CORE_LOCAL, &cb_data,
+			       sizeof(cb_data));
 
-	buffer_unlock(buffer, flags);
+	if (buffer->notify_mask & BIT(NOTIFIER_ID_BUFFER_CONSUME_TICK))
+		buffer_tick_add(&buffer->tick_consume,
+				cb_data.transaction_begin_address, bytes);
+
+	if (buffer->spsc)
+		buffer_spsc_commit(buffer);
+	else
+		buffer_unlock(buffer, flags);
+
+	/* the data was read from the memory lent by the source buffer */
+	if (buffer->alias)
+		comp_update_buffer_consume(buffer->alias, bytes);
 
 	addr = buffer->stream.addr;
 
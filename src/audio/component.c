@@ -130,7 +130,9 @@ struct comp_dev *comp_new(struct sof_ipc_comp *comp)
 		drv->tctx->uuid_p, comp->type, comp->pipeline_id, comp->id);
 
 	/* create the new component */
+	comp_heap_owner_set(drv);
 	cdev = drv->ops.create(drv, comp);
+	comp_heap_owner_set(NULL);
 	if (!cdev) {
 		comp_cl_err(drv, "comp_new(): unable to create the new component");
 		return NULL;
@@ -252,6 +254,90 @@ int comp_set_state(struct comp_dev *dev, int cmd)
 	return ret;
 }
 
+void comp_set_transparent(struct comp_dev *dev)
+{
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+
+	if (dev->transparent || dev->is_shared ||
+	    list_is_empty(&dev->bsource_list) ||
+	    list_is_empty(&dev->bsink_list))
+		return;
+
+	source = list_first_item(&dev->bsource_list, struct comp_buffer,
+				 sink_list);
+	sink = list_first_item(&dev->bsink_list, struct comp_buffer,
+			       source_list);
+
+	if (!list_item_is_last(&source->sink_list, &dev->bsource_list) ||
+	    !list_item_is_last(&sink->source_list, &dev->bsink_list))
+		return;
+
+	/* aliased data is read as is and without cache maintenance */
+	if (source->stream.size != sink->stream.size ||
+	    source->stream.frame_fmt != sink->stream.frame_fmt ||
+	    source->stream.channels != sink->stream.channels ||
+	    source->stream.rate != sink->stream.rate ||
+	    source->inter_core || sink->inter_core ||
+	    (sink->caps & SOF_MEM_CAPS_DMA)) {
+		comp_info(dev, "comp_set_transparent(), buffers can't be aliased");
+		return;
+	}
+
+	comp_info(dev, "comp_set_transparent()");
+
+	dev->transparent = COMP_TRANSPARENT_PENDING;
+}
+
+bool comp_transparent_copy(struct comp_dev *dev)
+{
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+
+	source = list_first_item(&dev->bsource_list, struct comp_buffer,
+				 sink_list);
+	sink = list_first_item(&dev->bsink_list, struct comp_buffer,
+			       source_list);
+
+	switch (dev->transparent) {
+	case COMP_TRANSPARENT_PENDING:
+		/* sink memory lent downstream can't be replaced, else the
+		 * aliasing waits until the sink is drained
+		 */
+		if (sink->sink->transparent == COMP_TRANSPARENT_ON ||
+		    buffer_alias(sink, source) < 0)
+			return false;
+
+		comp_info(dev, "comp_transparent_copy(), sink aliases source");
+		dev->transparent = COMP_TRANSPARENT_ON;
+		/* fallthrough */
+	case COMP_TRANSPARENT_ON:
+		buffer_alias_sync(sink);
+		return true;
+	case COMP_TRANSPARENT_EXIT:
+		/* data already passed stays in the sink, the rest is
+		 * processed with the new configuration
+		 */
+		comp_info(dev, "comp_transparent_copy(), exit");
+		buffer_unalias(sink, true);
+		dev->transparent = COMP_TRANSPARENT_OFF;
+		return false;
+	default:
+		return false;
+	}
+}
+
+void comp_transparent_reset(struct comp_dev *dev)
+{
+	struct comp_buffer *sink;
+
+	sink = list_first_item(&dev->bsink_list, struct comp_buffer,
+			       source_list);
+	buffer_unalias(sink, false);
+
+	dev->transparent = COMP_TRANSPARENT_OFF;
+}
+
 void sys_comp_init(struct sof *sof)
 {
 	sof->comp_drivers = platform_shared_get(&cd, sizeof(cd));
@@ -264,6 +350,9 @@ void sys_comp_init(struct sof *sof)
 void comp_get_copy_limits(struct comp_buffer *source, struct comp_buffer *sink,
 			  struct comp_copy_limits *cl)
 {
+	buffer_spsc_sync(source);
+	buffer_spsc_sync(sink);
+
 	cl->frames = audio_stream_avail_frames(&source->stream, &sink->stream);
 	cl->source_frame_bytes = audio_stream_frame_bytes(&source->stream);
 	cl->sink_frame_bytes = audio_stream_frame_bytes(&sink->stream);
@@ -10,6 +10,18 @@
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
 #include <sof/audio/crossover/crossover.h>
+#include <sof/math/numbers.h>
+
+#if CROSSOVER_GENERIC
+/*
+ * \brief Runs a block through the LR4 filter, two biquads in series.
+ */
+static inline void crossover_generic_lr4(struct iir_state_df2t *lr4,
+					 const int32_t *x, int32_t *y,
+					 int frames)
+{
+	iir_df2t_block(lr4, x, y, frames, 1);
+}
 
 /*
  * \brief Splits x into two based on the coefficients set in the lp
@@ -21,11 +33,11 @@
  */
 static inline void crossover_generic_lr4_split(struct iir_state_df2t *lp,
 					       struct iir_state_df2t *hp,
-					       int32_t x, int32_t *y1,
-					       int32_t *y2)
+					       const int32_t *x, int32_t *y1,
+					       int32_t *y2, int frames)
 {
-	*y1 = crossover_generic_process_lr4(x, lp);
-	*y2 = crossover_generic_process_lr4(x, hp);
+	crossover_generic_lr4(lp, x, y1, frames);
+	crossover_generic_lr4(hp, x, y2, frames);
 }
 
 /*
@@ -39,50 +51,114 @@ static inline void crossover_generic_lr4_split(struct iir_state_df2t *lp,
  */
 static inline void crossover_generic_lr4_merge(struct iir_state_df2t *lp,
 					       struct iir_state_df2t *hp,
-					       int32_t x, int32_t *y)
+					       const int32_t *x, int32_t *y,
+					       int frames)
 {
-	int32_t z1, z2;
+	int32_t z[CROSSOVER_BLOCK_FRAMES];
+	int i;
 
-	z1 = crossover_generic_process_lr4(x, lp);
-	z2 = crossover_generic_process_lr4(x, hp);
-	*y = sat_int32(((int64_t)z1) + z2);
+	crossover_generic_lr4(lp, x, y, frames);
+	crossover_generic_lr4(hp, x, z, frames);
+	for (i = 0; i < frames; i++)
+		y[i] = sat_int32(((int64_t)y[i]) + z[i]);
 }
 
-static void crossover_generic_split_2way(int32_t in,
-					 int32_t out[],
-					 struct crossover_state *state)
+static void crossover_generic_split_2way(const int32_t *in, int32_t *out[],
+					 struct crossover_state *state,
+					 int frames)
 {
 	crossover_generic_lr4_split(&state->lowpass[0], &state->highpass[0],
-				    in, &out[0], &out[1]);
+				    in, out[0], out[1], frames);
 }
 
-static void crossover_generic_split_3way(int32_t in,
-					 int32_t out[],
-					 struct crossover_state *state)
+static void crossover_generic_split_3way(const int32_t *in, int32_t *out[],
+					 struct crossover_state *state,
+					 int frames)
 {
-	int32_t z1, z2;
+	int32_t z1[CROSSOVER_BLOCK_FRAMES];
+	int32_t z2[CROSSOVER_BLOCK_FRAMES];
 
 	crossover_generic_lr4_split(&state->lowpass[0], &state->highpass[0],
-				    in, &z1, &z2);
+				    in, z1, z2, frames);
 	/* Realign the phase of z1 */
 	crossover_generic_lr4_merge(&state->lowpass[1], &state->highpass[1],
-				    z1, &out[0]);
+				    z1, out[0], frames);
 	crossover_generic_lr4_split(&state->lowpass[2], &state->highpass[2],
-				    z2, &out[1], &out[2]);
+				    z2, out[1], out[2], frames);
 }
 
-static void crossover_generic_split_4way(int32_t in,
-					 int32_t out[],
-					 struct crossover_state *state)
+static void crossover_generic_split_4way(const int32_t *in, int32_t *out[],
+					 struct crossover_state *state,
+					 int frames)
 {
-	int32_t z1, z2;
+	int32_t z1[CROSSOVER_BLOCK_FRAMES];
+	int32_t z2[CROSSOVER_BLOCK_FRAMES];
 
 	crossover_generic_lr4_split(&state->lowpass[1], &state->highpass[1],
-				    in, &z1, &z2);
+				    in, z1, z2, frames);
 	crossover_generic_lr4_split(&state->lowpass[0], &state->highpass[0],
-				    z1, &out[0], &out[1]);
+				    z1, out[0], out[1], frames);
 	crossover_generic_lr4_split(&state->lowpass[2], &state->highpass[2],
-				    z2, &out[2], &out[3]);
+				    z2, out[2], out[3], frames);
+}
+
+const crossover_split crossover_split_fnmap[] = {
+	crossover_generic_split_2way,
+	crossover_generic_split_3way,
+	crossover_generic_split_4way,
+};
+
+const size_t crossover_split_fncount = ARRAY_SIZE(crossover_split_fnmap);
+#endif /* CROSSOVER_GENERIC */
+
+/* initializes iterators over the source and all connected sinks */
+static void crossover_init_iters(const struct comp_buffer *source,
+				 struct comp_buffer *sinks[],
+				 int32_t num_sinks, uint32_t frames,
+				 struct audio_stream_iter *in,
+				 struct audio_stream_iter *out)
+{
+	int j;
+
+	audio_stream_iter_init(in, &source->stream, source->stream.r_ptr,
+			       frames);
+
+	for (j = 0; j < num_sinks; j++)
+		if (sinks[j])
+			audio_stream_iter_init_sink(&out[j],
+						    &sinks[j]->stream,
+						    sinks[j]->stream.w_ptr,
+						    frames);
+}
+
+/* frames which can be processed without wrap in any of the streams */
+static uint32_t crossover_block_frames(struct audio_stream_iter *in,
+				       struct audio_stream_iter *out,
+				       struct comp_buffer *sinks[],
+				       int32_t num_sinks)
+{
+	uint32_t frames = audio_stream_iter_frames(in);
+	int j;
+
+	for (j = 0; j < num_sinks; j++)
+		if (sinks[j])
+			frames = MIN(frames, audio_stream_iter_frames(&out[j]));
+
+	return frames;
+}
+
+static void crossover_next_iters(struct audio_stream_iter *in,
+				 struct audio_stream_iter *out,
+				 struct comp_buffer *sinks[],
+				 int32_t num_sinks, uint32_t frames)
+{
+	int j;
+
+	audio_stream_iter_next(in, frames);
+
+	for (j = 0; j < num_sinks; j++)
+		if (sinks[j])
+			audio_stream_iter_next(&out[j], frames);
 }
 
 #if CONFIG_FORMAT_S16LE
@@ -92,20 +168,23 @@ static void crossover_s16_default_pass(const struct comp_dev *dev,
 				       int32_t num_sinks,
 				       uint32_t frames)
 {
-	const struct audio_stream *source_stream = &source->stream;
-	int16_t *x;
-	int32_t *y;
-	int i, j;
-	int n = source_stream->channels * frames;
-
-	for (i = 0; i < n; i++) {
-		x = audio_stream_read_frag_s16(source_stream, i);
-		for (j = 0; j < num_sinks; j++) {
-			if (!sinks[j])
-				continue;
-			y = audio_stream_read_frag_s16((&sinks[j]->stream), i);
-			*y = *x;
-		}
+	struct audio_stream_iter in;
+	struct audio_stream_iter out[SOF_CROSSOVER_MAX_STREAMS];
+	uint32_t bytes;
+	uint32_t n;
+	int j;
+
+	crossover_init_iters(source, sinks, num_sinks, frames, &in, out);
+
+	while (in.frames) {
+		n = crossover_block_frames(&in, out, sinks, num_sinks);
+		bytes = n * in.frame_bytes;
+
+		for (j = 0; j < num_sinks; j++)
+			if (sinks[j])
+				memcpy_s(out[j].ptr, bytes, in.ptr, bytes);
+
+		crossover_next_iters(&in, out, sinks, num_sinks, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
@@ -117,23 +196,33 @@ static void crossover_s32_default_pass(const struct comp_dev *dev,
 				       int32_t num_sinks,
 				       uint32_t frames)
 {
-	const struct audio_stream *source_stream = &source->stream;
-	int32_t *x, *y;
-	int i, j;
-	int n = source_stream->channels * frames;
-
-	for (i = 0; i < n; i++) {
-		x = audio_stream_read_frag_s32(source_stream, i);
-		for (j = 0; j < num_sinks; j++) {
-			if (!sinks[j])
-				continue;
-			y = audio_stream_read_frag_s32((&sinks[j]->stream), i);
-			*y = *x;
-		}
+	struct audio_stream_iter in;
+	struct audio_stream_iter out[SOF_CROSSOVER_MAX_STREAMS];
+	uint32_t bytes;
+	uint32_t n;
+	int j;
+
+	crossover_init_iters(source, sinks, num_sinks, frames, &in, out);
+
+	while (in.frames) {
+		n = crossover_block_frames(&in, out, sinks, num_sinks);
+		bytes = n * in.frame_bytes;
+
+		for (j = 0; j < num_sinks; j++)
+			if (sinks[j])
+				memcpy_s(out[j].ptr, bytes, in.ptr, bytes);
+
+		crossover_next_iters(&in, out, sinks, num_sinks, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
 
+/*
+ * Each contiguous block is split channel by channel, CROSSOVER_BLOCK_FRAMES
+ * at a time. The channel is gathered to a Q1.31 work buffer, split with the
+ * architecture specific split function and the outputs are written to all
+ * sinks as runs with channels stride.
+ */
 #if CONFIG_FORMAT_S16LE
 static void crossover_s16_default(const struct comp_dev *dev,
 				  const struct comp_buffer *source,
@@ -143,32 +232,45 @@ static void crossover_s16_default(const struct comp_dev *dev,
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct crossover_state *state;
-	const struct audio_stream *source_stream = &source->stream;
-	struct audio_stream *sink_stream;
-	int16_t *x, *y;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out[SOF_CROSSOVER_MAX_STREAMS];
+	int32_t x[CROSSOVER_BLOCK_FRAMES];
+	int32_t z[SOF_CROSSOVER_MAX_STREAMS][CROSSOVER_BLOCK_FRAMES];
+	int32_t *zp[SOF_CROSSOVER_MAX_STREAMS];
+	const int16_t *src;
+	int16_t *dst;
 	int ch, i, j;
-	int idx = 0;
-	int nch = source_stream->channels;
-	int32_t out[num_sinks];
+	int nch = source->stream.channels;
+	uint32_t n;
+
+	for (j = 0; j < SOF_CROSSOVER_MAX_STREAMS; j++)
+		zp[j] = z[j];
+
+	crossover_init_iters(source, sinks, num_sinks, frames, &in, out);
 
-	for (ch = 0; ch < nch; ch++) {
-		idx = ch;
-		state = &cd->state[ch];
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s16(source_stream, idx);
-			cd->crossover_split(*x << 16, out, state);
+	while (in.frames) {
+		n = MIN(crossover_block_frames(&in, out, sinks, num_sinks),
+			CROSSOVER_BLOCK_FRAMES);
+
+		for (ch = 0; ch < nch; ch++) {
+			state = &cd->state[ch];
+			src = (int16_t *)in.ptr + ch;
+			for (i = 0; i < n; i++)
+				x[i] = src[i * nch] << 16;
+
+			cd->crossover_split(x, zp, state, n);
 
 			for (j = 0; j < num_sinks; j++) {
 				if (!sinks[j])
 					continue;
-				sink_stream = &sinks[j]->stream;
-				y = audio_stream_read_frag_s16(sink_stream,
-							       idx);
-				*y = sat_int16(Q_SHIFT_RND(out[j], 31, 15));
+				dst = (int16_t *)out[j].ptr + ch;
+				for (i = 0; i < n; i++)
+					dst[i * nch] = sat_int16(Q_SHIFT_RND(z[j][i],
+									     31, 15));
 			}
-
-			idx += nch;
 		}
+
+		crossover_next_iters(&in, out, sinks, num_sinks, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
@@ -182,32 +284,45 @@ static void crossover_s24_default(const struct comp_dev *dev,
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct crossover_state *state;
-	const struct audio_stream *source_stream = &source->stream;
-	struct audio_stream *sink_stream;
-	int32_t *x, *y;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out[SOF_CROSSOVER_MAX_STREAMS];
+	int32_t x[CROSSOVER_BLOCK_FRAMES];
+	int32_t z[SOF_CROSSOVER_MAX_STREAMS][CROSSOVER_BLOCK_FRAMES];
+	int32_t *zp[SOF_CROSSOVER_MAX_STREAMS];
+	const int32_t *src;
+	int32_t *dst;
 	int ch, i, j;
-	int idx = 0;
-	int nch = source_stream->channels;
-	int32_t out[num_sinks];
+	int nch = source->stream.channels;
+	uint32_t n;
+
+	for (j = 0; j < SOF_CROSSOVER_MAX_STREAMS; j++)
+		zp[j] = z[j];
+
+	crossover_init_iters(source, sinks, num_sinks, frames, &in, out);
+
+	while (in.frames) {
+		n = MIN(crossover_block_frames(&in, out, sinks, num_sinks),
+			CROSSOVER_BLOCK_FRAMES);
+
+		for (ch = 0; ch < nch; ch++) {
+			state = &cd->state[ch];
+			src = (int32_t *)in.ptr + ch;
+			for (i = 0; i < n; i++)
+				x[i] = src[i * nch] << 8;
 
-	for (ch = 0; ch < nch; ch++) {
-		idx = ch;
-		state = &cd->state[ch];
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source_stream, idx);
-			cd->crossover_split(*x << 8, out, state);
+			cd->crossover_split(x, zp, state, n);
 
 			for (j = 0; j < num_sinks; j++) {
 				if (!sinks[j])
 					continue;
-				sink_stream = &sinks[j]->stream;
-				y = audio_stream_read_frag_s32(sink_stream,
-							       idx);
-				*y = sat_int24(Q_SHIFT_RND(out[j], 31, 23));
+				dst = (int32_t *)out[j].ptr + ch;
+				for (i = 0; i < n; i++)
+					dst[i * nch] = sat_int24(Q_SHIFT_RND(z[j][i],
+									     31, 23));
 			}
-
-			idx += nch;
 		}
+
+		crossover_next_iters(&in, out, sinks, num_sinks, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S24LE */
@@ -221,32 +336,44 @@ static void crossover_s32_default(const struct comp_dev *dev,
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct crossover_state *state;
-	const struct audio_stream *source_stream = &source->stream;
-	struct audio_stream *sink_stream;
-	int32_t *x, *y;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out[SOF_CROSSOVER_MAX_STREAMS];
+	int32_t x[CROSSOVER_BLOCK_FRAMES];
+	int32_t z[SOF_CROSSOVER_MAX_STREAMS][CROSSOVER_BLOCK_FRAMES];
+	int32_t *zp[SOF_CROSSOVER_MAX_STREAMS];
+	const int32_t *src;
+	int32_t *dst;
 	int ch, i, j;
-	int idx = 0;
-	int nch = source_stream->channels;
-	int32_t out[num_sinks];
+	int nch = source->stream.channels;
+	uint32_t n;
+
+	for (j = 0; j < SOF_CROSSOVER_MAX_STREAMS; j++)
+		zp[j] = z[j];
+
+	crossover_init_iters(source, sinks, num_sinks, frames, &in, out);
 
-	for (ch = 0; ch < nch; ch++) {
-		idx = ch;
-		state = &cd->state[0];
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source_stream, idx);
-			cd->crossover_split(*x, out, state);
+	while (in.frames) {
+		n = MIN(crossover_block_frames(&in, out, sinks, num_sinks),
+			CROSSOVER_BLOCK_FRAMES);
+
+		for (ch = 0; ch < nch; ch++) {
+			state = &cd->state[ch];
+			src = (int32_t *)in.ptr + ch;
+			for (i = 0; i < n; i++)
+				x[i] = src[i * nch];
+
+			cd->crossover_split(x, zp, state, n);
 
 			for (j = 0; j < num_sinks; j++) {
 				if (!sinks[j])
 					continue;
-				sink_stream = &sinks[j]->stream;
-				y = audio_stream_read_frag_s32(sink_stream,
-							       idx);
-				*y = out[j];
+				dst = (int32_t *)out[j].ptr + ch;
+				for (i = 0; i < n; i++)
+					dst[i * nch] = z[j][i];
 			}
-
-			idx += nch;
 		}
+
+		crossover_next_iters(&in, out, sinks, num_sinks, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S32LE */
@@ -282,11 +409,3 @@ const struct crossover_proc_fnmap crossover_proc_fnmap_pass[] = {
 };
 
 const size_t crossover_proc_fncount = ARRAY_SIZE(crossover_proc_fnmap);
-
-const crossover_split crossover_split_fnmap[] = {
-	crossover_generic_split_2way,
-	crossover_generic_split_3way,
-	crossover_generic_split_4way,
-};
-
-const size_t crossover_split_fncount = ARRAY_SIZE(crossover_split_fnmap);
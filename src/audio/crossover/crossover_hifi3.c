@@ -0,0 +1,187 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Google LLC. All rights reserved.
+//
+// Author: Sebastiano Carlucci <scarlucci@google.com>
+
+#include <sof/audio/crossover/crossover.h>
+
+#if CROSSOVER_HIFI3
+
+#include <sof/audio/component.h>
+#include <sof/common.h>
+#include <sof/math/iir_df2t.h>
+#include <user/eq.h>
+#include <xtensa/tie/xt_hifi3.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * \brief Runs a block through the LR4 filter.
+ *
+ * Both biquads of a LR4 share the same coefficients, so they are loaded
+ * once and kept in registers with all four delays for the whole block.
+ * The arithmetic is the same as in HiFi3 iir_df2t() so the output is bit
+ * exact with it.
+ */
+static void crossover_hifi3_lr4(struct iir_state_df2t *lr4,
+				const int32_t *x, int32_t *y, int frames)
+{
+	ae_f64 acc;
+	ae_f64 d0;
+	ae_f64 d1;
+	ae_f64 d2;
+	ae_f64 d3;
+	ae_valign align;
+	ae_f32x2 coef_a2a1;
+	ae_f32x2 coef_b2b1;
+	ae_f32x2 coef_b0shift;
+	ae_f32x2 gain;
+	ae_f32 in;
+	ae_f32 tmp;
+	ae_f32x2 *coefp = (ae_f32x2 *)lr4->coef;
+	ae_f64 *delayp = (ae_f64 *)lr4->delay;
+	int shift;
+	int i;
+
+	/* Coefficients order in coef[] is {a2, a1, b2, b1, b0, shift, gain} */
+	align = AE_LA64_PP(coefp);
+	AE_LA32X2_IP(coef_a2a1, align, coefp);
+	AE_LA32X2_IP(coef_b2b1, align, coefp);
+	AE_LA32X2_IP(coef_b0shift, align, coefp);
+	AE_LA32X2_IP(gain, align, coefp);
+	shift = AE_SEL32_LL(coef_b0shift, coef_b0shift);
+	d0 = delayp[0];
+	d1 = delayp[1];
+	d2 = delayp[2];
+	d3 = delayp[3];
+
+	for (i = 0; i < frames; i++) {
+		/* First biquad, delays are Q17.47 */
+		in = x[i];
+		acc = AE_SRAI64(d0, 1);
+		AE_MULAF32R_HH(acc, coef_b0shift, in); /* Coef b0 */
+		acc = AE_SLAI64S(acc, 1);
+		tmp = AE_ROUND32F48SSYM(acc);
+
+		acc = AE_SRAI64(d1, 1);
+		AE_MULAF32R_LL(acc, coef_b2b1, in); /* Coef b1 */
+		AE_MULAF32R_LL(acc, coef_a2a1, tmp); /* Coef a1 */
+		d0 = AE_SLAI64S(acc, 1);
+
+		acc = AE_MULF32R_HH(coef_b2b1, in); /* Coef b2 */
+		AE_MULAF32R_HH(acc, coef_a2a1, tmp); /* Coef a2 */
+		d1 = AE_SLAI64S(acc, 1);
+
+		acc = AE_MULF32R_HH(gain, tmp); /* Gain */
+		acc = AE_SLAI64S(acc, 17);
+		acc = AE_SRAA64(acc, shift);
+		in = AE_ROUND32F48SSYM(acc);
+
+		/* Second biquad continues from output of the first one */
+		acc = AE_SRAI64(d2, 1);
+		AE_MULAF32R_HH(acc, coef_b0shift, in); /* Coef b0 */
+		acc = AE_SLAI64S(acc, 1);
+		tmp = AE_ROUND32F48SSYM(acc);
+
+		acc = AE_SRAI64(d3, 1);
+		AE_MULAF32R_LL(acc, coef_b2b1, in); /* Coef b1 */
+		AE_MULAF32R_LL(acc, coef_a2a1, tmp); /* Coef a1 */
+		d2 = AE_SLAI64S(acc, 1);
+
+		acc = AE_MULF32R_HH(coef_b2b1, in); /* Coef b2 */
+		AE_MULAF32R_HH(acc, coef_a2a1, tmp); /* Coef a2 */
+		d3 = AE_SLAI64S(acc, 1);
+
+		acc = AE_MULF32R_HH(gain, tmp); /* Gain */
+		acc = AE_SLAI64S(acc, 17);
+		acc = AE_SRAA64(acc, shift);
+		y[i] = AE_ROUND32F48SSYM(acc);
+	}
+
+	delayp[0] = d0;
+	delayp[1] = d1;
+	delayp[2] = d2;
+	delayp[3] = d3;
+}
+
+/*
+ * \brief Splits x into two based on the coefficients set in the lp
+ *        and hp filters. The output of the lp is in y1, the output of
+ *        the hp is in y2.
+ */
+static inline void crossover_hifi3_lr4_split(struct iir_state_df2t *lp,
+					     struct iir_state_df2t *hp,
+					     const int32_t *x, int32_t *y1,
+					     int32_t *y2, int frames)
+{
+	crossover_hifi3_lr4(lp, x, y1, frames);
+	crossover_hifi3_lr4(hp, x, y2, frames);
+}
+
+/*
+ * \brief Splits input signal into two and merges it back to realign
+ *        the phase of the 3-way crossover low band.
+ */
+static inline void crossover_hifi3_lr4_merge(struct iir_state_df2t *lp,
+					     struct iir_state_df2t *hp,
+					     const int32_t *x, int32_t *y,
+					     int frames)
+{
+	int32_t z[CROSSOVER_BLOCK_FRAMES];
+	int i;
+
+	crossover_hifi3_lr4(lp, x, y, frames);
+	crossover_hifi3_lr4(hp, x, z, frames);
+	for (i = 0; i < frames; i++)
+		y[i] = AE_F32_ADDS_F32(y[i], z[i]);
+}
+
+static void crossover_hifi3_split_2way(const int32_t *in, int32_t *out[],
+				       struct crossover_state *state,
+				       int frames)
+{
+	crossover_hifi3_lr4_split(&state->lowpass[0], &state->highpass[0],
+				  in, out[0], out[1], frames);
+}
+
+static void crossover_hifi3_split_3way(const int32_t *in, int32_t *out[],
+				       struct crossover_state *state,
+				       int frames)
+{
+	int32_t z1[CROSSOVER_BLOCK_FRAMES];
+	int32_t z2[CROSSOVER_BLOCK_FRAMES];
+
+	crossover_hifi3_lr4_split(&state->lowpass[0], &state->highpass[0],
+				  in, z1, z2, frames);
+	/* Realign the phase of z1 */
+	crossover_hifi3_lr4_merge(&state->lowpass[1], &state->highpass[1],
+				  z1, out[0], frames);
+	crossover_hifi3_lr4_split(&state->lowpass[2], &state->highpass[2],
+				  z2, out[1], out[2], frames);
+}
+
+static void crossover_hifi3_split_4way(const int32_t *in, int32_t *out[],
+				       struct crossover_state *state,
+				       int frames)
+{
+	int32_t z1[CROSSOVER_BLOCK_FRAMES];
+	int32_t z2[CROSSOVER_BLOCK_FRAMES];
+
+	crossover_hifi3_lr4_split(&state->lowpass[1], &state->highpass[1],
+				  in, z1, z2, frames);
+	crossover_hifi3_lr4_split(&state->lowpass[0], &state->highpass[0],
+				  z1, out[0], out[1], frames);
+	crossover_hifi3_lr4_split(&state->lowpass[2], &state->highpass[2],
+				  z2, out[2], out[3], frames);
+}
+
+const crossover_split crossover_split_fnmap[] = {
+	crossover_hifi3_split_2way,
+	crossover_hifi3_split_3way,
+	crossover_hifi3_split_4way,
+};
+
+const size_t crossover_split_fncount = ARRAY_SIZE(crossover_split_fnmap);
+
+#endif /* CROSSOVER_HIFI3 */
@@ -25,6 +25,7 @@
 #include <ipc/topology.h>
 #include <user/trace.h>
 #include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -51,6 +52,21 @@ static void dcblock_set_passthrough(struct comp_data *cd)
 		cd->R_coeffs[i] = ONE_Q2_30;
 }
 
+/**
+ * \brief Checks if the DC Blocking filter is in pass through mode.
+ * With R set to 1 and zero initial state the output equals the input.
+ */
+static bool dcblock_is_passthrough(struct comp_data *cd, int channels)
+{
+	int i;
+
+	for (i = 0; i < channels; i++)
+		if (cd->R_coeffs[i] != ONE_Q2_30)
+			return false;
+
+	return true;
+}
+
 /**
  * \brief Initializes the state of the DC Blocking Filter
  */
@@ -373,6 +389,9 @@ static int dcblock_prepare(struct comp_dev *dev)
 	comp_info(dev, "dcblock_prepare(), source_format=%d, sink_format=%d",
 		  cd->source_format, cd->sink_format);
 
+	if (dcblock_is_passthrough(cd, sourceb->stream.channels))
+		comp_set_transparent(dev);
+
 	return 0;
 
 err:
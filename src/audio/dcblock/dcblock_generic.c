@@ -8,6 +8,7 @@
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
 #include <sof/audio/dcblock/dcblock.h>
+#include <sof/math/numbers.h>
 
 /**
  *
@@ -38,26 +39,39 @@ static void dcblock_s16_default(const struct comp_dev *dev,
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct dcblock_state *state;
-	int16_t *x;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
+	const int16_t *x;
 	int16_t *y;
 	int32_t R;
 	int32_t tmp;
-	int idx;
+	int nch = source->channels;
 	int ch;
 	int i;
-	int nch = source->channels;
+	int n;
+
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+
+	while (in.frames) {
+		n = MIN(audio_stream_iter_frames(&in),
+			audio_stream_iter_frames(&out));
 
-	for (ch = 0; ch < nch; ch++) {
-		state = &cd->state[ch];
-		R = cd->R_coeffs[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s16(source, idx);
-			y = audio_stream_read_frag_s16(sink, idx);
-			tmp = dcblock_generic(state, R, *x << 16);
-			*y = sat_int16(Q_SHIFT_RND(tmp, 31, 15));
-			idx += nch;
+		for (ch = 0; ch < nch; ch++) {
+			state = &cd->state[ch];
+			R = cd->R_coeffs[ch];
+			x = (int16_t *)in.ptr + ch;
+			y = (int16_t *)out.ptr + ch;
+			for (i = 0; i < n; i++) {
+				tmp = dcblock_generic(state, R, *x << 16);
+				*y = sat_int16(Q_SHIFT_RND(tmp, 31, 15));
+				x += nch;
+				y += nch;
+			}
 		}
+
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
@@ -70,26 +84,39 @@ static void dcblock_s24_default(const struct comp_dev *dev,
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct dcblock_state *state;
-	int32_t *x;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
+	const int32_t *x;
 	int32_t *y;
 	int32_t R;
 	int32_t tmp;
-	int idx;
+	int nch = source->channels;
 	int ch;
 	int i;
-	int nch = source->channels;
+	int n;
+
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
 
-	for (ch = 0; ch < nch; ch++) {
-		state = &cd->state[ch];
-		R = cd->R_coeffs[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_read_frag_s32(sink, idx);
-			tmp = dcblock_generic(state, R, *x << 8);
-			*y = sat_int24(Q_SHIFT_RND(tmp, 31, 23));
-			idx += nch;
+	while (in.frames) {
+		n = MIN(audio_stream_iter_frames(&in),
+			audio_stream_iter_frames(&out));
+
+		for (ch = 0; ch < nch; ch++) {
+			state = &cd->state[ch];
+			R = cd->R_coeffs[ch];
+			x = (int32_t *)in.ptr + ch;
+			y = (int32_t *)out.ptr + ch;
+			for (i = 0; i < n; i++) {
+				tmp = dcblock_generic(state, R, *x << 8);
+				*y = sat_int24(Q_SHIFT_RND(tmp, 31, 23));
+				x += nch;
+				y += nch;
+			}
 		}
+
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S24LE */
@@ -102,24 +129,37 @@ static void dcblock_s32_default(const struct comp_dev *dev,
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct dcblock_state *state;
-	int32_t *x;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
+	const int32_t *x;
 	int32_t *y;
 	int32_t R;
-	int idx;
+	int nch = source->channels;
 	int ch;
 	int i;
-	int nch = source->channels;
+	int n;
 
-	for (ch = 0; ch < nch; ch++) {
-		state = &cd->state[ch];
-		R = cd->R_coeffs[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_read_frag_s32(sink, idx);
-			*y = dcblock_generic(state, R, *x);
-			idx += nch;
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+
+	while (in.frames) {
+		n = MIN(audio_stream_iter_frames(&in),
+			audio_stream_iter_frames(&out));
+
+		for (ch = 0; ch < nch; ch++) {
+			state = &cd->state[ch];
+			R = cd->R_coeffs[ch];
+			x = (int32_t *)in.ptr + ch;
+			y = (int32_t *)out.ptr + ch;
+			for (i = 0; i < n; i++) {
+				*y = dcblock_generic(state, R, *x);
+				x += nch;
+				y += nch;
+			}
 		}
+
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S32LE */
@@ -0,0 +1,589 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+//
+// Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+
+#include <sof/audio/buffer.h>
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <sof/audio/pipeline.h>
+#include <sof/audio/drc/drc.h>
+#include <sof/common.h>
+#include <sof/debug/panic.h>
+#include <sof/drivers/ipc.h>
+#include <sof/lib/alloc.h>
+#include <sof/lib/memory.h>
+#include <sof/lib/uuid.h>
+#include <sof/list.h>
+#include <sof/math/decibels.h>
+#include <sof/math/iir_df2t.h>
+#include <sof/platform.h>
+#include <sof/string.h>
+#include <sof/ut.h>
+#include <sof/trace/trace.h>
+#include <ipc/control.h>
+#include <ipc/stream.h>
+#include <ipc/topology.h>
+#include <user/drc.h>
+#include <user/eq.h>
+#include <user/trace.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+static const struct comp_driver comp_drc;
+
+/* 2c7bbec9-0d01-4a22-b8ad-3f2ea16c5249 */
+DECLARE_SOF_RT_UUID("drc", drc_uuid, 0x2c7bbec9, 0x0d01, 0x4a22,
+		    0xb8, 0xad, 0x3f, 0x2e, 0xa1, 0x6c, 0x52, 0x49);
+
+DECLARE_TR_CTX(drc_tr, SOF_UUID(drc_uuid), LOG_LEVEL_INFO);
+
+/* Number of LR4 low pass and high pass filter pairs for band split */
+static int drc_num_lr4(int num_bands)
+{
+	switch (num_bands) {
+	case 1:
+		return 0;
+	case 2:
+		return 1;
+	default:
+		return DRC_MAX_LR4;
+	}
+}
+
+static int drc_validate_config(struct sof_drc_config *config)
+{
+	struct sof_drc_params *params;
+	size_t size;
+	int i;
+
+	if (config->num_bands < 1 || config->num_bands > SOF_DRC_MAX_BANDS) {
+		comp_cl_err(&comp_drc, "drc_validate_config(), invalid num_bands %u",
+			    config->num_bands);
+		return -EINVAL;
+	}
+
+	size = sizeof(*config) + 2 * drc_num_lr4(config->num_bands) *
+		sizeof(struct sof_eq_iir_biquad_df2t);
+	if (config->size != size) {
+		comp_cl_err(&comp_drc, "drc_validate_config(), size %u does not match %u for %u bands",
+			    config->size, size, config->num_bands);
+		return -EINVAL;
+	}
+
+	if (config->lookahead_time > SOF_DRC_MAX_LOOKAHEAD_TIME) {
+		comp_cl_err(&comp_drc, "drc_validate_config(), look-ahead %u us exceeds %u us",
+			    config->lookahead_time,
+			    SOF_DRC_MAX_LOOKAHEAD_TIME);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < config->num_bands; i++) {
+		params = &config->params[i];
+		if (!params->enabled)
+			continue;
+
+		if (params->threshold > 0 ||
+		    params->threshold <
+		    Q_CONVERT_FLOAT(SOF_DRC_MIN_THRESHOLD_DB, 24) ||
+		    params->knee < 0 ||
+		    params->knee > Q_CONVERT_FLOAT(SOF_DRC_MAX_KNEE_DB, 24) ||
+		    params->slope < 0 ||
+		    params->slope > Q_CONVERT_FLOAT(1.0, 30) ||
+		    params->makeup_gain <
+		    -Q_CONVERT_FLOAT(SOF_DRC_MAX_MAKEUP_GAIN_DB, 24) ||
+		    params->makeup_gain >
+		    Q_CONVERT_FLOAT(SOF_DRC_MAX_MAKEUP_GAIN_DB, 24)) {
+			comp_cl_err(&comp_drc, "drc_validate_config(), invalid parameters for band %d",
+				    i);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+/*
+ * \brief Returns Q1.31 smoothing coefficient exp(-T / time) for a block of
+ *	  DRC_DIVISION_FRAMES frames, T is the block duration.
+ */
+static int32_t drc_time_coef(uint32_t time, uint32_t rate)
+{
+	int64_t arg;
+
+	if (!time || !rate)
+		return 0;
+
+	/* Time is in microseconds, exp_fixed() argument is Q5.27 */
+	arg = -(((int64_t)DRC_DIVISION_FRAMES * 1000000) << 27) /
+		((int64_t)time * rate);
+	if (arg < INT32_MIN)
+		return 0;
+
+	/* Q12.20 to Q1.31 */
+	return sat_int32((int64_t)exp_fixed((int32_t)arg) << 11);
+}
+
+static void drc_init_band(struct drc_band_state *band,
+			  struct sof_drc_params *params, uint32_t rate)
+{
+	band->enabled = params->enabled;
+	band->threshold = params->threshold;
+	band->knee = params->knee;
+	band->slope = params->slope;
+	band->makeup = params->makeup_gain;
+	band->attack = drc_time_coef(params->attack_time, rate);
+	band->release = drc_time_coef(params->release_time, rate);
+	band->env = 0;
+	band->peak = 0;
+	band->peak_prev = 0;
+	band->step = 0;
+
+	/* Start with the makeup gain and no reduction */
+	if (band->enabled)
+		band->gain = sat_int32((int64_t)db2lin_fixed(band->makeup) << 4);
+	else
+		band->gain = DRC_GAIN_ONE;
+
+	band->target = band->gain;
+}
+
+static void drc_init_lr4(struct iir_state_df2t *lr4, int32_t *coef,
+			 int64_t *delay)
+{
+	lr4->coef = coef;
+	lr4->delay = delay;
+	lr4->biquads = 2;
+	lr4->biquads_in_series = 2;
+}
+
+static void drc_free_data(struct drc_comp_data *cd)
+{
+	rfree(cd->data);
+	cd->data = NULL;
+	cd->in = NULL;
+}
+
+/**
+ * \brief Setup the gain computers, band split filters, look-ahead delay
+ *	  lines and work buffers for DRC.
+ */
+static int drc_setup(struct drc_comp_data *cd, int nch, uint32_t rate)
+{
+	struct sof_drc_config *config = cd->config;
+	struct sof_eq_iir_biquad_df2t *coef;
+	size_t block_samples = DRC_DIVISION_FRAMES * nch;
+	size_t size;
+	int64_t *delay;
+	int32_t *data;
+	int num_lr4;
+	int ret;
+	int ch;
+	int i;
+
+	/* Free any previous allocation */
+	drc_free_data(cd);
+
+	if (nch < 1 || nch > PLATFORM_MAX_CHANNELS) {
+		comp_cl_err(&comp_drc, "drc_setup(), invalid channels count %d",
+			    nch);
+		return -EINVAL;
+	}
+
+	ret = drc_validate_config(config);
+	if (ret < 0)
+		return ret;
+
+	cd->nch = nch;
+	cd->num_bands = config->num_bands;
+	cd->delay_frames = ((uint64_t)config->lookahead_time * rate + 999999) /
+		1000000;
+	cd->delay_idx = 0;
+	cd->pos = 0;
+	num_lr4 = drc_num_lr4(cd->num_bands);
+
+	/* LR4 delays, input block, band blocks and look-ahead delay lines */
+	size = 2 * num_lr4 * nch * DRC_NUM_DELAYS_LR4 * sizeof(int64_t);
+	size += block_samples * sizeof(int32_t);
+	if (cd->num_bands > 1)
+		size += cd->num_bands * block_samples * sizeof(int32_t);
+
+	size += cd->num_bands * cd->delay_frames * nch * sizeof(int32_t);
+
+	cd->data = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, size);
+	if (!cd->data) {
+		comp_cl_err(&comp_drc, "drc_setup(), allocation failed for size %u",
+			    size);
+		return -ENOMEM;
+	}
+
+	/* Both biquads of a LR4 use the same coefficients */
+	coef = config->coef;
+	for (i = 0; i < 2 * num_lr4; i++) {
+		ret = memcpy_s(cd->lr4_coef[i], sizeof(cd->lr4_coef[i]),
+			       &coef[i], sizeof(coef[i]));
+		assert(!ret);
+		ret = memcpy_s(&cd->lr4_coef[i][SOF_EQ_IIR_NBIQUAD_DF2T],
+			       sizeof(coef[i]), &coef[i], sizeof(coef[i]));
+		assert(!ret);
+	}
+
+	delay = cd->data;
+	for (i = 0; i < num_lr4; i++) {
+		for (ch = 0; ch < nch; ch++) {
+			drc_init_lr4(&cd->lowpass[i][ch], cd->lr4_coef[2 * i],
+				     delay);
+			delay += DRC_NUM_DELAYS_LR4;
+			drc_init_lr4(&cd->highpass[i][ch],
+				     cd->lr4_coef[2 * i + 1], delay);
+			delay += DRC_NUM_DELAYS_LR4;
+		}
+	}
+
+	data = (int32_t *)delay;
+	cd->in = data;
+	data += block_samples;
+	for (i = 0; i < cd->num_bands; i++) {
+		if (cd->num_bands > 1) {
+			cd->band[i].buf = data;
+			data += block_samples;
+		} else {
+			cd->band[i].buf = cd->in;
+		}
+
+		cd->band[i].delay = data;
+		data += cd->delay_frames * nch;
+		drc_init_band(&cd->band[i], &config->params[i], rate);
+	}
+
+	comp_cl_info(&comp_drc, "drc_setup(), %d bands, look-ahead %d frames",
+		     cd->num_bands, cd->delay_frames);
+
+	return 0;
+}
+
+/**
+ * \brief Creates DRC component.
+ * \return Pointer to DRC component device.
+ */
+static struct comp_dev *drc_new(const struct comp_driver *drv,
+				struct sof_ipc_comp *comp)
+{
+	struct sof_ipc_comp_process *ipc_drc =
+		(struct sof_ipc_comp_process *)comp;
+	struct comp_dev *dev;
+	struct drc_comp_data *cd;
+	size_t bs = ipc_drc->size;
+	int ret;
+
+	comp_cl_info(&comp_drc, "drc_new()");
+
+	/* Check first that configuration blob size is sane */
+	if (bs > SOF_DRC_MAX_SIZE) {
+		comp_cl_err(&comp_drc, "drc_new(), blob size (%d) exceeds maximum allowed size (%i)",
+			    bs, SOF_DRC_MAX_SIZE);
+		return NULL;
+	}
+
+	dev = comp_alloc(drv, COMP_SIZE(struct sof_ipc_comp_process));
+	if (!dev)
+		return NULL;
+
+	ret = memcpy_s(COMP_GET_IPC(dev, sof_ipc_comp_process),
+		       sizeof(struct sof_ipc_comp_process), ipc_drc,
+		       sizeof(struct sof_ipc_comp_process));
+	assert(!ret);
+
+	cd = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, sizeof(*cd));
+	if (!cd) {
+		rfree(dev);
+		return NULL;
+	}
+
+	comp_set_drvdata(dev, cd);
+
+	/* Handler for configuration data */
+	cd->model_handler = comp_data_blob_handler_new(dev);
+	if (!cd->model_handler) {
+		comp_cl_err(&comp_drc, "drc_new(): comp_data_blob_handler_new() failed.");
+		rfree(dev);
+		rfree(cd);
+		return NULL;
+	}
+
+	ret = comp_init_data_blob(cd->model_handler, bs, ipc_drc->data);
+	if (ret < 0) {
+		comp_cl_err(&comp_drc, "drc_new(): comp_init_data_blob() failed.");
+		comp_data_blob_handler_free(cd->model_handler);
+		rfree(dev);
+		rfree(cd);
+		return NULL;
+	}
+
+	dev->state = COMP_STATE_READY;
+	return dev;
+}
+
+/**
+ * \brief Frees DRC component.
+ */
+static void drc_free(struct comp_dev *dev)
+{
+	struct drc_comp_data *cd = comp_get_drvdata(dev);
+
+	comp_info(dev, "drc_free()");
+
+	drc_free_data(cd);
+	comp_data_blob_handler_free(cd->model_handler);
+
+	rfree(cd);
+	rfree(dev);
+}
+
+static int drc_params(struct comp_dev *dev,
+		      struct sof_ipc_stream_params *params)
+{
+	int ret;
+
+	comp_dbg(dev, "drc_params()");
+
+	ret = comp_verify_params(dev, 0, params);
+	if (ret < 0)
+		comp_err(dev, "drc_params(): pcm params verification failed");
+
+	return ret;
+}
+
+static int drc_cmd_get_data(struct comp_dev *dev,
+			    struct sof_ipc_ctrl_data *cdata, int max_size)
+{
+	struct drc_comp_data *cd = comp_get_drvdata(dev);
+	int ret = 0;
+
+	switch (cdata->cmd) {
+	case SOF_CTRL_CMD_BINARY:
+		comp_info(dev, "drc_cmd_get_data(), SOF_CTRL_CMD_BINARY");
+		ret = comp_data_blob_get_cmd(cd->model_handler, cdata, max_size);
+		break;
+	default:
+		comp_err(dev, "drc_cmd_get_data(), invalid command");
+		ret = -EINVAL;
+		break;
+	}
+
+	return ret;
+}
+
+static int drc_cmd_set_data(struct comp_dev *dev,
+			    struct sof_ipc_ctrl_data *cdata)
+{
+	struct drc_comp_data *cd = comp_get_drvdata(dev);
+	int ret = 0;
+
+	switch (cdata->cmd) {
+	case SOF_CTRL_CMD_BINARY:
+		comp_info(dev, "drc_cmd_set_data(), SOF_CTRL_CMD_BINARY");
+		ret = comp_data_blob_set_cmd(cd->model_handler, cdata);
+		break;
+	default:
+		comp_err(dev, "drc_cmd_set_data(), invalid command");
+		ret = -EINVAL;
+		break;
+	}
+
+	return ret;
+}
+
+/**
+ * \brief Handles incoming IPC commands for DRC component.
+ */
+static int drc_cmd(struct comp_dev *dev, int cmd, void *data,
+		   int max_data_size)
+{
+	struct sof_ipc_ctrl_data *cdata = data;
+	int ret = 0;
+
+	comp_info(dev, "drc_cmd()");
+
+	switch (cmd) {
+	case COMP_CMD_SET_DATA:
+		ret = drc_cmd_set_data(dev, cdata);
+		break;
+	case COMP_CMD_GET_DATA:
+		ret = drc_cmd_get_data(dev, cdata, max_data_size);
+		break;
+	default:
+		comp_err(dev, "drc_cmd(), invalid command");
+		ret = -EINVAL;
+	}
+
+	return ret;
+}
+
+static int drc_trigger(struct comp_dev *dev, int cmd)
+{
+	int ret;
+
+	comp_info(dev, "drc_trigger(), command = %u", cmd);
+
+	ret = comp_set_state(dev, cmd);
+	if (ret == COMP_STATUS_STATE_ALREADY_SET)
+		ret = PPL_STATUS_PATH_STOP;
+
+	return ret;
+}
+
+/**
+ * \brief Copies and processes stream data.
+ */
+static int drc_copy(struct comp_dev *dev)
+{
+	struct drc_comp_data *cd = comp_get_drvdata(dev);
+	struct comp_copy_limits cl;
+	struct comp_buffer *sourceb;
+	struct comp_buffer *sinkb;
+	int ret;
+
+	comp_dbg(dev, "drc_copy()");
+
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
+				  sink_list);
+	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
+				source_list);
+
+	/* Check for changed configuration */
+	if (comp_is_new_data_blob_available(cd->model_handler)) {
+		cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
+		ret = drc_setup(cd, sourceb->stream.channels,
+				sourceb->stream.rate);
+		if (ret < 0) {
+			comp_err(dev, "drc_copy(), failed DRC setup");
+			return ret;
+		}
+	}
+
+	/* Get source, sink, number of frames etc. to process. */
+	comp_get_copy_limits(sourceb, sinkb, &cl);
+
+	buffer_invalidate(sourceb, cl.source_bytes);
+
+	/* Pass through until a valid configuration is received */
+	if (cd->config && cd->in)
+		cd->drc_func(cd, &sourceb->stream, &sinkb->stream, cl.frames);
+	else
+		audio_stream_copy(&sourceb->stream, 0, &sinkb->stream, 0,
+				  cl.frames * sourceb->stream.channels);
+
+	buffer_writeback(sinkb, cl.sink_bytes);
+
+	comp_update_buffer_consume(sourceb, cl.source_bytes);
+	comp_update_buffer_produce(sinkb, cl.sink_bytes);
+
+	return 0;
+}
+
+/**
+ * \brief Prepares DRC component for processing.
+ */
+static int drc_prepare(struct comp_dev *dev)
+{
+	struct drc_comp_data *cd = comp_get_drvdata(dev);
+	struct comp_buffer *sourceb;
+	struct comp_buffer *sinkb;
+	int ret;
+
+	comp_info(dev, "drc_prepare()");
+
+	ret = comp_set_state(dev, COMP_TRIGGER_PREPARE);
+	if (ret < 0)
+		return ret;
+
+	if (ret == COMP_STATUS_STATE_ALREADY_SET)
+		return PPL_STATUS_PATH_STOP;
+
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
+				  sink_list);
+	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
+				source_list);
+
+	if (sourceb->stream.frame_fmt != sinkb->stream.frame_fmt ||
+	    sourceb->stream.channels != sinkb->stream.channels) {
+		comp_err(dev, "drc_prepare(), source and sink formats differ");
+		ret = -EINVAL;
+		goto err;
+	}
+
+	cd->drc_func = drc_find_func(sourceb->stream.frame_fmt);
+	if (!cd->drc_func) {
+		comp_err(dev, "drc_prepare(), No processing function matching frame_fmt %i",
+			 sourceb->stream.frame_fmt);
+		ret = -EINVAL;
+		goto err;
+	}
+
+	/* Initialize DRC, without configuration the stream passes through */
+	cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
+	if (cd->config) {
+		ret = drc_setup(cd, sourceb->stream.channels,
+				sourceb->stream.rate);
+		if (ret < 0) {
+			comp_err(dev, "drc_prepare(), setup failed");
+			goto err;
+		}
+	} else {
+		comp_info(dev, "drc_prepare(), setting DRC to passthrough mode");
+		comp_set_transparent(dev);
+	}
+
+	return 0;
+
+err:
+	comp_set_state(dev, COMP_TRIGGER_RESET);
+	return ret;
+}
+
+/**
+ * \brief Resets DRC component.
+ */
+static int drc_reset(struct comp_dev *dev)
+{
+	struct drc_comp_data *cd = comp_get_drvdata(dev);
+
+	comp_info(dev, "drc_reset()");
+
+	drc_free_data(cd);
+	cd->drc_func = NULL;
+
+	comp_set_state(dev, COMP_TRIGGER_RESET);
+	return 0;
+}
+
+/** \brief DRC component definition. */
+static const struct comp_driver comp_drc = {
+	.uid	= SOF_RT_UUID(drc_uuid),
+	.tctx	= &drc_tr,
+	.ops	= {
+		.create		= drc_new,
+		.free		= drc_free,
+		.params		= drc_params,
+		.cmd		= drc_cmd,
+		.trigger	= drc_trigger,
+		.copy		= drc_copy,
+		.prepare	= drc_prepare,
+		.reset		= drc_reset,
+	},
+};
+
+static SHARED_DATA struct comp_driver_info comp_drc_info = {
+	.drv = &comp_drc,
+};
+
+UT_STATIC void sys_comp_drc_init(void)
+{
+	comp_register(platform_shared_get(&comp_drc_info,
+					  sizeof(comp_drc_info)));
+}
+
+DECLARE_MODULE(sys_comp_drc_init);
@@ -0,0 +1,344 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+//
+// Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <sof/audio/drc/drc.h>
+#include <sof/common.h>
+#include <sof/math/decibels.h>
+#include <sof/math/iir_df2t.h>
+#include <sof/math/numbers.h>
+#include <sof/string.h>
+#include <ipc/stream.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if DRC_GENERIC
+int32_t drc_peak(const int32_t *x, int samples)
+{
+	return find_max_abs_int32((int32_t *)x, samples);
+}
+
+void drc_gain(struct drc_band_state *band, int frames, int nch)
+{
+	int32_t *x = band->buf;
+	int32_t gain = band->gain;
+	int ch;
+	int i;
+
+	for (i = 0; i < frames; i++) {
+		gain += band->step;
+		for (ch = 0; ch < nch; ch++) {
+			/* Q1.31 x Q8.24 -> Q1.31 */
+			*x = sat_int32(Q_MULTSR_32X32((int64_t)*x, gain,
+						      31, 24, 31));
+			x++;
+		}
+	}
+
+	band->gain = gain;
+}
+#endif /* DRC_GENERIC */
+
+/*
+ * \brief Runs interleaved frames of all channels through LR4 filters.
+ */
+static void drc_lr4(struct iir_state_df2t *lr4, const int32_t *x,
+		    int32_t *y, int frames, int nch)
+{
+	int ch;
+
+	for (ch = 0; ch < nch; ch++)
+		iir_df2t_block(&lr4[ch], x + ch, y + ch, frames, nch);
+}
+
+/*
+ * \brief Splits cd->in to the band buffers the same way as the 2-way and
+ *	  3-way crossover does. The low band of 3-way split is passed through
+ *	  the all-pass of the high split frequency to align the phases.
+ */
+static void drc_split(struct drc_comp_data *cd, int frames)
+{
+	int32_t *low = cd->band[0].buf;
+	int32_t *mid = cd->band[1].buf;
+	int32_t *high;
+	int nch = cd->nch;
+	int i;
+
+	if (cd->num_bands == 2) {
+		drc_lr4(cd->lowpass[0], cd->in, low, frames, nch);
+		drc_lr4(cd->highpass[0], cd->in, mid, frames, nch);
+		return;
+	}
+
+	/* cd->in is free as work buffer after the first split */
+	high = cd->band[2].buf;
+	drc_lr4(cd->lowpass[0], cd->in, low, frames, nch);
+	drc_lr4(cd->highpass[0], cd->in, high, frames, nch);
+	drc_lr4(cd->lowpass[1], low, cd->in, frames, nch);
+	drc_lr4(cd->highpass[1], low, low, frames, nch);
+	for (i = 0; i < frames * nch; i++)
+		low[i] = sat_int32((int64_t)low[i] + cd->in[i]);
+
+	drc_lr4(cd->lowpass[2], high, mid, frames, nch);
+	drc_lr4(cd->highpass[2], high, high, frames, nch);
+}
+
+/*
+ * \brief Delays the interleaved band samples by the look-ahead length.
+ */
+static void drc_delay(struct drc_comp_data *cd, int32_t *x, int32_t *delay,
+		      int frames)
+{
+	int32_t tmp;
+	int length = cd->delay_frames * cd->nch;
+	int idx = cd->delay_idx * cd->nch;
+	int i;
+
+	for (i = 0; i < frames * cd->nch; i++) {
+		tmp = delay[idx];
+		delay[idx] = x[i];
+		x[i] = tmp;
+		if (++idx == length)
+			idx = 0;
+	}
+}
+
+/*
+ * \brief Returns gain reduction in dB for a level in dB from the static
+ *	  compression curve with soft knee, all Q8.24.
+ */
+static int32_t drc_curve(const struct drc_band_state *band, int32_t level)
+{
+	int64_t over = (int64_t)level - band->threshold;
+	int64_t t;
+
+	/* Below the knee */
+	if (2 * over <= -band->knee)
+		return 0;
+
+	/* Inside the knee the reduction grows quadratically */
+	if (2 * over < band->knee) {
+		t = over + (band->knee >> 1);
+		t = (t * t) / (2 * band->knee);
+		return -(int32_t)((t * band->slope) >> 30);
+	}
+
+	return -(int32_t)((over * band->slope) >> 30);
+}
+
+/*
+ * \brief Computes the new gain of band from the peaks of the previous and
+ *	  the completed block. The gain reduction is smoothed in dB domain
+ *	  with attack and release coefficients and the linear gain is ramped
+ *	  to it during the next block.
+ *
+ * Since the peaks of two blocks are used both ends of the ramp are low
+ * enough for the samples of the completed block. A limiter with attack
+ * time zero and two blocks look-ahead does not overshoot.
+ */
+static void drc_update_gain(struct drc_band_state *band)
+{
+	int32_t level = MAX(band->peak, band->peak_prev);
+	int32_t target;
+	int32_t coef;
+
+	band->peak_prev = band->peak;
+	band->peak = 0;
+
+	/* Q1.31 peak is Q12.20 for conversion to dB */
+	target = drc_curve(band, lin2db_fixed(level >> 11));
+	coef = target < band->env ? band->attack : band->release;
+	band->env = target + (int32_t)Q_MULTSR_32X32((int64_t)band->env -
+						     target, coef, 24, 31, 24);
+
+	/* Q12.20 linear gain to Q8.24 */
+	band->gain = band->target;
+	band->target = sat_int32((int64_t)db2lin_fixed(band->env +
+						       band->makeup) << 4);
+	band->step = (band->target - band->gain) / DRC_DIVISION_FRAMES;
+}
+
+/*
+ * \brief Processes interleaved Q1.31 frames of cd->in in place. The frames
+ *	  must not cross a DRC_DIVISION_FRAMES block boundary.
+ */
+static void drc_process_block(struct drc_comp_data *cd, int frames)
+{
+	struct drc_band_state *band;
+	int samples = frames * cd->nch;
+	int b;
+	int i;
+
+	if (cd->num_bands > 1)
+		drc_split(cd, frames);
+
+	for (b = 0; b < cd->num_bands; b++) {
+		band = &cd->band[b];
+		if (band->enabled)
+			band->peak = MAX(band->peak,
+					 drc_peak(band->buf, samples));
+
+		if (cd->delay_frames)
+			drc_delay(cd, band->buf, band->delay, frames);
+
+		if (band->enabled)
+			drc_gain(band, frames, cd->nch);
+	}
+
+	/* Sum the bands back to cd->in */
+	if (cd->num_bands > 1) {
+		for (i = 0; i < samples; i++)
+			cd->in[i] = sat_int32((int64_t)cd->band[0].buf[i] +
+					      cd->band[1].buf[i]);
+
+		if (cd->num_bands > 2)
+			for (i = 0; i < samples; i++)
+				cd->in[i] = sat_int32((int64_t)cd->in[i] +
+						      cd->band[2].buf[i]);
+	}
+
+	if (cd->delay_frames)
+		cd->delay_idx = (cd->delay_idx + frames) % cd->delay_frames;
+
+	cd->pos += frames;
+	if (cd->pos < DRC_DIVISION_FRAMES)
+		return;
+
+	cd->pos = 0;
+	for (b = 0; b < cd->num_bands; b++)
+		if (cd->band[b].enabled)
+			drc_update_gain(&cd->band[b]);
+}
+
+/* frames which can be processed without wrap and block boundary crossing */
+static uint32_t drc_block_frames(struct drc_comp_data *cd,
+				 struct audio_stream_iter *in,
+				 struct audio_stream_iter *out)
+{
+	uint32_t frames = MIN(audio_stream_iter_frames(in),
+			      audio_stream_iter_frames(out));
+
+	return MIN(frames, DRC_DIVISION_FRAMES - cd->pos);
+}
+
+/*
+ * Each contiguous block is converted to Q1.31 to cd->in, processed in
+ * place and converted back to the sink format.
+ */
+#if CONFIG_FORMAT_S16LE
+static void drc_s16_default(struct drc_comp_data *cd,
+			    const struct audio_stream *source,
+			    struct audio_stream *sink, uint32_t frames)
+{
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
+	int16_t *x;
+	int16_t *y;
+	int samples;
+	int n;
+	int i;
+
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+
+	while (in.frames) {
+		n = drc_block_frames(cd, &in, &out);
+		samples = n * cd->nch;
+		x = in.ptr;
+		y = out.ptr;
+
+		for (i = 0; i < samples; i++)
+			cd->in[i] = (int32_t)x[i] << 16;
+
+		drc_process_block(cd, n);
+
+		for (i = 0; i < samples; i++)
+			y[i] = sat_int16(Q_SHIFT_RND(cd->in[i], 31, 15));
+
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void drc_s24_default(struct drc_comp_data *cd,
+			    const struct audio_stream *source,
+			    struct audio_stream *sink, uint32_t frames)
+{
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
+	int32_t *x;
+	int32_t *y;
+	int samples;
+	int n;
+	int i;
+
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+
+	while (in.frames) {
+		n = drc_block_frames(cd, &in, &out);
+		samples = n * cd->nch;
+		x = in.ptr;
+		y = out.ptr;
+
+		for (i = 0; i < samples; i++)
+			cd->in[i] = x[i] << 8;
+
+		drc_process_block(cd, n);
+
+		for (i = 0; i < samples; i++)
+			y[i] = sat_int24(Q_SHIFT_RND(cd->in[i], 31, 23));
+
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void drc_s32_default(struct drc_comp_data *cd,
+			    const struct audio_stream *source,
+			    struct audio_stream *sink, uint32_t frames)
+{
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
+	uint32_t bytes;
+	int n;
+
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+
+	while (in.frames) {
+		n = drc_block_frames(cd, &in, &out);
+		bytes = n * in.frame_bytes;
+
+		memcpy_s(cd->in, bytes, in.ptr, bytes);
+		drc_process_block(cd, n);
+		memcpy_s(out.ptr, bytes, cd->in, bytes);
+
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+const struct drc_func_map drc_fnmap[] = {
+/* { SOURCE_FORMAT , PROCESSING FUNCTION } */
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, drc_s16_default },
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, drc_s24_default },
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, drc_s32_default },
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+const size_t drc_fncount = ARRAY_SIZE(drc_fnmap);
@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+//
+// Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+
+#include <sof/audio/drc/drc.h>
+
+#if DRC_HIFI3
+
+#include <sof/common.h>
+#include <sof/math/numbers.h>
+#include <xtensa/tie/xt_hifi3.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * \brief Returns the largest absolute value of samples.
+ *
+ * The samples are loaded as pairs and the absolute values are compared
+ * two at a time.
+ */
+int32_t drc_peak(const int32_t *x, int samples)
+{
+	ae_int32x2 *in = (ae_int32x2 *)x;
+	ae_int32x2 peak = AE_ZERO32();
+	ae_int32x2 sample;
+	ae_valign align;
+	int i;
+
+	align = AE_LA64_PP(in);
+	for (i = 0; i < samples >> 1; i++) {
+		AE_LA32X2_IP(sample, align, in);
+		peak = AE_MAX32(peak, AE_ABS32S(sample));
+	}
+
+	if (samples & 1) {
+		sample = AE_L32_I((ae_int32 *)in, 0);
+		peak = AE_MAX32(peak, AE_ABS32S(sample));
+	}
+
+	return MAX(AE_MOVAD32_H(peak), AE_MOVAD32_L(peak));
+}
+
+/*
+ * \brief Applies the band gain ramp to interleaved frames.
+ *
+ * The gain of a frame is applied to channel pairs with dual multiply and
+ * the last channel of odd channels count is handled separately.
+ */
+void drc_gain(struct drc_band_state *band, int frames, int nch)
+{
+	ae_int32x2 *in;
+	ae_int32x2 *out;
+	ae_int32 *last;
+	ae_f64 hi;
+	ae_f64 lo;
+	ae_f32x2 gain;
+	ae_f32x2 sample;
+	ae_valign inu;
+	ae_valign outu = AE_ZALIGN64();
+	int32_t *x = band->buf;
+	int32_t g = band->gain;
+	int pairs = nch >> 1;
+	int ch;
+	int i;
+
+	for (i = 0; i < frames; i++) {
+		g += band->step;
+		gain = AE_MOVDA32(g);
+
+		in = (ae_int32x2 *)x;
+		out = (ae_int32x2 *)x;
+		inu = AE_LA64_PP(in);
+		for (ch = 0; ch < pairs; ch++) {
+			AE_LA32X2_IP(sample, inu, in);
+
+			/* Q1.31 x Q8.24 fractional product is Q9.56, shift
+			 * to Q17.47 for round and saturate to Q1.31.
+			 */
+			hi = AE_SRAI64(AE_MULF32S_HH(sample, gain), 9);
+			lo = AE_SRAI64(AE_MULF32S_LL(sample, gain), 9);
+			sample = AE_ROUND32X2F48SSYM(hi, lo);
+			AE_SA32X2_IP(sample, outu, out);
+		}
+
+		AE_SA64POS_FP(outu, out);
+
+		if (nch & 1) {
+			last = (ae_int32 *)(x + nch - 1);
+			sample = AE_L32_I(last, 0);
+			lo = AE_SRAI64(AE_MULF32S_LL(sample, gain), 9);
+			AE_S32_L_I(AE_ROUND32F48SSYM(lo), last, 0);
+		}
+
+		x += nch;
+	}
+
+	band->gain = g;
+}
+
+#endif /* DRC_HIFI3 */
@@ -18,6 +18,7 @@
 #include <sof/lib/uuid.h>
 #include <sof/list.h>
 #include <sof/math/fir_config.h>
+#include <sof/math/fir_fft.h>
 #include <sof/platform.h>
 #include <sof/string.h>
 #include <sof/ut.h>
@@ -44,6 +45,10 @@ DECLARE_TR_CTX(eq_fir_tr, SOF_UUID(eq_fir_uuid), LOG_LEVEL_INFO);
 /* src component private data */
 struct comp_data {
 	struct fir_state_32x16 fir[PLATFORM_MAX_CHANNELS]; /**< filters state */
+	struct fir_nch_state_32x16 fir_nch[PLATFORM_MAX_CHANNELS]; /**< groups */
+	struct fir_fft_state fft[PLATFORM_MAX_CHANNELS]; /**< FFT filters state */
+	struct fir_fft_coef fft_coef[SOF_EQ_FIR_MAX_RESPONSES]; /**< spectra */
+	struct rfft_plan *fft_plan;		/**< set when FFT is used */
 	struct comp_data_blob_handler *model_handler;
 	struct sof_eq_fir_config *config;
 	enum sof_ipc_frame source_format;	/**< source frame format */
@@ -54,6 +59,14 @@ struct comp_data {
 			    const struct audio_stream *source,
 			    struct audio_stream *sink,
 			    int frames, int nch);
+	void (*eq_fir_fft_func)(struct fir_fft_state fft[],
+				const struct audio_stream *source,
+				struct audio_stream *sink,
+				int frames, int nch);
+	void (*eq_fir_nch_func)(struct fir_nch_state_32x16 fir[],
+				const struct audio_stream *source,
+				struct audio_stream *sink,
+				int frames, int nch);
 };
 
 /*
@@ -103,11 +116,91 @@ static inline void set_s32_fir(struct comp_data *cd)
 #endif /* CONFIG_FORMAT_S32LE */
 #endif
 
+static inline int set_fir_fft_func(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_buffer *sourceb;
+
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
+				  sink_list);
+
+	switch (sourceb->stream.frame_fmt) {
+#if CONFIG_FORMAT_S16LE
+	case SOF_IPC_FRAME_S16_LE:
+		comp_info(dev, "set_fir_fft_func(), SOF_IPC_FRAME_S16_LE");
+		cd->eq_fir_fft_func = eq_fir_fft_s16;
+		break;
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	case SOF_IPC_FRAME_S24_4LE:
+		comp_info(dev, "set_fir_fft_func(), SOF_IPC_FRAME_S24_4LE");
+		cd->eq_fir_fft_func = eq_fir_fft_s24;
+		break;
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	case SOF_IPC_FRAME_S32_LE:
+		comp_info(dev, "set_fir_fft_func(), SOF_IPC_FRAME_S32_LE");
+		cd->eq_fir_fft_func = eq_fir_fft_s32;
+		break;
+#endif /* CONFIG_FORMAT_S32LE */
+	default:
+		comp_err(dev, "set_fir_fft_func(), invalid frame_fmt");
+		return -EINVAL;
+	}
+	return 0;
+}
+
+static inline int set_fir_nch_func(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct comp_buffer *sourceb;
+
+	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
+				  sink_list);
+
+	switch (sourceb->stream.frame_fmt) {
+#if CONFIG_FORMAT_S16LE
+	case SOF_IPC_FRAME_S16_LE:
+		comp_info(dev, "set_fir_nch_func(), SOF_IPC_FRAME_S16_LE");
+		cd->eq_fir_nch_func = eq_fir_nch_s16;
+		break;
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	case SOF_IPC_FRAME_S24_4LE:
+		comp_info(dev, "set_fir_nch_func(), SOF_IPC_FRAME_S24_4LE");
+		cd->eq_fir_nch_func = eq_fir_nch_s24;
+		break;
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	case SOF_IPC_FRAME_S32_LE:
+		comp_info(dev, "set_fir_nch_func(), SOF_IPC_FRAME_S32_LE");
+		cd->eq_fir_nch_func = eq_fir_nch_s32;
+		break;
+#endif /* CONFIG_FORMAT_S32LE */
+	default:
+		comp_err(dev, "set_fir_nch_func(), invalid frame_fmt");
+		return -EINVAL;
+	}
+	return 0;
+}
+
 static inline int set_fir_func(struct comp_dev *dev)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
 	struct comp_buffer *sourceb;
 
+	cd->eq_fir_func = NULL;
+	cd->eq_fir_fft_func = NULL;
+	cd->eq_fir_nch_func = NULL;
+
+	/* Long responses are convolved in frequency domain */
+	if (cd->fft_plan)
+		return set_fir_fft_func(dev);
+
+	/* Channels sharing a response are filtered as groups */
+	if (cd->fir_nch[0].nch)
+		return set_fir_nch_func(dev);
+
 	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
 				  sink_list);
 
@@ -160,24 +253,31 @@ static void eq_fir_free_delaylines(struct comp_data *cd)
 	rfree(cd->fir_delay);
 	cd->fir_delay = NULL;
 	cd->fir_delay_size = 0;
-	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++) {
 		fir[i].delay = NULL;
+		fir_nch_reset(&cd->fir_nch[i]);
+	}
+
+	/* Free FFT convolution state, spectra and plan */
+	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
+		fir_fft_free(&cd->fft[i]);
+
+	for (i = 0; i < SOF_EQ_FIR_MAX_RESPONSES; i++)
+		fir_fft_free_coef(&cd->fft_coef[i]);
+
+	rfft_plan_free(cd->fft_plan);
+	cd->fft_plan = NULL;
 }
 
-static int eq_fir_init_coef(struct sof_eq_fir_config *config,
-			    struct fir_state_32x16 *fir, int nch)
+static int eq_fir_get_lookup(struct sof_eq_fir_config *config,
+			     struct sof_fir_coef_data *lookup[], int nch)
 {
-	struct sof_fir_coef_data *lookup[SOF_EQ_FIR_MAX_RESPONSES];
 	struct sof_fir_coef_data *eq;
-	int16_t *assign_response;
 	int16_t *coef_data;
-	size_t size_sum = 0;
-	int resp = 0;
 	int i;
 	int j;
-	int s;
 
-	comp_cl_info(&comp_eq_fir, "eq_fir_init_coef(), response assign for %u channels, %u responses",
+	comp_cl_info(&comp_eq_fir, "eq_fir_get_lookup(), response assign for %u channels, %u responses",
 		     config->channels_in_config,
 		     config->number_of_responses);
 
@@ -185,17 +285,16 @@ static int eq_fir_init_coef(struct sof_eq_fir_config *config,
 	if (nch > PLATFORM_MAX_CHANNELS ||
 	    config->channels_in_config > PLATFORM_MAX_CHANNELS ||
 	    !config->channels_in_config) {
-		comp_cl_err(&comp_eq_fir, "eq_fir_init_coef(), invalid channels count");
+		comp_cl_err(&comp_eq_fir, "eq_fir_get_lookup(), invalid channels count");
 		return -EINVAL;
 	}
 	if (config->number_of_responses > SOF_EQ_FIR_MAX_RESPONSES) {
-		comp_cl_err(&comp_eq_fir, "eq_fir_init_coef(), # of resp exceeds max");
+		comp_cl_err(&comp_eq_fir, "eq_fir_get_lookup(), # of resp exceeds max");
 		return -EINVAL;
 	}
 
 	/* Collect index of respose start positions in all_coefficients[]  */
 	j = 0;
-	assign_response = ASSUME_ALIGNED(&config->data[0], 4);
 	coef_data = ASSUME_ALIGNED(&config->data[config->channels_in_config],
 				   4);
 	for (i = 0; i < SOF_EQ_FIR_MAX_RESPONSES; i++) {
@@ -208,6 +307,232 @@ static int eq_fir_init_coef(struct sof_eq_fir_config *config,
 		}
 	}
 
+	return 0;
+}
+
+/* If any response assigned to channels is at least of the blob threshold
+ * length all channels are convolved with FFT. A mix of FFT and time domain
+ * channels would have different delays.
+ */
+static bool eq_fir_use_fft(struct sof_eq_fir_config *config,
+			   struct sof_fir_coef_data *lookup[], int nch)
+{
+	int16_t *assign_response = ASSUME_ALIGNED(&config->data[0], 4);
+	int resp = 0;
+	int i;
+
+	if (!config->fft_threshold)
+		return false;
+
+	for (i = 0; i < nch; i++) {
+		if (i < config->channels_in_config)
+			resp = assign_response[i];
+
+		if (resp >= 0 && resp < config->number_of_responses &&
+		    lookup[resp]->length >= config->fft_threshold)
+			return true;
+	}
+
+	return false;
+}
+
+static int eq_fir_init_fft(struct comp_data *cd,
+			   struct sof_fir_coef_data *lookup[], int nch)
+{
+	struct sof_eq_fir_config *config = cd->config;
+	int16_t *assign_response = ASSUME_ALIGNED(&config->data[0], 4);
+	int resp = 0;
+	int ret;
+	int i;
+
+	cd->fft_plan = fir_fft_plan_new();
+	if (!cd->fft_plan) {
+		comp_cl_err(&comp_eq_fir, "eq_fir_init_fft(), plan allocation failed");
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < nch; i++) {
+		/* The previous channel response is assigned for any
+		 * additional channels in the stream.
+		 */
+		if (i < config->channels_in_config)
+			resp = assign_response[i];
+
+		/* FFT state without coefficients is bypass */
+		if (resp < 0) {
+			comp_cl_info(&comp_eq_fir, "eq_fir_init_fft(), ch %d is set to bypass",
+				     i);
+			continue;
+		}
+
+		if (resp >= config->number_of_responses) {
+			comp_cl_err(&comp_eq_fir, "eq_fir_init_fft(), requested response %d exceeds what has been defined",
+				    resp);
+			return -EINVAL;
+		}
+
+		/* Spectra of a response are shared by its channels */
+		if (!cd->fft_coef[resp].spectra) {
+			ret = fir_fft_init_coef(&cd->fft_coef[resp],
+						cd->fft_plan, lookup[resp]);
+			if (ret < 0) {
+				comp_cl_err(&comp_eq_fir, "eq_fir_init_fft(), FIR length %d init failed",
+					    lookup[resp]->length);
+				return ret;
+			}
+		}
+
+		ret = fir_fft_init(&cd->fft[i], cd->fft_plan,
+				   &cd->fft_coef[resp]);
+		if (ret < 0) {
+			comp_cl_err(&comp_eq_fir, "eq_fir_init_fft(), state allocation failed");
+			return ret;
+		}
+
+		comp_cl_info(&comp_eq_fir, "eq_fir_init_fft(), ch %d is set to response = %d, %d partitions",
+			     i, resp, cd->fft_coef[resp].partitions);
+	}
+
+	return 0;
+}
+
+/* Get response of a channel, the previous channel response is assigned for
+ * any additional channels in the stream.
+ */
+static int eq_fir_channel_response(struct sof_eq_fir_config *config, int ch)
+{
+	int16_t *assign_response = ASSUME_ALIGNED(&config->data[0], 4);
+
+	return assign_response[MIN(ch, config->channels_in_config - 1)];
+}
+
+/* Check if any response is shared by more than one channel */
+static bool eq_fir_use_nch(struct sof_eq_fir_config *config, int nch)
+{
+	int i;
+	int j;
+
+	for (i = 0; i < nch; i++)
+		for (j = i + 1; j < nch; j++)
+			if (eq_fir_channel_response(config, i) >= 0 &&
+			    eq_fir_channel_response(config, i) ==
+			    eq_fir_channel_response(config, j))
+				return true;
+
+	return false;
+}
+
+/* Form a group of channels for every used response and one for bypassed
+ * channels. The groups share one delay lines buffer.
+ */
+static int eq_fir_init_nch(struct comp_data *cd,
+			   struct sof_fir_coef_data *lookup[], int nch)
+{
+	struct sof_eq_fir_config *config = cd->config;
+	struct fir_nch_state_32x16 *group;
+	int group_resp[PLATFORM_MAX_CHANNELS];
+	int32_t *fir_delay;
+	size_t size_sum = 0;
+	int ngroups = 0;
+	int resp;
+	int ch;
+	int g;
+	int s;
+
+	for (ch = 0; ch < nch; ch++) {
+		resp = eq_fir_channel_response(config, ch);
+		if (resp >= config->number_of_responses) {
+			comp_cl_err(&comp_eq_fir, "eq_fir_init_nch(), requested response %d exceeds what has been defined",
+				    resp);
+			return -EINVAL;
+		}
+
+		/* Find group of the response or start a new one */
+		for (g = 0; g < ngroups; g++)
+			if (group_resp[g] == resp)
+				break;
+
+		if (g == ngroups) {
+			group_resp[g] = resp;
+			ngroups++;
+		}
+
+		group = &cd->fir_nch[g];
+		if (group->nch == FIR_NCH_MAX_CHANNELS) {
+			comp_cl_err(&comp_eq_fir, "eq_fir_init_nch(), too many channels for response %d",
+				    resp);
+			return -EINVAL;
+		}
+
+		group->channel[group->nch++] = ch;
+		comp_cl_info(&comp_eq_fir, "eq_fir_init_nch(), ch %d is set to response = %d, group %d",
+			     ch, resp, g);
+	}
+
+	/* Initialize group coefficients, bypass group stays with zero
+	 * length.
+	 */
+	for (g = 0; g < ngroups; g++) {
+		resp = group_resp[g];
+		if (resp < 0)
+			continue;
+
+		group = &cd->fir_nch[g];
+		s = fir_nch_delay_size(lookup[resp], group->nch);
+		if (s <= 0) {
+			comp_cl_err(&comp_eq_fir, "eq_fir_init_nch(), FIR length %d is invalid",
+				    lookup[resp]->length);
+			return -EINVAL;
+		}
+
+#if defined FIR_MAX_LENGTH_BUILD_SPECIFIC
+		if (lookup[resp]->length * nch >
+		    FIR_MAX_LENGTH_BUILD_SPECIFIC) {
+			comp_cl_err(&comp_eq_fir, "Filter length %d exceeds limitation for build.",
+				    lookup[resp]->length);
+			return -EINVAL;
+		}
+#endif
+
+		size_sum += s;
+		fir_nch_init_coef(group, lookup[resp], group->nch);
+	}
+
+	/* All channels are bypassed */
+	if (!size_sum)
+		return 0;
+
+	cd->fir_delay = rballoc(0, SOF_MEM_CAPS_RAM, size_sum);
+	if (!cd->fir_delay) {
+		comp_cl_err(&comp_eq_fir, "eq_fir_init_nch(), delay allocation failed for size %d",
+			    size_sum);
+		return -ENOMEM;
+	}
+
+	memset(cd->fir_delay, 0, size_sum);
+	cd->fir_delay_size = size_sum;
+
+	fir_delay = cd->fir_delay;
+	for (g = 0; g < ngroups; g++)
+		if (cd->fir_nch[g].length)
+			fir_nch_init_delay(&cd->fir_nch[g], &fir_delay);
+
+	return 0;
+}
+
+static int eq_fir_init_coef(struct sof_eq_fir_config *config,
+			    struct sof_fir_coef_data *lookup[],
+			    struct fir_state_32x16 *fir, int nch)
+{
+	struct sof_fir_coef_data *eq;
+	int16_t *assign_response;
+	size_t size_sum = 0;
+	int resp = 0;
+	int i;
+	int s;
+
+	assign_response = ASSUME_ALIGNED(&config->data[0], 4);
+
 	/* Initialize 1st phase */
 	for (i = 0; i < nch; i++) {
 		/* Check for not reading past blob response to channel assign
@@ -277,13 +602,27 @@ static void eq_fir_init_delay(struct fir_state_32x16 *fir,
 
 static int eq_fir_setup(struct comp_data *cd, int nch)
 {
+	struct sof_fir_coef_data *lookup[SOF_EQ_FIR_MAX_RESPONSES];
 	int delay_size;
+	int ret;
 
 	/* Free existing FIR channels data if it was allocated */
 	eq_fir_free_delaylines(cd);
 
+	ret = eq_fir_get_lookup(cd->config, lookup, nch);
+	if (ret < 0)
+		return ret;
+
+	/* Long responses switch all channels to FFT convolution */
+	if (eq_fir_use_fft(cd->config, lookup, nch))
+		return eq_fir_init_fft(cd, lookup, nch);
+
+	/* Responses shared by channels are filtered as channel groups */
+	if (eq_fir_use_nch(cd->config, nch))
+		return eq_fir_init_nch(cd, lookup, nch);
+
 	/* Set coefficients for each channel EQ from coefficient blob */
-	delay_size = eq_fir_init_coef(cd->config, cd->fir, nch);
+	delay_size = eq_fir_init_coef(cd->config, lookup, cd->fir, nch);
 	if (delay_size < 0)
 		return delay_size; /* Contains error code */
 
@@ -354,6 +693,9 @@ static struct comp_dev *eq_fir_new(const struct comp_driver *drv,
 	comp_set_drvdata(dev, cd);
 
 	cd->eq_fir_func = NULL;
+	cd->eq_fir_fft_func = NULL;
+	cd->eq_fir_nch_func = NULL;
+	cd->fft_plan = NULL;
 	cd->fir_delay = NULL;
 	cd->fir_delay_size = 0;
 
@@ -468,7 +810,8 @@ static int eq_fir_trigger(struct comp_dev *dev, int cmd)
 	comp_info(dev, "eq_fir_trigger()");
 
 	if (cmd == COMP_TRIGGER_START || cmd == COMP_TRIGGER_RELEASE)
-		assert(cd->eq_fir_func);
+		assert(cd->eq_fir_func || cd->eq_fir_fft_func ||
+		       cd->eq_fir_nch_func);
 
 	return comp_set_state(dev, cmd);
 }
@@ -481,8 +824,16 @@ static void eq_fir_process(struct comp_dev *dev, struct comp_buffer *source,
 
 	buffer_invalidate(source, source_bytes);
 
-	cd->eq_fir_func(cd->fir, &source->stream, &sink->stream, frames,
-			source->stream.channels);
+	if (cd->eq_fir_fft_func)
+		cd->eq_fir_fft_func(cd->fft, &source->stream, &sink->stream,
+				    frames, source->stream.channels);
+	else if (cd->eq_fir_nch_func)
+		cd->eq_fir_nch_func(cd->fir_nch, &source->stream,
+				    &sink->stream, frames,
+				    source->stream.channels);
+	else
+		cd->eq_fir_func(cd->fir, &source->stream, &sink->stream,
+				frames, source->stream.channels);
 
 	buffer_writeback(sink, sink_bytes);
 
@@ -514,6 +865,11 @@ static int eq_fir_copy(struct comp_dev *dev)
 			comp_err(dev, "eq_fir_copy(), failed FIR setup");
 			return ret;
 		}
+
+		/* The new blob may switch between FFT and time domain */
+		ret = set_fir_func(dev);
+		if (ret < 0)
+			return ret;
 	}
 
 	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
@@ -595,6 +951,9 @@ static int eq_fir_prepare(struct comp_dev *dev)
 	}
 
 	cd->eq_fir_func = eq_fir_passthrough;
+	cd->eq_fir_fft_func = NULL;
+	cd->eq_fir_nch_func = NULL;
+	comp_set_transparent(dev);
 
 	return ret;
 
@@ -613,6 +972,8 @@ static int eq_fir_reset(struct comp_dev *dev)
 	eq_fir_free_delaylines(cd);
 
 	cd->eq_fir_func = NULL;
+	cd->eq_fir_fft_func = NULL;
+	cd->eq_fir_nch_func = NULL;
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
 		fir_reset(&cd->fir[i]);
 
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+//
+// Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+
+#include <sof/audio/eq_fir/eq_fir.h>
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/format.h>
+#include <sof/math/fir_nch.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* The groups of channels sharing a response are processed frame by frame.
+ * The group channels are gathered from the stream frame to x[], filtered
+ * to y[] and scattered back to sink frame. Groups array ends at first
+ * group with no channels.
+ */
+
+#if CONFIG_FORMAT_S16LE
+void eq_fir_nch_s16(struct fir_nch_state_32x16 fir[],
+		    const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch)
+{
+	struct fir_nch_state_32x16 *group;
+	int32_t x[FIR_NCH_MAX_CHANNELS];
+	int32_t y[FIR_NCH_MAX_CHANNELS];
+	int16_t *src;
+	int16_t *dst;
+	int idx = 0;
+	int ch;
+	int g;
+	int i;
+
+	for (i = 0; i < frames; i++) {
+		for (g = 0; g < nch && fir[g].nch; g++) {
+			group = &fir[g];
+			for (ch = 0; ch < group->nch; ch++) {
+				src = audio_stream_read_frag_s16(source,
+								 idx + group->channel[ch]);
+				x[ch] = *src << 16;
+			}
+
+			fir_32x16_nch(group, x, y);
+
+			for (ch = 0; ch < group->nch; ch++) {
+				dst = audio_stream_write_frag_s16(sink,
+								  idx + group->channel[ch]);
+				*dst = sat_int16(Q_SHIFT_RND(y[ch], 31, 15));
+			}
+		}
+
+		idx += nch;
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+void eq_fir_nch_s24(struct fir_nch_state_32x16 fir[],
+		    const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch)
+{
+	struct fir_nch_state_32x16 *group;
+	int32_t x[FIR_NCH_MAX_CHANNELS];
+	int32_t y[FIR_NCH_MAX_CHANNELS];
+	int32_t *src;
+	int32_t *dst;
+	int idx = 0;
+	int ch;
+	int g;
+	int i;
+
+	for (i = 0; i < frames; i++) {
+		for (g = 0; g < nch && fir[g].nch; g++) {
+			group = &fir[g];
+			for (ch = 0; ch < group->nch; ch++) {
+				src = audio_stream_read_frag_s32(source,
+								 idx + group->channel[ch]);
+				x[ch] = *src << 8;
+			}
+
+			fir_32x16_nch(group, x, y);
+
+			for (ch = 0; ch < group->nch; ch++) {
+				dst = audio_stream_write_frag_s32(sink,
+								  idx + group->channel[ch]);
+				*dst = sat_int24(Q_SHIFT_RND(y[ch], 31, 23));
+			}
+		}
+
+		idx += nch;
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+void eq_fir_nch_s32(struct fir_nch_state_32x16 fir[],
+		    const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch)
+{
+	struct fir_nch_state_32x16 *group;
+	int32_t x[FIR_NCH_MAX_CHANNELS];
+	int32_t y[FIR_NCH_MAX_CHANNELS];
+	int32_t *src;
+	int32_t *dst;
+	int idx = 0;
+	int ch;
+	int g;
+	int i;
+
+	for (i = 0; i < frames; i++) {
+		for (g = 0; g < nch && fir[g].nch; g++) {
+			group = &fir[g];
+			for (ch = 0; ch < group->nch; ch++) {
+				src = audio_stream_read_frag_s32(source,
+								 idx + group->channel[ch]);
+				x[ch] = *src;
+			}
+
+			fir_32x16_nch(group, x, y);
+
+			for (ch = 0; ch < group->nch; ch++) {
+				dst = audio_stream_write_frag_s32(sink,
+								  idx + group->channel[ch]);
+				*dst = y[ch];
+			}
+		}
+
+		idx += nch;
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
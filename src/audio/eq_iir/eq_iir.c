@@ -53,11 +53,28 @@ struct comp_data {
 	eq_iir_func eq_iir_func;		/**< processing function */
 };
 
-#if CONFIG_FORMAT_S16LE
+/* Number of samples converted at once for 16 and 24 bit formats */
+#define EQ_IIR_BLOCK_SAMPLES	64
+
 /*
  * EQ IIR algorithm code
+ *
+ * Source and sink are processed in contiguous blocks, each block is filtered
+ * for all channels at once with iir_df2t_block_nch().
  */
 
+/* frames which can be processed without wrap in source and sink */
+static uint32_t eq_iir_block_frames(struct audio_stream_iter *in,
+				    struct audio_stream_iter *out,
+				    uint32_t max_frames)
+{
+	uint32_t frames = MIN(audio_stream_iter_frames(in),
+			      audio_stream_iter_frames(out));
+
+	return MIN(frames, max_frames);
+}
+
+#if CONFIG_FORMAT_S16LE
 static void eq_iir_s16_default(const struct comp_dev *dev,
 			       const struct audio_stream *source,
 			       struct audio_stream *sink,
@@ -65,25 +82,34 @@ static void eq_iir_s16_default(const struct comp_dev *dev,
 
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
+	int32_t z[EQ_IIR_BLOCK_SAMPLES];
 	int16_t *x;
 	int16_t *y;
-	int32_t z;
-	int ch;
-	int i;
-	int idx;
 	int nch = source->channels;
+	uint32_t max_frames = EQ_IIR_BLOCK_SAMPLES / nch;
+	uint32_t n;
+	int i;
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s16(source, idx);
-			y = audio_stream_write_frag_s16(sink, idx);
-			z = iir_df2t(filter, *x << 16);
-			*y = sat_int16(Q_SHIFT_RND(z, 31, 15));
-			idx += nch;
-		}
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+
+	while (in.frames) {
+		n = eq_iir_block_frames(&in, &out, max_frames);
+		x = in.ptr;
+		y = out.ptr;
+
+		for (i = 0; i < n * nch; i++)
+			z[i] = x[i] << 16;
+
+		iir_df2t_block_nch(cd->iir, z, z, n, nch);
+
+		for (i = 0; i < n * nch; i++)
+			y[i] = sat_int16(Q_SHIFT_RND(z[i], 31, 15));
+
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
@@ -96,25 +122,33 @@ static void eq_iir_s24_default(const struct comp_dev *dev,
 
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
 	int32_t *x;
 	int32_t *y;
-	int32_t z;
-	int idx;
-	int ch;
-	int i;
 	int nch = source->channels;
+	uint32_t n;
+	int i;
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s32(sink, idx);
-			z = iir_df2t(filter, *x << 8);
-			*y = sat_int24(Q_SHIFT_RND(z, 31, 23));
-			idx += nch;
-		}
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+
+	/* Samples are scaled to Q1.31 and back in place in sink */
+	while (in.frames) {
+		n = eq_iir_block_frames(&in, &out, in.frames);
+		x = in.ptr;
+		y = out.ptr;
+
+		for (i = 0; i < n * nch; i++)
+			y[i] = x[i] << 8;
+
+		iir_df2t_block_nch(cd->iir, y, y, n, nch);
+
+		for (i = 0; i < n * nch; i++)
+			y[i] = sat_int24(Q_SHIFT_RND(y[i], 31, 23));
+
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S24LE */
@@ -127,23 +161,19 @@ static void eq_iir_s32_default(const struct comp_dev *dev,
 
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
-	int32_t *x;
-	int32_t *y;
-	int idx;
-	int ch;
-	int i;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
 	int nch = source->channels;
+	uint32_t n;
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s32(sink, idx);
-			*y = iir_df2t(filter, *x);
-			idx += nch;
-		}
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+
+	while (in.frames) {
+		n = eq_iir_block_frames(&in, &out, in.frames);
+		iir_df2t_block_nch(cd->iir, in.ptr, out.ptr, n, nch);
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S32LE */
@@ -156,25 +186,29 @@ static void eq_iir_s32_16_default(const struct comp_dev *dev,
 
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
-	int32_t *x;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
+	int32_t z[EQ_IIR_BLOCK_SAMPLES];
 	int16_t *y;
-	int32_t z;
-	int idx;
-	int ch;
-	int i;
 	int nch = source->channels;
+	uint32_t max_frames = EQ_IIR_BLOCK_SAMPLES / nch;
+	uint32_t n;
+	int i;
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s16(sink, idx);
-			z = iir_df2t(filter, *x);
-			*y = sat_int16(Q_SHIFT_RND(z, 31, 15));
-			idx += nch;
-		}
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+
+	while (in.frames) {
+		n = eq_iir_block_frames(&in, &out, max_frames);
+		y = out.ptr;
+
+		iir_df2t_block_nch(cd->iir, in.ptr, z, n, nch);
+
+		for (i = 0; i < n * nch; i++)
+			y[i] = sat_int16(Q_SHIFT_RND(z[i], 31, 15));
+
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S16LE */
@@ -187,25 +221,27 @@ static void eq_iir_s32_24_default(const struct comp_dev *dev,
 
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct iir_state_df2t *filter;
-	int32_t *x;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
 	int32_t *y;
-	int32_t z;
-	int idx;
-	int ch;
-	int i;
 	int nch = source->channels;
+	uint32_t n;
+	int i;
 
-	for (ch = 0; ch < nch; ch++) {
-		filter = &cd->iir[ch];
-		idx = ch;
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source, idx);
-			y = audio_stream_write_frag_s32(sink, idx);
-			z = iir_df2t(filter, *x);
-			*y = sat_int24(Q_SHIFT_RND(z, 31, 23));
-			idx += nch;
-		}
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+
+	while (in.frames) {
+		n = eq_iir_block_frames(&in, &out, in.frames);
+		y = out.ptr;
+
+		iir_df2t_block_nch(cd->iir, in.ptr, y, n, nch);
+
+		for (i = 0; i < n * nch; i++)
+			y[i] = sat_int24(Q_SHIFT_RND(y[i], 31, 23));
+
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S24LE */
@@ -824,6 +860,7 @@ static int eq_iir_prepare(struct comp_dev *dev)
 			goto err;
 		}
 		comp_info(dev, "eq_iir_prepare(), pass-through mode.");
+		comp_set_transparent(dev);
 	}
 	return 0;
 
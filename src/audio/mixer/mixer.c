@@ -22,6 +22,7 @@
 #include <sof/string.h>
 #include <sof/trace/trace.h>
 #include <sof/ut.h>
+#include <ipc/control.h>
 #include <ipc/stream.h>
 #include <ipc/topology.h>
 #include <user/trace.h>
@@ -36,83 +37,6 @@ DECLARE_SOF_RT_UUID("mixer", mixer_uuid, 0xbc06c037, 0x12aa, 0x417c,
 
 DECLARE_TR_CTX(mixer_tr, SOF_UUID(mixer_uuid), LOG_LEVEL_INFO);
 
-/* mixer component private data */
-struct mixer_data {
-	void (*mix_func)(struct comp_dev *dev, struct audio_stream *sink,
-			 const struct audio_stream **sources, uint32_t count,
-			 uint32_t frames);
-};
-
-#if CONFIG_FORMAT_S16LE
-/* Mix n 16 bit PCM source streams to one sink stream */
-static void mix_n_s16(struct comp_dev *dev, struct audio_stream *sink,
-		      const struct audio_stream **sources, uint32_t num_sources,
-		      uint32_t frames)
-{
-	int16_t *src;
-	int16_t *dest;
-	int32_t val;
-	int i;
-	int j;
-	int channel;
-	uint32_t frag = 0;
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < sink->channels; channel++) {
-			val = 0;
-
-			for (j = 0; j < num_sources; j++) {
-				src = audio_stream_read_frag_s16(sources[j],
-								 frag);
-				val += *src;
-			}
-
-			dest = audio_stream_write_frag_s16(sink, frag);
-
-			/* Saturate to 16 bits */
-			*dest = sat_int16(val);
-
-			frag++;
-		}
-	}
-}
-#endif /* CONFIG_FORMAT_S16LE */
-
-#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
-/* Mix n 32 bit PCM source streams to one sink stream */
-static void mix_n_s32(struct comp_dev *dev, struct audio_stream *sink,
-		      const struct audio_stream **sources, uint32_t num_sources,
-		      uint32_t frames)
-{
-	int32_t *src;
-	int32_t *dest;
-	int64_t val;
-	int i;
-	int j;
-	int channel;
-	uint32_t frag = 0;
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < sink->channels; channel++) {
-			val = 0;
-
-			for (j = 0; j < num_sources; j++) {
-				src = audio_stream_read_frag_s32(sources[j],
-								 frag);
-				val += *src;
-			}
-
-			dest = audio_stream_write_frag_s32(sink, frag);
-
-			/* Saturate to 32 bits */
-			*dest = sat_int32(val);
-
-			frag++;
-		}
-	}
-}
-#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
-
 static struct comp_dev *mixer_new(const struct comp_driver *drv,
 				  struct sof_ipc_comp *comp)
 {
@@ -267,6 +191,133 @@ static int mixer_trigger(struct comp_dev *dev, int cmd)
 	return ret;
 }
 
+/* returns Q1.31 gain set for the pipeline feeding the source buffer */
+static int32_t mixer_get_source_gain(struct mixer_data *md,
+				     struct comp_buffer *source)
+{
+	uint32_t pipeline_id = dev_comp_pipe_id(source->source);
+	int i;
+
+	for (i = 0; i < md->num_gains; i++) {
+		if (md->gains[i].pipeline_id == pipeline_id)
+			return md->gains[i].gain;
+	}
+
+	return MIXER_GAIN_UNITY;
+}
+
+static int mixer_set_source_gain(struct comp_dev *dev, uint32_t pipeline_id,
+				 int32_t gain)
+{
+	struct mixer_data *md = comp_get_drvdata(dev);
+	int i;
+
+	if (gain < 0) {
+		comp_err(dev, "mixer_set_source_gain(): invalid gain %d for pipeline %u",
+			 gain, pipeline_id);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < md->num_gains; i++) {
+		if (md->gains[i].pipeline_id == pipeline_id)
+			break;
+	}
+
+	if (i == PLATFORM_MAX_STREAMS) {
+		comp_err(dev, "mixer_set_source_gain(): no space for pipeline %u",
+			 pipeline_id);
+		return -ENOMEM;
+	}
+
+	md->gains[i].pipeline_id = pipeline_id;
+	md->gains[i].gain = gain;
+	if (i == md->num_gains)
+		md->num_gains++;
+
+	return 0;
+}
+
+/*
+ * Per-source gains use SOF_CTRL_CMD_VOLUME, where the channel of each element
+ * is the id of the source pipeline and the value is Q1.31 gain applied to it.
+ */
+static int mixer_ctrl_set_cmd(struct comp_dev *dev,
+			      struct sof_ipc_ctrl_data *cdata)
+{
+	int ret;
+	int j;
+
+	if (cdata->cmd != SOF_CTRL_CMD_VOLUME) {
+		comp_err(dev, "mixer_ctrl_set_cmd(): invalid cdata->cmd %u",
+			 cdata->cmd);
+		return -EINVAL;
+	}
+
+	if (cdata->num_elems == 0 ||
+	    cdata->num_elems > PLATFORM_MAX_STREAMS) {
+		comp_err(dev, "mixer_ctrl_set_cmd(): invalid cdata->num_elems %u",
+			 cdata->num_elems);
+		return -EINVAL;
+	}
+
+	for (j = 0; j < cdata->num_elems; j++) {
+		comp_info(dev, "mixer_ctrl_set_cmd(), pipeline = %u, gain = %u",
+			  cdata->chanv[j].channel, cdata->chanv[j].value);
+
+		ret = mixer_set_source_gain(dev, cdata->chanv[j].channel,
+					    (int32_t)cdata->chanv[j].value);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+static int mixer_ctrl_get_cmd(struct comp_dev *dev,
+			      struct sof_ipc_ctrl_data *cdata)
+{
+	struct mixer_data *md = comp_get_drvdata(dev);
+	int j;
+
+	if (cdata->cmd != SOF_CTRL_CMD_VOLUME) {
+		comp_err(dev, "mixer_ctrl_get_cmd(): invalid cdata->cmd %u",
+			 cdata->cmd);
+		return -EINVAL;
+	}
+
+	if (cdata->num_elems > PLATFORM_MAX_STREAMS) {
+		comp_err(dev, "mixer_ctrl_get_cmd(): invalid cdata->num_elems %u",
+			 cdata->num_elems);
+		return -EINVAL;
+	}
+
+	cdata->num_elems = MIN(cdata->num_elems, md->num_gains);
+	for (j = 0; j < cdata->num_elems; j++) {
+		cdata->chanv[j].channel = md->gains[j].pipeline_id;
+		cdata->chanv[j].value = md->gains[j].gain;
+	}
+
+	return 0;
+}
+
+/* used to pass standard and bespoke commands (with data) to component */
+static int mixer_cmd(struct comp_dev *dev, int cmd, void *data,
+		     int max_data_size)
+{
+	struct sof_ipc_ctrl_data *cdata = data;
+
+	comp_dbg(dev, "mixer_cmd()");
+
+	switch (cmd) {
+	case COMP_CMD_SET_VALUE:
+		return mixer_ctrl_set_cmd(dev, cdata);
+	case COMP_CMD_GET_VALUE:
+		return mixer_ctrl_get_cmd(dev, cdata);
+	default:
+		return -EINVAL;
+	}
+}
+
 /*
  * Mix N source PCM streams to one sink PCM stream. Frames copied is constant.
  */
@@ -276,6 +327,8 @@ static int mixer_copy(struct comp_dev *dev)
 	struct comp_buffer *sink;
 	struct comp_buffer *sources[PLATFORM_MAX_STREAMS];
 	const struct audio_stream *sources_stream[PLATFORM_MAX_STREAMS];
+	int32_t source_gains[PLATFORM_MAX_STREAMS];
+	const int32_t *gains = NULL;
 	struct comp_buffer *source;
 	struct list_item *blist;
 	int32_t i = 0;
@@ -325,6 +378,16 @@ static int mixer_copy(struct comp_dev *dev)
 
 	buffer_unlock(sink, flags);
 
+	/* resolve per-source gains, skip multiplication when all are unity */
+	if (md->num_gains) {
+		for (i = 0; i < num_mix_sources; i++) {
+			source_gains[i] = mixer_get_source_gain(md,
+								sources[i]);
+			if (source_gains[i] != MIXER_GAIN_UNITY)
+				gains = source_gains;
+		}
+	}
+
 	/* Every source has the same format, so calculate bytes based
 	 * on the first one.
 	 */
@@ -337,8 +400,8 @@ static int mixer_copy(struct comp_dev *dev)
 	/* mix streams */
 	for (i = num_mix_sources - 1; i >= 0; i--)
 		buffer_invalidate(sources[i], source_bytes);
-	md->mix_func(dev, &sink->stream, sources_stream, num_mix_sources,
-		     frames);
+	md->mix_func(dev, &sink->stream, sources_stream, gains,
+		     num_mix_sources, frames);
 	buffer_writeback(sink, sink_bytes);
 
 	/* update source buffer pointers */
@@ -399,23 +462,9 @@ static int mixer_prepare(struct comp_dev *dev)
 	/* does mixer already have active source streams ? */
 	if (dev->state != COMP_STATE_ACTIVE) {
 		/* currently inactive so setup mixer */
-		switch (sink->stream.frame_fmt) {
-#if CONFIG_FORMAT_S16LE
-		case SOF_IPC_FRAME_S16_LE:
-			md->mix_func = mix_n_s16;
-			break;
-#endif /* CONFIG_FORMAT_S16LE */
-#if CONFIG_FORMAT_S24LE
-		case SOF_IPC_FRAME_S24_4LE:
-			md->mix_func = mix_n_s32;
-			break;
-#endif /* CONFIG_FORMAT_S24LE */
-#if CONFIG_FORMAT_S32LE
-		case SOF_IPC_FRAME_S32_LE:
-			md->mix_func = mix_n_s32;
-			break;
-#endif /* CONFIG_FORMAT_S32LE */
-		default:
+		md->mix_func =
+			mixer_get_processing_function(sink->stream.frame_fmt);
+		if (!md->mix_func) {
 			comp_err(dev, "unsupported data format");
 			return -EINVAL;
 		}
@@ -451,6 +500,7 @@ static const struct comp_driver comp_mixer = {
 		.create		= mixer_new,
 		.free		= mixer_free,
 		.params		= mixer_params,
+		.cmd		= mixer_cmd,
 		.prepare	= mixer_prepare,
 		.trigger	= mixer_trigger,
 		.copy		= mixer_copy,
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2016 Intel Corporation. All rights reserved.
+//
+// Author: Liam Girdwood <liam.r.girdwood@linux.intel.com>
+//         Keyon Jie <yang.jie@linux.intel.com>
+
+#include <sof/audio/mixer.h>
+
+#if MIXER_GENERIC
+
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/math/numbers.h>
+#include <ipc/stream.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if CONFIG_FORMAT_S16LE
+/* Mix n 16 bit PCM source streams to one sink stream */
+static void mix_n_s16(struct comp_dev *dev, struct audio_stream *sink,
+		      const struct audio_stream **sources,
+		      const int32_t *gains, uint32_t num_sources,
+		      uint32_t frames)
+{
+	struct audio_stream_iter in[PLATFORM_MAX_STREAMS];
+	struct audio_stream_iter out;
+	const int16_t *src;
+	int16_t *dst;
+	int32_t acc[MIXER_BLOCK_SAMPLES];
+	uint32_t max_frames = MIXER_BLOCK_SAMPLES / sink->channels;
+	uint32_t samples;
+	uint32_t n;
+	int32_t gain;
+	int i;
+	int j;
+
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+	for (j = 0; j < num_sources; j++)
+		audio_stream_iter_init(&in[j], sources[j], sources[j]->r_ptr,
+				       frames);
+
+	while (out.frames) {
+		n = MIN(mixer_block_frames(&out, in, num_sources), max_frames);
+		samples = n * sink->channels;
+
+		for (i = 0; i < samples; i++)
+			acc[i] = 0;
+
+		/* accumulate whole block of each source at once */
+		for (j = 0; j < num_sources; j++) {
+			src = in[j].ptr;
+			if (gains) {
+				gain = gains[j];
+				for (i = 0; i < samples; i++)
+					acc[i] += q_multsr_32x32(src[i], gain,
+								 MIXER_GAIN_QY);
+			} else {
+				for (i = 0; i < samples; i++)
+					acc[i] += src[i];
+			}
+
+			audio_stream_iter_next(&in[j], n);
+		}
+
+		/* Saturate to 16 bits */
+		dst = out.ptr;
+		for (i = 0; i < samples; i++)
+			dst[i] = sat_int16(acc[i]);
+
+		audio_stream_iter_next(&out, n);
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+/* Mix n 32 bit PCM source streams to one sink stream */
+static void mix_n_s32(struct comp_dev *dev, struct audio_stream *sink,
+		      const struct audio_stream **sources,
+		      const int32_t *gains, uint32_t num_sources,
+		      uint32_t frames)
+{
+	struct audio_stream_iter in[PLATFORM_MAX_STREAMS];
+	struct audio_stream_iter out;
+	const int32_t *src;
+	int32_t *dst;
+	int64_t acc[MIXER_BLOCK_SAMPLES];
+	uint32_t max_frames = MIXER_BLOCK_SAMPLES / sink->channels;
+	uint32_t samples;
+	uint32_t n;
+	int32_t gain;
+	int i;
+	int j;
+
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+	for (j = 0; j < num_sources; j++)
+		audio_stream_iter_init(&in[j], sources[j], sources[j]->r_ptr,
+				       frames);
+
+	while (out.frames) {
+		n = MIN(mixer_block_frames(&out, in, num_sources), max_frames);
+		samples = n * sink->channels;
+
+		for (i = 0; i < samples; i++)
+			acc[i] = 0;
+
+		/* accumulate whole block of each source at once */
+		for (j = 0; j < num_sources; j++) {
+			src = in[j].ptr;
+			if (gains) {
+				gain = gains[j];
+				for (i = 0; i < samples; i++)
+					acc[i] += q_multsr_32x32(src[i], gain,
+								 MIXER_GAIN_QY);
+			} else {
+				for (i = 0; i < samples; i++)
+					acc[i] += src[i];
+			}
+
+			audio_stream_iter_next(&in[j], n);
+		}
+
+		/* Saturate to 32 bits */
+		dst = out.ptr;
+		for (i = 0; i < samples; i++)
+			dst[i] = sat_int32(acc[i]);
+
+		audio_stream_iter_next(&out, n);
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
+
+const struct mixer_func_map mixer_func_map[] = {
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, mix_n_s16 },
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, mix_n_s32 },
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, mix_n_s32 },
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+const size_t mixer_func_count = ARRAY_SIZE(mixer_func_map);
+
+#endif /* MIXER_GENERIC */
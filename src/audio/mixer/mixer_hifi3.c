@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2016 Intel Corporation. All rights reserved.
+//
+// Author: Liam Girdwood <liam.r.girdwood@linux.intel.com>
+//         Keyon Jie <yang.jie@linux.intel.com>
+
+#include <sof/audio/mixer.h>
+
+#if MIXER_HIFI3
+
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/math/numbers.h>
+#include <ipc/stream.h>
+#include <xtensa/tie/xt_hifi3.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if CONFIG_FORMAT_S16LE
+/* Mix n 16 bit PCM source streams to one sink stream */
+static void mix_n_s16(struct comp_dev *dev, struct audio_stream *sink,
+		      const struct audio_stream **sources,
+		      const int32_t *gains, uint32_t num_sources,
+		      uint32_t frames)
+{
+	struct audio_stream_iter in[PLATFORM_MAX_STREAMS];
+	struct audio_stream_iter out;
+	ae_int32x2 acc[MIXER_BLOCK_SAMPLES / 2];
+	int32_t tail[3];
+	ae_int16x4 sample;
+	ae_int32x2 high;
+	ae_int32x2 low;
+	ae_f32x2 gain = AE_ZERO32();
+	ae_valign align;
+	const ae_int16x4 *src;
+	ae_int16x4 *dst;
+	const int16_t *src_tail;
+	int16_t *dst_tail;
+	uint32_t max_frames = MIXER_BLOCK_SAMPLES / sink->channels;
+	uint32_t samples;
+	uint32_t quads;
+	uint32_t n;
+	int i;
+	int j;
+
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+	for (j = 0; j < num_sources; j++)
+		audio_stream_iter_init(&in[j], sources[j], sources[j]->r_ptr,
+				       frames);
+
+	while (out.frames) {
+		n = MIN(mixer_block_frames(&out, in, num_sources), max_frames);
+		samples = n * sink->channels;
+		quads = samples >> 2;
+
+		for (i = 0; i < 2 * quads; i++)
+			acc[i] = AE_ZERO32();
+		for (i = 0; i < (samples & 3); i++)
+			tail[i] = 0;
+
+		/* accumulate whole block of each source, four samples per
+		 * load, the sum of the sources can't overflow 32 bits
+		 */
+		for (j = 0; j < num_sources; j++) {
+			src = in[j].ptr;
+			align = AE_LA64_PP(src);
+			if (gains)
+				gain = AE_MOVDA32(gains[j]);
+
+			for (i = 0; i < quads; i++) {
+				AE_LA16X4_IP(sample, align, src);
+				high = AE_SEXT32X2D16_32(sample);
+				low = AE_SEXT32X2D16_10(sample);
+				if (gains) {
+					high = AE_MULFP32X2RS(high, gain);
+					low = AE_MULFP32X2RS(low, gain);
+				}
+
+				acc[2 * i] = AE_ADD32(acc[2 * i], high);
+				acc[2 * i + 1] = AE_ADD32(acc[2 * i + 1], low);
+			}
+
+			src_tail = (const int16_t *)src;
+			for (i = 0; i < (samples & 3); i++)
+				tail[i] += gains ?
+					q_multsr_32x32(src_tail[i], gains[j],
+						       MIXER_GAIN_QY) :
+					src_tail[i];
+
+			audio_stream_iter_next(&in[j], n);
+		}
+
+		/* Saturate to 16 bits */
+		dst = out.ptr;
+		align = AE_ZALIGN64();
+		for (i = 0; i < quads; i++)
+			AE_SA16X4_IP(AE_SAT16X4(acc[2 * i], acc[2 * i + 1]),
+				     align, dst);
+		AE_SA64POS_FP(align, dst);
+
+		dst_tail = (int16_t *)dst;
+		for (i = 0; i < (samples & 3); i++)
+			dst_tail[i] = sat_int16(tail[i]);
+
+		audio_stream_iter_next(&out, n);
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+/* Mix n 32 bit PCM source streams to one sink stream */
+static void mix_n_s32(struct comp_dev *dev, struct audio_stream *sink,
+		      const struct audio_stream **sources,
+		      const int32_t *gains, uint32_t num_sources,
+		      uint32_t frames)
+{
+	struct audio_stream_iter in[PLATFORM_MAX_STREAMS];
+	struct audio_stream_iter out;
+	ae_f64 acc[MIXER_BLOCK_SAMPLES];
+	ae_f32x2 sample;
+	ae_f32x2 gain = AE_ZERO32();
+	ae_valign align;
+	const ae_f32x2 *src;
+	ae_f32x2 *dst;
+	ae_int32 *src_tail;
+	ae_int32 *dst_tail;
+	uint32_t max_frames = MIXER_BLOCK_SAMPLES / sink->channels;
+	uint32_t samples;
+	uint32_t pairs;
+	uint32_t n;
+	int i;
+	int j;
+
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+	for (j = 0; j < num_sources; j++)
+		audio_stream_iter_init(&in[j], sources[j], sources[j]->r_ptr,
+				       frames);
+
+	while (out.frames) {
+		n = MIN(mixer_block_frames(&out, in, num_sources), max_frames);
+		samples = n * sink->channels;
+		pairs = samples >> 1;
+
+		for (i = 0; i < samples; i++)
+			acc[i] = AE_ZERO64();
+
+		/* accumulate whole block of each source, two Q1.31 samples
+		 * per load, in Q17.47
+		 */
+		for (j = 0; j < num_sources; j++) {
+			src = in[j].ptr;
+			align = AE_LA64_PP(src);
+			if (gains)
+				gain = AE_MOVDA32(gains[j]);
+
+			for (i = 0; i < pairs; i++) {
+				AE_LA32X2_IP(sample, align, src);
+				if (gains)
+					sample = AE_MULFP32X2RS(sample, gain);
+
+				acc[2 * i] = AE_ADD64S(acc[2 * i],
+						       AE_CVT64F32_H(sample));
+				acc[2 * i + 1] = AE_ADD64S(acc[2 * i + 1],
+							   AE_CVT64F32_L(sample));
+			}
+
+			if (samples & 1) {
+				src_tail = (ae_int32 *)src;
+				AE_L32_IP(sample, src_tail, sizeof(ae_int32));
+				if (gains)
+					sample = AE_MULFP32X2RS(sample, gain);
+
+				acc[samples - 1] = AE_ADD64S(acc[samples - 1],
+							     AE_CVT64F32_H(sample));
+			}
+
+			audio_stream_iter_next(&in[j], n);
+		}
+
+		/* Round and saturate to Q1.31 */
+		dst = out.ptr;
+		align = AE_ZALIGN64();
+		for (i = 0; i < pairs; i++)
+			AE_SA32X2_IP(AE_ROUND32X2F48SSYM(acc[2 * i],
+							 acc[2 * i + 1]),
+				     align, dst);
+		AE_SA64POS_FP(align, dst);
+
+		if (samples & 1) {
+			dst_tail = (ae_int32 *)dst;
+			sample = AE_ROUND32F48SSYM(acc[samples - 1]);
+			AE_S32_L_IP(sample, dst_tail, sizeof(ae_int32));
+		}
+
+		audio_stream_iter_next(&out, n);
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
+
+const struct mixer_func_map mixer_func_map[] = {
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, mix_n_s16 },
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, mix_n_s32 },
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, mix_n_s32 },
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+const size_t mixer_func_count = ARRAY_SIZE(mixer_func_map);
+
+#endif /* MIXER_HIFI3 */
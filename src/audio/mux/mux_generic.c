@@ -18,238 +18,48 @@
 #include <stddef.h>
 #include <stdint.h>
 
-static void mux_check_for_wrap(struct audio_stream *sink,
-			       const struct audio_stream **sources,
-			       struct mux_look_up *lookup)
+/* initializes iterators over sink and all connected mux sources */
+static void mux_init_iters(struct audio_stream *sink,
+			   const struct audio_stream **sources,
+			   uint32_t frames, struct audio_stream_iter *out,
+			   struct audio_stream_iter *in)
 {
-	const struct audio_stream *source;
-	uint32_t elem;
-
-	/* check sources and destinations for wrap */
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		source = sources[lookup->copy_elem[elem].stream_id];
-		lookup->copy_elem[elem].dest =
-			audio_stream_wrap(sink, lookup->copy_elem[elem].dest);
-		lookup->copy_elem[elem].src =
-			audio_stream_wrap(source, lookup->copy_elem[elem].src);
-	}
-}
-
-static void demux_check_for_wrap(struct audio_stream *sink,
-				 const struct audio_stream *source,
-				 struct mux_look_up *lookup)
-{
-	uint32_t elem;
-
-	/* check sources and destinations for wrap */
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		lookup->copy_elem[elem].dest =
-			audio_stream_wrap(sink, lookup->copy_elem[elem].dest);
-		lookup->copy_elem[elem].src =
-			audio_stream_wrap(source, lookup->copy_elem[elem].src);
-	}
-}
-
-static uint32_t mux_calc_frames_without_wrap_s32(struct comp_dev *dev,
-						 struct audio_stream *sink,
-						 const struct audio_stream
-						 **sources,
-						 struct mux_look_up *lookup)
-{
-	const struct audio_stream *source;
-	uint32_t frames;
-	uint32_t min_frames;
-	uint32_t elem;
-	void *ptr;
-
-	/* dest pointer for all copy_elems in lookup refers to the same
-	 * sink buffer (mux has one sink buffer), so dest min_frames
-	 * calculation based only on lookup table first element is sufficient.
-	 */
-	ptr = (int32_t *)lookup->copy_elem[0].dest -
-		lookup->copy_elem[0].out_ch;
-	min_frames = audio_stream_frames_without_wrap(sink, ptr);
-
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		source = sources[lookup->copy_elem[elem].stream_id];
-
-		ptr = (int32_t *)lookup->copy_elem[elem].src -
-			lookup->copy_elem[elem].in_ch;
-		frames = audio_stream_frames_without_wrap(source, ptr);
-
-		min_frames = (frames < min_frames) ? frames : min_frames;
-	}
-
-	return min_frames;
-}
-
-static uint32_t mux_calc_frames_without_wrap_s16(struct comp_dev *dev,
-						 struct audio_stream *sink,
-						 const struct audio_stream
-						 **sources,
-						 struct mux_look_up *lookup)
-{
-	const struct audio_stream *source;
-	uint32_t frames;
-	uint32_t min_frames;
-	uint32_t elem;
-	void *ptr;
-
-	/* dest pointer for all copy_elems in lookup refers to the same
-	 * sink buffer (mux has one sink buffer), so dest min_frames
-	 * calculation based only on lookup table first element is sufficient.
-	 */
-	ptr = (int16_t *)lookup->copy_elem[0].dest -
-		lookup->copy_elem[0].out_ch;
-	min_frames = audio_stream_frames_without_wrap(sink, ptr);
-
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		source = sources[lookup->copy_elem[elem].stream_id];
-
-		ptr = (int16_t *)lookup->copy_elem[elem].src -
-			lookup->copy_elem[elem].in_ch;
-		frames = audio_stream_frames_without_wrap(source, ptr);
-
-		min_frames = (frames < min_frames) ? frames : min_frames;
-	}
+	uint32_t i;
 
-	return min_frames;
-}
-
-static uint32_t demux_calc_frames_without_wrap_s32(struct comp_dev *dev,
-						   struct audio_stream *sink,
-						   const struct audio_stream
-						   *source,
-						   struct mux_look_up *lookup)
-{
-	uint32_t frames;
-	uint32_t min_frames;
-	void *ptr;
-
-	/* for demux we process each source buffer separately - dest/src for
-	 * each copy_elem refers to the same sink/source buffer, so min_frames
-	 * calculation based only on lookup table first element is sufficient.
-	 */
-	ptr = (int32_t *)lookup->copy_elem[0].dest -
-		lookup->copy_elem[0].out_ch;
-	min_frames = audio_stream_frames_without_wrap(sink, ptr);
+	audio_stream_iter_init_sink(out, sink, sink->w_ptr, frames);
 
-	ptr = (int32_t *)lookup->copy_elem[0].src -
-		lookup->copy_elem[0].in_ch;
-	frames = audio_stream_frames_without_wrap(source, ptr);
-
-	min_frames = (frames < min_frames) ? frames : min_frames;
-
-	return min_frames;
+	for (i = 0; i < MUX_MAX_STREAMS; i++)
+		if (sources[i])
+			audio_stream_iter_init(&in[i], sources[i],
+					       sources[i]->r_ptr, frames);
 }
 
-static uint32_t demux_calc_frames_without_wrap_s16(struct comp_dev *dev,
-						   struct audio_stream *sink,
-						   const struct audio_stream
-						   *source,
-						   struct mux_look_up *lookup)
+/* frames which can be processed without wrap in any of the streams */
+static uint32_t mux_block_frames(const struct audio_stream **sources,
+				 struct audio_stream_iter *out,
+				 struct audio_stream_iter *in)
 {
-	uint32_t frames;
-	uint32_t min_frames;
-	void *ptr;
-
-	/* for demux we process each source buffer separately - dest/src for
-	 * each copy_elem refers to the same sink/source buffer, so min_frames
-	 * calculation based only on lookup table first element is sufficient.
-	 */
-	ptr = (int16_t *)lookup->copy_elem[0].dest -
-		lookup->copy_elem[0].out_ch;
-	min_frames = audio_stream_frames_without_wrap(sink, ptr);
+	uint32_t frames = audio_stream_iter_frames(out);
+	uint32_t i;
 
-	ptr = (int16_t *)lookup->copy_elem[0].src -
-		lookup->copy_elem[0].in_ch;
-	frames = audio_stream_frames_without_wrap(source, ptr);
+	for (i = 0; i < MUX_MAX_STREAMS; i++)
+		if (sources[i])
+			frames = MIN(frames, audio_stream_iter_frames(&in[i]));
 
-	min_frames = (frames < min_frames) ? frames : min_frames;
-
-	return min_frames;
+	return frames;
 }
 
-static void mux_init_look_up_pointers_s32(struct comp_dev *dev,
-					  struct audio_stream *sink,
-					  const struct audio_stream **sources,
-					  struct mux_look_up *lookup)
+static void mux_next_iters(const struct audio_stream **sources,
+			   struct audio_stream_iter *out,
+			   struct audio_stream_iter *in, uint32_t frames)
 {
-	const struct audio_stream *source;
-	uint32_t elem;
-
-	/* init pointers */
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		source = sources[lookup->copy_elem[elem].stream_id];
+	uint32_t i;
 
-		lookup->copy_elem[elem].src = (int32_t *)source->r_ptr +
-			lookup->copy_elem[elem].in_ch;
-		lookup->copy_elem[elem].src_inc = source->channels;
+	audio_stream_iter_next(out, frames);
 
-		lookup->copy_elem[elem].dest = (int32_t *)sink->w_ptr +
-			lookup->copy_elem[elem].out_ch;
-		lookup->copy_elem[elem].dest_inc = sink->channels;
-	}
-}
-
-static void mux_init_look_up_pointers_s16(struct comp_dev *dev,
-					  struct audio_stream *sink,
-					  const struct audio_stream **sources,
-					  struct mux_look_up *lookup)
-{
-	const struct audio_stream *source;
-	uint32_t elem;
-
-	/* init pointers */
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		source = sources[lookup->copy_elem[elem].stream_id];
-
-		lookup->copy_elem[elem].src = (int16_t *)source->r_ptr +
-			lookup->copy_elem[elem].in_ch;
-		lookup->copy_elem[elem].src_inc = source->channels;
-
-		lookup->copy_elem[elem].dest = (int16_t *)sink->w_ptr +
-			lookup->copy_elem[elem].out_ch;
-		lookup->copy_elem[elem].dest_inc = sink->channels;
-	}
-}
-
-static void demux_init_look_up_pointers_s16(struct comp_dev *dev,
-					    struct audio_stream *sink,
-					    const struct audio_stream *source,
-					    struct mux_look_up *lookup)
-{
-	uint32_t elem;
-
-	/* init pointers */
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		lookup->copy_elem[elem].src = (int16_t *)source->r_ptr +
-			lookup->copy_elem[elem].in_ch;
-		lookup->copy_elem[elem].src_inc = source->channels;
-
-		lookup->copy_elem[elem].dest = (int16_t *)sink->w_ptr +
-			lookup->copy_elem[elem].out_ch;
-		lookup->copy_elem[elem].dest_inc = sink->channels;
-	}
-}
-
-static void demux_init_look_up_pointers_s32(struct comp_dev *dev,
-					    struct audio_stream *sink,
-					    const struct audio_stream *source,
-					    struct mux_look_up *lookup)
-{
-	uint32_t elem;
-
-	/* init pointers */
-	for (elem = 0; elem < lookup->num_elems; elem++) {
-		lookup->copy_elem[elem].src = (int32_t *)source->r_ptr +
-			lookup->copy_elem[elem].in_ch;
-		lookup->copy_elem[elem].src_inc = source->channels;
-
-		lookup->copy_elem[elem].dest = (int32_t *)sink->w_ptr +
-			lookup->copy_elem[elem].out_ch;
-		lookup->copy_elem[elem].dest_inc = sink->channels;
-	}
+	for (i = 0; i < MUX_MAX_STREAMS; i++)
+		if (sources[i])
+			audio_stream_iter_next(&in[i], frames);
 }
 
 #if CONFIG_FORMAT_S16LE
@@ -269,41 +79,40 @@ static void demux_s16le(struct comp_dev *dev, struct audio_stream *sink,
 			const struct audio_stream *source, uint32_t frames,
 			struct mux_look_up *lookup)
 {
-	uint8_t i;
-	int16_t *src;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
+	struct mux_copy_elem *elem;
+	const int16_t *src;
 	int16_t *dst;
-	uint32_t elem;
-	uint32_t frames_without_wrap;
+	uint32_t src_inc = source->channels;
+	uint32_t dst_inc = sink->channels;
+	uint32_t n;
+	uint32_t i;
+	uint32_t j;
 
 	comp_dbg(dev, "demux_s16le()");
 
 	if (!lookup || !lookup->num_elems)
 		return;
 
-	demux_init_look_up_pointers_s16(dev, sink, source, lookup);
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
 
-	while (frames) {
-		frames_without_wrap =
-			demux_calc_frames_without_wrap_s16(dev, sink, source,
-							   lookup);
+	while (out.frames) {
+		n = MIN(audio_stream_iter_frames(&in),
+			audio_stream_iter_frames(&out));
 
-		frames_without_wrap = MIN(frames, frames_without_wrap);
+		for (j = 0; j < lookup->num_elems; j++) {
+			elem = &lookup->copy_elem[j];
+			src = (int16_t *)in.ptr + elem->in_ch;
+			dst = (int16_t *)out.ptr + elem->out_ch;
 
-		for (i = 0; i < frames_without_wrap; i++) {
-			for (elem = 0; elem < lookup->num_elems; elem++) {
-				src = (int16_t *)lookup->copy_elem[elem].src;
-				dst = (int16_t *)lookup->copy_elem[elem].dest;
-				*dst = *src;
-				lookup->copy_elem[elem].src = src +
-					lookup->copy_elem[elem].src_inc;
-				lookup->copy_elem[elem].dest = dst +
-					lookup->copy_elem[elem].dest_inc;
-			}
+			for (i = 0; i < n; i++)
+				dst[i * dst_inc] = src[i * src_inc];
 		}
 
-		demux_check_for_wrap(sink, source, lookup);
-
-		frames -= frames_without_wrap;
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
 	}
 }
 
@@ -323,41 +132,38 @@ static void mux_s16le(struct comp_dev *dev, struct audio_stream *sink,
 		      const struct audio_stream **sources, uint32_t frames,
 		      struct mux_look_up *lookup)
 {
-	uint8_t i;
-	int16_t *src;
+	struct audio_stream_iter in[MUX_MAX_STREAMS];
+	struct audio_stream_iter out;
+	struct mux_copy_elem *elem;
+	const int16_t *src;
 	int16_t *dst;
-	uint32_t elem;
-	uint32_t frames_without_wrap;
+	uint32_t src_inc;
+	uint32_t dst_inc = sink->channels;
+	uint32_t n;
+	uint32_t i;
+	uint32_t j;
 
 	comp_dbg(dev, "mux_s16le()");
 
 	if (!lookup || !lookup->num_elems)
 		return;
 
-	mux_init_look_up_pointers_s16(dev, sink, sources, lookup);
+	mux_init_iters(sink, sources, frames, &out, in);
 
-	while (frames) {
-		frames_without_wrap =
-			mux_calc_frames_without_wrap_s16(dev, sink, sources,
-							 lookup);
+	while (out.frames) {
+		n = mux_block_frames(sources, &out, in);
 
-		frames_without_wrap = MIN(frames, frames_without_wrap);
+		for (j = 0; j < lookup->num_elems; j++) {
+			elem = &lookup->copy_elem[j];
+			src = (int16_t *)in[elem->stream_id].ptr + elem->in_ch;
+			src_inc = sources[elem->stream_id]->channels;
+			dst = (int16_t *)out.ptr + elem->out_ch;
 
-		for (i = 0; i < frames_without_wrap; i++) {
-			for (elem = 0; elem < lookup->num_elems; elem++) {
-				src = (int16_t *)lookup->copy_elem[elem].src;
-				dst = (int16_t *)lookup->copy_elem[elem].dest;
-				*dst = *src;
-				lookup->copy_elem[elem].src = src +
-					lookup->copy_elem[elem].src_inc;
-				lookup->copy_elem[elem].dest = dst +
-					lookup->copy_elem[elem].dest_inc;
-			}
+			for (i = 0; i < n; i++)
+				dst[i * dst_inc] = src[i * src_inc];
 		}
 
-		mux_check_for_wrap(sink, sources, lookup);
-
-		frames -= frames_without_wrap;
+		mux_next_iters(sources, &out, in, n);
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
@@ -379,41 +185,40 @@ static void demux_s32le(struct comp_dev *dev, struct audio_stream *sink,
 			const struct audio_stream *source, uint32_t frames,
 			struct mux_look_up *lookup)
 {
-	uint8_t i;
-	int32_t *src;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
+	struct mux_copy_elem *elem;
+	const int32_t *src;
 	int32_t *dst;
-	uint32_t elem;
-	uint32_t frames_without_wrap;
+	uint32_t src_inc = source->channels;
+	uint32_t dst_inc = sink->channels;
+	uint32_t n;
+	uint32_t i;
+	uint32_t j;
 
-	comp_dbg(dev, "demux_s32le");
+	comp_dbg(dev, "demux_s32le()");
 
 	if (!lookup || !lookup->num_elems)
 		return;
 
-	demux_init_look_up_pointers_s32(dev, sink, source, lookup);
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
 
-	while (frames) {
-		frames_without_wrap =
-			demux_calc_frames_without_wrap_s32(dev, sink, source,
-							   lookup);
+	while (out.frames) {
+		n = MIN(audio_stream_iter_frames(&in),
+			audio_stream_iter_frames(&out));
 
-		frames_without_wrap = MIN(frames, frames_without_wrap);
+		for (j = 0; j < lookup->num_elems; j++) {
+			elem = &lookup->copy_elem[j];
+			src = (int32_t *)in.ptr + elem->in_ch;
+			dst = (int32_t *)out.ptr + elem->out_ch;
 
-		for (i = 0; i < frames_without_wrap; i++) {
-			for (elem = 0; elem < lookup->num_elems; elem++) {
-				src = (int32_t *)lookup->copy_elem[elem].src;
-				dst = (int32_t *)lookup->copy_elem[elem].dest;
-				*dst = *src;
-				lookup->copy_elem[elem].src = src +
-					lookup->copy_elem[elem].src_inc;
-				lookup->copy_elem[elem].dest = dst +
-					lookup->copy_elem[elem].dest_inc;
-			}
+			for (i = 0; i < n; i++)
+				dst[i * dst_inc] = src[i * src_inc];
 		}
 
-		demux_check_for_wrap(sink, source, lookup);
-
-		frames -= frames_without_wrap;
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
 	}
 }
 
@@ -433,41 +238,38 @@ static void mux_s32le(struct comp_dev *dev, struct audio_stream *sink,
 		      const struct audio_stream **sources, uint32_t frames,
 		      struct mux_look_up *lookup)
 {
-	uint8_t i;
-	int32_t *src;
+	struct audio_stream_iter in[MUX_MAX_STREAMS];
+	struct audio_stream_iter out;
+	struct mux_copy_elem *elem;
+	const int32_t *src;
 	int32_t *dst;
-	uint32_t elem;
-	uint32_t frames_without_wrap;
+	uint32_t src_inc;
+	uint32_t dst_inc = sink->channels;
+	uint32_t n;
+	uint32_t i;
+	uint32_t j;
 
 	comp_dbg(dev, "mux_s32le()");
 
 	if (!lookup || !lookup->num_elems)
 		return;
 
-	mux_init_look_up_pointers_s32(dev, sink, sources, lookup);
+	mux_init_iters(sink, sources, frames, &out, in);
 
-	while (frames) {
-		frames_without_wrap =
-			mux_calc_frames_without_wrap_s32(dev, sink, sources,
-							 lookup);
+	while (out.frames) {
+		n = mux_block_frames(sources, &out, in);
 
-		frames_without_wrap = MIN(frames, frames_without_wrap);
+		for (j = 0; j < lookup->num_elems; j++) {
+			elem = &lookup->copy_elem[j];
+			src = (int32_t *)in[elem->stream_id].ptr + elem->in_ch;
+			src_inc = sources[elem->stream_id]->channels;
+			dst = (int32_t *)out.ptr + elem->out_ch;
 
-		for (i = 0; i < frames_without_wrap; i++) {
-			for (elem = 0; elem < lookup->num_elems; elem++) {
-				src = (int32_t *)lookup->copy_elem[elem].src;
-				dst = (int32_t *)lookup->copy_elem[elem].dest;
-				*dst = *src;
-				lookup->copy_elem[elem].src = src +
-					lookup->copy_elem[elem].src_inc;
-				lookup->copy_elem[elem].dest = dst +
-					lookup->copy_elem[elem].dest_inc;
-			}
+			for (i = 0; i < n; i++)
+				dst[i * dst_inc] = src[i * src_inc];
 		}
 
-		mux_check_for_wrap(sink, sources, lookup);
-
-		frames -= frames_without_wrap;
+		mux_next_iters(sources, &out, in, n);
 	}
 }
 
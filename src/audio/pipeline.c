@@ -54,6 +54,10 @@ DECLARE_SOF_UUID("pipe-task", pipe_task_uuid, 0xf11818eb, 0xe92e, 0x4082,
 
 static SHARED_DATA struct pipeline_posn pipeline_posn;
 
+/* pipeline tasks are recycled on every topology load/unload */
+static SHARED_DATA struct mm_pool pipe_task_pool =
+	MM_POOL_DEF(SOF_MEM_POOL_PIPE_TASK, sizeof(struct pipeline_task), 4, 0);
+
 void pipeline_posn_init(struct sof *sof)
 {
 	sof->pipeline_posn = platform_shared_get(&pipeline_posn,
@@ -133,6 +137,12 @@ int pipeline_connect(struct comp_dev *comp, struct comp_buffer *buffer,
 	comp_writeback(comp);
 	irq_local_enable(flags);
 
+	/* graph changed, copy schedules have to be compiled again */
+	if (buffer->source)
+		pipeline_schedule_invalidate(buffer->source->pipeline);
+	if (buffer->sink)
+		pipeline_schedule_invalidate(buffer->sink->pipeline);
+
 	return 0;
 }
 
@@ -321,11 +331,13 @@ int pipeline_free(struct pipeline *p)
 	/* remove from any scheduling */
 	if (p->pipe_task) {
 		schedule_task_free(p->pipe_task);
-		rfree(p->pipe_task);
+		rpool_free(&pipe_task_pool, pipeline_task_get(p->pipe_task));
 	}
 
 	ipc_msg_free(p->msg);
 
+	rfree(p->steps);
+
 	pipeline_posn_offset_put(p->posn_offset);
 
 	/* now free the pipeline */
@@ -564,15 +576,14 @@ static struct task *pipeline_task_init(struct pipeline *p, uint32_t type,
 {
 	struct pipeline_task *task = NULL;
 
-	task = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
-		       sizeof(*task));
+	task = rpool_zalloc(&pipe_task_pool);
 	if (!task)
 		return NULL;
 
 	if (schedule_task_init_ll(&task->task, SOF_UUID(pipe_task_uuid), type,
 				  p->ipc_pipe.priority, func,
 				  p, p->ipc_pipe.core, 0) < 0) {
-		rfree(task);
+		rpool_free(&pipe_task_pool, task);
 		return NULL;
 	}
 
@@ -604,6 +615,123 @@ static int pipeline_comp_task_init(struct pipeline *p)
 	return 0;
 }
 
+/* data used by pipeline_comp_schedule() while compiling copy schedule */
+struct pipeline_schedule_data {
+	struct comp_dev *start;
+	struct pipeline_step *steps;	/* NULL when only counting steps */
+	uint32_t size;
+	uint32_t count;
+};
+
+/* direction in which pipeline_copy() processes components */
+static uint32_t pipeline_copy_dir(struct pipeline *p)
+{
+	return p->source_comp->direction == SOF_IPC_STREAM_PLAYBACK ?
+		PPL_DIR_UPSTREAM : PPL_DIR_DOWNSTREAM;
+}
+
+/* start component of pipeline_copy() */
+static struct comp_dev *pipeline_copy_start(struct pipeline *p)
+{
+	return p->source_comp->direction == SOF_IPC_STREAM_PLAYBACK ?
+		p->sink_comp : p->source_comp;
+}
+
+/* Appends component to the copy schedule in the same order in which
+ * pipeline_comp_copy() would copy it. Downstream components are copied
+ * before the components they feed, upstream ones after.
+ */
+static int pipeline_comp_schedule(struct comp_dev *current,
+				  struct comp_buffer *calling_buf,
+				  struct pipeline_walk_context *ctx, int dir)
+{
+	struct pipeline_schedule_data *sd = ctx->comp_data;
+	uint32_t first;
+	uint32_t index = 0;
+	int err;
+
+	if (!comp_is_single_pipeline(current, sd->start))
+		return 0;
+
+	first = sd->count;
+	if (dir == PPL_DIR_DOWNSTREAM)
+		index = sd->count++;
+
+	err = pipeline_for_each_comp(current, ctx, dir);
+	if (err < 0)
+		return err;
+
+	if (dir == PPL_DIR_UPSTREAM)
+		index = sd->count++;
+
+	if (sd->steps && index < sd->size) {
+		sd->steps[index].comp = current;
+		sd->steps[index].subtree = dir == PPL_DIR_DOWNSTREAM ?
+			sd->count - index - 1 : index - first;
+	}
+
+	return 0;
+}
+
+/* Compiles component graph into the flat array of copy steps, so that
+ * pipeline_copy() doesn't have to walk the graph on every period.
+ */
+static int pipeline_schedule_build(struct pipeline *p)
+{
+	struct pipeline_schedule_data sd;
+	struct pipeline_walk_context walk_ctx = {
+		.comp_func = pipeline_comp_schedule,
+		.comp_data = &sd,
+		.skip_incomplete = true,
+	};
+	struct pipeline_step *steps;
+	uint32_t dir;
+
+	p->steps_valid = false;
+
+	if (!p->source_comp || !p->sink_comp)
+		return 0;
+
+	dir = pipeline_copy_dir(p);
+
+	sd.start = pipeline_copy_start(p);
+	sd.steps = NULL;
+	sd.size = 0;
+	sd.count = 0;
+
+	/* count the steps first */
+	walk_ctx.comp_func(sd.start, NULL, &walk_ctx, dir);
+
+	if (sd.count > p->steps_size) {
+		steps = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+				sizeof(*steps) * sd.count);
+		if (!steps) {
+			pipe_err(p, "pipeline_schedule_build(): Out of Memory, steps %u",
+				 sd.count);
+			return -ENOMEM;
+		}
+
+		rfree(p->steps);
+		p->steps = steps;
+		p->steps_size = sd.count;
+	}
+
+	sd.steps = p->steps;
+	sd.size = p->steps_size;
+	sd.count = 0;
+
+	walk_ctx.comp_func(sd.start, NULL, &walk_ctx, dir);
+
+	p->steps_count = sd.count;
+	p->steps_dir = dir;
+	p->steps_valid = true;
+
+	pipe_dbg(p, "pipeline_schedule_build(), steps %u dir %u",
+		 p->steps_count, dir);
+
+	return 0;
+}
+
 static int pipeline_comp_prepare(struct comp_dev *current,
 				 struct comp_buffer *calling_buf,
 				 struct pipeline_walk_context *ctx, int dir)
@@ -659,6 +787,7 @@ int pipeline_prepare(struct pipeline *p, struct comp_dev *dev)
 		.skip_incomplete = true,
 	};
 	int ret;
+	int err;
 
 	pipe_info(p, "pipe prepare");
 
@@ -671,6 +800,10 @@ int pipeline_prepare(struct pipeline *p, struct comp_dev *dev)
 		return ret;
 	}
 
+	err = pipeline_schedule_build(p);
+	if (err < 0)
+		return err;
+
 	p->status = COMP_STATE_PREPARE;
 
 	return ret;
@@ -809,12 +942,31 @@ static int pipeline_xrun_handle_trigger(struct pipeline *p, int cmd)
 	return ret;
 }
 
-static void pipeline_schedule_triggered(struct pipeline_walk_context *ctx,
-					int cmd)
+static int pipeline_schedule_triggered(struct pipeline_walk_context *ctx,
+				       int cmd)
 {
 	struct list_item *tlist;
 	struct pipeline *p;
 	uint32_t flags;
+	int ret;
+
+	/* compile outdated copy schedules before pipelines start running */
+	if (cmd == COMP_TRIGGER_START || cmd == COMP_TRIGGER_RELEASE) {
+		list_for_item(tlist, &ctx->pipelines) {
+			p = container_of(tlist, struct pipeline, list);
+
+			if (p->steps_valid &&
+			    p->steps_dir == pipeline_copy_dir(p))
+				continue;
+
+			ret = pipeline_schedule_build(p);
+			if (ret < 0) {
+				pipe_err(p, "pipeline_schedule_triggered(): schedule build failed, ret = %d",
+					 ret);
+				return ret;
+			}
+		}
+	}
 
 	irq_local_disable(flags);
 
@@ -841,6 +993,8 @@ static void pipeline_schedule_triggered(struct pipeline_walk_context *ctx,
 	}
 
 	irq_local_enable(flags);
+
+	return 0;
 }
 
 /* trigger pipeline */
@@ -853,6 +1007,7 @@ int pipeline_trigger(struct pipeline *p, struct comp_dev *host, int cmd)
 		.skip_incomplete = true,
 	};
 	int ret;
+	int err;
 
 	pipe_info(p, "pipe trigger cmd %d", cmd);
 
@@ -878,7 +1033,9 @@ int pipeline_trigger(struct pipeline *p, struct comp_dev *host, int cmd)
 			 ret, dev_comp_id(host), cmd);
 	}
 
-	pipeline_schedule_triggered(&walk_ctx, cmd);
+	err = pipeline_schedule_triggered(&walk_ctx, cmd);
+	if (err < 0)
+		return err;
 
 	return ret;
 }
@@ -989,12 +1146,11 @@ static int pipeline_comp_copy(struct comp_dev *current,
 	return err;
 }
 
-/* Copy data across all pipeline components.
- * For capture pipelines it always starts from source component
- * and continues downstream and for playback pipelines it first
- * copies sink component itself and then goes upstream.
+/* Copy data across all pipeline components by walking the graph.
+ * Used only when there is no valid copy schedule.
  */
-static int pipeline_copy(struct pipeline *p)
+static int pipeline_copy_walk(struct pipeline *p, struct comp_dev *start,
+			      uint32_t dir)
 {
 	struct pipeline_data data;
 	struct pipeline_walk_context walk_ctx = {
@@ -1002,22 +1158,94 @@ static int pipeline_copy(struct pipeline *p)
 		.comp_data = &data,
 		.skip_incomplete = true,
 	};
-	struct comp_dev *start;
-	uint32_t dir;
-	int ret;
-
-	if (p->source_comp->direction == SOF_IPC_STREAM_PLAYBACK) {
-		dir = PPL_DIR_UPSTREAM;
-		start = p->sink_comp;
-	} else {
-		dir = PPL_DIR_DOWNSTREAM;
-		start = p->source_comp;
-	}
 
 	data.start = start;
 	data.p = p;
 
-	ret = walk_ctx.comp_func(start, NULL, &walk_ctx, dir);
+	return walk_ctx.comp_func(start, NULL, &walk_ctx, dir);
+}
+
+/* Copy data across components in downstream schedule order. Inactive
+ * components and components stopping the path skip all their dependants.
+ */
+static int pipeline_copy_downstream(struct pipeline *p)
+{
+	struct pipeline_step *step;
+	uint32_t i;
+	int err;
+
+	for (i = 0; i < p->steps_count; i++) {
+		step = &p->steps[i];
+
+		if (!comp_is_active(step->comp)) {
+			i += step->subtree;
+			continue;
+		}
+
+		err = comp_copy(step->comp);
+		if (err < 0)
+			return err;
+
+		if (err == PPL_STATUS_PATH_STOP)
+			i += step->subtree;
+	}
+
+	return 0;
+}
+
+/* Copy data across components in upstream schedule order. Dependants of
+ * each step are placed before it, so activity is resolved backwards first.
+ */
+static int pipeline_copy_upstream(struct pipeline *p)
+{
+	struct pipeline_step *step;
+	uint32_t i = p->steps_count;
+	uint32_t j;
+	int err;
+
+	while (i--) {
+		step = &p->steps[i];
+		step->run = comp_is_active(step->comp);
+
+		if (!step->run) {
+			for (j = i - step->subtree; j < i; j++)
+				p->steps[j].run = false;
+			i -= step->subtree;
+		}
+	}
+
+	for (i = 0; i < p->steps_count; i++) {
+		step = &p->steps[i];
+
+		if (!step->run)
+			continue;
+
+		err = comp_copy(step->comp);
+		if (err < 0)
+			return err;
+	}
+
+	return 0;
+}
+
+/* Copy data across all pipeline components.
+ * For capture pipelines it always starts from source component
+ * and continues downstream and for playback pipelines it first
+ * copies sink component itself and then goes upstream.
+ */
+static int pipeline_copy(struct pipeline *p)
+{
+	struct comp_dev *start = pipeline_copy_start(p);
+	uint32_t dir = pipeline_copy_dir(p);
+	int ret;
+
+	if (!p->steps_valid || p->steps_dir != dir)
+		ret = pipeline_copy_walk(p, start, dir);
+	else if (dir == PPL_DIR_DOWNSTREAM)
+		ret = pipeline_copy_downstream(p);
+	else
+		ret = pipeline_copy_upstream(p);
+
 	if (ret < 0)
 		pipe_err(p, "pipeline_copy(): ret = %d, start->comp.id = %u, dir = %u",
 			 ret, dev_comp_id(start), dir);
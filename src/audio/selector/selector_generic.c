@@ -14,6 +14,7 @@
 #include <sof/audio/component.h>
 #include <sof/audio/selector.h>
 #include <sof/common.h>
+#include <sof/math/numbers.h>
 #include <ipc/stream.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -30,16 +31,28 @@ static void sel_s16le_1ch(struct comp_dev *dev, struct audio_stream *sink,
 			  const struct audio_stream *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
+	const int16_t *src;
 	int16_t *dest;
+	uint32_t nch = source->channels;
+	uint32_t n;
 	uint32_t i;
-	uint32_t j = 0;
-	uint32_t nch = cd->config.in_channels_count;
 
-	for (i = cd->config.sel_channel; i < frames * nch; i += nch) {
-		src = audio_stream_read_frag_s16(source, i);
-		dest = audio_stream_write_frag_s16(sink, j++);
-		*dest = *src;
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+
+	while (in.frames) {
+		n = MIN(audio_stream_iter_frames(&in),
+			audio_stream_iter_frames(&out));
+		src = (int16_t *)in.ptr + cd->config.sel_channel;
+		dest = out.ptr;
+
+		for (i = 0; i < n; i++)
+			dest[i] = src[i * nch];
+
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
 	}
 }
 
@@ -53,22 +66,7 @@ static void sel_s16le_1ch(struct comp_dev *dev, struct audio_stream *sink,
 static void sel_s16le_nch(struct comp_dev *dev, struct audio_stream *sink,
 			  const struct audio_stream *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src;
-	int16_t *dest;
-	uint32_t i;
-	uint32_t j = 0;
-	uint32_t channel;
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < cd->config.in_channels_count;
-		     channel++) {
-			src = audio_stream_read_frag_s16(source, j);
-			dest = audio_stream_write_frag_s16(sink, j);
-			*dest = *src;
-			j++;
-		}
-	}
+	audio_stream_copy(source, 0, sink, 0, frames * source->channels);
 }
 #endif /* CONFIG_FORMAT_S16LE */
 
@@ -84,16 +82,28 @@ static void sel_s32le_1ch(struct comp_dev *dev, struct audio_stream *sink,
 			  const struct audio_stream *source, uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
+	const int32_t *src;
 	int32_t *dest;
+	uint32_t nch = source->channels;
+	uint32_t n;
 	uint32_t i;
-	uint32_t j = 0;
-	uint32_t nch = cd->config.in_channels_count;
 
-	for (i = cd->config.sel_channel; i < frames * nch; i += nch) {
-		src = audio_stream_read_frag_s32(source, i);
-		dest = audio_stream_write_frag_s32(sink, j++);
-		*dest = *src;
+	audio_stream_iter_init(&in, source, source->r_ptr, frames);
+	audio_stream_iter_init_sink(&out, sink, sink->w_ptr, frames);
+
+	while (in.frames) {
+		n = MIN(audio_stream_iter_frames(&in),
+			audio_stream_iter_frames(&out));
+		src = (int32_t *)in.ptr + cd->config.sel_channel;
+		dest = out.ptr;
+
+		for (i = 0; i < n; i++)
+			dest[i] = src[i * nch];
+
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
 	}
 }
 
@@ -107,22 +117,7 @@ static void sel_s32le_1ch(struct comp_dev *dev, struct audio_stream *sink,
 static void sel_s32le_nch(struct comp_dev *dev, struct audio_stream *sink,
 			  const struct audio_stream *source, uint32_t frames)
 {
-	struct comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src;
-	int32_t *dest;
-	uint32_t i;
-	uint32_t j = 0;
-	uint32_t channel;
-
-	for (i = 0; i < frames; i++) {
-		for (channel = 0; channel < cd->config.in_channels_count;
-		     channel++) {
-			src = audio_stream_read_frag_s32(source, j);
-			dest = audio_stream_write_frag_s32(sink, j);
-			*dest = *src;
-			j++;
-		}
-	}
+	audio_stream_copy(source, 0, sink, 0, frames * source->channels);
 }
 #endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
 
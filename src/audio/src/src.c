@@ -31,7 +31,10 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#if SRC_SHORT || CONFIG_COMP_SRC_TINY
+#if CONFIG_COMP_SRC_GEN
+#define MAX_FIR_DELAY_SIZE SRC_COEF_MAX_FIR_DELAY_SIZE
+#define MAX_OUT_DELAY_SIZE SRC_COEF_MAX_OUT_DELAY_SIZE
+#elif SRC_SHORT || CONFIG_COMP_SRC_TINY
 #include <sof/audio/coefficients/src/src_tiny_int16_define.h>
 #include <sof/audio/coefficients/src/src_tiny_int16_table.h>
 #else
@@ -62,6 +65,9 @@ struct comp_data {
 	struct polyphase_src src;
 	struct src_param param;
 	int32_t *delay_lines;
+#if CONFIG_COMP_SRC_GEN
+	struct src_coef_bank *bank;
+#endif
 	uint32_t sink_rate;
 	uint32_t source_rate;
 	uint32_t sink_format;
@@ -94,6 +100,7 @@ static int src_out_delay_length(struct src_stage *s)
 	return 1 + (s->num_of_subfilters - 1) * s->odm;
 }
 
+#if !CONFIG_COMP_SRC_GEN
 /* Returns index of a matching sample rate */
 static int src_find_fs(int fs_list[], int list_length, int fs)
 {
@@ -105,6 +112,7 @@ static int src_find_fs(int fs_list[], int list_length, int fs)
 	}
 	return -EINVAL;
 }
+#endif
 
 /* Calculates buffers to allocate for a SRC mode */
 int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
@@ -112,7 +120,6 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 {
 	struct src_stage *stage1;
 	struct src_stage *stage2;
-	int r1;
 
 	if (nch > PLATFORM_MAX_CHANNELS) {
 		/* TODO: should be device, not class */
@@ -122,6 +129,14 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 	}
 
 	a->nch = nch;
+#if CONFIG_COMP_SRC_GEN
+	/* The stages are set by the caller from the generated bank */
+	if (!a->stage1 || !a->stage2) {
+		comp_cl_err(&comp_src, "src_buffer_lengths(): no coefficients, fs_in: %u, fs_out: %u",
+			    fs_in, fs_out);
+		return -EINVAL;
+	}
+#else
 	a->idx_in = src_find_fs(src_in_fs, NUM_IN_FS, fs_in);
 	a->idx_out = src_find_fs(src_out_fs, NUM_OUT_FS, fs_out);
 
@@ -132,8 +147,12 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 		return -EINVAL;
 	}
 
-	stage1 = src_table1[a->idx_out][a->idx_in];
-	stage2 = src_table2[a->idx_out][a->idx_in];
+	a->stage1 = src_table1[a->idx_out][a->idx_in];
+	a->stage2 = src_table2[a->idx_out][a->idx_in];
+#endif
+
+	stage1 = a->stage1;
+	stage2 = a->stage2;
 
 	/* Check from stage1 parameter for a deleted in/out rate combination.*/
 	if (stage1->filter_length < 1) {
@@ -161,18 +180,12 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 		a->fir_s2 = nch * src_fir_delay_length(stage2);
 		a->out_s2 = nch * src_out_delay_length(stage2);
 
-		/* Stage 1 is repeated max. amount that just exceeds one
-		 * period.
-		 */
-		r1 = source_frames / stage1->blk_in + 1;
-
-		/* Set sbuf length to allow storing two stage 1 output
-		 * periods. This is an empirically found value for no
-		 * xruns to happen with SRC in/out buffers. Due to
-		 * variable number of blocks to process per each stage
-		 * there is no equation known for minimum size.
+		/* The stages are run in turns so the intermediate buffer
+		 * needs to hold one stage 1 output block in addition to
+		 * less than a stage 2 input block that is waiting for
+		 * more data.
 		 */
-		a->sbuf_length = 2 * nch * stage1->blk_out * r1;
+		a->sbuf_length = nch * (stage1->blk_out + stage2->blk_in - 1);
 	}
 
 	a->src_multich = a->fir_s1 + a->fir_s2 + a->out_s1 + a->out_s2;
@@ -270,24 +283,24 @@ int src_polyphase_init(struct polyphase_src *src, struct src_param *p,
 	int n_stages;
 	int ret;
 
-	if (p->idx_in < 0 || p->idx_out < 0)
+	if (!p->stage1 || !p->stage2)
 		return -EINVAL;
 
 	/* Get setup for 2 stage conversion */
-	stage1 = src_table1[p->idx_out][p->idx_in];
-	stage2 = src_table2[p->idx_out][p->idx_in];
+	stage1 = p->stage1;
+	stage2 = p->stage2;
 	ret = init_stages(stage1, stage2, src, p, 2, delay_lines_start);
 	if (ret < 0)
 		return -EINVAL;
 
 	/* Get number of stages used for optimize opportunity. 2nd
 	 * stage length is one if conversion needs only one stage.
-	 * If input and output rate is the same return 0 to
-	 * use a simple copy function instead of 1 stage FIR with one
-	 * tap.
+	 * If input and output rate is the same the first stage is
+	 * also one tap. Return 0 to use a simple copy function instead
+	 * of 1 stage FIR with one tap.
 	 */
 	n_stages = (src->stage2->filter_length == 1) ? 1 : 2;
-	if (p->idx_in == p->idx_out)
+	if (src->stage1->filter_length == 1)
 		n_stages = 0;
 
 	/* If filter length for first stage is zero this is a deleted
@@ -309,25 +322,28 @@ static void src_fallback(struct comp_dev *dev,
 	*n_written = 0;
 }
 
-/* Normal 2 stage SRC */
+/* Two stage SRC. The stages are run in turns and stage 1 output blocks
+ * are streamed to stage 2 through the small intermediate buffer, so the
+ * data between the stages stays in cache. The samples not consumed by
+ * stage 2 at end of period remain in the buffer for the next copy.
+ */
 static void src_2s(struct comp_dev *dev, const struct audio_stream *source,
 		   struct audio_stream *sink, int *n_read, int *n_written)
 {
 	struct src_stage_prm s1;
 	struct src_stage_prm s2;
-	int s1_blk_in;
-	int s1_blk_out;
-	int s2_blk_in;
-	int s2_blk_out;
 	struct comp_data *cd = comp_get_drvdata(dev);
+	struct src_stage *stage1 = cd->src.stage1;
+	struct src_stage *stage2 = cd->src.stage2;
+	size_t sbuf_size = cd->param.sbuf_length * cd->sample_container_bytes;
 	void *sbuf_addr = cd->delay_lines;
-	void *sbuf_end_addr = &cd->delay_lines[cd->param.sbuf_length];
-	size_t sbuf_size = cd->param.sbuf_length * sizeof(int32_t);
+	void *sbuf_end_addr = (uint8_t *)sbuf_addr + sbuf_size;
 	int nch = source->channels;
-	int sbuf_free = cd->param.sbuf_length - cd->sbuf_avail;
-	int avail_b = audio_stream_get_avail_bytes(source);
-	int free_b = audio_stream_get_free_bytes(sink);
-	int sz = cd->sample_container_bytes;
+	int s1_blk_out = stage1->blk_out * nch;
+	int s2_blk_in = stage2->blk_in * nch;
+	int s1_times = cd->param.stage1_times;
+	int s2_times = cd->param.stage2_times;
+	int n;
 
 	*n_read = 0;
 	*n_written = 0;
@@ -337,7 +353,7 @@ static void src_2s(struct comp_dev *dev, const struct audio_stream *source,
 	s1.y_end_addr = sbuf_end_addr;
 	s1.y_size = sbuf_size;
 	s1.state = &cd->src.state1;
-	s1.stage = cd->src.stage1;
+	s1.stage = stage1;
 	s1.x_rptr = source->r_ptr;
 	s1.y_wptr = cd->sbuf_w_ptr;
 	s1.nch = nch;
@@ -349,56 +365,39 @@ static void src_2s(struct comp_dev *dev, const struct audio_stream *source,
 	s2.y_end_addr = sink->end_addr;
 	s2.y_size = sink->size;
 	s2.state = &cd->src.state2;
-	s2.stage = cd->src.stage2;
+	s2.stage = stage2;
 	s2.x_rptr = cd->sbuf_r_ptr;
 	s2.y_wptr = sink->w_ptr;
 	s2.nch = nch;
 	s2.shift = cd->data_shift;
 
-	/* Test if 1st stage can be run with default block length to reach
-	 * the period length or just under it.
-	 */
-	s1.times = cd->param.stage1_times;
-	s1_blk_in = s1.times * cd->src.stage1->blk_in * nch;
-	s1_blk_out = s1.times * cd->src.stage1->blk_out * nch;
+	while (s2_times > 0) {
+		/* Stage 2 for all complete input blocks in buffer */
+		n = MIN(cd->sbuf_avail / s2_blk_in, s2_times);
+		if (n > 0) {
+			s2.times = n;
+			cd->polyphase_func(&s2);
+			cd->sbuf_avail -= n * s2_blk_in;
+			s2_times -= n;
+			*n_written += n * stage2->blk_out;
+			continue;
+		}
 
-	/* The sbuf may limit how many times s1 can be looped. It's harder
-	 * to prepare for in advance so the repeats number is adjusted down
-	 * here if need.
-	 */
-	if (s1_blk_out > sbuf_free) {
-		s1.times = sbuf_free / (cd->src.stage1->blk_out * nch);
-		s1_blk_in = s1.times * cd->src.stage1->blk_in * nch;
-		s1_blk_out = s1.times * cd->src.stage1->blk_out * nch;
-		comp_dbg(dev, "s1.times = %d", s1.times);
-	}
+		/* Stage 1 blocks to fill the buffer from source */
+		n = (cd->param.sbuf_length - cd->sbuf_avail) / s1_blk_out;
+		n = MIN(n, s1_times);
+		if (!n)
+			break;
 
-	if (avail_b >= s1_blk_in * sz && sbuf_free >= s1_blk_out) {
+		s1.times = n;
 		cd->polyphase_func(&s1);
-
-		cd->sbuf_w_ptr = s1.y_wptr;
-		cd->sbuf_avail += s1_blk_out;
-		*n_read += s1.times * cd->src.stage1->blk_in;
-	}
-
-	s2.times = cd->param.stage2_times;
-	s2_blk_in = s2.times * cd->src.stage2->blk_in * nch;
-	s2_blk_out = s2.times * cd->src.stage2->blk_out * nch;
-	if (s2_blk_in > cd->sbuf_avail) {
-		s2.times = cd->sbuf_avail / (cd->src.stage2->blk_in * nch);
-		s2_blk_in = s2.times * cd->src.stage2->blk_in * nch;
-		s2_blk_out = s2.times * cd->src.stage2->blk_out * nch;
-		comp_dbg(dev, "s2.times = %d", s2.times);
+		cd->sbuf_avail += n * s1_blk_out;
+		s1_times -= n;
+		*n_read += n * stage1->blk_in;
 	}
 
-	/* Test if second stage can be run with default block length. */
-	if (cd->sbuf_avail >= s2_blk_in && free_b >= s2_blk_out * sz) {
-		cd->polyphase_func(&s2);
-
-		cd->sbuf_r_ptr = s2.x_rptr;
-		cd->sbuf_avail -= s2_blk_in;
-		*n_written += s2.times * cd->src.stage2->blk_out;
-	}
+	cd->sbuf_w_ptr = s1.y_wptr;
+	cd->sbuf_r_ptr = s2.x_rptr;
 }
 
 /* 1 stage SRC for simple conversions */
@@ -504,6 +503,11 @@ static void src_free(struct comp_dev *dev)
 	if (cd->delay_lines)
 		rfree(cd->delay_lines);
 
+#if CONFIG_COMP_SRC_GEN
+	if (cd->bank)
+		src_coef_bank_put(cd->bank);
+#endif
+
 	rfree(cd);
 	rfree(dev);
 }
@@ -544,6 +548,34 @@ static int src_verify_params(struct comp_dev *dev,
 	return 0;
 }
 
+#if CONFIG_COMP_SRC_GEN
+/* Gets the coefficients for the rates, designed if not in use already */
+static int src_coef_select(struct comp_dev *dev)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	struct src_coef_bank *bank = cd->bank;
+
+	if (!bank || bank->fs_in != cd->source_rate ||
+	    bank->fs_out != cd->sink_rate) {
+		bank = src_coef_bank_get(cd->source_rate, cd->sink_rate);
+		if (!bank) {
+			comp_err(dev, "src_coef_select(): design failed, source_rate = %u, sink_rate = %u",
+				 cd->source_rate, cd->sink_rate);
+			return -EINVAL;
+		}
+
+		if (cd->bank)
+			src_coef_bank_put(cd->bank);
+
+		cd->bank = bank;
+	}
+
+	cd->param.stage1 = &bank->stage1;
+	cd->param.stage2 = &bank->stage2;
+	return 0;
+}
+#endif
+
 /* set component audio stream parameters */
 static int src_params(struct comp_dev *dev,
 		      struct sof_ipc_stream_params *params)
@@ -593,6 +625,11 @@ static int src_params(struct comp_dev *dev,
 	comp_info(dev, "src_params(), sourceb->channels = %u, sinkb->channels = %u, dev->frames = %u",
 		  sourceb->stream.channels,
 		  sinkb->stream.channels, dev->frames);
+#if CONFIG_COMP_SRC_GEN
+	err = src_coef_select(dev);
+	if (err < 0)
+		return err;
+#endif
 	err = src_buffer_lengths(&cd->param, cd->source_rate,
 				 cd->sink_rate,
 				 sourceb->stream.channels, cd->source_frames);
@@ -927,6 +964,9 @@ static SHARED_DATA struct comp_driver_info comp_src_info = {
 
 UT_STATIC void sys_comp_src_init(void)
 {
+#if CONFIG_COMP_SRC_GEN
+	src_coef_init();
+#endif
 	comp_register(platform_shared_get(&comp_src_info,
 					  sizeof(comp_src_info)));
 }
@@ -0,0 +1,571 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+//
+// Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+
+/*
+ * Run-time design of the polyphase filters for SRC. The conversion is
+ * factorized to two stages and the filters are designed with the Kaiser
+ * window method in the same way as tools/tune/src/src_generate.m does, so
+ * only the coefficients of the rates in use take memory. The banks are
+ * kept per core and shared by all SRC instances converting between the
+ * same rates.
+ */
+
+#include <sof/audio/format.h>
+#include <sof/audio/src/src.h>
+#include <sof/audio/src/src_config.h>
+#include <sof/common.h>
+#include <sof/lib/alloc.h>
+#include <sof/lib/cpu.h>
+#include <sof/lib/memory.h>
+#include <sof/list.h>
+#include <sof/math/numbers.h>
+#include <sof/math/trig.h>
+#include <sof/math/vec.h>
+#include <sof/string.h>
+#include <ipc/topology.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if SRC_SHORT
+typedef int16_t src_coef_t;
+#else
+typedef int32_t src_coef_t;
+#endif
+
+/* Frequencies are Hz in Q24.8 */
+#define SRC_COEF_FS_Q		8
+
+/* Passband is 20 kHz at 44.1 kHz rate, 24 kHz above 80 kHz rate */
+#define SRC_COEF_PB_NUM		200
+#define SRC_COEF_PB_DEN		441
+#define SRC_COEF_PB_HIGH_FS	80000
+#define SRC_COEF_PB_HIGH	24000
+
+/* -1 dB total gain, -0.5 dB for each stage of two */
+#define SRC_COEF_GAIN_1S	1913946816 /* Q1.31 */
+#define SRC_COEF_GAIN_2S	2027355295 /* Q1.31 */
+
+/* 70 dB stopband attenuation: Kaiser beta 0.1102 * (70 - 8.7) and filter
+ * order (70 - 7.95) / 14.36 times sample rate per transition bandwidth
+ */
+#define SRC_COEF_BETA		1813351298 /* Q4.28 */
+#define SRC_COEF_ORDER		283183 /* Q16.16 */
+
+/* Subfilter lengths are multiple of four for the optimized filter cores */
+#define SRC_COEF_LENGTH_MULT	4
+
+/* Highest coefficient is 32767/32768 with the largest possible shift */
+#define SRC_COEF_PEAK_MAX	(INT32_MAX - (1 << 16) + 1)
+
+/* Unused banks kept for next streams with the same rates */
+#define SRC_COEF_IDLE_MAX	2
+
+struct src_coef_design {
+	int l;		/* interpolation factor */
+	int m;		/* decimation factor */
+	uint64_t fs;	/* input rate, Q24.8 */
+	uint64_t f_pb;	/* passband edge, Q24.8 */
+	uint64_t f_sb;	/* stopband edge, Q24.8 */
+	int32_t gain;	/* Q1.31 */
+	int length;	/* filter length */
+};
+
+/*
+ * Banks of each core, coefficients are in core local memory. A list and
+ * the refcounts of its banks are only touched by SRC instances running on
+ * that core, since IPC for other cores is forwarded to them, so no lock
+ * is needed.
+ */
+#if CONFIG_LIBRARY
+/* every host thread runs its own firmware instance as core 0 */
+static __thread struct list_item src_coef_banks[PLATFORM_CORE_COUNT];
+#else
+static SHARED_DATA struct list_item src_coef_banks[PLATFORM_CORE_COUNT];
+#endif
+
+#if SRC_SHORT
+static const int16_t src_coef_one = 16384;
+#else
+static const int32_t src_coef_one = 1073741824;
+#endif
+
+static inline struct list_item *src_coef_cache(void)
+{
+	struct list_item *banks = platform_shared_get(src_coef_banks,
+						      sizeof(src_coef_banks));
+
+#if CONFIG_LIBRARY
+	/* src_coef_init() only ran in the thread loading the component */
+	if (!banks[cpu_get_id()].next)
+		list_init(&banks[cpu_get_id()]);
+#endif
+
+	return &banks[cpu_get_id()];
+}
+
+/* Splits c to factors a * b as close to sqrt(c) as possible */
+static void src_coef_factor2(int c, int *a, int *b)
+{
+	int x = 1;
+	int a1 = 0;
+	int a2 = 0;
+	int t;
+
+	while ((x + 1) * (x + 1) <= c)
+		x++;
+
+	/* round to nearest */
+	if (c - x * x > x)
+		x++;
+
+	for (t = x; t <= 2 * x; t++) {
+		if (!(c % t)) {
+			a1 = t;
+			break;
+		}
+	}
+
+	for (t = x; t >= x / 2 && t > 0; t--) {
+		if (!(c % t)) {
+			a2 = t;
+			break;
+		}
+	}
+
+	*a = a1 && (!a2 || a1 - x < x - a2) ? a1 : a2;
+
+	/* large prime factors, fails later in filter length check */
+	if (!*a)
+		*a = c;
+
+	*b = c / *a;
+}
+
+/* Conversions with preferred first stage factors */
+static const int src_coef_fixed_lm[][4] = {
+	/* l, m, l1, m1 */
+	{ 147, 640, 7, 8 },	/* 192 to 44.1 kHz */
+	{ 147, 320, 7, 8 },	/* 96 to 44.1 kHz */
+	{ 147, 160, 7, 8 },	/* 48 to 44.1 kHz */
+	{ 160, 147, 8, 7 },	/* 44.1 to 48 kHz */
+	{ 320, 147, 8, 7 },	/* 44.1 to 96 kHz */
+	{ 4, 3, 4, 3 },		/* 24 to 32 kHz, single stage */
+	{ 3, 4, 3, 4 },		/* 32 to 24 kHz, single stage */
+};
+
+/*
+ * Factorizes the conversion to two stages. The intermediate rate is the
+ * lowest one that is not below the lower of input and output rates.
+ */
+static void src_coef_factor2_lm(int fs1, int fs2, int *l1, int *m1, int *l2,
+				int *m2)
+{
+	int l[4];
+	int m[4];
+	int lf[2];
+	int mf[2];
+	int k = gcd(fs1, fs2);
+	int fs_min = MIN(fs1, fs2);
+	int best = -1;
+	int i;
+
+	l[0] = fs2 / k;
+	m[0] = fs1 / k;
+	src_coef_factor2(l[0], &lf[0], &lf[1]);
+	src_coef_factor2(m[0], &mf[0], &mf[1]);
+
+	for (i = 0; i < ARRAY_SIZE(src_coef_fixed_lm); i++) {
+		if (src_coef_fixed_lm[i][0] == l[0] &&
+		    src_coef_fixed_lm[i][1] == m[0]) {
+			lf[0] = src_coef_fixed_lm[i][2];
+			mf[0] = src_coef_fixed_lm[i][3];
+			lf[1] = l[0] / lf[0];
+			mf[1] = m[0] / mf[0];
+		}
+	}
+
+	/* first stage candidates, the second stage gets the other factors */
+	for (i = 0; i < 4; i++) {
+		l[i] = lf[i >> 1];
+		m[i] = mf[i & 1];
+		if ((int64_t)fs1 * l[i] < (int64_t)fs_min * m[i])
+			continue;
+
+		if (best < 0 || (int64_t)l[i] * m[best] < (int64_t)l[best] * m[i])
+			best = i;
+	}
+
+	*l1 = l[best];
+	*m1 = m[best];
+	*l2 = lf[1 - (best >> 1)];
+	*m2 = mf[1 - (best & 1)];
+
+	if (*l1 == 1 && *m1 == 1) {
+		*l1 = *l2;
+		*m1 = *m2;
+		*l2 = 1;
+		*m2 = 1;
+	}
+}
+
+/* Finds smallest l0, m0 for -l0 * L + m0 * M = 1 */
+static void src_coef_find_l0m0(int l, int m, int *l0, int *m0)
+{
+	int lt;
+
+	*l0 = 0;
+	*m0 = 1;
+	if (m == 1)
+		return;
+
+	*l0 = 1;
+	*m0 = 0;
+	if (l == 1)
+		return;
+
+	for (lt = 1; lt <= 4 * l; lt++) {
+		if (!((1 + lt * l) % m)) {
+			*l0 = lt;
+			*m0 = (1 + lt * l) / m;
+			return;
+		}
+	}
+}
+
+static uint64_t src_coef_passband(uint64_t fs_min)
+{
+	if (fs_min > ((uint64_t)SRC_COEF_PB_HIGH_FS << SRC_COEF_FS_Q))
+		return (uint64_t)SRC_COEF_PB_HIGH << SRC_COEF_FS_Q;
+
+	return fs_min * SRC_COEF_PB_NUM / SRC_COEF_PB_DEN;
+}
+
+static int src_coef_length(struct src_coef_design *d)
+{
+	uint64_t fs_up = d->fs * d->l;
+	int mult = d->l * SRC_COEF_LENGTH_MULT;
+	int order;
+
+	if (d->f_sb <= d->f_pb)
+		return -EINVAL;
+
+	order = (fs_up * SRC_COEF_ORDER / (d->f_sb - d->f_pb) + 65535) >> 16;
+	if (order >= SRC_COEF_MAX_FILTER_LENGTH)
+		return -EINVAL;
+
+	return ceil_divide(order + 1, mult) * mult;
+}
+
+/* Modified Bessel function of first kind I0(x) for x in Q4.28, Q8.24 */
+static uint64_t src_coef_bessel_i0(int32_t x)
+{
+	uint64_t y = (uint64_t)x * x >> 34; /* (x / 2)^2 in Q8.24 */
+	uint64_t term = 1 << 24;
+	uint64_t sum = term;
+	int k;
+
+	for (k = 1; term; k++) {
+		term = (term * y >> 24) / ((uint64_t)k * k);
+		sum += term;
+	}
+
+	return sum;
+}
+
+/*
+ * Kaiser windowed sinc lowpass of cutoff (f_pb + f_sb) / 2 at rate
+ * L * fs, normalized to gain L for the interpolation.
+ */
+static int src_coef_fir(struct src_coef_design *d, int32_t *h)
+{
+	struct vec_sin_state gen;
+	uint64_t fs_up = d->fs * d->l;
+	uint64_t i0_beta = src_coef_bessel_i0(SRC_COEF_BETA);
+	int64_t sum = 0;
+	int64_t peak;
+	int64_t gain;
+	int64_t x;
+	int32_t h_max = 0;
+	int32_t r;
+	int n = d->length;
+	uint32_t kw;
+	int shift;
+	int u;
+	int i;
+
+	/* cutoff relative to half of the rate, Q0.32 */
+	kw = ((d->f_pb + d->f_sb) << 32) / fs_up;
+
+	/* sin(pi * kw * t) for t = (2 * i - n + 1) / 2 */
+	gen.phase = (uint32_t)(((int64_t)kw * (1 - n)) >> 2);
+	gen.step = kw >> 1;
+	vec_sin_fixed(&gen, h, n);
+
+	for (i = 0; i < n; i++) {
+		u = 2 * i - n + 1;
+
+		/* sinc as sin(pi * kw * t) / (pi * t) */
+		h[i] = ((int64_t)h[i] << 29) / ((int64_t)u * PI_Q4_28);
+
+		/* window I0(beta * sqrt(1 - x^2)) / I0(beta) for x in -1..1 */
+		x = ((int64_t)u << 31) / (n - 1);
+		r = (((int64_t)1 << 62) - x * x) >> 31;
+		vec_sqrt_fixed(&r, &r, 1);
+		r = MIN((src_coef_bessel_i0(((int64_t)SRC_COEF_BETA * r) >> 31)
+			<< 31) / i0_beta, INT32_MAX);
+		h[i] = Q_MULTSR_32X32((int64_t)h[i], r, 31, 31, 31);
+
+		sum += h[i];
+		h_max = MAX(h_max, ABS(h[i]));
+	}
+
+	if (sum <= 0)
+		return -EINVAL;
+
+	/* gain to scale the DC response to L * gain, Q8.24 */
+	gain = (((int64_t)d->l * (d->gain >> 7)) << 31) / sum;
+
+	/* normalize the highest coefficient with the shift, the peak of a
+	 * lowpass with cutoff below the Nyquist rate is less than one
+	 */
+	peak = ((int64_t)h_max * gain) >> 24;
+	if (!peak || peak > SRC_COEF_PEAK_MAX)
+		return -EINVAL;
+
+	shift = 0;
+	while (peak << 1 <= SRC_COEF_PEAK_MAX) {
+		peak <<= 1;
+		shift++;
+	}
+
+	if (shift >= 24)
+		return -EINVAL;
+
+	for (i = 0; i < n; i++)
+		h[i] = sat_int32((((int64_t)h[i] * gain) +
+				  ((int64_t)1 << (23 - shift))) >> (24 - shift));
+
+	return shift;
+}
+
+/* Designs a stage and stores the coefficients in polyphase order */
+static int src_coef_stage(struct src_coef_design *d, struct src_stage *stage,
+			  src_coef_t *coef, int32_t *h)
+{
+	int sub_length = d->length / d->l;
+	int shift;
+	int idm;
+	int odm;
+	int i;
+	int j;
+
+	src_coef_find_l0m0(d->l, d->m, &idm, &odm);
+
+	if (sub_length + (d->l - 1) * idm + d->m > SRC_COEF_MAX_FIR_DELAY_SIZE ||
+	    1 + (d->l - 1) * odm > SRC_COEF_MAX_OUT_DELAY_SIZE)
+		return -EINVAL;
+
+	shift = src_coef_fir(d, h);
+	if (shift < 0)
+		return shift;
+
+	/* subfilter j has taps j, j + L, j + 2L, ... */
+	for (j = 0; j < d->l; j++)
+		for (i = 0; i < sub_length; i++)
+#if SRC_SHORT
+			coef[j * sub_length + i] =
+				sat_int16(Q_SHIFT_RND(h[j + i * d->l], 31, 15));
+#else
+			coef[j * sub_length + i] = h[j + i * d->l];
+#endif
+
+	/* stage fields are const, the whole stage is written at once */
+	const struct src_stage s = {
+		.idm = idm,
+		.odm = odm,
+		.num_of_subfilters = d->l,
+		.subfilter_length = sub_length,
+		.filter_length = d->length,
+		.blk_in = d->m,
+		.blk_out = d->l,
+		.halfband = 0,
+		.shift = shift,
+		.coefs = coef,
+	};
+
+	memcpy_s(stage, sizeof(*stage), &s, sizeof(s));
+
+	return 0;
+}
+
+/* Pass-through stage of single stage conversions */
+static void src_coef_stage_one(struct src_stage *stage)
+{
+	const struct src_stage s = {
+		.idm = 0,
+		.odm = 0,
+		.num_of_subfilters = 1,
+		.subfilter_length = 1,
+		.filter_length = 1,
+		.blk_in = 1,
+		.blk_out = 1,
+		.halfband = 0,
+		.shift = -1,
+		.coefs = &src_coef_one,
+	};
+
+	memcpy_s(stage, sizeof(*stage), &s, sizeof(s));
+}
+
+static struct src_coef_bank *src_coef_generate(int fs_in, int fs_out)
+{
+	struct src_coef_design d1;
+	struct src_coef_design d2;
+	struct src_coef_bank *bank;
+	src_coef_t *coef;
+	int32_t *h;
+	uint64_t fs3;
+	int l2;
+	int m2;
+	int ret;
+
+	memset(&d1, 0, sizeof(d1));
+	memset(&d2, 0, sizeof(d2));
+
+	if (fs_in != fs_out) {
+		src_coef_factor2_lm(fs_in, fs_out, &d1.l, &d1.m, &l2, &m2);
+		d1.fs = (uint64_t)fs_in << SRC_COEF_FS_Q;
+		fs3 = d1.fs * d1.l / d1.m;
+		d1.f_pb = src_coef_passband(MIN(d1.fs, fs3));
+		d1.f_sb = MIN(d1.fs, fs3) >> 1;
+		d1.gain = SRC_COEF_GAIN_1S;
+
+		if (l2 != m2) {
+			d2.l = l2;
+			d2.m = m2;
+			d2.fs = fs3;
+			d2.f_pb = src_coef_passband(MIN(fs3, (uint64_t)fs_out <<
+							SRC_COEF_FS_Q));
+			d2.f_sb = MIN(fs3, (uint64_t)fs_out << SRC_COEF_FS_Q) >> 1;
+			d1.gain = SRC_COEF_GAIN_2S;
+			d2.gain = SRC_COEF_GAIN_2S;
+
+			/* passband of the lower rate end is used for both
+			 * stages for wider transition band of the other one
+			 */
+			if (fs_out < fs_in)
+				d1.f_pb = d2.f_pb;
+			else
+				d2.f_pb = d1.f_pb;
+
+			d2.length = src_coef_length(&d2);
+			if (d2.length < 0)
+				return NULL;
+		}
+
+		d1.length = src_coef_length(&d1);
+		if (d1.length < 0)
+			return NULL;
+	}
+
+	bank = rballoc(0, SOF_MEM_CAPS_RAM, sizeof(*bank) +
+		       (d1.length + d2.length) * sizeof(src_coef_t));
+	if (!bank)
+		return NULL;
+
+	h = rballoc(0, SOF_MEM_CAPS_RAM,
+		    MAX(MAX(d1.length, d2.length), 1) * sizeof(int32_t));
+	if (!h) {
+		rfree(bank);
+		return NULL;
+	}
+
+	bank->fs_in = fs_in;
+	bank->fs_out = fs_out;
+	coef = (src_coef_t *)(bank + 1);
+
+	ret = 0;
+	if (d1.length)
+		ret = src_coef_stage(&d1, &bank->stage1, coef, h);
+	else
+		src_coef_stage_one(&bank->stage1);
+
+	if (d2.length && !ret)
+		ret = src_coef_stage(&d2, &bank->stage2, coef + d1.length, h);
+	else
+		src_coef_stage_one(&bank->stage2);
+
+	rfree(h);
+
+	if (ret < 0) {
+		rfree(bank);
+		return NULL;
+	}
+
+	return bank;
+}
+
+void src_coef_init(void)
+{
+	struct list_item *banks = platform_shared_get(src_coef_banks,
+						      sizeof(src_coef_banks));
+	int i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		list_init(&banks[i]);
+
+	platform_shared_commit(banks, sizeof(src_coef_banks));
+}
+
+struct src_coef_bank *src_coef_bank_get(int fs_in, int fs_out)
+{
+	struct list_item *cache = src_coef_cache();
+	struct list_item *item;
+	struct src_coef_bank *bank;
+
+	list_for_item(item, cache) {
+		bank = container_of(item, struct src_coef_bank, list);
+		if (bank->fs_in == fs_in && bank->fs_out == fs_out)
+			goto found;
+	}
+
+	bank = src_coef_generate(fs_in, fs_out);
+	if (!bank)
+		return NULL;
+
+	bank->refs = 1;
+	list_item_prepend(&bank->list, cache);
+	return bank;
+
+found:
+	/* most recently used first */
+	list_item_del(&bank->list);
+	list_item_prepend(&bank->list, cache);
+	bank->refs++;
+
+	return bank;
+}
+
+void src_coef_bank_put(struct src_coef_bank *bank)
+{
+	struct list_item *cache = src_coef_cache();
+	struct list_item *item;
+	struct list_item *tmp;
+	int idle = 0;
+
+	bank->refs--;
+
+	/* free the least recently used idle banks */
+	list_for_item_safe(item, tmp, cache) {
+		bank = container_of(item, struct src_coef_bank, list);
+		if (bank->refs || ++idle <= SRC_COEF_IDLE_MAX)
+			continue;
+
+		list_item_del(&bank->list);
+		rfree(bank);
+	}
+}
@@ -51,7 +51,7 @@ void panic_dump(uint32_t p, struct sof_ipc_panic_info *panic_info,
 
 	/* flush last trace messages */
 #if CONFIG_TRACE
-	trace_flush();
+	trace_flush(true);
 #endif
 
 	/* dump stack frames */
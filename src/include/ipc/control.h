@@ -177,6 +177,26 @@ struct sof_ipc_comp_event {
 	};
 } __attribute__((packed));
 
+/**
+ * Component processing load - SOF_IPC_COMP_GET_PERF, ABI3.18.
+ * Host sets comp_id, DSP replies with the copy() statistics. Cycles are
+ * counted in DSP core clock ticks.
+ */
+struct sof_ipc_comp_perf {
+	struct sof_ipc_reply rhdr;
+	uint32_t comp_id;
+
+	uint32_t copies;	/**< number of timed copies */
+	uint32_t cycles_last;	/**< cycles spent in the last copy */
+	uint32_t cycles_avg;	/**< average cycles per copy */
+	uint32_t cycles_peak;	/**< highest cycles spent in one copy */
+	uint32_t frames_last;	/**< frames processed by the last copy */
+	uint64_t frames_total;	/**< frames processed by all copies */
+
+	/* reserved for future use */
+	uint32_t reserved[4];
+} __attribute__((packed));
+
 /** @}*/
 
 /** @}*/
@@ -0,0 +1,60 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file include/ipc/debug.h
+ * \brief IPC definitions for the debug and telemetry services
+ */
+
+#ifndef __IPC_DEBUG_H__
+#define __IPC_DEBUG_H__
+
+#include <ipc/header.h>
+#include <stdint.h>
+
+/** usage of a single heap, part of sof_ipc_dbg_mem_usage, ABI3.19 */
+struct sof_ipc_dbg_mem_usage_elem {
+	uint32_t zone;		/**< heap zone, SOF_MEM_ZONE_ */
+	uint32_t id;		/**< heap index within the zone */
+	uint32_t caps;		/**< heap capabilities, SOF_MEM_CAPS_ */
+	uint32_t size;		/**< heap size in bytes */
+	uint32_t used;		/**< bytes currently allocated */
+	uint32_t used_peak;	/**< high-water mark of allocated bytes */
+	uint32_t largest_free;	/**< largest free contiguous run in bytes */
+	uint32_t alloc_fails;	/**< requests the heap could not serve */
+} __attribute__((packed));
+
+/**
+ * Heap usage telemetry - SOF_IPC_DEBUG_MEM_USAGE, ABI3.19.
+ * DSP replies with one element per block heap.
+ */
+struct sof_ipc_dbg_mem_usage {
+	struct sof_ipc_reply rhdr;
+	uint32_t num_elems;		/**< number of entries in elems[] */
+	uint32_t reserved[2];		/**< reserved for future use */
+	struct sof_ipc_dbg_mem_usage_elem elems[];
+} __attribute__((packed));
+
+/** heap usage of a single owner, part of sof_ipc_dbg_mem_owners, ABI3.19 */
+struct sof_ipc_dbg_mem_owner_elem {
+	uint32_t uuid_key;	/**< owner UUID address from ldc, 0 for none */
+	uint32_t used;		/**< bytes currently allocated */
+	uint32_t used_peak;	/**< high-water mark of allocated bytes */
+	uint32_t alloc_fails;	/**< failed allocation requests */
+} __attribute__((packed));
+
+/**
+ * Heap usage per owner - SOF_IPC_DEBUG_MEM_OWNERS, ABI3.19.
+ * DSP replies with one element per component driver that allocated from
+ * the block heaps, the first element accounts for unattributed memory.
+ */
+struct sof_ipc_dbg_mem_owners {
+	struct sof_ipc_reply rhdr;
+	uint32_t num_elems;		/**< number of entries in elems[] */
+	uint32_t reserved[2];		/**< reserved for future use */
+	struct sof_ipc_dbg_mem_owner_elem elems[];
+} __attribute__((packed));
+
+#endif /* __IPC_DEBUG_H__ */
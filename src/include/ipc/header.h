@@ -186,6 +186,7 @@
 #define SOF_IPC_GLB_GDB_DEBUG                   SOF_GLB_TYPE(0xAU)
 #define SOF_IPC_GLB_TEST			SOF_GLB_TYPE(0xBU)
 #define SOF_IPC_GLB_PROBE			SOF_GLB_TYPE(0xCU)
+#define SOF_IPC_GLB_DEBUG			SOF_GLB_TYPE(0xDU) /**< ABI3.19 */
 
 /** @} */
 
@@ -230,6 +231,7 @@
 #define SOF_IPC_COMP_SET_DATA			SOF_CMD_TYPE(0x003)
 #define SOF_IPC_COMP_GET_DATA			SOF_CMD_TYPE(0x004)
 #define SOF_IPC_COMP_NOTIFICATION		SOF_CMD_TYPE(0x005)
+#define SOF_IPC_COMP_GET_PERF			SOF_CMD_TYPE(0x006) /**< ABI3.18 */
 
 /** @} */
 
@@ -293,6 +295,15 @@
 
 /** @} */
 
+/** \name DSP Command: Debug - additional services
+ *  @{
+ */
+
+#define SOF_IPC_DEBUG_MEM_USAGE			SOF_CMD_TYPE(0x001) /**< ABI3.19 */
+#define SOF_IPC_DEBUG_MEM_OWNERS		SOF_CMD_TYPE(0x002) /**< ABI3.19 */
+
+/** @} */
+
 /** \name IPC Message Definitions
  * @{
  */
@@ -342,12 +353,57 @@ struct sof_ipc_reply {
  * commands are split into blocks and each block has a header. This header
  * identifies the command type and the number of commands before the next
  * header.
+ *
+ * The message starts with a struct sof_ipc_cmd_hdr with cmd
+ * SOF_IPC_GLB_COMPOUND and the size of the whole message, which can be up
+ * to the size of the host mailbox. In each block header hdr.cmd is the
+ * command of the block and hdr.size is the size of the block header. The
+ * block header is followed by count complete messages of that command,
+ * each with its own header and size. The commands are executed in order
+ * and the sequence ends at the end of the message or at a block with
+ * count 0. (ABI3.22)
  */
 struct sof_ipc_compound_hdr {
 	struct sof_ipc_cmd_hdr hdr;
 	uint32_t count;		/**< count of 0 means end of compound sequence */
 } __attribute__((packed));
 
+/**
+ * Reply to compound commands, ABI3.22.
+ *
+ * The execution stops at the first failing command and rhdr.error is its
+ * error. The components, buffers and pipelines created by the earlier
+ * commands of the same message are then freed. Other effects of the
+ * earlier commands are not reverted. Commands that have their own reply
+ * type only report the error of it here, so such commands should rather
+ * be sent separately.
+ */
+struct sof_ipc_compound_reply {
+	struct sof_ipc_reply rhdr;
+	uint32_t count;		/**< number of executed commands */
+	int32_t status[];	/**< error of each executed command */
+} __attribute__((packed));
+
+/** Max number of commands that fit a compound message of msg_size bytes */
+#define SOF_IPC_COMPOUND_MSG_CMDS(msg_size) \
+	(((msg_size) - sizeof(struct sof_ipc_cmd_hdr) - \
+	  sizeof(struct sof_ipc_compound_hdr)) / sizeof(struct sof_ipc_cmd_hdr))
+
+/** Max number of command statuses that fit a reply of reply_size bytes */
+#define SOF_IPC_COMPOUND_REPLY_CMDS(reply_size) \
+	(((reply_size) - sizeof(struct sof_ipc_compound_reply)) / \
+	 sizeof(int32_t))
+
+/**
+ * Max number of commands in one compound message for the given host
+ * mailbox and reply outbox sizes, ABI3.22
+ */
+#define SOF_IPC_COMPOUND_MAX_CMDS(mailbox_size, reply_size) \
+	(SOF_IPC_COMPOUND_MSG_CMDS(mailbox_size) < \
+	 SOF_IPC_COMPOUND_REPLY_CMDS(reply_size) ? \
+	 SOF_IPC_COMPOUND_MSG_CMDS(mailbox_size) : \
+	 SOF_IPC_COMPOUND_REPLY_CMDS(reply_size))
+
 /**
  * OOPS header architecture specific data.
  */
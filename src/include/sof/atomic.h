@@ -36,4 +36,9 @@ static inline int32_t atomic_sub(atomic_t *a, int32_t value)
 	return arch_atomic_sub(a, value);
 }
 
+static inline void memory_barrier(void)
+{
+	arch_memory_barrier();
+}
+
 #endif /* __SOF_ATOMIC_H__ */
@@ -47,11 +47,27 @@
 #include <stdint.h>
 
 /*
- * @brief FIR filter is max 128 taps and delay lines per channel are
- * max 256 samples long.
+ * @brief Number of output frames whose impulse responses are computed
+ * together in one pass over the polyphase filter coefficients. Unit
+ * tests may define it to test the block path in any configuration.
+ */
+#ifndef ASRC_BLOCK_LENGTH
+#if CONFIG_ASRC_BLOCK_LENGTH
+#define ASRC_BLOCK_LENGTH	CONFIG_ASRC_BLOCK_LENGTH
+#else
+#define ASRC_BLOCK_LENGTH	1
+#endif
+#endif
+
+/*
+ * @brief FIR filter is max 128 taps from max 7 polyphase filters and
+ * delay lines per channel are max 256 samples long, plus two samples
+ * for each additional frame in a block of impulse responses.
  */
 #define ASRC_MAX_FILTER_LENGTH	128
-#define ASRC_MAX_BUFFER_LENGTH	256
+#define ASRC_MAX_NUM_FILTERS	7
+#define ASRC_MAX_BUFFER_LENGTH	\
+	(2 * (ASRC_MAX_FILTER_LENGTH + ASRC_BLOCK_LENGTH - 1))
 
 /*
  * @brief Define whether the input and output buffers shall be
@@ -165,8 +181,9 @@ struct asrc_farrow {
 	/* + filter coefficients */
 	const int32_t *polyphase_filters; /*!< Pointer to the filter */
 					  /*!< coefficients */
-	int32_t *impulse_response; /*!< Pointer to the impulse response */
-				   /*!< for generating one output sample */
+	int32_t *impulse_response; /*!< Pointer to the impulse responses */
+				   /*!< for generating a block of output */
+				   /*!< samples */
 
 	/* PROGRAM + general */
 	bool is_initialised;	/*!< Flag is set to true after */
@@ -207,6 +224,18 @@ struct asrc_farrow {
 					/*!< secondary side during one */
 					/*!< control loop */
 
+	/* + block of queued output frames */
+	uint32_t block_time[ASRC_BLOCK_LENGTH];	/*!< time_value of each */
+						/*!< queued frame (5q27) */
+	int block_position[ASRC_BLOCK_LENGTH];	/*!< Ring buffer write */
+						/*!< position of each */
+						/*!< queued frame */
+	int block_frame[ASRC_BLOCK_LENGTH];	/*!< Output buffer index of */
+						/*!< each queued frame */
+	int block_count;	/*!< Number of queued frames */
+	int block_span;		/*!< Input frames written since the */
+				/*!< first queued frame */
+
 	/* + function pointer */
 	void (*calc_ir)(struct asrc_farrow *src_obj);	/*!< Pointer */
 	/*!< to the function which calculates the impulse response */
@@ -627,18 +656,24 @@ void asrc_write_to_ring_buffer32(struct asrc_farrow *src_obj,
 				 int index_input_frame);
 
 /*
- * Filter the 32 bit ring buffer values with impulse_response
+ * Filter the 16 bit ring buffer values ending at buffer_position with
+ * impulse_response
  */
 void asrc_fir_filter16(struct asrc_farrow *src_obj,
 		       int16_t **output_buffers,
-		       int index_output_frame);
+		       int index_output_frame,
+		       const int32_t *impulse_response,
+		       int buffer_position);
 
 /*
- * Filter the 32 bit ring buffer values with impulse_response
+ * Filter the 32 bit ring buffer values ending at buffer_position with
+ * impulse_response
  */
 void asrc_fir_filter32(struct asrc_farrow *src_obj,
 		       int32_t **output_buffers,
-		       int index_output_frame);
+		       int index_output_frame,
+		       const int32_t *impulse_response,
+		       int buffer_position);
 
 /*
  * Calculates the impulse response. This impulse response is then
@@ -652,4 +687,13 @@ void asrc_calc_impulse_response_n5(struct asrc_farrow *src_obj);
 void asrc_calc_impulse_response_n6(struct asrc_farrow *src_obj);
 void asrc_calc_impulse_response_n7(struct asrc_farrow *src_obj);
 
+/*
+ * Calculates the impulse responses for the num_frames first queued
+ * times in block_time. The impulse response of frame n is stored to
+ * impulse_response[n * filter_length]. Each pair of coefficients of
+ * the polyphase filters is loaded once for the whole block.
+ */
+void asrc_calc_impulse_response_block(struct asrc_farrow *src_obj,
+				      int num_frames);
+
 #endif /* IAS_SRC_FARROW_H */
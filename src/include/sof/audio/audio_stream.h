@@ -543,6 +543,149 @@ audio_stream_frames_without_wrap(const struct audio_stream *source,
 	return bytes / frame_bytes;
 }
 
+/** \brief Size of the largest frame, staged by stream iterator at wrap. */
+#define AUDIO_STREAM_ITER_BOUNCE	(SOF_IPC_MAX_CHANNELS * sizeof(int32_t))
+
+/**
+ * Iterator over the frames of a circular stream. It splits the requested
+ * frames into blocks that are contiguous in memory, so processing loops
+ * can index plain arrays instead of checking for wrap on every sample.
+ * A frame split by the end of the buffer is passed through a bounce
+ * buffer as a block of its own.
+ */
+struct audio_stream_iter {
+	const struct audio_stream *stream;	/**< iterated stream */
+	void *ptr;				/**< start of current block */
+	void *split;				/**< bounced frame position */
+	uint32_t frames;			/**< frames left to iterate */
+	uint32_t frame_bytes;			/**< size of one frame */
+	bool write;				/**< iterating sink stream */
+	/** split frame, aligned for the sample and vector loads */
+	uint8_t bounce[AUDIO_STREAM_ITER_BOUNCE] __aligned(8);
+};
+
+/* common part of reading and writing iterator initialization */
+static inline void audio_stream_iter_setup(struct audio_stream_iter *iter,
+					   const struct audio_stream *stream,
+					   void *ptr, uint32_t frames,
+					   bool write)
+{
+	iter->stream = stream;
+	iter->ptr = ptr;
+	iter->split = NULL;
+	iter->frames = frames;
+	iter->frame_bytes = audio_stream_frame_bytes(stream);
+	iter->write = write;
+
+	assert(iter->frame_bytes <= AUDIO_STREAM_ITER_BOUNCE);
+}
+
+/**
+ * Initializes iterator reading the stream.
+ * @param iter Iterator to be initialized.
+ * @param stream Stream to be iterated.
+ * @param ptr Starting position, usually r_ptr of the stream.
+ * @param frames Total number of frames to iterate over.
+ */
+static inline void audio_stream_iter_init(struct audio_stream_iter *iter,
+					  const struct audio_stream *stream,
+					  void *ptr, uint32_t frames)
+{
+	audio_stream_iter_setup(iter, stream, ptr, frames, false);
+}
+
+/**
+ * Initializes iterator writing the stream.
+ * @param iter Iterator to be initialized.
+ * @param stream Stream to be iterated.
+ * @param ptr Starting position, usually w_ptr of the stream.
+ * @param frames Total number of frames to iterate over.
+ */
+static inline void
+audio_stream_iter_init_sink(struct audio_stream_iter *iter,
+			    const struct audio_stream *stream,
+			    void *ptr, uint32_t frames)
+{
+	audio_stream_iter_setup(iter, stream, ptr, frames, true);
+}
+
+/**
+ * Calculates size of the current contiguous block. When the next frame is
+ * split by the end of the buffer, it is staged in the bounce buffer and
+ * returned as a block of one frame.
+ * @param iter Stream iterator.
+ * @return Number of frames which can be accessed at iter->ptr without wrap.
+ */
+static inline uint32_t audio_stream_iter_frames(struct audio_stream_iter *iter)
+{
+	uint32_t bytes;
+	int ret;
+
+	if (!iter->frames)
+		return 0;
+
+	/* split frame already staged */
+	if (iter->split)
+		return 1;
+
+	bytes = audio_stream_bytes_without_wrap(iter->stream, iter->ptr);
+	if (bytes >= iter->frame_bytes)
+		return MIN(iter->frames, bytes / iter->frame_bytes);
+
+	iter->split = iter->ptr;
+	iter->ptr = iter->bounce;
+
+	if (!iter->write) {
+		ret = memcpy_s(iter->bounce, sizeof(iter->bounce),
+			       iter->split, bytes);
+		assert(!ret);
+		ret = memcpy_s(iter->bounce + bytes,
+			       sizeof(iter->bounce) - bytes,
+			       iter->stream->addr, iter->frame_bytes - bytes);
+		assert(!ret);
+	}
+
+	return 1;
+}
+
+/**
+ * Moves iterator past processed frames, wrapping the position if needed.
+ * @param iter Stream iterator.
+ * @param frames Number of processed frames, not larger than the value
+ *	  returned by audio_stream_iter_frames().
+ */
+static inline void audio_stream_iter_next(struct audio_stream_iter *iter,
+					  uint32_t frames)
+{
+	uint32_t bytes;
+	int ret;
+
+	if (iter->split) {
+		if (!frames)
+			return;
+
+		/* write staged frame back around the end of the buffer */
+		if (iter->write) {
+			bytes = audio_stream_bytes_without_wrap(iter->stream,
+								iter->split);
+			ret = memcpy_s(iter->split, bytes, iter->bounce, bytes);
+			assert(!ret);
+			ret = memcpy_s(iter->stream->addr,
+				       iter->frame_bytes - bytes,
+				       iter->bounce + bytes,
+				       iter->frame_bytes - bytes);
+			assert(!ret);
+		}
+
+		iter->ptr = iter->split;
+		iter->split = NULL;
+	}
+
+	iter->ptr = audio_stream_wrap(iter->stream, (char *)iter->ptr +
+				      frames * iter->frame_bytes);
+	iter->frames -= frames;
+}
+
 /**
  * Copies data from source buffer to sink buffer.
  * @param source Source buffer.
@@ -11,10 +11,12 @@
 #include <sof/audio/audio_stream.h>
 #include <sof/audio/pipeline.h>
 #include <sof/math/numbers.h>
+#include <sof/atomic.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
+#include <sof/lib/notifier.h>
 #include <sof/lib/uuid.h>
 #include <sof/list.h>
 #include <sof/math/numbers.h>
@@ -30,6 +32,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
+struct comp_buffer;
 struct comp_dev;
 
 /** \name Trace macros
@@ -83,12 +86,36 @@ extern struct tr_ctx buffer_tr;
 #define BUFF_PARAMS_RATE	BIT(2)
 #define BUFF_PARAMS_CHANNELS	BIT(3)
 
+struct buffer_cb_transact {
+	struct comp_buffer *buffer;
+	uint32_t transaction_amount;
+	void *transaction_begin_address;
+};
+
+/* buffer events delivered to subscribers, see buffer_notifier_register() */
+#define BUFFER_NOTIFY_TICK_MASK	(BIT(NOTIFIER_ID_BUFFER_PRODUCE_TICK) | \
+				 BIT(NOTIFIER_ID_BUFFER_CONSUME_TICK))
+
+/*
+ * Position of one side of a lock-free buffer, free running in
+ * [0, 2 * size) so a full buffer can be told apart from an empty one.
+ * Each position owns a cache line and is written by a single core.
+ */
+struct buffer_spsc_pos {
+	atomic_t pos;
+} __aligned(PLATFORM_DCACHE_ALIGN);
+
 /* audio component buffer - connects 2 audio components together in pipeline */
 struct comp_buffer {
 	spinlock_t *lock;		/* locking mechanism */
 
-	/* data buffer */
-	struct audio_stream stream;
+	/* data buffer, in cache lines of its own, see buffer_spsc_commit() */
+	struct audio_stream stream __aligned(PLATFORM_DCACHE_ALIGN);
+
+	/* lock-free single producer/single consumer mode, see buffer_spsc_*() */
+	struct buffer_spsc_pos produced;	/**< written by source only */
+	struct buffer_spsc_pos consumed;	/**< written by sink only */
+	bool spsc;	/**< positions above are published instead of locking */
 
 	/* configuration */
 	uint32_t id;
@@ -112,12 +139,15 @@ struct comp_buffer {
 
 	bool hw_params_configured; /**< indicates whether hw params were set */
 	bool walking;	/**< indicates if the buffer is being walking */
-};
 
-struct buffer_cb_transact {
-	struct comp_buffer *buffer;
-	uint32_t transaction_amount;
-	void *transaction_begin_address;
+	/* event subscribers */
+	uint32_t notify_mask;	/**< BIT(notify_id) of subscribed events */
+	struct buffer_cb_transact tick_produce;	/**< produced in this LL tick */
+	struct buffer_cb_transact tick_consume;	/**< consumed in this LL tick */
+
+	/* zero-copy pass-through, see buffer_alias() */
+	struct comp_buffer *alias;	/**< source buffer lending its memory */
+	void *own_addr;		/**< own memory while aliased */
 };
 
 struct buffer_cb_free {
@@ -159,6 +189,34 @@ struct comp_buffer *buffer_new(struct sof_ipc_buffer *desc);
 int buffer_set_size(struct comp_buffer *buffer, uint32_t size);
 void buffer_free(struct comp_buffer *buffer);
 
+/*
+ * Zero-copy pass-through between two buffers of the same size and format.
+ * The sink buffer borrows the memory of the source buffer, data consumed
+ * from the sink is consumed from the source too and buffer_alias_sync()
+ * exposes the data produced to the source since the previous call, so
+ * it replaces the copy of a transparent component.
+ */
+int buffer_alias(struct comp_buffer *sink, struct comp_buffer *source);
+void buffer_alias_sync(struct comp_buffer *sink);
+void buffer_unalias(struct comp_buffer *sink, bool keep);
+
+/*
+ * Buffer produce/consume events are only dispatched while they have
+ * subscribers, so listeners of a single buffer must use these instead of
+ * notifier_register(). Listeners registered with a NULL caller still get
+ * the events of every buffer. The *_TICK events coalesce all transactions
+ * of one LL tick into a single event sent from NOTIFIER_ID_LL_POST_RUN,
+ * carrying the total amount and the begin address of the first
+ * transaction, and are only available through these.
+ */
+int buffer_notifier_register(void *receiver, struct comp_buffer *buffer,
+			     enum notify_id type,
+			     void (*cb)(void *arg, enum notify_id type,
+					void *data),
+			     uint32_t flags);
+void buffer_notifier_unregister(void *receiver, struct comp_buffer *buffer,
+				enum notify_id type);
+
 /* called by a component after producing data into this buffer */
 void comp_update_buffer_produce(struct comp_buffer *buffer, uint32_t bytes);
 
@@ -181,6 +239,96 @@ static inline void buffer_writeback(struct comp_buffer *buffer, uint32_t bytes)
 	audio_stream_writeback(&buffer->stream, bytes);
 }
 
+/* moves a lock-free buffer position by bytes */
+static inline uint32_t buffer_spsc_advance(struct comp_buffer *buffer,
+					   uint32_t pos, uint32_t bytes)
+{
+	pos += bytes;
+
+	return pos >= 2 * buffer->stream.size ?
+		pos - 2 * buffer->stream.size : pos;
+}
+
+/* data address of a lock-free buffer position */
+static inline void *buffer_spsc_ptr(struct comp_buffer *buffer, uint32_t pos)
+{
+	if (pos >= buffer->stream.size)
+		pos -= buffer->stream.size;
+
+	return (char *)buffer->stream.addr + pos;
+}
+
+static inline uint32_t buffer_spsc_load(struct comp_buffer *buffer,
+					struct buffer_spsc_pos *spsc)
+{
+	if (buffer->inter_core)
+		dcache_invalidate_region(spsc, sizeof(*spsc));
+
+	return atomic_read(&spsc->pos);
+}
+
+static inline void buffer_spsc_store(struct comp_buffer *buffer,
+				     struct buffer_spsc_pos *spsc,
+				     uint32_t pos)
+{
+	/* data has to be in place before its position is published */
+	memory_barrier();
+
+	atomic_set(&spsc->pos, pos);
+
+	if (buffer->inter_core)
+		dcache_writeback_region(spsc, sizeof(*spsc));
+}
+
+/**
+ * Refreshes stream state of a lock-free buffer from the positions
+ * published by its producer and consumer. Pointers and avail/free are
+ * only computed in the local view of the calling core, so both cores
+ * can do it concurrently. No-op for locked buffers.
+ * @param buffer Buffer instance.
+ */
+static inline void buffer_spsc_sync(struct comp_buffer *buffer)
+{
+	struct audio_stream *stream = &buffer->stream;
+	uint32_t produced;
+	uint32_t consumed;
+
+	if (!buffer->spsc)
+		return;
+
+	produced = buffer_spsc_load(buffer, &buffer->produced);
+	consumed = buffer_spsc_load(buffer, &buffer->consumed);
+
+	/* positions have to be read before the data they describe */
+	memory_barrier();
+
+	stream->avail = produced >= consumed ? produced - consumed :
+		2 * stream->size + produced - consumed;
+	stream->free = stream->size - stream->avail;
+	stream->w_ptr = buffer_spsc_ptr(buffer, produced);
+	stream->r_ptr = buffer_spsc_ptr(buffer, consumed);
+}
+
+/**
+ * Drops stream state refreshed by buffer_spsc_sync() from the cache for
+ * buffers connecting components running on different cores. The state
+ * is derived locally by each core and never written back, only the
+ * position owned by the core is published by buffer_spsc_store().
+ * @param buffer Buffer instance.
+ */
+static inline void buffer_spsc_commit(struct comp_buffer *buffer)
+{
+	if (buffer->inter_core)
+		dcache_invalidate_region(&buffer->stream,
+					 sizeof(buffer->stream));
+}
+
+static inline void buffer_spsc_reset(struct comp_buffer *buffer)
+{
+	atomic_set(&buffer->produced.pos, 0);
+	atomic_set(&buffer->consumed.pos, 0);
+}
+
 /**
  * Locks buffer instance for buffers connecting components
  * running on different cores. Buffer parameters will be invalidated
@@ -197,6 +345,8 @@ static inline void buffer_lock(struct comp_buffer *buffer, uint32_t *flags)
 
 	/* invalidate in case something has changed during our wait */
 	dcache_invalidate_region(buffer, sizeof(*buffer));
+
+	buffer_spsc_sync(buffer);
 }
 
 /**
@@ -239,6 +389,7 @@ static inline void buffer_reset_pos(struct comp_buffer *buffer, void *data)
 
 	/* reset rw pointers and avail/free bytes counters */
 	audio_stream_reset(&buffer->stream);
+	buffer_spsc_reset(buffer);
 
 	/* clear buffer contents */
 	buffer_zero(buffer);
@@ -253,6 +404,7 @@ static inline void buffer_init(struct comp_buffer *buffer, uint32_t size,
 
 	/* addr should be set in alloc function */
 	audio_stream_init(&buffer->stream, buffer->stream.addr, size);
+	buffer_spsc_reset(buffer);
 }
 
 static inline void buffer_reset_params(struct comp_buffer *buffer, void *data)
@@ -66,6 +66,15 @@ struct dai_hw_params;
 #define COMP_STATE_ACTIVE	5	/**< Component active */
 /** @}*/
 
+/** \name Transparent Component States, see comp_set_transparent()
+ *  @{
+ */
+#define COMP_TRANSPARENT_OFF	 0	/**< Copy is run */
+#define COMP_TRANSPARENT_PENDING 1	/**< Buffers aliased on next copy */
+#define COMP_TRANSPARENT_ON	 2	/**< Sink aliases source, no copy */
+#define COMP_TRANSPARENT_EXIT	 3	/**< Aliasing released on next copy */
+/** @}*/
+
 /** \name Standard Component Stream Commands
  *  TODO: use IPC versions after 1.1
  *  @{
@@ -397,6 +406,19 @@ struct comp_driver_info {
 	struct list_item list;		/**< list of component drivers */
 };
 
+/**
+ * Processing load statistics of comp_ops::copy, cycles are counted
+ * in arch timer ticks.
+ */
+struct comp_perf_stats {
+	uint64_t cycles_total;	/**< cycles spent in all copies */
+	uint64_t frames_total;	/**< frames processed by all copies */
+	uint32_t cycles_last;	/**< cycles spent in the last copy */
+	uint32_t cycles_peak;	/**< highest cycles spent in one copy */
+	uint32_t frames_last;	/**< frames processed by the last copy */
+	uint32_t copies;	/**< number of timed copies */
+};
+
 /**
  * Audio component base device "class"
  * - used by other component types.
@@ -428,6 +450,7 @@ struct comp_dev {
 	bool is_shared;		/**< indicates whether component is shared
 				  *  across cores
 				  */
+	uint8_t transparent;	/**< COMP_TRANSPARENT_ */
 	struct tr_ctx tctx;	/**< trace settings */
 
 	/* common runtime configuration for downstream/upstream */
@@ -444,6 +467,7 @@ struct comp_dev {
 
 #if CONFIG_PERFORMANCE_COUNTERS
 	struct perf_cnt_data pcd;
+	struct comp_perf_stats perf;	/**< copy load statistics */
 #endif
 
 	/**
@@ -632,6 +656,33 @@ void comp_unregister(struct comp_driver_info *drv);
  */
 int comp_set_state(struct comp_dev *dev, int cmd);
 
+/**
+ * Declares the component transparent when its processing doesn't change
+ * the data, e.g. a filter without configuration. The copy of such
+ * component is skipped and the sink buffer aliases the source buffer
+ * until comp_reset() or new configuration arrives with comp_cmd().
+ * @param dev Component device.
+ *
+ * To be called from prepare(), it has no effect unless the component
+ * has a single source and a single sink buffer of the same size and
+ * stream parameters on the same core.
+ */
+void comp_set_transparent(struct comp_dev *dev);
+
+/**
+ * Runs copy of a transparent component.
+ * @param dev Component device.
+ * @return true if the data was passed and comp_ops::copy has to be
+ *	   skipped, false otherwise.
+ */
+bool comp_transparent_copy(struct comp_dev *dev);
+
+/**
+ * Releases buffer aliasing of a transparent component.
+ * @param dev Component device.
+ */
+void comp_transparent_reset(struct comp_dev *dev);
+
 /* \brief Set component period frames */
 static inline void component_set_period_frames(struct comp_dev *current,
 					       uint32_t rate)
@@ -643,6 +694,85 @@ static inline void component_set_period_frames(struct comp_dev *current,
 	current->frames = ceil_divide(rate * current->period, 1000000);
 }
 
+/** \name Processing load statistics.
+ *  @{
+ */
+
+/**
+ * Starts timing of comp_ops::copy.
+ * @param dev Component device.
+ */
+static inline void comp_perf_start(struct comp_dev *dev)
+{
+#if CONFIG_PERFORMANCE_COUNTERS
+	dev->perf.frames_last = 0;
+	perf_cnt_init(&dev->pcd);
+#endif
+}
+
+/**
+ * Stops timing of comp_ops::copy and accounts it in the statistics.
+ * @param dev Component device.
+ */
+static inline void comp_perf_stop(struct comp_dev *dev)
+{
+#if CONFIG_PERFORMANCE_COUNTERS
+	struct comp_perf_stats *perf = &dev->perf;
+
+	perf_cnt_stamp(&dev->pcd, comp_perf_info, dev);
+
+	perf->cycles_last = dev->pcd.cpu_delta_last;
+	perf->cycles_peak = MAX(perf->cycles_peak, perf->cycles_last);
+	perf->cycles_total += perf->cycles_last;
+	perf->frames_total += perf->frames_last;
+	perf->copies++;
+#endif
+}
+
+/**
+ * Notes frames moved by the component in the current copy, called on
+ * buffer produce and consume. The largest amount moved through any of the
+ * buffers is taken as the number of frames processed.
+ * @param dev Component device, may be NULL for unconnected buffer ends.
+ * @param stream Stream of the buffer.
+ * @param bytes Number of bytes moved.
+ */
+static inline void comp_perf_frames(struct comp_dev *dev,
+				    const struct audio_stream *stream,
+				    uint32_t bytes)
+{
+#if CONFIG_PERFORMANCE_COUNTERS
+	uint32_t frame_bytes = audio_stream_frame_bytes(stream);
+
+	if (dev && frame_bytes)
+		dev->perf.frames_last = MAX(dev->perf.frames_last,
+					    bytes / frame_bytes);
+#endif
+}
+
+/**
+ * Retrieves processing load statistics of the component.
+ * @param dev Component device.
+ * @param perf IPC structure to be filled in, comp_id is preserved.
+ */
+static inline void comp_perf_get(struct comp_dev *dev,
+				 struct sof_ipc_comp_perf *perf)
+{
+#if CONFIG_PERFORMANCE_COUNTERS
+	struct comp_perf_stats *stats = &dev->perf;
+
+	perf->copies = stats->copies;
+	perf->cycles_last = stats->cycles_last;
+	perf->cycles_peak = stats->cycles_peak;
+	perf->cycles_avg = stats->copies ?
+		stats->cycles_total / stats->copies : 0;
+	perf->frames_last = stats->frames_last;
+	perf->frames_total = stats->frames_total;
+#endif
+}
+
+/** @}*/
+
 /** \name XRUN handling.
  *  @{
  */
@@ -716,6 +846,12 @@ void comp_get_copy_limits_with_lock(struct comp_buffer *source,
 	uint32_t source_flags = 0;
 	uint32_t sink_flags = 0;
 
+	/* lock-free buffers publish positions, nothing else is read here */
+	if (source->spsc && sink->spsc) {
+		comp_get_copy_limits(source, sink, cl);
+		return;
+	}
+
 	buffer_lock(source, &source_flags);
 	buffer_lock(sink, &sink_flags);
 
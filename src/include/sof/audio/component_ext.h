@@ -64,6 +64,15 @@ static inline void comp_shared_commit(struct comp_dev *dev)
 		platform_shared_commit(dev, sizeof(*dev));
 }
 
+/**
+ * Attributes heap allocations made by the driver ops to the driver.
+ * @param drv Component driver, NULL to stop attribution.
+ */
+static inline void comp_heap_owner_set(const struct comp_driver *drv)
+{
+	heap_owner_set(drv && drv->tctx ? drv->tctx->uuid_p : NULL);
+}
+
 /**
  * Parameter init for component on other core.
  * @param dev Component device.
@@ -88,6 +97,7 @@ static inline int comp_params(struct comp_dev *dev,
 	if (dev->is_shared && !cpu_is_me(dev->comp.core)) {
 		ret = comp_params_remote(dev, params);
 	} else {
+		comp_heap_owner_set(dev->drv);
 		if (dev->drv->ops.params) {
 			ret = dev->drv->ops.params(dev, params);
 		} else {
@@ -96,6 +106,7 @@ static inline int comp_params(struct comp_dev *dev,
 			if (ret < 0)
 				comp_err(dev, "pcm params verification failed");
 		}
+		comp_heap_owner_set(NULL);
 	}
 
 	comp_shared_commit(dev);
@@ -133,8 +144,16 @@ static inline int comp_cmd(struct comp_dev *dev, int cmd, void *data,
 		goto out;
 	}
 
-	if (dev->drv->ops.cmd)
+	/* new configuration is applied by the copy of the component */
+	if ((cmd == COMP_CMD_SET_DATA || cmd == COMP_CMD_SET_VALUE) &&
+	    dev->transparent)
+		dev->transparent = COMP_TRANSPARENT_EXIT;
+
+	if (dev->drv->ops.cmd) {
+		comp_heap_owner_set(dev->drv);
 		ret = dev->drv->ops.cmd(dev, cmd, data, max_data_size);
+		comp_heap_owner_set(NULL);
+	}
 
 out:
 	comp_shared_commit(dev);
@@ -183,9 +202,15 @@ static inline int comp_prepare(struct comp_dev *dev)
 {
 	int ret = 0;
 
-	if (dev->drv->ops.prepare)
-		ret = (dev->is_shared && !cpu_is_me(dev->comp.core)) ?
-			comp_prepare_remote(dev) : dev->drv->ops.prepare(dev);
+	if (dev->drv->ops.prepare) {
+		if (dev->is_shared && !cpu_is_me(dev->comp.core)) {
+			ret = comp_prepare_remote(dev);
+		} else {
+			comp_heap_owner_set(dev->drv);
+			ret = dev->drv->ops.prepare(dev);
+			comp_heap_owner_set(NULL);
+		}
+	}
 
 	comp_shared_commit(dev);
 
@@ -201,9 +226,10 @@ static inline int comp_copy(struct comp_dev *dev)
 
 	/* copy only if we are the owner of the component */
 	if (cpu_is_me(dev->comp.core)) {
-		perf_cnt_init(&dev->pcd);
-		ret = dev->drv->ops.copy(dev);
-		perf_cnt_stamp(&dev->pcd, comp_perf_info, dev);
+		comp_perf_start(dev);
+		if (!dev->transparent || !comp_transparent_copy(dev))
+			ret = dev->drv->ops.copy(dev);
+		comp_perf_stop(dev);
 	}
 	comp_shared_commit(dev);
 
@@ -242,6 +268,9 @@ static inline int comp_reset(struct comp_dev *dev)
 {
 	int ret = 0;
 
+	if (dev->transparent)
+		comp_transparent_reset(dev);
+
 	if (dev->drv->ops.reset)
 		ret = (dev->is_shared && !cpu_is_me(dev->comp.core)) ?
 			comp_reset_remote(dev) : dev->drv->ops.reset(dev);
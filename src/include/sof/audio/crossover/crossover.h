@@ -15,6 +15,25 @@
 struct comp_buffer;
 struct comp_dev;
 
+/* Select optimized code variant when xt-xcc compiler is used */
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 == 1
+#define CROSSOVER_GENERIC	0
+#define CROSSOVER_HIFI3		1
+#else
+#define CROSSOVER_GENERIC	1
+#define CROSSOVER_HIFI3		0
+#endif /* XCHAL_HAVE_HIFI3 */
+#else
+/* GCC */
+#define CROSSOVER_GENERIC	1
+#define CROSSOVER_HIFI3		0
+#endif /* __XCC__ */
+
+/* Number of frames of one channel split at a time */
+#define CROSSOVER_BLOCK_FRAMES 16
+
 /* Maximum number of LR4 highpass OR lowpass filters */
 #define CROSSOVER_MAX_LR4 3
 /* Number of delay slots allocated for LR4 Filters */
@@ -72,8 +91,9 @@ typedef void (*crossover_process)(const struct comp_dev *dev,
 				  int32_t num_sinks,
 				  uint32_t frames);
 
-typedef void (*crossover_split)(int32_t in, int32_t out[],
-				struct crossover_state *state);
+/* Splits a block of Q1.31 samples of one channel to per sink blocks */
+typedef void (*crossover_split)(const int32_t *in, int32_t *out[],
+				struct crossover_state *state, int frames);
 
 /* Crossover component private data */
 struct comp_data {
@@ -142,14 +162,4 @@ static inline crossover_split crossover_find_split_func(int32_t num_sinks)
 	return crossover_split_fnmap[num_sinks - CROSSOVER_2WAY_NUM_SINKS];
 }
 
-/*
- * \brief Runs input in through the LR4 filter and returns it's output.
- */
-static inline int32_t crossover_generic_process_lr4(int32_t in,
-						    struct iir_state_df2t *lr4)
-{
-	/* Cascade two biquads with same coefficients in series. */
-	return iir_df2t(lr4, in);
-}
-
 #endif //  __SOF_AUDIO_CROSSOVER_CROSSOVER_H__
@@ -0,0 +1,134 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *
+ * Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+ */
+
+#ifndef __SOF_AUDIO_DRC_DRC_H__
+#define __SOF_AUDIO_DRC_DRC_H__
+
+#include <sof/audio/format.h>
+#include <sof/math/iir_df2t.h>
+#include <sof/platform.h>
+#include <ipc/stream.h>
+#include <user/drc.h>
+#include <user/eq.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct audio_stream;
+struct comp_data_blob_handler;
+
+/* Select optimized code variant when xt-xcc compiler is used */
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 == 1
+#define DRC_GENERIC	0
+#define DRC_HIFI3	1
+#else
+#define DRC_GENERIC	1
+#define DRC_HIFI3	0
+#endif /* XCHAL_HAVE_HIFI3 */
+#else
+/* GCC */
+#define DRC_GENERIC	1
+#define DRC_HIFI3	0
+#endif /* __XCC__ */
+
+/* Number of frames in a block for which the gain is computed once. The
+ * gain is ramped linearly to the new value during the next block.
+ */
+#define DRC_DIVISION_FRAMES	32
+
+/* Maximum number of LR4 highpass OR lowpass filters in band split */
+#define DRC_MAX_LR4		3
+/* Number of delay slots allocated for LR4 Filters */
+#define DRC_NUM_DELAYS_LR4	4
+
+/* Unity linear gain, Q8.24 */
+#define DRC_GAIN_ONE		Q_CONVERT_FLOAT(1.0, 24)
+
+/**
+ * Stores the gain computer state of one band. All channels of the band
+ * share the same gain so that the stereo image does not move.
+ */
+struct drc_band_state {
+	bool enabled;		/**< false for pass through band */
+	int32_t threshold;	/**< Q8.24 dB */
+	int32_t knee;		/**< Q8.24 dB */
+	int32_t slope;		/**< Q2.30, 1 - 1 / ratio */
+	int32_t makeup;		/**< Q8.24 dB */
+	int32_t attack;		/**< Q1.31 smoothing coefficient per block */
+	int32_t release;	/**< Q1.31 smoothing coefficient per block */
+	int32_t env;		/**< Smoothed gain reduction, Q8.24 dB */
+	int32_t peak;		/**< Peak of current block, Q1.31 */
+	int32_t peak_prev;	/**< Peak of previous block, Q1.31 */
+	int32_t gain;		/**< Linear gain of previous frame, Q8.24 */
+	int32_t target;		/**< Linear gain at end of ramp, Q8.24 */
+	int32_t step;		/**< Gain ramp increment per frame, Q8.24 */
+	int32_t *buf;		/**< Interleaved band samples of a block */
+	int32_t *delay;		/**< Interleaved look-ahead delay line */
+};
+
+struct drc_comp_data;
+
+typedef void (*drc_func)(struct drc_comp_data *cd,
+			 const struct audio_stream *source,
+			 struct audio_stream *sink,
+			 uint32_t frames);
+
+/* DRC component private data */
+struct drc_comp_data {
+	struct comp_data_blob_handler *model_handler;
+	struct sof_drc_config *config;		/**< pointer to setup blob */
+	struct drc_band_state band[SOF_DRC_MAX_BANDS];
+	/* band split filters, LR4s share coefficients across channels */
+	struct iir_state_df2t lowpass[DRC_MAX_LR4][PLATFORM_MAX_CHANNELS];
+	struct iir_state_df2t highpass[DRC_MAX_LR4][PLATFORM_MAX_CHANNELS];
+	int32_t lr4_coef[2 * DRC_MAX_LR4][2 * SOF_EQ_IIR_NBIQUAD_DF2T];
+	int32_t *in;		/**< Interleaved Q1.31 input of a block */
+	void *data;		/**< Buffers and delay lines allocation */
+	int num_bands;		/**< number of bands in use */
+	int nch;		/**< number of channels */
+	int delay_frames;	/**< look-ahead delay length in frames */
+	int delay_idx;		/**< look-ahead delay line position */
+	int pos;		/**< frames processed in current block */
+	drc_func drc_func;	/**< processing function */
+};
+
+struct drc_func_map {
+	enum sof_ipc_frame fmt;
+	drc_func func;
+};
+
+extern const struct drc_func_map drc_fnmap[];
+extern const size_t drc_fncount;
+
+/**
+ * \brief Returns DRC processing function.
+ */
+static inline drc_func drc_find_func(enum sof_ipc_frame fmt)
+{
+	int i;
+
+	/* Find suitable processing function from map */
+	for (i = 0; i < drc_fncount; i++)
+		if (fmt == drc_fnmap[i].fmt)
+			return drc_fnmap[i].func;
+
+	return NULL;
+}
+
+/**
+ * \brief Returns the largest absolute value of samples, Q1.31.
+ */
+int32_t drc_peak(const int32_t *x, int samples);
+
+/**
+ * \brief Applies the band gain ramp to a block of interleaved frames.
+ */
+void drc_gain(struct drc_band_state *band, int frames, int nch);
+
+#endif /* __SOF_AUDIO_DRC_DRC_H__ */
@@ -20,6 +20,8 @@
 #if FIR_HIFI3
 #include <sof/math/fir_hifi3.h>
 #endif
+#include <sof/math/fir_fft.h>
+#include <sof/math/fir_nch.h>
 #include <user/fir.h>
 #include <stdint.h>
 
@@ -29,6 +31,13 @@ void eq_fir_s16(struct fir_state_32x16 *fir, const struct audio_stream *source,
 
 void eq_fir_2x_s16(struct fir_state_32x16 *fir, const struct audio_stream *source,
 		   struct audio_stream *sink, int frames, int nch);
+
+void eq_fir_fft_s16(struct fir_fft_state *fft, const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch);
+
+void eq_fir_nch_s16(struct fir_nch_state_32x16 *fir,
+		    const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch);
 #endif /* CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S24LE
@@ -37,6 +46,13 @@ void eq_fir_s24(struct fir_state_32x16 *fir, const struct audio_stream *source,
 
 void eq_fir_2x_s24(struct fir_state_32x16 *fir, const struct audio_stream *source,
 		   struct audio_stream *sink, int frames, int nch);
+
+void eq_fir_fft_s24(struct fir_fft_state *fft, const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch);
+
+void eq_fir_nch_s24(struct fir_nch_state_32x16 *fir,
+		    const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch);
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
@@ -45,6 +61,13 @@ void eq_fir_s32(struct fir_state_32x16 *fir, const struct audio_stream *source,
 
 void eq_fir_2x_s32(struct fir_state_32x16 *fir, const struct audio_stream *source,
 		   struct audio_stream *sink, int frames, int nch);
+
+void eq_fir_fft_s32(struct fir_fft_state *fft, const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch);
+
+void eq_fir_nch_s32(struct fir_nch_state_32x16 *fir,
+		    const struct audio_stream *source,
+		    struct audio_stream *sink, int frames, int nch);
 #endif /* CONFIG_FORMAT_S32LE */
 
 #endif /* __SOF_AUDIO_EQ_FIR_EQ_FIR_H__ */
@@ -8,6 +8,121 @@
 #ifndef __SOF_AUDIO_MIXER_H__
 #define __SOF_AUDIO_MIXER_H__
 
+#include <sof/audio/audio_stream.h>
+#include <sof/math/numbers.h>
+#include <sof/platform.h>
+#include <ipc/stream.h>
+#include <stddef.h>
+#include <stdint.h>
+
+struct comp_dev;
+
+/* Select optimized code variant when xt-xcc compiler is used, unit tests
+ * may select the variant themselves
+ */
+#ifndef MIXER_GENERIC
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 == 1
+#define MIXER_GENERIC	0
+#define MIXER_HIFI3	1
+#else
+#define MIXER_GENERIC	1
+#define MIXER_HIFI3	0
+#endif /* XCHAL_HAVE_HIFI3 */
+#else
+/* GCC */
+#define MIXER_GENERIC	1
+#define MIXER_HIFI3	0
+#endif /* __XCC__ */
+#endif /* MIXER_GENERIC */
+
+/** \brief Samples mixed at once, sizes the accumulators kept on stack. */
+#define MIXER_BLOCK_SAMPLES	32
+
+/** \brief Per-source gain Q format, Q1.31. */
+#define MIXER_GAIN_QY		31
+
+/** \brief Per-source gain of 0 dB, the largest Q1.31 value. */
+#define MIXER_GAIN_UNITY	INT32_MAX
+
+/**
+ * \brief Mixing function.
+ * \param[in,out] dev Mixer base component device.
+ * \param[in,out] sink Destination stream.
+ * \param[in] sources Source streams.
+ * \param[in] gains Per-source Q1.31 gains or NULL if all gains are unity.
+ * \param[in] num_sources Number of source streams.
+ * \param[in] frames Number of frames to mix.
+ */
+typedef void (*mixer_func)(struct comp_dev *dev, struct audio_stream *sink,
+			   const struct audio_stream **sources,
+			   const int32_t *gains, uint32_t num_sources,
+			   uint32_t frames);
+
+/* per-source gain, source is identified by its pipeline */
+struct mixer_source_gain {
+	uint32_t pipeline_id;
+	int32_t gain;			/**< Q1.31 */
+};
+
+/* mixer component private data */
+struct mixer_data {
+	mixer_func mix_func;
+
+	/* gains set by SOF_CTRL_CMD_VOLUME, unity for unlisted sources */
+	struct mixer_source_gain gains[PLATFORM_MAX_STREAMS];
+	uint32_t num_gains;
+};
+
+/* mixing function for each supported frame format */
+struct mixer_func_map {
+	enum sof_ipc_frame frame_fmt;
+	mixer_func func;
+};
+
+extern const struct mixer_func_map mixer_func_map[];
+extern const size_t mixer_func_count;
+
+/**
+ * \brief Retrieves mixing function matching the sink frame format.
+ * \param[in] frame_fmt Sink frame format.
+ * \return Mixing function or NULL if format is not supported.
+ */
+static inline mixer_func mixer_get_processing_function(enum sof_ipc_frame
+						       frame_fmt)
+{
+	int i;
+
+	for (i = 0; i < mixer_func_count; i++) {
+		if (frame_fmt == mixer_func_map[i].frame_fmt)
+			return mixer_func_map[i].func;
+	}
+
+	return NULL;
+}
+
+/**
+ * \brief Calculates the largest number of frames which can be mixed
+ *	  without wrap in the sink nor in any of the sources.
+ * \param[in] out Sink stream iterator.
+ * \param[in] in Source stream iterators.
+ * \param[in] num_sources Number of source streams.
+ * \return Number of frames in the block.
+ */
+static inline uint32_t mixer_block_frames(struct audio_stream_iter *out,
+					  struct audio_stream_iter *in,
+					  uint32_t num_sources)
+{
+	uint32_t n = audio_stream_iter_frames(out);
+	int j;
+
+	for (j = 0; j < num_sources; j++)
+		n = MIN(n, audio_stream_iter_frames(&in[j]));
+
+	return n;
+}
+
 #ifdef UNIT_TEST
 void sys_comp_mixer_init(void);
 #endif
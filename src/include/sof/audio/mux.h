@@ -39,12 +39,6 @@ struct mux_copy_elem {
 	uint32_t stream_id;
 	uint32_t in_ch;
 	uint32_t out_ch;
-
-	void *dest;
-	void *src;
-
-	uint32_t dest_inc;
-	uint32_t src_inc;
 };
 
 struct mux_look_up {
@@ -89,6 +89,15 @@ extern struct tr_ctx pipe_tr;
 #define PPL_POSN_OFFSETS \
 	(MAILBOX_STREAM_SIZE / sizeof(struct sof_ipc_stream_posn))
 
+/*
+ * Single entry of the flat pipeline copy schedule.
+ */
+struct pipeline_step {
+	struct comp_dev *comp;	/* component to be copied */
+	uint32_t subtree;	/* number of steps depending on this one */
+	bool run;		/* copy scheduled in the current period */
+};
+
 /*
  * Audio pipeline.
  */
@@ -112,6 +121,13 @@ struct pipeline {
 
 	struct list_item list;	/**< list in walk context */
 
+	/* flat copy schedule compiled from the component graph */
+	struct pipeline_step *steps;	/* steps in execution order */
+	uint32_t steps_count;		/* number of compiled steps */
+	uint32_t steps_size;		/* number of allocated steps */
+	uint32_t steps_dir;		/* direction schedule was built for */
+	bool steps_valid;		/* schedule matches current graph */
+
 	/* position update */
 	uint32_t posn_offset;		/* position update array offset*/
 	struct ipc_msg *msg;
@@ -215,6 +231,13 @@ int pipeline_free(struct pipeline *p);
 int pipeline_connect(struct comp_dev *comp, struct comp_buffer *buffer,
 		     int dir);
 
+/* copy schedule has to be compiled again after graph change */
+static inline void pipeline_schedule_invalidate(struct pipeline *p)
+{
+	if (p)
+		p->steps_valid = false;
+}
+
 /* complete the pipeline */
 int pipeline_complete(struct pipeline *p, struct comp_dev *source,
 		      struct comp_dev *sink);
@@ -8,6 +8,7 @@
 #ifndef __SOF_AUDIO_SRC_SRC_H__
 #define __SOF_AUDIO_SRC_SRC_H__
 
+#include <sof/list.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -26,6 +27,8 @@ struct src_param {
 	int idx_in;
 	int idx_out;
 	int nch;
+	struct src_stage *stage1;
+	struct src_stage *stage2;
 };
 
 struct src_stage {
@@ -41,6 +44,21 @@ struct src_stage {
 	const void *coefs; /* Can be int16_t or int32_t depending on config */
 };
 
+/* Limits of run-time generated polyphase filters */
+#define SRC_COEF_MAX_FILTER_LENGTH	4096
+#define SRC_COEF_MAX_FIR_DELAY_SIZE	1024
+#define SRC_COEF_MAX_OUT_DELAY_SIZE	1024
+
+/* Generated coefficients of a conversion, followed by the filters */
+struct src_coef_bank {
+	struct list_item list;	/* in cache of the core */
+	int fs_in;
+	int fs_out;
+	int refs;		/* number of SRC instances using the bank */
+	struct src_stage stage1;
+	struct src_stage stage2;
+};
+
 struct src_state {
 	int fir_delay_size;	/* samples */
 	int out_delay_size;	/* samples */
@@ -120,6 +138,17 @@ int src_buffer_lengths(struct src_param *a, int fs_in, int fs_out, int nch,
 
 int32_t src_input_rates(void);
 
+#if CONFIG_COMP_SRC_GEN
+void src_coef_init(void);
+
+/* Returns a bank shared by all users of the rates on the core, NULL if the
+ * conversion can't be designed
+ */
+struct src_coef_bank *src_coef_bank_get(int fs_in, int fs_out);
+
+void src_coef_bank_put(struct src_coef_bank *bank);
+#endif /* CONFIG_COMP_SRC_GEN */
+
 int32_t src_output_rates(void);
 
 #endif /* __SOF_AUDIO_SRC_SRC_H__ */
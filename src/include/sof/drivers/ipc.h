@@ -49,6 +49,10 @@ struct ipc_msg;
 /** \brief Scheduling period for IPC task in microseconds. */
 #define IPC_PERIOD_USEC	100
 
+/* number of buckets in component lookup tables, must be power of 2 */
+#define IPC_COMP_HASH_SIZE	32
+#define IPC_COMP_HASH(id)	((id) & (IPC_COMP_HASH_SIZE - 1))
+
 /* validates internal non tail structures within IPC command structure */
 #define IPC_IS_SIZE_INVALID(object)					\
 	(object).hdr.size == sizeof(object) ? 0 : 1
@@ -76,6 +80,8 @@ struct ipc_comp_dev {
 
 	/* lists */
 	struct list_item list;		/* list in components */
+	struct list_item id_list;	/* list in ID hash bucket */
+	struct list_item ppl_list;	/* list in pipeline ID hash bucket */
 };
 
 struct ipc_msg {
@@ -97,6 +103,10 @@ struct ipc {
 
 	struct list_item comp_list;	/* list of component devices */
 
+	/* component devices hashed by ID and by pipeline ID */
+	struct list_item comp_hash[IPC_COMP_HASH_SIZE];
+	struct list_item ppl_hash[IPC_COMP_HASH_SIZE];
+
 	/* processing task */
 	struct task ipc_task;
 
@@ -303,6 +313,12 @@ int ipc_pipeline_complete(struct ipc *ipc, uint32_t comp_id);
 int ipc_comp_connect(struct ipc *ipc,
 	struct sof_ipc_pipe_comp_connect *connect);
 
+/*
+ * Unlink component, buffer or pipeline from the list and the ID hashes,
+ * for callers that free the device themselves.
+ */
+void ipc_comp_dev_del(struct ipc_comp_dev *icd);
+
 /*
  * Get component by ID.
  */
@@ -17,6 +17,10 @@
 #define __SOF_LIB_ALLOC_H__
 
 #include <sof/bit.h>
+#include <sof/lib/cpu.h>
+#include <sof/lib/memory.h>
+#include <sof/list.h>
+#include <sof/spinlock.h>
 #include <sof/string.h>
 #include <sof/trace/trace.h>
 #include <user/trace.h>
@@ -147,6 +151,80 @@ void rfree(void *ptr);
  */
 void *rzalloc_core_sys(int core, size_t bytes);
 
+/** \name Object pools
+ *  @{
+ */
+
+/** \brief Object pool ids, reported by heap_trace_all(). */
+enum mem_pool {
+	SOF_MEM_POOL_BUFFER = 0,	/**< struct comp_buffer */
+	SOF_MEM_POOL_BUFFER_LOCK,	/**< shared spinlock_t of comp_buffer */
+	SOF_MEM_POOL_PIPE_TASK,		/**< struct pipeline_task */
+};
+
+/** \brief Free list of an object pool owned by one core. */
+struct mm_pool_core {
+	void *free;		/**< first free object, next link inside */
+	uint32_t free_count;	/**< objects on the free list */
+	int32_t used;		/**< objects allocated minus freed by core */
+} __aligned(PLATFORM_DCACHE_ALIGN);
+
+/**
+ * \brief Pool of fixed size objects.
+ *
+ * Slabs of slab_objs objects are allocated from SOF_MEM_ZONE_RUNTIME when
+ * the free list of the calling core runs dry, smaller ones if no heap block
+ * fits a full slab. Freed objects go to the free
+ * list of the freeing core and are handed out again in O(1) without taking
+ * the heap lock. Slabs are never given back to the heap, so repeated
+ * topology load and unload reuses the same blocks instead of fragmenting it.
+ */
+struct mm_pool {
+	enum mem_pool id;	/**< pool id */
+	uint32_t size;		/**< object size in bytes */
+	uint32_t slab_objs;	/**< objects allocated from heap at once */
+	uint32_t flags;		/**< slab allocation flags, SOF_MEM_FLAG_... */
+	spinlock_t lock;	/**< guards slabs and peak, unlocked when zeroed */
+	uint32_t slabs;		/**< slabs allocated so far */
+	uint32_t peak;		/**< highest number of objects in use */
+	struct list_item list;	/**< in list of pools owning slabs */
+	struct mm_pool_core core[PLATFORM_CORE_COUNT];
+};
+
+#define MM_POOL_DEF(pool_id, obj_size, objs, mem_flags) \
+	{.id = pool_id, .size = obj_size, .slab_objs = objs, \
+	 .flags = mem_flags}
+
+/**
+ * Allocates object from the pool.
+ * @param pool Pool to allocate from, see MM_POOL_DEF().
+ * @return Pointer to the object or NULL if the pool could not grow.
+ */
+void *rpool_alloc(struct mm_pool *pool);
+
+/**
+ * Similar to rpool_alloc(), guarantees that returned object is zeroed.
+ */
+void *rpool_zalloc(struct mm_pool *pool);
+
+/**
+ * Returns object to the pool.
+ * @param pool Pool the object was allocated from.
+ * @param ptr Pointer to the object, NULL is ignored.
+ */
+void rpool_free(struct mm_pool *pool, void *ptr);
+
+struct sof_uuid_entry;
+
+/**
+ * Attributes following block heap allocations made on the current core
+ * to an owner, reported by the heap usage telemetry.
+ * @param uid UUID entry of the owning component driver, NULL for none.
+ */
+void heap_owner_set(const struct sof_uuid_entry *uid);
+
+/** @}*/
+
 /** \brief Zeroes memory block.
  * @param ptr Pointer to the memory block.
  * @param size Size of the block in bytes.
@@ -13,6 +13,7 @@
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/lib/memory.h>
+#include <sof/list.h>
 #include <sof/sof.h>
 #include <sof/spinlock.h>
 
@@ -21,6 +22,12 @@
 
 struct dma_copy;
 struct dma_sg_config;
+struct sof_ipc_dbg_mem_owner_elem;
+struct sof_ipc_dbg_mem_usage_elem;
+struct sof_uuid_entry;
+
+/* number of owners tracked by heap usage attribution, 0 is unattributed */
+#define HEAP_OWNER_COUNT	16
 
 struct mm_info {
 	uint32_t used;
@@ -29,7 +36,8 @@ struct mm_info {
 
 struct block_hdr {
 	uint16_t size;		/* size in blocks for continuous allocation */
-	uint16_t used;		/* usage flags for page */
+	uint8_t used;		/* usage flags for page */
+	uint8_t owner;		/* index of owner in mm owners table */
 	void *unaligned_ptr;	/* align ptr */
 } __packed;
 
@@ -53,6 +61,16 @@ struct mm_heap {
 	uint32_t size;
 	uint32_t caps;
 	struct mm_info info;
+	uint32_t used_peak;	/* high-water mark of info.used */
+	uint32_t alloc_fails;	/* failed requests this heap was first for */
+};
+
+/* block heap usage attributed to a single component driver */
+struct mm_owner {
+	const struct sof_uuid_entry *uid;	/* owner UUID, NULL if unattributed */
+	uint32_t used;		/* bytes currently allocated */
+	uint32_t used_peak;	/* high-water mark of used */
+	uint32_t alloc_fails;	/* failed allocation requests */
 };
 
 /* heap block memory map */
@@ -67,6 +85,8 @@ struct mm {
 	struct mm_heap buffer[PLATFORM_HEAP_BUFFER];
 
 	struct mm_info total;
+	struct list_item pools;	/* object pools owning slabs */
+	struct mm_owner owners[HEAP_OWNER_COUNT];	/* usage attribution */
 	uint32_t heap_trace_updated;	/* updates that can be presented */
 	spinlock_t lock;	/* all allocs and frees are atomic */
 };
@@ -86,6 +106,10 @@ void free_heap(enum mem_zone zone);
 void heap_trace_all(int force);
 void heap_trace(struct mm_heap *heap, int size);
 
+/* usage telemetry, both return number of elements written */
+int heap_usage_get(struct sof_ipc_dbg_mem_usage_elem *elems, int max);
+int heap_owners_get(struct sof_ipc_dbg_mem_owner_elem *elems, int max);
+
 /* retrieve memory map pointer */
 static inline struct mm *memmap_get(void)
 {
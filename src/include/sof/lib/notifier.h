@@ -11,6 +11,7 @@
 #include <sof/bit.h>
 #include <sof/list.h>
 #include <sof/sof.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 /* notifier target core masks */
@@ -34,11 +35,14 @@ enum notify_id {
 	NOTIFIER_ID_LL_POST_RUN,		/* NULL */
 	NOTIFIER_ID_DMA_IRQ,			/* struct dma_chan_data * */
 	NOTIFIER_ID_DAI_TRIGGER,		/* struct dai_group * */
+	NOTIFIER_ID_BUFFER_PRODUCE_TICK,	/* struct buffer_cb_transact* */
+	NOTIFIER_ID_BUFFER_CONSUME_TICK,	/* struct buffer_cb_transact* */
 	NOTIFIER_ID_COUNT
 };
 
 struct notify {
 	struct list_item list[NOTIFIER_ID_COUNT]; /* list of callback handles */
+	uint32_t wildcards[NOTIFIER_ID_COUNT]; /* handles with NULL caller */
 };
 
 struct notify_data {
@@ -62,6 +66,7 @@ int notifier_register(void *receiver, void *caller, enum notify_id type,
 		      uint32_t flags);
 void notifier_unregister(void *receiver, void *caller, enum notify_id type);
 void notifier_unregister_all(void *receiver, void *caller);
+bool notifier_has_callbacks(const void *caller, enum notify_id type);
 
 void notifier_notify_remote(void);
 void notifier_event(const void *caller, enum notify_id type, uint32_t core_mask,
@@ -71,6 +76,12 @@ void init_system_notify(struct sof *sof);
 
 void free_system_notify(void);
 
+/* true if someone listens to events of this type from any caller */
+static inline bool notifier_has_wildcard(enum notify_id type)
+{
+	return (*arch_notify_get())->wildcards[type];
+}
+
 static inline struct notify_data *notify_data_get(void)
 {
 	return sof_get()->notify_data;
@@ -15,8 +15,14 @@
 #define EXP_FIXED_OUTPUT_QY 20
 #define DB2LIN_FIXED_INPUT_QY 24
 #define DB2LIN_FIXED_OUTPUT_QY 20
+#define LOG_FIXED_INPUT_QY 20
+#define LOG_FIXED_OUTPUT_QY 27
+#define LIN2DB_FIXED_INPUT_QY 20
+#define LIN2DB_FIXED_OUTPUT_QY 24
 
 int32_t exp_fixed(int32_t x); /* Input is Q5.27, output is Q12.20 */
 int32_t db2lin_fixed(int32_t x); /* Input is Q8.24, output is Q12.20 */
+int32_t log_fixed(int32_t x); /* Input is Q12.20, output is Q5.27 */
+int32_t lin2db_fixed(int32_t x); /* Input is Q12.20, output is Q8.24 */
 
 #endif /* __SOF_MATH_DECIBELS_H__ */
@@ -0,0 +1,69 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *
+ * Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+ */
+
+#ifndef __SOF_MATH_FFT_H__
+#define __SOF_MATH_FFT_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Largest supported complex FFT size, limited by twiddle accuracy of the
+ * sine table used by sin_fixed().
+ */
+#define FFT_MAX_SIZE	2048
+
+/* Q1.31 complex number */
+struct icomplex32 {
+	int32_t real;
+	int32_t imag;
+};
+
+/* Radix-2 complex FFT plan */
+struct fft_plan {
+	uint32_t size;			/* Number of complex points, 2^N */
+	uint32_t depth;			/* log2(size) */
+	uint16_t *bit_reverse_idx;	/* Bit reversed index of each point */
+	struct icomplex32 *twiddle;	/* e^(-j*2*pi*k/size), k < size/2 */
+};
+
+/* Real FFT plan, computed with a half size complex FFT */
+struct rfft_plan {
+	uint32_t size;			/* Number of real points, 2^N */
+	struct fft_plan *fft;		/* Complex FFT of size / 2 points */
+	struct icomplex32 *twiddle;	/* e^(-j*2*pi*k/size), k <= size/4 */
+};
+
+struct fft_plan *fft_plan_new(uint32_t size);
+
+void fft_plan_free(struct fft_plan *plan);
+
+/*
+ * In place complex FFT. The forward transform is scaled by 1/size so that
+ * it can't overflow. The inverse transform is not scaled so an inverse of
+ * a forward transform returns the original data. The inverse saturates.
+ */
+void fft_execute_32(struct fft_plan *plan, struct icomplex32 *buf, bool ifft);
+
+struct rfft_plan *rfft_plan_new(uint32_t size);
+
+void rfft_plan_free(struct rfft_plan *plan);
+
+/*
+ * In place real FFT. The buffer holds size real Q1.31 samples on input and
+ * size / 2 + 1 bins of the spectrum scaled by 1/size on output, so it must
+ * have space for size / 2 + 1 complex numbers.
+ */
+void rfft_execute_32(struct rfft_plan *plan, struct icomplex32 *buf);
+
+/*
+ * In place inverse real FFT. The buffer holds size / 2 + 1 bins of a
+ * spectrum in the scale of rfft_execute_32() on input and size real Q1.31
+ * samples on output. The input bins are overwritten.
+ */
+void irfft_execute_32(struct rfft_plan *plan, struct icomplex32 *buf);
+
+#endif /* __SOF_MATH_FFT_H__ */
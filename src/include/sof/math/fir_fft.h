@@ -0,0 +1,79 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *
+ * Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+ */
+
+#ifndef __SOF_MATH_FIR_FFT_H__
+#define __SOF_MATH_FIR_FFT_H__
+
+#include <sof/math/fft.h>
+#include <user/fir.h>
+#include <stdint.h>
+
+/* Partition length in samples. The FFT size is twice this and the filter
+ * output is delayed by this many samples.
+ */
+#define FIR_FFT_BLOCK_SIZE	128
+
+/* Spectra of a partitioned impulse response, shared by all channels that
+ * use the same response.
+ */
+struct fir_fft_coef {
+	int partitions;			/* Number of partitions */
+	int shift;			/* Right shift of spectral products */
+	struct icomplex32 *spectra;	/* Spectra of all partitions */
+};
+
+/* Uniformly partitioned overlap-save convolution state of one channel */
+struct fir_fft_state {
+	struct rfft_plan *plan;		/* Shared FFT plan */
+	struct fir_fft_coef *coef;	/* Shared response spectra */
+	struct icomplex32 *fdl;		/* Frequency domain delay line */
+	struct icomplex32 *work;	/* FFT work buffer */
+	int32_t *in;			/* Previous and current input block */
+	int32_t *out;			/* Output block */
+	int fdl_head;			/* Newest input spectrum in fdl */
+	int pos;			/* Sample position in current block */
+};
+
+/* Number of complex bins stored for each partition */
+#define FIR_FFT_BINS	(FIR_FFT_BLOCK_SIZE + 1)
+
+struct rfft_plan *fir_fft_plan_new(void);
+
+int fir_fft_init_coef(struct fir_fft_coef *coef, struct rfft_plan *plan,
+		      struct sof_fir_coef_data *config);
+
+void fir_fft_free_coef(struct fir_fft_coef *coef);
+
+int fir_fft_init(struct fir_fft_state *fft, struct rfft_plan *plan,
+		 struct fir_fft_coef *coef);
+
+void fir_fft_free(struct fir_fft_state *fft);
+
+void fir_fft_block(struct fir_fft_state *fft);
+
+/* Filters one Q1.31 sample. The output is delayed by FIR_FFT_BLOCK_SIZE
+ * samples, a full block is convolved when the input block gets filled.
+ */
+static inline int32_t fir_fft_32(struct fir_fft_state *fft, int32_t x)
+{
+	int32_t y;
+
+	/* Bypass is set with coefficients set to NULL. */
+	if (!fft->coef)
+		return x;
+
+	y = fft->out[fft->pos];
+	fft->in[FIR_FFT_BLOCK_SIZE + fft->pos] = x;
+	if (++fft->pos == FIR_FFT_BLOCK_SIZE) {
+		fir_fft_block(fft);
+		fft->pos = 0;
+	}
+
+	return y;
+}
+
+#endif /* __SOF_MATH_FIR_FFT_H__ */
@@ -0,0 +1,47 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *
+ * Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+ */
+
+#ifndef __SOF_MATH_FIR_NCH_H__
+#define __SOF_MATH_FIR_NCH_H__
+
+#include <sof/math/fir_config.h>
+#include <user/fir.h>
+#include <stdint.h>
+
+/* Max. number of channels that share one response */
+#define FIR_NCH_MAX_CHANNELS	8
+
+/* FIR filter for a group of channels that share the same response. The
+ * delay line is channel interleaved so that every coefficient is loaded
+ * once per frame and applied to all channels of the group. The frame
+ * stride of delay line is kept even for 64 bit loads of channel pairs.
+ */
+struct fir_nch_state_32x16 {
+	int rwi; /* Circular read and write index in frames */
+	int length; /* Number of FIR taps, zero for bypass */
+	int out_shift; /* Amount of right shifts at output */
+	int nch; /* Number of channels in group */
+	int stride; /* Delay line frame length in samples */
+	int channel[FIR_NCH_MAX_CHANNELS]; /* Stream channel of each */
+	int16_t *coef; /* Pointer to FIR coefficients */
+	int32_t *delay; /* Pointer to channel interleaved delay line */
+};
+
+void fir_nch_reset(struct fir_nch_state_32x16 *fir);
+
+int fir_nch_delay_size(struct sof_fir_coef_data *config, int nch);
+
+int fir_nch_init_coef(struct fir_nch_state_32x16 *fir,
+		      struct sof_fir_coef_data *config, int nch);
+
+void fir_nch_init_delay(struct fir_nch_state_32x16 *fir, int32_t **data);
+
+/* Filters one frame of the group channels from x[] to y[] */
+void fir_32x16_nch(struct fir_nch_state_32x16 *fir, const int32_t x[],
+		   int32_t y[]);
+
+#endif /* __SOF_MATH_FIR_NCH_H__ */
@@ -49,6 +49,9 @@
 
 #define IIR_DF2T_NUM_DELAYS 2
 
+/* Max number of channels filtered side by side by iir_df2t_block_nch() */
+#define IIR_DF2T_MAX_LANES 4
+
 struct iir_state_df2t {
 	unsigned int biquads; /* Number of IIR 2nd order sections total */
 	unsigned int biquads_in_series; /* Number of IIR 2nd order sections
@@ -60,4 +63,36 @@ struct iir_state_df2t {
 
 int32_t iir_df2t(struct iir_state_df2t *iir, int32_t x);
 
+/**
+ * \brief Filters a block of Q1.31 samples with a DF2T IIR.
+ *
+ * Output is bit exact with calling iir_df2t() for each sample. The biquad
+ * coefficients and delays are kept in registers over runs of samples.
+ *
+ * \param[in,out] iir Filter state.
+ * \param[in] in Input samples.
+ * \param[out] out Output samples, can be the same as in.
+ * \param[in] frames Number of samples to filter.
+ * \param[in] stride Distance of consecutive samples in in and out, e.g.
+ *	number of interleaved channels.
+ */
+void iir_df2t_block(struct iir_state_df2t *iir, const int32_t *in,
+		    int32_t *out, int frames, int stride);
+
+/**
+ * \brief Filters a block of interleaved Q1.31 frames, one IIR per channel.
+ *
+ * Channels with filters of the same structure are run side by side in
+ * groups of up to IIR_DF2T_MAX_LANES, other channels are filtered with
+ * iir_df2t_block(). Output is bit exact with iir_df2t().
+ *
+ * \param[in,out] iir Array of nch filter states.
+ * \param[in] in Input frames.
+ * \param[out] out Output frames, can be the same as in.
+ * \param[in] frames Number of frames to filter.
+ * \param[in] nch Number of interleaved channels.
+ */
+void iir_df2t_block_nch(struct iir_state_df2t *iir, const int32_t *in,
+			int32_t *out, int frames, int nch);
+
 #endif /* __SOF_MATH_IIR_DF2T_H__ */
@@ -16,6 +16,12 @@
 #define PI_Q4_28      843314857
 #define PI_MUL2_Q4_28     1686629713
 
+#define SINE_NQUART 512 /* Must be 2^N */
+#define SINE_TABLE_SIZE (SINE_NQUART + 1)
+
+/* An 1/4 period of sine wave as Q1.31 */
+extern const int32_t sine_table[SINE_TABLE_SIZE];
+
 int32_t sin_fixed(int32_t w); /* Input is Q4.28, output is Q1.31 */
 
 #endif /* __SOF_MATH_TRIG_H__ */
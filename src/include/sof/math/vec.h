@@ -0,0 +1,110 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *
+ * Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+ */
+
+#ifndef __SOF_MATH_VEC_H__
+#define __SOF_MATH_VEC_H__
+
+#include <stdint.h>
+
+/* Select optimized code variant when xt-xcc compiler is used */
+#if defined __XCC__
+#include <xtensa/config/core-isa.h>
+#if XCHAL_HAVE_HIFI3 == 1
+#define VEC_GENERIC	0
+#define VEC_HIFI3	1
+#else
+#define VEC_GENERIC	1
+#define VEC_HIFI3	0
+#endif /* XCHAL_HAVE_HIFI3 */
+#else
+/* GCC */
+#define VEC_GENERIC	1
+#define VEC_HIFI3	0
+#endif /* __XCC__ */
+
+/* Q formats of the block functions */
+#define VEC_LOG2_OUTPUT_QY	26
+#define VEC_EXP2_INPUT_QY	26
+#define VEC_EXP2_OUTPUT_QY	20
+#define VEC_INV_QY		20
+
+/* Number of polynomial coefficients */
+#define VEC_LOG2_NCOEF		10
+#define VEC_EXP2_NCOEF		7
+#define VEC_RSQRT_NCOEF		3
+
+/* Newton-Raphson iterations after the initial approximation */
+#define VEC_INV_ITERATIONS	3
+#define VEC_RSQRT_ITERATIONS	3
+
+/* Polynomials in Q2.30 or Q3.29, highest order coefficient first */
+extern const int32_t vec_log2_coef[VEC_LOG2_NCOEF];
+extern const int32_t vec_exp2_coef[VEC_EXP2_NCOEF];
+extern const int32_t vec_rsqrt_coef[VEC_RSQRT_NCOEF];
+
+/**
+ * Phase accumulator sine generator state. The phase is an unsigned
+ * fraction of full cycle so that it wraps naturally.
+ */
+struct vec_sin_state {
+	uint32_t phase;		/**< Current phase, Q0.32 cycles */
+	uint32_t step;		/**< Phase increment per sample */
+};
+
+/**
+ * \brief Computes base 2 logarithm of positive integers.
+ * \param[in] x Input samples, the value is interpreted as integer.
+ * \param[out] y Output log2(x) in Q6.26, INT32_MIN for x <= 0.
+ * \param[in] n Number of samples.
+ *
+ * For an input in Qx.qy format subtract qy << 26 from the result.
+ * The maximum measured error is 2.43e-8, about 1.6 LSB of the output.
+ */
+void vec_log2_int32(const int32_t *x, int32_t *y, int n);
+
+/**
+ * \brief Computes power of two.
+ * \param[in] x Input exponents in Q6.26.
+ * \param[out] y Output 2^x in Q12.20, saturated.
+ * \param[in] n Number of samples.
+ */
+void vec_exp2_fixed(const int32_t *x, int32_t *y, int n);
+
+/**
+ * \brief Computes square root.
+ * \param[in] x Input samples in Q1.31, negative values give zero.
+ * \param[out] y Output sqrt(x) in Q1.31.
+ * \param[in] n Number of samples.
+ */
+void vec_sqrt_fixed(const int32_t *x, int32_t *y, int n);
+
+/**
+ * \brief Computes reciprocal.
+ * \param[in] x Input samples in Q12.20.
+ * \param[out] y Output 1 / x in Q12.20, saturated. Zero input gives
+ *		 INT32_MAX.
+ * \param[in] n Number of samples.
+ */
+void vec_inv_fixed(const int32_t *x, int32_t *y, int n);
+
+/**
+ * \brief Sets sine generator frequency and resets the phase.
+ * \param[out] gen Generator state.
+ * \param[in] freq Frequency in Hz in Q16.16, must be below rate / 2.
+ * \param[in] rate Sample rate in Hz.
+ */
+void vec_sin_init(struct vec_sin_state *gen, uint32_t freq, uint32_t rate);
+
+/**
+ * \brief Generates a block of full scale sine wave.
+ * \param[in,out] gen Generator state.
+ * \param[out] y Output samples in Q1.31.
+ * \param[in] n Number of samples.
+ */
+void vec_sin_fixed(struct vec_sin_state *gen, int32_t *y, int n);
+
+#endif /* __SOF_MATH_VEC_H__ */
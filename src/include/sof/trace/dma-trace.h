@@ -8,11 +8,14 @@
 #ifndef __SOF_TRACE_DMA_TRACE_H__
 #define __SOF_TRACE_DMA_TRACE_H__
 
+#include <sof/atomic.h>
+#include <sof/lib/cache.h>
 #include <sof/lib/dma.h>
 #include <sof/schedule/task.h>
 #include <sof/sof.h>
 #include <sof/spinlock.h>
 #include <ipc/trace.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 struct ipc_msg;
@@ -27,6 +30,22 @@ struct dma_trace_buf {
 	uint32_t avail;		/* avail bytes in buffer */
 };
 
+/*
+ * Per-core trace ring, written without locking by its owner core and
+ * drained by the DMA trace work. Positions are free running and each one
+ * owns a cache line.
+ */
+struct dma_trace_ring_pos {
+	atomic_t pos;
+} __aligned(PLATFORM_DCACHE_ALIGN);
+
+struct dma_trace_ring {
+	struct dma_trace_ring_pos w_pos;	/* written by owner core */
+	struct dma_trace_ring_pos r_pos;	/* written by trace work */
+	char *addr;				/* ring base address */
+	uint32_t dropped_entries;		/* amount of dropped entries */
+};
+
 struct dma_trace_data {
 	struct dma_sg_config config;
 	struct dma_trace_buf dmatb;
@@ -42,7 +61,7 @@ struct dma_trace_data {
 	uint32_t dma_copy_align; /**< Minimal chunk of data possible to be
 				   *  copied by dma connected to host
 				   */
-	uint32_t dropped_entries; /* amount of dropped entries */
+	struct dma_trace_ring *rings; /* per-core trace rings */
 	spinlock_t lock; /* dma trace lock */
 };
 
@@ -52,7 +71,7 @@ int dma_trace_host_buffer(struct dma_trace_data *d,
 			  struct dma_sg_elem_array *elem_array,
 			  uint32_t host_size);
 int dma_trace_enable(struct dma_trace_data *d);
-void dma_trace_flush(void *t);
+void dma_trace_flush(void *t, bool panic);
 void dma_trace_on(void);
 void dma_trace_off(void);
 
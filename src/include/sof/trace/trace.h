@@ -132,7 +132,7 @@ struct trace_filter {
 				     ctx, id_1, id_2,			\
 				     format, ##__VA_ARGS__)
 
-void trace_flush(void);
+void trace_flush(bool panic);
 void trace_on(void);
 void trace_off(void);
 void trace_init(struct sof *sof);
@@ -240,7 +240,7 @@ do {									\
 
 #define trace_point(x)  do {} while (0)
 
-static inline void trace_flush(void) { }
+static inline void trace_flush(bool panic) { }
 static inline void trace_on(void) { }
 static inline void trace_off(void) { }
 static inline void trace_init(struct sof *sof) { }
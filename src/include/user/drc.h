@@ -0,0 +1,91 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *
+ * Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+ */
+
+#ifndef __USER_DRC_H__
+#define __USER_DRC_H__
+
+#include <stdint.h>
+#include <user/eq.h>
+
+/* Maximum number of frequency bands */
+#define SOF_DRC_MAX_BANDS 3
+
+/* Maximum number allowed in configuration blob */
+#define SOF_DRC_MAX_SIZE 1024
+
+/* Maximum look-ahead delay in microseconds */
+#define SOF_DRC_MAX_LOOKAHEAD_TIME 20000
+
+/* Limits for static curve parameters in dB */
+#define SOF_DRC_MIN_THRESHOLD_DB -100
+#define SOF_DRC_MAX_KNEE_DB 40
+#define SOF_DRC_MAX_MAKEUP_GAIN_DB 40
+
+ /* drc_band_parameters
+  *     uint32_t enabled
+  *         0 = band is passed through without gain, 1 = compressed.
+  *     int32_t threshold    Q8.24 dB
+  *         Level above which the gain is reduced, e.g. -20 dBFS. Range
+  *         SOF_DRC_MIN_THRESHOLD_DB .. 0.
+  *     int32_t knee         Q8.24 dB
+  *         Width of soft knee region around threshold, 0 for hard knee.
+  *     int32_t slope        Q2.30
+  *         Amount of gain reduction per dB above threshold, equal to
+  *         1 - 1 / ratio. A limiter has slope 1.0 (ratio inf:1).
+  *     int32_t makeup_gain  Q8.24 dB
+  *         Static gain added to the compressed band.
+  *     uint32_t attack_time
+  *         Time constant in microseconds for gain decrease.
+  *     uint32_t release_time
+  *         Time constant in microseconds for gain increase.
+  */
+struct sof_drc_params {
+	uint32_t enabled;
+	int32_t threshold;
+	int32_t knee;
+	int32_t slope;
+	int32_t makeup_gain;
+	uint32_t attack_time;
+	uint32_t release_time;
+
+	/* reserved */
+	uint32_t reserved[4];
+} __attribute__((packed));
+
+ /* drc_configuration
+  *     uint32_t size
+  *         Size of the whole blob in bytes.
+  *     uint32_t num_bands <= SOF_DRC_MAX_BANDS
+  *         1 = full band compressor, n = input is split to n bands with
+  *         LR4 filters in the same way as in a n-way crossover.
+  *     uint32_t lookahead_time
+  *         Delay of the signal in microseconds before gain is applied. The
+  *         gain is computed once per a short block of frames and is ramped
+  *         over the next block, so a limiter does not overshoot when the
+  *         look-ahead is at least two blocks long.
+  *     struct sof_drc_params params[SOF_DRC_MAX_BANDS]
+  *         Parameters of each band from lowest to highest, only the first
+  *         num_bands entries are used.
+  *     struct sof_eq_iir_biquad_df2t coef[]
+  *         The band split LR4 coefficients, as in sof_crossover_config.
+  *         2 bands: [LR4 LP0, LR4 HP0]
+  *         3 bands: [LR4 LP0, LR4 HP0, LR4 LP1, LR4 HP1, LR4 LP2, LR4 HP2]
+  *         There are no coefficients for a single band.
+  */
+struct sof_drc_config {
+	uint32_t size;
+	uint32_t num_bands;
+	uint32_t lookahead_time;
+
+	/* reserved */
+	uint32_t reserved[4];
+
+	struct sof_drc_params params[SOF_DRC_MAX_BANDS];
+	struct sof_eq_iir_biquad_df2t coef[];
+} __attribute__((packed));
+
+#endif /* __USER_DRC_H__ */
@@ -14,7 +14,7 @@
 
 #define SOF_EQ_FIR_IDX_SWITCH	0
 
-#define SOF_EQ_FIR_MAX_SIZE 4096 /* Max size allowed for coef data in bytes */
+#define SOF_EQ_FIR_MAX_SIZE 16384 /* Max size allowed for coef data in bytes */
 
 #define SOF_EQ_FIR_MAX_RESPONSES 8 /* A blob can define max 8 FIR EQs */
 
@@ -28,6 +28,11 @@
  *         can be different from PLATFORM_MAX_CHANNELS.
  *     uint16_t number_of_responses
  *         0=no responses, 1=one response defined, 2=two responses defined, etc.
+ *     uint16_t fft_threshold
+ *         Filter length from which the EQ switches to FFT convolution. If
+ *         any response assigned to channels is this long all channels are
+ *         filtered with FFT convolution for equal delay. Then responses can
+ *         be up to SOF_FIR_FFT_MAX_LENGTH long. 0 = never use FFT.
  *     int16_t data[]
  *         assign_response[channels_in_config]
  *             0 = use first response, 1 = use 2nd response, etc.
@@ -53,9 +58,11 @@ struct sof_eq_fir_config {
 	uint32_t size;
 	uint16_t channels_in_config;
 	uint16_t number_of_responses;
+	uint16_t fft_threshold;
 
 	/* reserved */
-	uint32_t reserved[4];
+	uint16_t reserved16;
+	uint32_t reserved[3];
 
 	int16_t data[];
 } __attribute__((packed));
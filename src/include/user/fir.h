@@ -11,6 +11,7 @@
 #include <stdint.h>
 
 #define SOF_FIR_MAX_LENGTH 256 /* Max length for individual filter */
+#define SOF_FIR_FFT_MAX_LENGTH 4096 /* Max length with FFT convolution */
 
 struct sof_fir_coef_data {
 	int16_t length; /* Number of FIR taps */
@@ -30,6 +30,7 @@
 #include <sof/lib/dma.h>
 #include <sof/lib/mailbox.h>
 #include <sof/lib/memory.h>
+#include <sof/lib/mm_heap.h>
 #include <sof/lib/pm_runtime.h>
 #include <sof/list.h>
 #include <sof/math/numbers.h>
@@ -42,6 +43,7 @@
 #include <sof/trace/trace.h>
 #include <ipc/control.h>
 #include <ipc/dai.h>
+#include <ipc/debug.h>
 #include <ipc/header.h>
 #include <ipc/pm.h>
 #include <ipc/stream.h>
@@ -92,6 +94,22 @@ struct sof_ipc_cmd_hdr *mailbox_validate(void)
 	/* read component values from the inbox */
 	mailbox_hostbox_read(hdr, SOF_IPC_MSG_MAX_SIZE, 0, sizeof(*hdr));
 
+	/* compound messages can fill the whole mailbox, the handler reads
+	 * them from there
+	 */
+	if (iGS(hdr->cmd) == SOF_IPC_GLB_COMPOUND) {
+		if (hdr->size < sizeof(*hdr) ||
+		    hdr->size > MAILBOX_HOSTBOX_SIZE) {
+			tr_err(&ipc_tr, "ipc: invalid compound size 0x%x",
+			       hdr->size);
+			return NULL;
+		}
+
+		platform_shared_commit(hdr, sizeof(*hdr));
+
+		return hdr;
+	}
+
 	/* validate component header */
 	if (hdr->size < sizeof(*hdr) || hdr->size > SOF_IPC_MSG_MAX_SIZE) {
 		tr_err(&ipc_tr, "ipc: invalid size 0x%x", hdr->size);
@@ -1084,6 +1102,42 @@ static int ipc_comp_value(uint32_t header, uint32_t cmd)
 	return ret;
 }
 
+#if CONFIG_PERFORMANCE_COUNTERS
+static int ipc_comp_perf(uint32_t header)
+{
+	struct ipc *ipc = ipc_get();
+	struct ipc_comp_dev *comp_dev;
+	struct sof_ipc_comp_perf perf;
+
+	/* copy message with ABI safe method */
+	IPC_COPY_CMD(perf, ipc->comp_data);
+
+	/* get the component */
+	comp_dev = ipc_get_comp_by_id(ipc, perf.comp_id);
+	if (!comp_dev || comp_dev->type != COMP_TYPE_COMPONENT) {
+		tr_err(&ipc_tr, "ipc: comp %d not found", perf.comp_id);
+		return -ENODEV;
+	}
+
+	/* check core */
+	if (!cpu_is_me(comp_dev->core))
+		return ipc_process_on_core(comp_dev->core);
+
+	tr_dbg(&ipc_tr, "ipc: comp %d -> perf", perf.comp_id);
+
+	comp_perf_get(comp_dev->cd, &perf);
+
+	platform_shared_commit(comp_dev, sizeof(*comp_dev));
+
+	perf.rhdr.hdr.cmd = header;
+	perf.rhdr.hdr.size = sizeof(perf);
+	perf.rhdr.error = 0;
+	mailbox_hostbox_write(0, &perf, sizeof(perf));
+
+	return 1;
+}
+#endif
+
 static int ipc_glb_comp_message(uint32_t header)
 {
 	uint32_t cmd = iCS(header);
@@ -1097,6 +1151,10 @@ static int ipc_glb_comp_message(uint32_t header)
 		return ipc_comp_value(header, COMP_CMD_SET_DATA);
 	case SOF_IPC_COMP_GET_DATA:
 		return ipc_comp_value(header, COMP_CMD_GET_DATA);
+#if CONFIG_PERFORMANCE_COUNTERS
+	case SOF_IPC_COMP_GET_PERF:
+		return ipc_comp_perf(header);
+#endif
 	default:
 		tr_err(&ipc_tr, "ipc: unknown comp cmd 0x%x", cmd);
 		return -EINVAL;
@@ -1281,6 +1339,57 @@ static int ipc_glb_tplg_message(uint32_t header)
 	}
 }
 
+static int ipc_glb_dbg_mem_usage(uint32_t header)
+{
+	struct ipc *ipc = ipc_get();
+	struct sof_ipc_dbg_mem_usage *usage = ipc->comp_data;
+	size_t max_size = MIN(MAILBOX_HOSTBOX_SIZE, SOF_IPC_MSG_MAX_SIZE);
+	int max_elems = (max_size - sizeof(*usage)) / sizeof(usage->elems[0]);
+
+	bzero(usage, sizeof(*usage));
+	usage->num_elems = heap_usage_get(usage->elems, max_elems);
+
+	usage->rhdr.hdr.cmd = header;
+	usage->rhdr.hdr.size = sizeof(*usage) +
+			       usage->num_elems * sizeof(usage->elems[0]);
+	mailbox_hostbox_write(0, usage, usage->rhdr.hdr.size);
+
+	return 1;
+}
+
+static int ipc_glb_dbg_mem_owners(uint32_t header)
+{
+	struct ipc *ipc = ipc_get();
+	struct sof_ipc_dbg_mem_owners *owners = ipc->comp_data;
+	size_t max_size = MIN(MAILBOX_HOSTBOX_SIZE, SOF_IPC_MSG_MAX_SIZE);
+	int max_elems = (max_size - sizeof(*owners)) / sizeof(owners->elems[0]);
+
+	bzero(owners, sizeof(*owners));
+	owners->num_elems = heap_owners_get(owners->elems, max_elems);
+
+	owners->rhdr.hdr.cmd = header;
+	owners->rhdr.hdr.size = sizeof(*owners) +
+				owners->num_elems * sizeof(owners->elems[0]);
+	mailbox_hostbox_write(0, owners, owners->rhdr.hdr.size);
+
+	return 1;
+}
+
+static int ipc_glb_dbg_message(uint32_t header)
+{
+	uint32_t cmd = iCS(header);
+
+	switch (cmd) {
+	case SOF_IPC_DEBUG_MEM_USAGE:
+		return ipc_glb_dbg_mem_usage(header);
+	case SOF_IPC_DEBUG_MEM_OWNERS:
+		return ipc_glb_dbg_mem_owners(header);
+	default:
+		tr_err(&ipc_tr, "ipc: unknown debug cmd 0x%x", cmd);
+		return -EINVAL;
+	}
+}
+
 #if CONFIG_DEBUG
 static int ipc_glb_test_message(uint32_t header)
 {
@@ -1297,66 +1406,275 @@ static int ipc_glb_test_message(uint32_t header)
 #endif
 
 /*
- * Global IPC Operations.
+ * Compound IPC Operations.
  */
 
-void ipc_cmd(struct sof_ipc_cmd_hdr *hdr)
+#define iGCS(x) ((x) & (SOF_GLB_TYPE_MASK | SOF_CMD_TYPE_MASK))
+
+static int ipc_glb_message(uint32_t header);
+
+/* Status of a command, the reply of a command that created its own reply
+ * is in the outbox.
+ */
+static int32_t ipc_compound_status(int ret)
 {
 	struct sof_ipc_reply reply;
-	uint32_t type = 0;
+
+	if (ret <= 0)
+		return ret;
+
+	mailbox_hostbox_read(&reply, sizeof(reply), 0, sizeof(reply));
+
+	return reply.error;
+}
+
+/* Frees an object created by a compound command. The free message is
+ * built in comp_data so that it can be forwarded to another core too.
+ */
+static void ipc_compound_free(uint32_t cmd, uint32_t id)
+{
+	struct ipc *ipc = ipc_get();
+	struct sof_ipc_free *ipc_free = ipc->comp_data;
 	int ret;
 
-	if (!hdr) {
-		tr_err(&ipc_tr, "ipc: invalid IPC header.");
-		ret = -EINVAL;
-		goto out;
+	ipc_free->hdr.cmd = SOF_IPC_GLB_TPLG_MSG | cmd;
+	ipc_free->hdr.size = sizeof(*ipc_free);
+	ipc_free->id = id;
+
+	tr_info(&ipc_tr, "ipc: compound rollback 0x%x id %d", cmd, id);
+
+	ret = ipc_glb_tplg_message(ipc_free->hdr.cmd);
+	if (ret < 0)
+		tr_err(&ipc_tr, "ipc: compound rollback of %d failed %d",
+		       id, ret);
+}
+
+/* compound messages fill the host mailbox, the reply is written there */
+#define IPC_COMPOUND_MAX_CMDS \
+	SOF_IPC_COMPOUND_MAX_CMDS(MAILBOX_HOSTBOX_SIZE, MAILBOX_HOSTBOX_SIZE)
+#define IPC_COMPOUND_REPLY_CMDS \
+	SOF_IPC_COMPOUND_REPLY_CMDS(MAILBOX_HOSTBOX_SIZE)
+
+/* Frees the objects created by the executed commands of the message,
+ * buffers first to disconnect them, then components and pipelines.
+ */
+static void ipc_compound_rollback(const uint8_t *msg,
+				  const struct sof_ipc_compound_reply *reply)
+{
+	static const uint32_t rollback[][2] = {
+		{ SOF_IPC_TPLG_BUFFER_NEW, SOF_IPC_TPLG_BUFFER_FREE },
+		{ SOF_IPC_TPLG_COMP_NEW, SOF_IPC_TPLG_COMP_FREE },
+		{ SOF_IPC_TPLG_PIPE_NEW, SOF_IPC_TPLG_PIPE_FREE },
+	};
+	struct sof_ipc_compound_hdr block;
+	struct sof_ipc_cmd_hdr hdr;
+	uint32_t offset;
+	uint32_t index;
+	uint32_t id;
+	uint32_t i;
+	int pass;
+
+	for (pass = 0; pass < ARRAY_SIZE(rollback); pass++) {
+		offset = sizeof(hdr);
+		index = 0;
+		while (index < reply->count) {
+			memcpy_s(&block, sizeof(block), msg + offset,
+				 sizeof(block));
+			offset += block.hdr.size;
+			for (i = 0; i < block.count && index < reply->count;
+			     i++, index++) {
+				memcpy_s(&hdr, sizeof(hdr), msg + offset,
+					 sizeof(hdr));
+				if (!reply->status[index] &&
+				    hdr.size >= sizeof(hdr) + sizeof(id) &&
+				    iGCS(hdr.cmd) == (SOF_IPC_GLB_TPLG_MSG |
+						      rollback[pass][0])) {
+					/* object id follows the header */
+					memcpy_s(&id, sizeof(id),
+						 msg + offset + sizeof(hdr),
+						 sizeof(id));
+					ipc_compound_free(rollback[pass][1],
+							  id);
+				}
+				offset += hdr.size;
+			}
+		}
 	}
+}
 
-	type = iGS(hdr->cmd);
+static int ipc_glb_compound(uint32_t header)
+{
+	struct ipc *ipc = ipc_get();
+	struct sof_ipc_cmd_hdr *hdr = ipc->comp_data;
+	struct sof_ipc_compound_reply *reply;
+	struct sof_ipc_compound_hdr block;
+	struct sof_ipc_cmd_hdr cmd_hdr;
+	size_t reply_size;
+	uint32_t max_cmds;
+	uint32_t offset;
+	uint32_t size = hdr->size;
+	uint32_t i;
+	uint8_t *msg;
+	int ret = 0;
+
+	if (size < sizeof(*hdr) || size > MAILBOX_HOSTBOX_SIZE) {
+		tr_err(&ipc_tr, "ipc: compound size %d invalid", size);
+		return -EINVAL;
+	}
+
+	/* the commands overwrite comp_data and their replies the mailbox,
+	 * so work on a copy of the message
+	 */
+	if (size < sizeof(*hdr) + sizeof(block))
+		max_cmds = 0;
+	else
+		max_cmds = MIN(IPC_COMPOUND_MAX_CMDS,
+			       SOF_IPC_COMPOUND_MSG_CMDS(size));
+	reply_size = sizeof(*reply) + max_cmds * sizeof(reply->status[0]);
+	reply = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			reply_size + size);
+	if (!reply) {
+		tr_err(&ipc_tr, "ipc: compound of %d bytes alloc failed", size);
+		return -ENOMEM;
+	}
+
+	msg = (uint8_t *)reply + reply_size;
+	mailbox_hostbox_read(msg, size, 0, size);
+
+	/* offset never exceeds size, so size - offset can't wrap */
+	offset = sizeof(*hdr);
+	while (!ret && sizeof(block) <= size - offset) {
+		memcpy_s(&block, sizeof(block), msg + offset, sizeof(block));
+		if (!block.count)
+			break;
+
+		if (block.hdr.size < sizeof(block) ||
+		    block.hdr.size > size - offset ||
+		    block.count > max_cmds - reply->count) {
+			tr_err(&ipc_tr, "ipc: compound block 0x%x count %d invalid",
+			       block.hdr.cmd, block.count);
+			ret = -EINVAL;
+			break;
+		}
+
+		/* the status of each command must fit the reply */
+		if (block.count > IPC_COMPOUND_REPLY_CMDS - reply->count) {
+			tr_err(&ipc_tr, "ipc: compound replies of %d commands don't fit",
+			       reply->count + block.count);
+			ret = -EINVAL;
+			break;
+		}
+
+		offset += block.hdr.size;
+		for (i = 0; i < block.count; i++) {
+			/* validate and copy the command for the handler */
+			if (sizeof(cmd_hdr) > size - offset) {
+				ret = -EINVAL;
+				break;
+			}
+
+			memcpy_s(&cmd_hdr, sizeof(cmd_hdr), msg + offset,
+				 sizeof(cmd_hdr));
+			if (cmd_hdr.size < sizeof(cmd_hdr) ||
+			    cmd_hdr.size > SOF_IPC_MSG_MAX_SIZE ||
+			    cmd_hdr.size > size - offset ||
+			    iGCS(cmd_hdr.cmd) != iGCS(block.hdr.cmd) ||
+			    iGS(cmd_hdr.cmd) == SOF_IPC_GLB_COMPOUND) {
+				tr_err(&ipc_tr, "ipc: compound cmd 0x%x size %d invalid",
+				       cmd_hdr.cmd, cmd_hdr.size);
+				ret = -EINVAL;
+				break;
+			}
+
+			memcpy_s(ipc->comp_data, SOF_IPC_MSG_MAX_SIZE,
+				 msg + offset, cmd_hdr.size);
+			platform_shared_commit(ipc->comp_data, cmd_hdr.size);
+
+			ret = ipc_compound_status(ipc_glb_message(cmd_hdr.cmd));
+			reply->status[reply->count++] = ret;
+			offset += cmd_hdr.size;
+			if (ret < 0) {
+				tr_err(&ipc_tr, "ipc: compound cmd %d 0x%x failed %d",
+				       reply->count - 1, cmd_hdr.cmd, ret);
+				break;
+			}
+		}
+	}
+
+	if (ret < 0)
+		ipc_compound_rollback(msg, reply);
+
+	tr_info(&ipc_tr, "ipc: compound of %d commands returned %d",
+		reply->count, ret);
+
+	reply->rhdr.error = ret;
+	reply->rhdr.hdr.cmd = header;
+	reply->rhdr.hdr.size = sizeof(*reply) +
+		reply->count * sizeof(reply->status[0]);
+	mailbox_hostbox_write(0, reply, reply->rhdr.hdr.size);
+
+	rfree(reply);
+
+	return 1;
+}
+
+/*
+ * Global IPC Operations.
+ */
+
+static int ipc_glb_message(uint32_t header)
+{
+	uint32_t type = iGS(header);
 
 	switch (type) {
 	case SOF_IPC_GLB_REPLY:
-		ret = 0;
-		break;
+		return 0;
 	case SOF_IPC_GLB_COMPOUND:
-		ret = -EINVAL;	/* TODO */
-		break;
+		return ipc_glb_compound(header);
 	case SOF_IPC_GLB_TPLG_MSG:
-		ret = ipc_glb_tplg_message(hdr->cmd);
-		break;
+		return ipc_glb_tplg_message(header);
 	case SOF_IPC_GLB_PM_MSG:
-		ret = ipc_glb_pm_message(hdr->cmd);
-		break;
+		return ipc_glb_pm_message(header);
 	case SOF_IPC_GLB_COMP_MSG:
-		ret = ipc_glb_comp_message(hdr->cmd);
-		break;
+		return ipc_glb_comp_message(header);
 	case SOF_IPC_GLB_STREAM_MSG:
-		ret = ipc_glb_stream_message(hdr->cmd);
-		break;
+		return ipc_glb_stream_message(header);
 	case SOF_IPC_GLB_DAI_MSG:
-		ret = ipc_glb_dai_message(hdr->cmd);
-		break;
+		return ipc_glb_dai_message(header);
 	case SOF_IPC_GLB_TRACE_MSG:
-		ret = ipc_glb_debug_message(hdr->cmd);
-		break;
+		return ipc_glb_debug_message(header);
 	case SOF_IPC_GLB_GDB_DEBUG:
-		ret = ipc_glb_gdb_debug(hdr->cmd);
-		break;
+		return ipc_glb_gdb_debug(header);
 	case SOF_IPC_GLB_PROBE:
-		ret = ipc_glb_probe(hdr->cmd);
-		break;
+		return ipc_glb_probe(header);
+	case SOF_IPC_GLB_DEBUG:
+		return ipc_glb_dbg_message(header);
 #if CONFIG_DEBUG
 	case SOF_IPC_GLB_TEST:
-		ret = ipc_glb_test_message(hdr->cmd);
-		break;
+		return ipc_glb_test_message(header);
 #endif
 	default:
 		tr_err(&ipc_tr, "ipc: unknown command type %u", type);
+		return -EINVAL;
+	}
+}
+
+void ipc_cmd(struct sof_ipc_cmd_hdr *hdr)
+{
+	struct sof_ipc_reply reply;
+	uint32_t type = 0;
+	int ret;
+
+	if (!hdr) {
+		tr_err(&ipc_tr, "ipc: invalid IPC header.");
 		ret = -EINVAL;
-		break;
+		goto out;
 	}
 
-	platform_shared_commit(hdr, hdr->size);
+	type = iGS(hdr->cmd);
+	ret = ipc_glb_message(hdr->cmd);
+
+	platform_shared_commit(hdr, MIN(hdr->size, SOF_IPC_MSG_MAX_SIZE));
 
 out:
 	tr_dbg(&ipc_tr, "ipc: last request 0x%x returned %d", type, ret);
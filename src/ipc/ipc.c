@@ -64,17 +64,37 @@ int ipc_process_on_core(uint32_t core)
 
 /*
  * Components, buffers and pipelines all use the same set of monotonic ID
- * numbers passed in by the host. They are stored in different lists, hence
- * more than 1 list may need to be searched for the corresponding component.
+ * numbers passed in by the host. They are kept in one list for iteration
+ * and hashed by ID and by pipeline ID, so lookups only need to search the
+ * few devices in one bucket.
  */
 
+static void ipc_comp_dev_add(struct ipc *ipc, struct ipc_comp_dev *icd)
+{
+	uint32_t ppl_id = ipc_comp_pipe_id(icd);
+
+	list_item_append(&icd->list, &ipc->comp_list);
+	list_item_prepend(&icd->id_list,
+			  &ipc->comp_hash[IPC_COMP_HASH(icd->id)]);
+
+	/* keep creation order within a pipeline for ipc_get_ppl_comp() */
+	list_item_append(&icd->ppl_list, &ipc->ppl_hash[IPC_COMP_HASH(ppl_id)]);
+}
+
+void ipc_comp_dev_del(struct ipc_comp_dev *icd)
+{
+	list_item_del(&icd->list);
+	list_item_del(&icd->id_list);
+	list_item_del(&icd->ppl_list);
+}
+
 struct ipc_comp_dev *ipc_get_comp_by_id(struct ipc *ipc, uint32_t id)
 {
 	struct ipc_comp_dev *icd;
 	struct list_item *clist;
 
-	list_for_item(clist, &ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
+	list_for_item(clist, &ipc->comp_hash[IPC_COMP_HASH(id)]) {
+		icd = container_of(clist, struct ipc_comp_dev, id_list);
 		if (icd->id == id)
 			return icd;
 
@@ -90,8 +110,8 @@ struct ipc_comp_dev *ipc_get_comp_by_ppl_id(struct ipc *ipc, uint16_t type,
 	struct ipc_comp_dev *icd;
 	struct list_item *clist;
 
-	list_for_item(clist, &ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
+	list_for_item(clist, &ipc->ppl_hash[IPC_COMP_HASH(ppl_id)]) {
+		icd = container_of(clist, struct ipc_comp_dev, ppl_list);
 		if (icd->type != type) {
 			platform_shared_commit(icd, sizeof(*icd));
 			continue;
@@ -114,14 +134,15 @@ struct ipc_comp_dev *ipc_get_comp_by_ppl_id(struct ipc *ipc, uint16_t type,
 static struct ipc_comp_dev *ipc_get_ppl_comp(struct ipc *ipc,
 					     uint32_t pipeline_id, int dir)
 {
+	struct list_item *bucket = &ipc->ppl_hash[IPC_COMP_HASH(pipeline_id)];
 	struct ipc_comp_dev *icd;
 	struct comp_buffer *buffer;
 	struct comp_dev *buff_comp;
 	struct list_item *clist;
 
 	/* first try to find the module in the pipeline */
-	list_for_item(clist, &ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
+	list_for_item(clist, bucket) {
+		icd = container_of(clist, struct ipc_comp_dev, ppl_list);
 		if (icd->type != COMP_TYPE_COMPONENT) {
 			platform_shared_commit(icd, sizeof(*icd));
 			continue;
@@ -140,8 +161,8 @@ static struct ipc_comp_dev *ipc_get_ppl_comp(struct ipc *ipc,
 	}
 
 	/* it's connected pipeline, so find the connected module */
-	list_for_item(clist, &ipc->comp_list) {
-		icd = container_of(clist, struct ipc_comp_dev, list);
+	list_for_item(clist, bucket) {
+		icd = container_of(clist, struct ipc_comp_dev, ppl_list);
 		if (icd->type != COMP_TYPE_COMPONENT) {
 			platform_shared_commit(icd, sizeof(*icd));
 			continue;
@@ -201,7 +222,7 @@ int ipc_comp_new(struct ipc *ipc, struct sof_ipc_comp *comp)
 	icd->id = comp->id;
 
 	/* add new component to the list */
-	list_item_append(&icd->list, &ipc->comp_list);
+	ipc_comp_dev_add(ipc, icd);
 
 	platform_shared_commit(icd, sizeof(*icd));
 
@@ -227,6 +248,7 @@ int ipc_comp_free(struct ipc *ipc, uint32_t comp_id)
 
 	/* set pipeline sink/source/sched pointers to NULL if needed */
 	if (icd->cd->pipeline) {
+		pipeline_schedule_invalidate(icd->cd->pipeline);
 		if (icd->cd == icd->cd->pipeline->source_comp)
 			icd->cd->pipeline->source_comp = NULL;
 		if (icd->cd == icd->cd->pipeline->sink_comp)
@@ -240,7 +262,7 @@ int ipc_comp_free(struct ipc *ipc, uint32_t comp_id)
 
 	icd->cd = NULL;
 
-	list_item_del(&icd->list);
+	ipc_comp_dev_del(icd);
 	rfree(icd);
 
 	return 0;
@@ -279,7 +301,7 @@ int ipc_buffer_new(struct ipc *ipc, struct sof_ipc_buffer *desc)
 	ibd->id = desc->comp.id;
 
 	/* add new buffer to the list */
-	list_item_append(&ibd->list, &ipc->comp_list);
+	ipc_comp_dev_add(ipc, ibd);
 
 	platform_shared_commit(ibd, sizeof(*ibd));
 
@@ -318,7 +340,7 @@ int ipc_buffer_free(struct ipc *ipc, uint32_t buffer_id)
 
 	/* free buffer and remove from list */
 	buffer_free(ibd->cb);
-	list_item_del(&ibd->list);
+	ipc_comp_dev_del(ibd);
 	rfree(ibd);
 
 	return 0;
@@ -493,7 +515,7 @@ int ipc_pipeline_new(struct ipc *ipc,
 	ipc_pipe->id = pipe_desc->comp_id;
 
 	/* add new pipeline to the list */
-	list_item_append(&ipc_pipe->list, &ipc->comp_list);
+	ipc_comp_dev_add(ipc, ipc_pipe);
 
 	platform_shared_commit(ipc_pipe, sizeof(*ipc_pipe));
 
@@ -521,7 +543,7 @@ int ipc_pipeline_free(struct ipc *ipc, uint32_t comp_id)
 		return ret;
 	}
 	ipc_pipe->pipeline = NULL;
-	list_item_del(&ipc_pipe->list);
+	ipc_comp_dev_del(ipc_pipe);
 	rfree(ipc_pipe);
 
 	return 0;
@@ -665,6 +687,8 @@ out:
 
 int ipc_init(struct sof *sof)
 {
+	int i;
+
 	tr_info(&ipc_tr, "ipc_init()");
 
 	/* init ipc data */
@@ -676,6 +700,10 @@ int ipc_init(struct sof *sof)
 	spinlock_init(&sof->ipc->lock);
 	list_init(&sof->ipc->msg_list);
 	list_init(&sof->ipc->comp_list);
+	for (i = 0; i < IPC_COMP_HASH_SIZE; i++) {
+		list_init(&sof->ipc->comp_hash[i]);
+		list_init(&sof->ipc->ppl_hash[i]);
+	}
 
 	return platform_ipc_init(sof->ipc);
 }
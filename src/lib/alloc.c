@@ -6,6 +6,7 @@
 //         Keyon Jie <yang.jie@linux.intel.com>
 
 #include <sof/debug/panic.h>
+#include <sof/drivers/interrupt.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
 #include <sof/lib/cpu.h>
@@ -13,9 +14,11 @@
 #include <sof/lib/memory.h>
 #include <sof/lib/mm_heap.h>
 #include <sof/lib/uuid.h>
+#include <sof/list.h>
 #include <sof/math/numbers.h>
 #include <sof/spinlock.h>
 #include <sof/string.h>
+#include <ipc/debug.h>
 #include <ipc/topology.h>
 #include <ipc/trace.h>
 
@@ -211,6 +214,66 @@ static void *align_ptr(struct mm_heap *heap, uint32_t alignment,
 	return (char *)ptr + mod_align;
 }
 
+/* heap owner set by a core, never touched by other cores */
+struct heap_core_owner {
+	const struct sof_uuid_entry *uid;
+	uint8_t index;		/* slot of uid in mm owners table */
+	bool resolved;		/* index is valid for uid */
+} __aligned(PLATFORM_DCACHE_ALIGN);
+
+static struct heap_core_owner heap_core_owner[PLATFORM_CORE_COUNT];
+
+/* find owners table slot for uid, claims a free one on first use */
+static uint8_t heap_owner_index(struct mm *memmap,
+				const struct sof_uuid_entry *uid)
+{
+	int i;
+
+	if (!uid)
+		return 0;
+
+	for (i = 1; i < HEAP_OWNER_COUNT; i++) {
+		if (!memmap->owners[i].uid)
+			memmap->owners[i].uid = uid;
+
+		if (memmap->owners[i].uid == uid)
+			return i;
+	}
+
+	/* table is full, account as unattributed */
+	return 0;
+}
+
+/* owners table slot of the calling core, called with the heap lock held */
+static uint8_t heap_owner_get(struct mm *memmap)
+{
+	struct heap_core_owner *owner = heap_core_owner + cpu_get_id();
+
+	if (!owner->resolved) {
+		owner->index = heap_owner_index(memmap, owner->uid);
+		owner->resolved = true;
+	}
+
+	return owner->index;
+}
+
+/* account allocated blocks to the heap and to the current owner */
+static void heap_alloc_account(struct mm_heap *heap, struct block_hdr *hdr,
+			       uint32_t bytes)
+{
+	struct mm *memmap = memmap_get();
+	struct mm_owner *owner;
+
+	heap->info.used += bytes;
+	heap->info.free -= bytes;
+	heap->used_peak = MAX(heap->used_peak, heap->info.used);
+
+	hdr->owner = heap_owner_get(memmap);
+	owner = memmap->owners + hdr->owner;
+	owner->used += bytes;
+	owner->used_peak = MAX(owner->used_peak, owner->used);
+}
+
 /* allocate single block */
 static void *alloc_block(struct mm_heap *heap, int level,
 			 uint32_t caps, uint32_t alignment)
@@ -229,8 +292,7 @@ static void *alloc_block(struct mm_heap *heap, int level,
 	hdr->size = 1;
 	hdr->used = 1;
 
-	heap->info.used += map->block_size;
-	heap->info.free -= map->block_size;
+	heap_alloc_account(heap, hdr, map->block_size);
 
 	/* find next free */
 	for (i = map->first_free; i < map->count; ++i) {
@@ -294,8 +356,8 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 
 	ptr = align_ptr(heap, alignment, ptr, hdr);
 
-	heap->info.used += count * map->block_size;
-	heap->info.free -= count * map->block_size;
+	heap_alloc_account(heap, hdr, count * map->block_size);
+
 	/* update first_free if needed */
 	if (map->first_free == start)
 		/* find first available free block */
@@ -438,6 +500,7 @@ static void *get_ptr_from_heap(struct mm_heap *heap, uint32_t flags,
 /* free block(s) */
 static void free_block(void *ptr)
 {
+	struct mm *memmap = memmap_get();
 	struct mm_heap *heap;
 	struct block_map *block_map = NULL;
 	struct block_hdr *hdr;
@@ -499,11 +562,13 @@ static void free_block(void *ptr)
 
 	/* free block header and continuous blocks */
 	used_blocks = block + hdr->size;
+	memmap->owners[hdr->owner].used -= hdr->size * block_map->block_size;
 
 	for (i = block; i < used_blocks; i++) {
 		hdr = &block_map->block[i];
 		hdr->size = 0;
 		hdr->used = 0;
+		hdr->owner = 0;
 		hdr->unaligned_ptr = NULL;
 		block_map->free_count++;
 		heap->info.used -= block_map->block_size;
@@ -531,6 +596,149 @@ static void free_block(void *ptr)
 	platform_shared_commit(heap, sizeof(*heap));
 }
 
+/* largest run of free blocks within a single map, in bytes */
+static uint32_t heap_largest_free(struct mm_heap *heap)
+{
+	struct block_map *map;
+	uint32_t largest = 0;
+	uint32_t run;
+	int i;
+	int j;
+
+	for (i = 0; i < heap->blocks; i++) {
+		map = &heap->map[i];
+		run = 0;
+
+		for (j = map->first_free; j < map->count; j++) {
+			if (map->block[j].used) {
+				run = 0;
+				continue;
+			}
+
+			run++;
+			largest = MAX(largest, run * map->block_size);
+		}
+
+		platform_shared_commit(map, sizeof(*map));
+	}
+
+	return largest;
+}
+
+void heap_owner_set(const struct sof_uuid_entry *uid)
+{
+	struct heap_core_owner *owner = heap_core_owner + cpu_get_id();
+
+	/* only ever used by this core, no locking or commit needed */
+	if (owner->uid != uid) {
+		owner->uid = uid;
+		owner->resolved = false;
+	}
+}
+
+/* count request that the whole zone failed to serve, called with lock held */
+static void heap_alloc_fail(struct mm *memmap, enum mem_zone zone,
+			    uint32_t caps)
+{
+	struct mm_heap *heap = NULL;
+
+	switch (zone) {
+	case SOF_MEM_ZONE_SYS_RUNTIME:
+		heap = memmap->system_runtime + cpu_get_id();
+		break;
+	case SOF_MEM_ZONE_RUNTIME:
+		heap = get_heap_from_caps(memmap->runtime,
+					  PLATFORM_HEAP_RUNTIME, caps);
+		if (heap)
+			break;
+		/* runtime requests fall back to the buffer heaps */
+		/* fall through */
+	case SOF_MEM_ZONE_BUFFER:
+		heap = get_heap_from_caps(memmap->buffer, PLATFORM_HEAP_BUFFER,
+					  caps);
+		break;
+	default:
+		break;
+	}
+
+	if (heap)
+		heap->alloc_fails++;
+
+	memmap->owners[heap_owner_get(memmap)].alloc_fails++;
+}
+
+static int heap_usage_fill(struct sof_ipc_dbg_mem_usage_elem *elems, int max,
+			   enum mem_zone zone, struct mm_heap *heap, int count)
+{
+	int i;
+
+	for (i = 0; i < count && i < max; i++, heap++) {
+		elems[i].zone = zone;
+		elems[i].id = i;
+		elems[i].caps = heap->caps;
+		elems[i].size = heap->size;
+		elems[i].used = heap->info.used;
+		elems[i].used_peak = heap->used_peak;
+		elems[i].largest_free = heap_largest_free(heap);
+		elems[i].alloc_fails = heap->alloc_fails;
+
+		platform_shared_commit(heap, sizeof(*heap));
+	}
+
+	return i;
+}
+
+int heap_usage_get(struct sof_ipc_dbg_mem_usage_elem *elems, int max)
+{
+	struct mm *memmap = memmap_get();
+	uint32_t flags;
+	int n;
+
+	spin_lock_irq(&memmap->lock, flags);
+
+	n = heap_usage_fill(elems, max, SOF_MEM_ZONE_SYS_RUNTIME,
+			    memmap->system_runtime,
+			    PLATFORM_HEAP_SYSTEM_RUNTIME);
+	n += heap_usage_fill(elems + n, max - n, SOF_MEM_ZONE_RUNTIME,
+			     memmap->runtime, PLATFORM_HEAP_RUNTIME);
+	n += heap_usage_fill(elems + n, max - n, SOF_MEM_ZONE_BUFFER,
+			     memmap->buffer, PLATFORM_HEAP_BUFFER);
+
+	spin_unlock_irq(&memmap->lock, flags);
+
+	platform_shared_commit(memmap, sizeof(*memmap));
+
+	return n;
+}
+
+int heap_owners_get(struct sof_ipc_dbg_mem_owner_elem *elems, int max)
+{
+	struct mm *memmap = memmap_get();
+	struct mm_owner *owner;
+	uint32_t flags;
+	int i;
+
+	spin_lock_irq(&memmap->lock, flags);
+
+	/* slots are claimed in order, stop at the first unused one */
+	for (i = 0; i < HEAP_OWNER_COUNT && i < max; i++) {
+		owner = memmap->owners + i;
+		if (i && !owner->uid)
+			break;
+
+		elems[i].uuid_key = (uint32_t)(uintptr_t)owner->uid;
+		elems[i].used = owner->used;
+		elems[i].used_peak = owner->used_peak;
+		elems[i].alloc_fails = owner->alloc_fails;
+	}
+
+	spin_unlock_irq(&memmap->lock, flags);
+
+	platform_shared_commit(memmap, sizeof(*memmap));
+
+	return i;
+}
+
 #if CONFIG_DEBUG_HEAP
 
 static void trace_heap_blocks(struct mm_heap *heap)
@@ -542,6 +750,8 @@ static void trace_heap_blocks(struct mm_heap *heap)
 	       heap->size, heap->blocks, heap->caps);
 	tr_err(&mem_tr, " used %d free %d", heap->info.used,
 	       heap->info.free);
+	tr_err(&mem_tr, " peak %d largest free %d fails %d",
+	       heap->used_peak, heap_largest_free(heap), heap->alloc_fails);
 
 	for (i = 0; i < heap->blocks; i++) {
 		block_map = &heap->map[i];
@@ -709,6 +919,8 @@ void *rmalloc(enum mem_zone zone, uint32_t flags, uint32_t caps, size_t bytes)
 	spin_lock_irq(&memmap->lock, lock_flags);
 
 	ptr = _malloc_unlocked(zone, flags, caps, bytes);
+	if (!ptr)
+		heap_alloc_fail(memmap, zone, caps);
 
 	spin_unlock_irq(&memmap->lock, lock_flags);
 
@@ -746,6 +958,126 @@ void *rzalloc_core_sys(int core, size_t bytes)
 	return ptr;
 }
 
+/* object size rounded so pooled objects never share a cache line */
+static inline uint32_t pool_obj_size(struct mm_pool *pool)
+{
+	return ALIGN_UP(MAX(pool->size, sizeof(void *)), PLATFORM_DCACHE_ALIGN);
+}
+
+/* puts a new slab on the free list of the calling core */
+static void pool_grow(struct mm_pool *pool, struct mm_pool_core *pc)
+{
+	struct mm *memmap = memmap_get();
+	uint32_t obj_size = pool_obj_size(pool);
+	uint32_t objs = pool->slab_objs;
+	uint32_t lock_flags;
+	char *slab;
+	void **obj;
+	int i;
+
+	spin_lock_irq(&memmap->lock, lock_flags);
+
+	/* settle for a smaller slab if no heap block fits a full one */
+	do {
+		slab = _malloc_unlocked(SOF_MEM_ZONE_RUNTIME, pool->flags,
+					SOF_MEM_CAPS_RAM, obj_size * objs);
+	} while (!slab && (objs >>= 1));
+
+	if (slab) {
+		spin_lock(&pool->lock);
+		if (!pool->slabs++)
+			list_item_append(&pool->list, &memmap->pools);
+		spin_unlock(&pool->lock);
+	} else {
+		heap_alloc_fail(memmap, SOF_MEM_ZONE_RUNTIME,
+				SOF_MEM_CAPS_RAM);
+	}
+
+	platform_shared_commit(memmap, sizeof(*memmap));
+
+	spin_unlock_irq(&memmap->lock, lock_flags);
+
+	if (!slab) {
+		tr_err(&mem_tr, "pool_grow(): pool %d can't alloc an object",
+		       pool->id);
+		return;
+	}
+
+	/* link objects in slab order so they are handed out sequentially */
+	for (i = objs - 1; i >= 0; i--) {
+		obj = (void **)(slab + i * obj_size);
+		*obj = pc->free;
+		pc->free = obj;
+	}
+
+	pc->free_count += objs;
+}
+
+void *rpool_alloc(struct mm_pool *pool)
+{
+	struct mm_pool_core *pc = pool->core + cpu_get_id();
+	uint32_t used = 0;
+	uint32_t flags;
+	void *ptr;
+	int i;
+
+	irq_local_disable(flags);
+
+	if (!pc->free)
+		pool_grow(pool, pc);
+
+	ptr = pc->free;
+	if (ptr) {
+		pc->free = *(void **)ptr;
+		pc->free_count--;
+		pc->used++;
+
+		for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+			used += pool->core[i].used;
+
+		/* the lock is only taken when a new peak is reached */
+		if (used > pool->peak) {
+			spin_lock(&pool->lock);
+			pool->peak = MAX(pool->peak, used);
+			spin_unlock(&pool->lock);
+		}
+	}
+
+	irq_local_enable(flags);
+
+	return ptr;
+}
+
+void *rpool_zalloc(struct mm_pool *pool)
+{
+	void *ptr;
+
+	ptr = rpool_alloc(pool);
+	if (ptr)
+		bzero(ptr, pool->size);
+
+	return ptr;
+}
+
+void rpool_free(struct mm_pool *pool, void *ptr)
+{
+	struct mm_pool_core *pc = pool->core + cpu_get_id();
+	uint32_t flags;
+
+	/* sanity check - NULL ptrs are fine */
+	if (!ptr)
+		return;
+
+	irq_local_disable(flags);
+
+	*(void **)ptr = pc->free;
+	pc->free = ptr;
+	pc->free_count++;
+	pc->used--;
+
+	irq_local_enable(flags);
+}
+
 /* allocates continuous buffers - not for direct use, clients use rballoc() */
 static void *alloc_heap_buffer(struct mm_heap *heap, uint32_t flags,
 			       uint32_t caps, size_t bytes, uint32_t alignment)
@@ -864,6 +1196,8 @@ void *rballoc_align(uint32_t flags, uint32_t caps, size_t bytes,
 	spin_lock_irq(&memmap->lock, lock_flags);
 
 	ptr = _balloc_unlocked(flags, caps, bytes, alignment);
+	if (!ptr)
+		heap_alloc_fail(memmap, SOF_MEM_ZONE_BUFFER, caps);
 
 	spin_unlock_irq(&memmap->lock, lock_flags);
 
@@ -926,6 +1260,8 @@ void *rbrealloc_align(void *ptr, uint32_t flags, uint32_t caps, size_t bytes,
 	spin_lock_irq(&memmap->lock, lock_flags);
 
 	new_ptr = _balloc_unlocked(flags, caps, bytes, alignment);
+	if (!new_ptr)
+		heap_alloc_fail(memmap, SOF_MEM_ZONE_BUFFER, caps);
 
 	if (new_ptr && ptr && !(flags & SOF_MEM_FLAG_NO_COPY))
 		memcpy_s(new_ptr, copy_bytes, ptr, copy_bytes);
@@ -999,6 +1335,9 @@ void heap_trace(struct mm_heap *heap, int size)
 			heap->caps);
 		tr_info(&mem_tr, "  used %d free %d", heap->info.used,
 			heap->info.free);
+		tr_info(&mem_tr, "  peak %d largest free %d fails %d",
+			heap->used_peak, heap_largest_free(heap),
+			heap->alloc_fails);
 
 		/* map[j]'s base is calculated based on map[j-1] */
 		for (j = 1; j < heap->blocks; j++) {
@@ -1021,6 +1360,32 @@ void heap_trace(struct mm_heap *heap, int size)
 	}
 }
 
+static void pool_trace(struct mm *memmap)
+{
+	struct list_item *plist;
+	struct mm_pool *pool;
+	uint32_t free;
+	int32_t used;
+	int i;
+
+	list_for_item(plist, &memmap->pools) {
+		pool = container_of(plist, struct mm_pool, list);
+		free = 0;
+		used = 0;
+
+		for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+			free += pool->core[i].free_count;
+			used += pool->core[i].used;
+		}
+
+		tr_info(&mem_tr, " pool %d size %d slabs %d objects %d",
+			pool->id, pool_obj_size(pool), pool->slabs,
+			used + free);
+		tr_info(&mem_tr, "  used %d free %d peak %d", used, free,
+			pool->peak);
+	}
+}
+
 void heap_trace_all(int force)
 {
 	struct mm *memmap = memmap_get();
@@ -1031,6 +1396,8 @@ void heap_trace_all(int force)
 		heap_trace(memmap->buffer, PLATFORM_HEAP_BUFFER);
 		tr_info(&mem_tr, "heap: runtime status");
 		heap_trace(memmap->runtime, PLATFORM_HEAP_RUNTIME);
+		tr_info(&mem_tr, "heap: pool status");
+		pool_trace(memmap);
 	}
 
 	memmap->heap_trace_updated = 0;
@@ -1065,6 +1432,8 @@ void init_heap(struct sof *sof)
 		      DEBUG_BLOCK_FREE_VALUE_8BIT);
 #endif
 
+	list_init(&memmap->pools);
+
 	spinlock_init(&memmap->lock);
 
 	platform_shared_commit(memmap, sizeof(*memmap));
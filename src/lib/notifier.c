@@ -17,6 +17,7 @@
 #include <sof/list.h>
 #include <sof/sof.h>
 #include <ipc/topology.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 /* 1fb15a7a-83cd-4c2e-8b32-4da1b2adeeaf */
@@ -74,6 +75,9 @@ int notifier_register(void *receiver, void *caller, enum notify_id type,
 
 	list_item_prepend(&handle->list, &notify->list[type]);
 
+	if (!caller)
+		notify->wildcards[type]++;
+
 out:
 	irq_local_enable(irq_flags);
 
@@ -107,6 +111,8 @@ void notifier_unregister(void *receiver, void *caller, enum notify_id type)
 		if ((!receiver || handle->receiver == receiver) &&
 		    (!caller || handle->caller == caller)) {
 			if (!--handle->num_registrations) {
+				if (!handle->caller)
+					notify->wildcards[type]--;
 				list_item_del(&handle->list);
 				rfree(handle);
 			}
@@ -124,6 +130,32 @@ void notifier_unregister_all(void *receiver, void *caller)
 		notifier_unregister(receiver, caller, i);
 }
 
+/* true if an event of this type sent by caller would reach any callback */
+bool notifier_has_callbacks(const void *caller, enum notify_id type)
+{
+	struct notify *notify = *arch_notify_get();
+	struct list_item *wlist;
+	struct callback_handle *handle;
+	bool found = false;
+	uint32_t flags;
+
+	assert(type >= NOTIFIER_ID_CPU_FREQ && type < NOTIFIER_ID_COUNT);
+
+	irq_local_disable(flags);
+
+	list_for_item(wlist, &notify->list[type]) {
+		handle = container_of(wlist, struct callback_handle, list);
+		if (!handle->caller || handle->caller == caller) {
+			found = true;
+			break;
+		}
+	}
+
+	irq_local_enable(flags);
+
+	return found;
+}
+
 static void notifier_notify(const void *caller, enum notify_id type, void *data)
 {
 	struct notify *notify = *arch_notify_get();
@@ -6,6 +6,7 @@
 
 #include <sof/audio/format.h>
 #include <sof/math/decibels.h>
+#include <sof/math/numbers.h>
 #include <stdint.h>
 
 #define ONE_Q20         Q_CONVERT_FLOAT(1.0, 20)	  /* Use Q12.20 */
@@ -13,6 +14,10 @@
 #define TWO_Q27         Q_CONVERT_FLOAT(2.0, 27)	  /* Use Q5.27 */
 #define MINUS_TWO_Q27   Q_CONVERT_FLOAT(-2.0, 27)	  /* Use Q5.27 */
 #define LOG10_DIV20_Q27 Q_CONVERT_FLOAT(0.1151292546, 27) /* Use Q5.27 */
+#define ONE_Q30         Q_CONVERT_FLOAT(1.0, 30)	  /* Use Q2.30 */
+#define SQRT2_Q30       Q_CONVERT_FLOAT(1.4142135624, 30) /* Use Q2.30 */
+#define LN2_Q27         Q_CONVERT_FLOAT(0.6931471806, 27) /* Use Q5.27 */
+#define DIV20_LOG10_Q27 Q_CONVERT_FLOAT(8.6858896381, 27) /* Use Q5.27 */
 
 /* Exponent function for small values of x. This function calculates
  * fairly accurately exponent for x in range -2.0 .. +2.0. The iteration
@@ -115,3 +120,66 @@ int32_t exp_fixed(int32_t x)
 
 	return y;
 }
+
+/* Natural logarithm function. The argument is normalized to x = m * 2^e
+ * with m in range 1/sqrt(2) .. sqrt(2). Then log(x) = e * log(2) + log(m)
+ * where log(m) is computed with series 2 * (z + z^3/3 + z^5/5 + ...)
+ * of z = (m - 1) / (m + 1). With |z| < 0.172 the first five terms are
+ * enough for the output precision.
+ *
+ * Input  is Q12.20, 0.0 .. +2048.0
+ * Output is Q5.27, approximately -13.9 .. +7.7. For non-positive input
+ * the smallest Q5.27 value is returned.
+ */
+
+int32_t log_fixed(int32_t x)
+{
+	int64_t s;
+	int64_t t;
+	int64_t z2;
+	int32_t m;
+	int e;
+	int k;
+
+	if (x <= 0)
+		return INT32_MIN;
+
+	/* Normalize to Q2.30 m in 1.0 .. 2.0, then to 1/sqrt(2) .. sqrt(2) */
+	k = norm_int32(x);
+	m = x << k;
+	e = 10 - k;
+	if (m >= SQRT2_Q30) {
+		m >>= 1;
+		e++;
+	}
+
+	/* z = (m - 1) / (m + 1) is Q1.31 */
+	s = ((int64_t)(m - ONE_Q30) << 31) / ((int64_t)m + ONE_Q30);
+	z2 = (s * s) >> 31;
+	t = s;
+	for (k = 3; k < 11; k += 2) {
+		t = (t * z2) >> 31;
+		s += t / k;
+	}
+
+	/* Q1.31 sum s is multiplied by two with the shift to Q5.27 */
+	return e * LN2_Q27 + (int32_t)Q_SHIFT_RND(s, 30, 27);
+}
+
+/* Linear to decibels conversion: The function uses log() and multiplies
+ * the result by 20/log(10) to calculate equivalent of 20 * log10(x).
+ *
+ * Input is Q12.20 (max 2048.0), the smallest positive value corresponds
+ * to about -120 dB. For zero or negative input -128 dB is returned.
+ * Output is Q8.24.
+ */
+
+int32_t lin2db_fixed(int32_t x)
+{
+	if (x <= 0)
+		return INT32_MIN;
+
+	/* Q5.27 x Q5.27, result needs to be Q8.24 */
+	return (int32_t)Q_MULTSR_32X32((int64_t)log_fixed(x), DIV20_LOG10_Q27,
+				       27, 27, 24);
+}
@@ -0,0 +1,280 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+//
+// Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+
+#include <sof/audio/format.h>
+#include <sof/lib/alloc.h>
+#include <sof/lib/memory.h>
+#include <sof/math/fft.h>
+#include <sof/math/trig.h>
+#include <ipc/topology.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* e^(-j*2*pi*k/size) as Q1.31, cos(x) is computed as sin(x + pi/2) */
+static void fft_twiddle(struct icomplex32 *w, uint32_t k, uint32_t size)
+{
+	int32_t angle = (int32_t)(((int64_t)PI_MUL2_Q4_28 * k) / size);
+
+	w->real = sin_fixed(angle + PI_DIV2_Q4_28);
+	w->imag = -sin_fixed(angle);
+}
+
+/* Product of Q1.31 complex numbers as Q2.62 real and imaginary parts */
+static inline void fft_cmul(const struct icomplex32 *a,
+			    const struct icomplex32 *w,
+			    int64_t *re, int64_t *im)
+{
+	*re = (int64_t)a->real * w->real - (int64_t)a->imag * w->imag;
+	*im = (int64_t)a->real * w->imag + (int64_t)a->imag * w->real;
+}
+
+/* Product of Q1.31 complex numbers rounded and saturated to Q1.31 */
+static inline void fft_cmul_sat(const struct icomplex32 *a,
+				const struct icomplex32 *w,
+				struct icomplex32 *y)
+{
+	int64_t re;
+	int64_t im;
+
+	fft_cmul(a, w, &re, &im);
+	y->real = sat_int32(Q_SHIFT_RND(re, 62, 31));
+	y->imag = sat_int32(Q_SHIFT_RND(im, 62, 31));
+}
+
+struct fft_plan *fft_plan_new(uint32_t size)
+{
+	struct fft_plan *plan;
+	uint32_t depth = 0;
+	uint32_t i;
+	uint32_t j;
+
+	if (size < 2 || size > FFT_MAX_SIZE || (size & (size - 1)))
+		return NULL;
+
+	while ((1u << depth) < size)
+		depth++;
+
+	plan = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+		       sizeof(*plan));
+	if (!plan)
+		return NULL;
+
+	plan->bit_reverse_idx = rzalloc(SOF_MEM_ZONE_RUNTIME, 0,
+					SOF_MEM_CAPS_RAM,
+					size * sizeof(uint16_t));
+	plan->twiddle = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+				size / 2 * sizeof(struct icomplex32));
+	if (!plan->bit_reverse_idx || !plan->twiddle) {
+		fft_plan_free(plan);
+		return NULL;
+	}
+
+	plan->size = size;
+	plan->depth = depth;
+
+	for (i = 0; i < size; i++) {
+		plan->bit_reverse_idx[i] = 0;
+		for (j = 0; j < depth; j++)
+			if (i & (1u << j))
+				plan->bit_reverse_idx[i] |= 1u << (depth - 1 - j);
+	}
+
+	for (i = 0; i < size / 2; i++)
+		fft_twiddle(&plan->twiddle[i], i, size);
+
+	return plan;
+}
+
+void fft_plan_free(struct fft_plan *plan)
+{
+	if (!plan)
+		return;
+
+	rfree(plan->bit_reverse_idx);
+	rfree(plan->twiddle);
+	rfree(plan);
+}
+
+/*
+ * Radix-2 decimation in time FFT. The butterflies of forward transform
+ * halve the output so the result can't grow over the input range. The
+ * inverse transform butterflies are not scaled and saturate instead.
+ */
+void fft_execute_32(struct fft_plan *plan, struct icomplex32 *buf, bool ifft)
+{
+	struct icomplex32 tmp;
+	struct icomplex32 w;
+	struct icomplex32 *a;
+	struct icomplex32 *b;
+	int64_t re;
+	int64_t im;
+	int64_t sr;
+	int64_t si;
+	uint32_t size = plan->size;
+	uint32_t half;
+	uint32_t step;
+	uint32_t i;
+	uint32_t j;
+	int q = ifft ? 61 : 62; /* Q62 interpretation halves the sum */
+
+	/* Sort the input to bit reversed order */
+	for (i = 0; i < size; i++) {
+		j = plan->bit_reverse_idx[i];
+		if (j > i) {
+			tmp = buf[i];
+			buf[i] = buf[j];
+			buf[j] = tmp;
+		}
+	}
+
+	for (half = 1; half < size; half <<= 1) {
+		step = size / (2 * half);
+		for (i = 0; i < size; i += 2 * half) {
+			for (j = 0; j < half; j++) {
+				w = plan->twiddle[j * step];
+				if (ifft)
+					w.imag = -w.imag;
+
+				a = &buf[i + j];
+				b = a + half;
+				fft_cmul(b, &w, &re, &im);
+
+				/* Sum a + b * w as Q3.61, then to Q1.31 */
+				re >>= 1;
+				im >>= 1;
+				sr = (int64_t)a->real << 30;
+				si = (int64_t)a->imag << 30;
+				b->real = sat_int32(Q_SHIFT_RND(sr - re, q, 31));
+				b->imag = sat_int32(Q_SHIFT_RND(si - im, q, 31));
+				a->real = sat_int32(Q_SHIFT_RND(sr + re, q, 31));
+				a->imag = sat_int32(Q_SHIFT_RND(si + im, q, 31));
+			}
+		}
+	}
+}
+
+struct rfft_plan *rfft_plan_new(uint32_t size)
+{
+	struct rfft_plan *plan;
+	uint32_t i;
+
+	if (size < 4 || size > 2 * FFT_MAX_SIZE || (size & (size - 1)))
+		return NULL;
+
+	plan = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+		       sizeof(*plan));
+	if (!plan)
+		return NULL;
+
+	plan->fft = fft_plan_new(size / 2);
+	plan->twiddle = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+				(size / 4 + 1) * sizeof(struct icomplex32));
+	if (!plan->fft || !plan->twiddle) {
+		rfft_plan_free(plan);
+		return NULL;
+	}
+
+	plan->size = size;
+	for (i = 0; i <= size / 4; i++)
+		fft_twiddle(&plan->twiddle[i], i, size);
+
+	return plan;
+}
+
+void rfft_plan_free(struct rfft_plan *plan)
+{
+	if (!plan)
+		return;
+
+	fft_plan_free(plan->fft);
+	rfree(plan->twiddle);
+	rfree(plan);
+}
+
+/*
+ * The even and odd samples are packed to real and imaginary parts of a
+ * half size complex sequence z. The spectrum is then split from Z with
+ * X[k] = E[k] + W^k * O[k] and X[M - k] = conj(E[k] - W^k * O[k]), where
+ * E[k] = (Z[k] + conj(Z[M - k])) / 2 and O[k] = (Z[k] - conj(Z[M - k])) / 2j.
+ */
+void rfft_execute_32(struct rfft_plan *plan, struct icomplex32 *buf)
+{
+	struct icomplex32 e;
+	struct icomplex32 o;
+	struct icomplex32 t;
+	struct icomplex32 a;
+	struct icomplex32 b;
+	uint32_t m = plan->size / 2;
+	uint32_t k;
+
+	/* Input samples are already in packed order */
+	fft_execute_32(plan->fft, buf, false);
+
+	/* Output is scaled by 1/size, i.e. one more halving after the
+	 * half size transform.
+	 */
+	a = buf[0];
+	buf[0].real = ((int64_t)a.real + a.imag) >> 1;
+	buf[0].imag = 0;
+	buf[m].real = ((int64_t)a.real - a.imag) >> 1;
+	buf[m].imag = 0;
+
+	for (k = 1; k <= m / 2; k++) {
+		a = buf[k];
+		b = buf[m - k];
+		e.real = ((int64_t)a.real + b.real) >> 1;
+		e.imag = ((int64_t)a.imag - b.imag) >> 1;
+		o.real = ((int64_t)a.imag + b.imag) >> 1;
+		o.imag = ((int64_t)b.real - a.real) >> 1;
+		fft_cmul_sat(&o, &plan->twiddle[k], &t);
+		buf[k].real = ((int64_t)e.real + t.real) >> 1;
+		buf[k].imag = ((int64_t)e.imag + t.imag) >> 1;
+		buf[m - k].real = ((int64_t)e.real - t.real) >> 1;
+		buf[m - k].imag = ((int64_t)t.imag - e.imag) >> 1;
+	}
+}
+
+/*
+ * Inverse of the split in rfft_execute_32(), Z[k] = E[k] + j * O[k] with
+ * E[k] = X[k] + conj(X[M - k]) and O[k] = (X[k] - conj(X[M - k])) * W^-k.
+ * The half size inverse transform then gives the packed samples.
+ */
+void irfft_execute_32(struct rfft_plan *plan, struct icomplex32 *buf)
+{
+	struct icomplex32 d;
+	struct icomplex32 w;
+	struct icomplex32 o;
+	struct icomplex32 a;
+	struct icomplex32 b;
+	int32_t er;
+	int32_t ei;
+	uint32_t m = plan->size / 2;
+	uint32_t k;
+
+	a = buf[0];
+	b = buf[m];
+	buf[0].real = sat_int32((int64_t)a.real + b.real);
+	buf[0].imag = sat_int32((int64_t)a.real - b.real);
+
+	for (k = 1; k <= m / 2; k++) {
+		a = buf[k];
+		b = buf[m - k];
+		er = sat_int32((int64_t)a.real + b.real);
+		ei = sat_int32((int64_t)a.imag - b.imag);
+		d.real = sat_int32((int64_t)a.real - b.real);
+		d.imag = sat_int32((int64_t)a.imag + b.imag);
+		w.real = plan->twiddle[k].real;
+		w.imag = -plan->twiddle[k].imag;
+		fft_cmul_sat(&d, &w, &o);
+		buf[k].real = sat_int32((int64_t)er - o.imag);
+		buf[k].imag = sat_int32((int64_t)ei + o.real);
+		buf[m - k].real = sat_int32((int64_t)er + o.imag);
+		buf[m - k].imag = sat_int32((int64_t)o.real - ei);
+	}
+
+	fft_execute_32(plan->fft, buf, true);
+}
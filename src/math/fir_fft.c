@@ -0,0 +1,175 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+//
+// Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+
+#include <sof/audio/format.h>
+#include <sof/lib/alloc.h>
+#include <sof/lib/memory.h>
+#include <sof/math/fft.h>
+#include <sof/math/fir_fft.h>
+#include <sof/math/numbers.h>
+#include <sof/string.h>
+#include <ipc/topology.h>
+#include <user/fir.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Uniformly partitioned overlap-save convolution. The impulse response is
+ * split to partitions of FIR_FFT_BLOCK_SIZE taps and the spectrum of each
+ * zero padded partition is computed once with a FFT of twice the partition
+ * length. For every block of input the spectrum of the previous and current
+ * input blocks is pushed to a frequency domain delay line. The output
+ * spectrum is the sum of products of delay line and partition spectra and
+ * the second half of its inverse FFT is the filter output for the block.
+ */
+
+#define FIR_FFT_SIZE		(2 * FIR_FFT_BLOCK_SIZE)
+
+struct rfft_plan *fir_fft_plan_new(void)
+{
+	return rfft_plan_new(FIR_FFT_SIZE);
+}
+
+int fir_fft_init_coef(struct fir_fft_coef *coef, struct rfft_plan *plan,
+		      struct sof_fir_coef_data *config)
+{
+	struct icomplex32 *spectrum;
+	int32_t *h;
+	int length = config->length;
+	int i;
+	int j;
+	int p;
+
+	if (length < 1 || length > SOF_FIR_FFT_MAX_LENGTH)
+		return -EINVAL;
+
+	coef->partitions = ceil_divide(length, FIR_FFT_BLOCK_SIZE);
+	coef->spectra = rballoc(0, SOF_MEM_CAPS_RAM, coef->partitions *
+				FIR_FFT_BINS * sizeof(struct icomplex32));
+	if (!coef->spectra)
+		return -ENOMEM;
+
+	/* The spectra are scaled by 1/FIR_FFT_SIZE as well as the input
+	 * spectra. The sum of products in Q2.62 is shifted to Q1.31 and
+	 * multiplied by FIR_FFT_SIZE to get back the unscaled output
+	 * spectrum. The output shift of the response is applied here too.
+	 */
+	coef->shift = 31 - (plan->fft->depth + 1) + config->out_shift;
+
+	for (p = 0; p < coef->partitions; p++) {
+		spectrum = &coef->spectra[p * FIR_FFT_BINS];
+		h = (int32_t *)spectrum;
+		for (i = 0; i < FIR_FFT_SIZE; i++) {
+			j = p * FIR_FFT_BLOCK_SIZE + i;
+			if (i < FIR_FFT_BLOCK_SIZE && j < length)
+				h[i] = (int32_t)config->coef[j] << 16;
+			else
+				h[i] = 0;
+		}
+
+		rfft_execute_32(plan, spectrum);
+	}
+
+	return 0;
+}
+
+void fir_fft_free_coef(struct fir_fft_coef *coef)
+{
+	rfree(coef->spectra);
+	coef->spectra = NULL;
+	coef->partitions = 0;
+}
+
+int fir_fft_init(struct fir_fft_state *fft, struct rfft_plan *plan,
+		 struct fir_fft_coef *coef)
+{
+	size_t fdl_size = coef->partitions * FIR_FFT_BINS *
+		sizeof(struct icomplex32);
+	size_t work_size = FIR_FFT_BINS * sizeof(struct icomplex32);
+	size_t size = fdl_size + work_size +
+		3 * FIR_FFT_BLOCK_SIZE * sizeof(int32_t);
+
+	/* All buffers of the channel are allocated in a single chunk */
+	fft->fdl = rballoc(0, SOF_MEM_CAPS_RAM, size);
+	if (!fft->fdl)
+		return -ENOMEM;
+
+	memset(fft->fdl, 0, size);
+	fft->work = fft->fdl + coef->partitions * FIR_FFT_BINS;
+	fft->in = (int32_t *)(fft->work + FIR_FFT_BINS);
+	fft->out = fft->in + 2 * FIR_FFT_BLOCK_SIZE;
+	fft->plan = plan;
+	fft->coef = coef;
+	fft->fdl_head = 0;
+	fft->pos = 0;
+	return 0;
+}
+
+void fir_fft_free(struct fir_fft_state *fft)
+{
+	rfree(fft->fdl);
+	fft->fdl = NULL;
+	fft->work = NULL;
+	fft->in = NULL;
+	fft->out = NULL;
+	fft->plan = NULL;
+	fft->coef = NULL;
+}
+
+void fir_fft_block(struct fir_fft_state *fft)
+{
+	struct fir_fft_coef *coef = fft->coef;
+	struct icomplex32 *x;
+	struct icomplex32 *h;
+	int32_t *y;
+	int64_t re;
+	int64_t im;
+	int partitions = coef->partitions;
+	int shift = coef->shift;
+	int head;
+	int i;
+	int k;
+	int p;
+
+	/* Push spectrum of the last two input blocks to delay line */
+	if (++fft->fdl_head == partitions)
+		fft->fdl_head = 0;
+
+	head = fft->fdl_head;
+	x = &fft->fdl[head * FIR_FFT_BINS];
+	memcpy_s(x, FIR_FFT_SIZE * sizeof(int32_t), fft->in,
+		 FIR_FFT_SIZE * sizeof(int32_t));
+	rfft_execute_32(fft->plan, x);
+
+	/* Multiply and accumulate the spectra of all partitions */
+	for (k = 0; k < FIR_FFT_BINS; k++) {
+		re = 0;
+		im = 0;
+		i = head;
+		for (p = 0; p < partitions; p++) {
+			x = &fft->fdl[i * FIR_FFT_BINS + k];
+			h = &coef->spectra[p * FIR_FFT_BINS + k];
+			re += (int64_t)x->real * h->real -
+				(int64_t)x->imag * h->imag;
+			im += (int64_t)x->real * h->imag +
+				(int64_t)x->imag * h->real;
+			if (--i < 0)
+				i = partitions - 1;
+		}
+
+		fft->work[k].real = sat_int32(((re >> (shift - 1)) + 1) >> 1);
+		fft->work[k].imag = sat_int32(((im >> (shift - 1)) + 1) >> 1);
+	}
+
+	/* The last half of circular convolution is the valid output */
+	irfft_execute_32(fft->plan, fft->work);
+	y = (int32_t *)fft->work;
+	for (i = 0; i < FIR_FFT_BLOCK_SIZE; i++) {
+		fft->out[i] = y[FIR_FFT_BLOCK_SIZE + i];
+		fft->in[i] = fft->in[FIR_FFT_BLOCK_SIZE + i];
+	}
+}
@@ -0,0 +1,57 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+//
+// Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+
+#include <sof/common.h>
+#include <sof/math/fir_nch.h>
+#include <user/fir.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Shared response FIR setup, common for all code variants
+ */
+
+void fir_nch_reset(struct fir_nch_state_32x16 *fir)
+{
+	fir->rwi = 0;
+	fir->length = 0;
+	fir->out_shift = 0;
+	fir->nch = 0;
+	fir->stride = 0;
+	fir->coef = NULL;
+	fir->delay = NULL;
+}
+
+int fir_nch_delay_size(struct sof_fir_coef_data *config, int nch)
+{
+	/* Check for sane FIR length and channels count */
+	if (config->length > SOF_FIR_MAX_LENGTH || config->length < 1)
+		return -EINVAL;
+
+	if (nch < 1 || nch > FIR_NCH_MAX_CHANNELS)
+		return -EINVAL;
+
+	return config->length * ALIGN_UP(nch, 2) * sizeof(int32_t);
+}
+
+int fir_nch_init_coef(struct fir_nch_state_32x16 *fir,
+		      struct sof_fir_coef_data *config, int nch)
+{
+	fir->rwi = 0;
+	fir->length = (int)config->length;
+	fir->out_shift = (int)config->out_shift;
+	fir->nch = nch;
+	fir->stride = ALIGN_UP(nch, 2);
+	fir->coef = ASSUME_ALIGNED(&config->coef[0], 4);
+	return 0;
+}
+
+void fir_nch_init_delay(struct fir_nch_state_32x16 *fir, int32_t **data)
+{
+	fir->delay = *data;
+	*data += fir->length * fir->stride; /* Point to next delay line start */
+}
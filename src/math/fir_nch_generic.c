@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+//
+// Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+
+#include <sof/math/fir_config.h>
+
+#if FIR_GENERIC || FIR_HIFIEP
+
+#include <sof/audio/format.h>
+#include <sof/math/fir_nch.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Accumulate taps from frame pointed by data backwards in delay line */
+static inline void fir_nch_mac(int64_t acc[], const int16_t *coef,
+			       const int32_t *data, int taps, int nch,
+			       int stride)
+{
+	int32_t c;
+	int ch;
+	int n;
+
+	for (n = 0; n < taps; n++) {
+		c = coef[n];
+		for (ch = 0; ch < nch; ch++)
+			acc[ch] += (int64_t)c * data[ch];
+
+		data -= stride;
+	}
+}
+
+void fir_32x16_nch(struct fir_nch_state_32x16 *fir, const int32_t x[],
+		   int32_t y[])
+{
+	int64_t acc[FIR_NCH_MAX_CHANNELS];
+	int32_t *data;
+	int shift = 15 + fir->out_shift;
+	int nch = fir->nch;
+	int n1;
+	int ch;
+
+	/* Bypass is set with length set to zero. */
+	if (!fir->length) {
+		for (ch = 0; ch < nch; ch++)
+			y[ch] = x[ch];
+		return;
+	}
+
+	/* Write frame to delay */
+	data = &fir->delay[fir->rwi * fir->stride];
+	for (ch = 0; ch < nch; ch++) {
+		data[ch] = x[ch];
+		acc[ch] = 0;
+	}
+
+	/* Part 1, from newest frame back to delay line start. Part 2,
+	 * un-wrap and continue from delay line end. Data is Q1.31, coef is
+	 * Q1.15, product is Q2.46.
+	 */
+	n1 = fir->rwi + 1;
+	fir_nch_mac(acc, fir->coef, data, n1, nch, fir->stride);
+	fir_nch_mac(acc, fir->coef + n1,
+		    &fir->delay[(fir->length - 1) * fir->stride],
+		    fir->length - n1, nch, fir->stride);
+
+	if (++fir->rwi == fir->length)
+		fir->rwi = 0;
+
+	/* Q2.46 -> Q2.31, saturate to Q1.31 */
+	for (ch = 0; ch < nch; ch++)
+		y[ch] = sat_int32(acc[ch] >> shift);
+}
+
+#endif /* FIR_GENERIC || FIR_HIFIEP */
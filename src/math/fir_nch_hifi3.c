@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+//
+// Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+
+#include <sof/math/fir_config.h>
+
+#if FIR_HIFI3
+
+#include <sof/math/fir_nch.h>
+#include <xtensa/config/defs.h>
+#include <xtensa/tie/xt_hifi3.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Accumulate taps of a channel pair from frame pointed by dp backwards in
+ * delay line. The pair is loaded with a single 64 bit load and the
+ * coefficient is loaded once for both channels.
+ */
+static inline void fir_nch_mac_pair(ae_f64 *a0, ae_f64 *a1,
+				    const int16_t *coef,
+				    const int32_t *data, int taps,
+				    int stride)
+{
+	ae_int16 *coefp = (ae_int16 *)coef;
+	ae_int32x2 *dp = (ae_int32x2 *)data;
+	ae_f64 acc0 = *a0;
+	ae_f64 acc1 = *a1;
+	ae_f32x2 d;
+	ae_f16x4 c;
+	const int inc = -stride * (int)sizeof(int32_t);
+	int n;
+
+	for (n = 0; n < taps; n++) {
+		/* Load coefficient to all lanes and frame of channel pair,
+		 * the lower channel index is in the high half.
+		 */
+		AE_L16_IP(c, coefp, sizeof(int16_t));
+		AE_L32X2_XP(d, dp, inc);
+
+		/* Q1.31 x Q1.15 -> Q17.47 */
+		AE_MULAF32X16_H0(acc0, d, c);
+		AE_MULAF32X16_L0(acc1, d, c);
+	}
+
+	*a0 = acc0;
+	*a1 = acc1;
+}
+
+void fir_32x16_nch(struct fir_nch_state_32x16 *fir, const int32_t x[],
+		   int32_t y[])
+{
+	ae_f64 a0;
+	ae_f64 a1;
+	int32_t *data;
+	int32_t *wrap;
+	int lshift = (fir->out_shift < 0) ? -fir->out_shift : 0;
+	int rshift = (fir->out_shift > 0) ? fir->out_shift : 0;
+	int shift = lshift - rshift;
+	int nch = fir->nch;
+	int n1;
+	int ch;
+
+	/* Bypass is set with length set to zero. */
+	if (!fir->length) {
+		for (ch = 0; ch < nch; ch++)
+			y[ch] = x[ch];
+		return;
+	}
+
+	/* Write frame to delay */
+	data = &fir->delay[fir->rwi * fir->stride];
+	for (ch = 0; ch < nch; ch++)
+		data[ch] = x[ch];
+
+	/* Part 1 is from newest frame back to delay line start and part 2
+	 * un-wraps and continues from delay line end.
+	 */
+	n1 = fir->rwi + 1;
+	wrap = &fir->delay[(fir->length - 1) * fir->stride];
+	for (ch = 0; ch < nch; ch += 2) {
+		a0 = AE_ZERO64();
+		a1 = AE_ZERO64();
+		fir_nch_mac_pair(&a0, &a1, fir->coef, data + ch, n1,
+				 fir->stride);
+		fir_nch_mac_pair(&a0, &a1, fir->coef + n1, wrap + ch,
+				 fir->length - n1, fir->stride);
+
+		/* Do scaling shifts, round to Q1.31. With odd channels
+		 * count the last pair contains the unused padding sample.
+		 */
+		a0 = AE_SLAA64S(a0, shift);
+		y[ch] = AE_ROUND32F48SSYM(a0);
+		if (ch + 1 < nch) {
+			a1 = AE_SLAA64S(a1, shift);
+			y[ch + 1] = AE_ROUND32F48SSYM(a1);
+		}
+	}
+
+	if (++fir->rwi == fir->length)
+		fir->rwi = 0;
+}
+
+#endif /* FIR_HIFI3 */
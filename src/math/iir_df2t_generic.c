@@ -8,6 +8,7 @@
 
 #include <sof/audio/format.h>
 #include <sof/math/iir_df2t.h>
+#include <sof/math/numbers.h>
 #include <user/eq.h>
 #include <errno.h>
 #include <stddef.h>
@@ -104,4 +105,196 @@ int32_t iir_df2t(struct iir_state_df2t *iir, int32_t x)
 	return out;
 }
 
+/* Number of samples kept on stack for block processing */
+#define IIR_DF2T_BLOCK_SAMPLES	64
+
+/* One biquad over contiguous block of lanes interleaved channels. The
+ * coefficients and delays of each lane stay in local variables for the
+ * whole block. With constant lanes the inner loop is unrolled and can be
+ * vectorized by compiler.
+ */
+static inline void iir_df2t_biquad_lanes(struct iir_state_df2t *iir,
+					 int c, int d, int32_t *w, int n,
+					 const int lanes)
+{
+	int64_t d0[IIR_DF2T_MAX_LANES];
+	int64_t d1[IIR_DF2T_MAX_LANES];
+	int32_t a2[IIR_DF2T_MAX_LANES];
+	int32_t a1[IIR_DF2T_MAX_LANES];
+	int32_t b2[IIR_DF2T_MAX_LANES];
+	int32_t b1[IIR_DF2T_MAX_LANES];
+	int32_t b0[IIR_DF2T_MAX_LANES];
+	int32_t shift[IIR_DF2T_MAX_LANES];
+	int32_t gain[IIR_DF2T_MAX_LANES];
+	int64_t acc;
+	int32_t in;
+	int32_t tmp;
+	int i;
+	int l;
+
+	/* Coefficients order in coef[] is {a2, a1, b2, b1, b0, shift, gain} */
+	for (l = 0; l < lanes; l++) {
+		a2[l] = iir[l].coef[c];
+		a1[l] = iir[l].coef[c + 1];
+		b2[l] = iir[l].coef[c + 2];
+		b1[l] = iir[l].coef[c + 3];
+		b0[l] = iir[l].coef[c + 4];
+		shift[l] = 45 + iir[l].coef[c + 5];
+		gain[l] = iir[l].coef[c + 6];
+		d0[l] = iir[l].delay[d];
+		d1[l] = iir[l].delay[d + 1];
+	}
+
+	for (i = 0; i < n; i++) {
+		for (l = 0; l < lanes; l++) {
+			in = w[l];
+
+			/* Same arithmetic as in iir_df2t() */
+			acc = (int64_t)b0[l] * in + d0[l];
+			tmp = (int32_t)Q_SHIFT_RND(acc, 61, 31);
+			d0[l] = d1[l] + (int64_t)b1[l] * in +
+				(int64_t)a1[l] * tmp;
+			d1[l] = (int64_t)b2[l] * in + (int64_t)a2[l] * tmp;
+			acc = (int64_t)gain[l] * tmp;
+			w[l] = sat_int32(Q_SHIFT_RND(acc, shift[l], 31));
+		}
+		w += lanes;
+	}
+
+	for (l = 0; l < lanes; l++) {
+		iir[l].delay[d] = d0[l];
+		iir[l].delay[d + 1] = d1[l];
+	}
+}
+
+/* Filters lanes channels with equal filter structure, n frames at a time */
+static inline void iir_df2t_block_lanes(struct iir_state_df2t *iir,
+					const int32_t *in, int32_t *out,
+					int frames, int stride,
+					const int lanes)
+{
+	int32_t w[IIR_DF2T_BLOCK_SAMPLES];
+	int32_t sum[IIR_DF2T_BLOCK_SAMPLES];
+	int32_t *res;
+	int max_frames = IIR_DF2T_BLOCK_SAMPLES / lanes;
+	int nseries = iir->biquads_in_series;
+	int samples;
+	int n;
+	int i;
+	int j;
+	int k;
+	int l;
+	int c;
+	int d;
+
+	/* Single series section output is directly the work buffer */
+	res = iir->biquads == nseries ? w : sum;
+
+	while (frames) {
+		n = MIN(frames, max_frames);
+		samples = n * lanes;
+		c = 0;
+		d = 0;
+
+		for (i = 0; i < n; i++)
+			for (l = 0; l < lanes; l++)
+				w[i * lanes + l] = in[i * stride + l];
+
+		/* Each section continues from output of previous one and
+		 * is added to sum as in iir_df2t().
+		 */
+		for (j = 0; j < iir->biquads; j += nseries) {
+			for (k = 0; k < nseries; k++) {
+				iir_df2t_biquad_lanes(iir, c, d, w, n, lanes);
+				c += SOF_EQ_IIR_NBIQUAD_DF2T;
+				d += IIR_DF2T_NUM_DELAYS;
+			}
+
+			if (res == w)
+				continue;
+
+			if (!j) {
+				for (i = 0; i < samples; i++)
+					sum[i] = w[i];
+			} else {
+				for (i = 0; i < samples; i++)
+					sum[i] = sat_int32((int64_t)sum[i] +
+							   w[i]);
+			}
+		}
+
+		for (i = 0; i < n; i++)
+			for (l = 0; l < lanes; l++)
+				out[i * stride + l] = res[i * lanes + l];
+
+		in += n * stride;
+		out += n * stride;
+		frames -= n;
+	}
+}
+
+void iir_df2t_block(struct iir_state_df2t *iir, const int32_t *in,
+		    int32_t *out, int frames, int stride)
+{
+	int i;
+
+	/* Bypass is set with number of biquads set to zero. */
+	if (!iir->biquads) {
+		if (in != out)
+			for (i = 0; i < frames; i++)
+				out[i * stride] = in[i * stride];
+		return;
+	}
+
+	iir_df2t_block_lanes(iir, in, out, frames, stride, 1);
+}
+
+/* Count of channels from first having filters of same structure */
+static int iir_df2t_lanes(const struct iir_state_df2t *iir, int nch)
+{
+	int lanes;
+	int l;
+
+	if (!iir->biquads)
+		return 1;
+
+	for (lanes = 1; lanes < MIN(nch, IIR_DF2T_MAX_LANES); lanes++) {
+		if (iir[lanes].biquads != iir->biquads ||
+		    iir[lanes].biquads_in_series != iir->biquads_in_series)
+			break;
+	}
+
+	/* Kernels exist for groups of four and two channels */
+	for (l = IIR_DF2T_MAX_LANES; l > 1; l >>= 1)
+		if (lanes >= l)
+			return l;
+
+	return 1;
+}
+
+void iir_df2t_block_nch(struct iir_state_df2t *iir, const int32_t *in,
+			int32_t *out, int frames, int nch)
+{
+	int lanes;
+	int ch;
+
+	for (ch = 0; ch < nch; ch += lanes) {
+		lanes = iir_df2t_lanes(&iir[ch], nch - ch);
+		switch (lanes) {
+		case 4:
+			iir_df2t_block_lanes(&iir[ch], in + ch, out + ch,
+					     frames, nch, 4);
+			break;
+		case 2:
+			iir_df2t_block_lanes(&iir[ch], in + ch, out + ch,
+					     frames, nch, 2);
+			break;
+		default:
+			iir_df2t_block(&iir[ch], in + ch, out + ch, frames,
+				       nch);
+			break;
+		}
+	}
+}
+
 #endif
@@ -11,6 +11,7 @@
 #include <errno.h>
 #include <sof/audio/format.h>
 #include <sof/math/iir_df2t.h>
+#include <sof/math/numbers.h>
 #include <user/eq.h>
 
 #if IIR_HIFI3
@@ -131,4 +132,144 @@ int32_t iir_df2t(struct iir_state_df2t *iir, int32_t x)
 	return out;
 }
 
+/* Number of samples kept on stack for block processing */
+#define IIR_DF2T_BLOCK_SAMPLES	64
+
+/* One biquad over a contiguous block, with coefficients and delays kept in
+ * registers for the whole block. Same arithmetic as in iir_df2t().
+ */
+static void iir_df2t_biquad_block(int32_t *coef, int64_t *delay,
+				  int32_t *w, int n)
+{
+	ae_f64 acc;
+	ae_f64 d0;
+	ae_f64 d1;
+	ae_valign align;
+	ae_f32x2 coef_a2a1;
+	ae_f32x2 coef_b2b1;
+	ae_f32x2 coef_b0shift;
+	ae_f32x2 gain;
+	ae_f32 in;
+	ae_f32 tmp;
+	ae_f32x2 *coefp = (ae_f32x2 *)coef;
+	ae_f64 *delayp = (ae_f64 *)delay;
+	int shift;
+	int i;
+
+	/* Coefficients order in coef[] is {a2, a1, b2, b1, b0, shift, gain} */
+	align = AE_LA64_PP(coefp);
+	AE_LA32X2_IP(coef_a2a1, align, coefp);
+	AE_LA32X2_IP(coef_b2b1, align, coefp);
+	AE_LA32X2_IP(coef_b0shift, align, coefp);
+	AE_LA32X2_IP(gain, align, coefp);
+	shift = AE_SEL32_LL(coef_b0shift, coef_b0shift);
+	d0 = delayp[0];
+	d1 = delayp[1];
+
+	for (i = 0; i < n; i++) {
+		in = w[i];
+
+		/* Compute output, delays are Q17.47 */
+		acc = AE_SRAI64(d0, 1);
+		AE_MULAF32R_HH(acc, coef_b0shift, in); /* Coef b0 */
+		acc = AE_SLAI64S(acc, 1);
+		tmp = AE_ROUND32F48SSYM(acc);
+
+		/* Compute 1st delay d0 */
+		acc = AE_SRAI64(d1, 1);
+		AE_MULAF32R_LL(acc, coef_b2b1, in); /* Coef b1 */
+		AE_MULAF32R_LL(acc, coef_a2a1, tmp); /* Coef a1 */
+		d0 = AE_SLAI64S(acc, 1);
+
+		/* Compute delay d1 */
+		acc = AE_MULF32R_HH(coef_b2b1, in); /* Coef b2 */
+		AE_MULAF32R_HH(acc, coef_a2a1, tmp); /* Coef a2 */
+		d1 = AE_SLAI64S(acc, 1);
+
+		/* Apply gain and shift, round and saturate to Q1.31 */
+		acc = AE_MULF32R_HH(gain, tmp); /* Gain */
+		acc = AE_SLAI64S(acc, 17);
+		acc = AE_SRAA64(acc, shift);
+		w[i] = AE_ROUND32F48SSYM(acc);
+	}
+
+	delayp[0] = d0;
+	delayp[1] = d1;
+}
+
+void iir_df2t_block(struct iir_state_df2t *iir, const int32_t *in,
+		    int32_t *out, int frames, int stride)
+{
+	int32_t w[IIR_DF2T_BLOCK_SAMPLES];
+	int32_t sum[IIR_DF2T_BLOCK_SAMPLES];
+	int32_t *res;
+	int nseries = iir->biquads_in_series;
+	int n;
+	int i;
+	int j;
+	int k;
+	int c;
+	int d;
+
+	/* Bypass is set with number of biquads set to zero. */
+	if (!iir->biquads) {
+		if (in != out)
+			for (i = 0; i < frames; i++)
+				out[i * stride] = in[i * stride];
+		return;
+	}
+
+	/* Single series section output is directly the work buffer */
+	res = iir->biquads == nseries ? w : sum;
+
+	while (frames) {
+		n = MIN(frames, IIR_DF2T_BLOCK_SAMPLES);
+		c = 0;
+		d = 0;
+
+		for (i = 0; i < n; i++)
+			w[i] = in[i * stride];
+
+		/* Each section continues from output of previous one and
+		 * is added to sum as in iir_df2t().
+		 */
+		for (j = 0; j < iir->biquads; j += nseries) {
+			for (k = 0; k < nseries; k++) {
+				iir_df2t_biquad_block(&iir->coef[c],
+						      &iir->delay[d], w, n);
+				c += SOF_EQ_IIR_NBIQUAD_DF2T;
+				d += IIR_DF2T_NUM_DELAYS;
+			}
+
+			if (res == w)
+				continue;
+
+			if (!j) {
+				for (i = 0; i < n; i++)
+					sum[i] = w[i];
+			} else {
+				for (i = 0; i < n; i++)
+					sum[i] = AE_F32_ADDS_F32(sum[i], w[i]);
+			}
+		}
+
+		for (i = 0; i < n; i++)
+			out[i * stride] = res[i];
+
+		in += n * stride;
+		out += n * stride;
+		frames -= n;
+	}
+}
+
+/* Channels are filtered one by one with the block kernel */
+void iir_df2t_block_nch(struct iir_state_df2t *iir, const int32_t *in,
+			int32_t *out, int frames, int nch)
+{
+	int ch;
+
+	for (ch = 0; ch < nch; ch++)
+		iir_df2t_block(&iir[ch], in + ch, out + ch, frames, nch);
+}
+
 #endif
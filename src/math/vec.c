@@ -0,0 +1,49 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+//
+// Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+
+#include <sof/math/vec.h>
+#include <stdint.h>
+
+/* log2(1 + f) for f in [0, 1), Chebyshev nodes fit with zero constant
+ * term for exact log2(1), Q2.30
+ */
+const int32_t vec_log2_coef[VEC_LOG2_NCOEF] = {
+	5673113,
+	-35052638,
+	101829719,
+	-192817251,
+	285362381,
+	-381367999,
+	515511779,
+	-774477404,
+	1549080120,
+	0,
+};
+
+/* 2^f for f in [0, 1), Chebyshev nodes fit, Q2.30 */
+const int32_t vec_exp2_coef[VEC_EXP2_NCOEF] = {
+	234782,
+	1330509,
+	10398316,
+	59571873,
+	257945486,
+	744260852,
+	1073741827,
+};
+
+/* Initial 1 / sqrt(m) for m in [0.25, 1), Chebyshev nodes fit, Q3.29 */
+const int32_t vec_rsqrt_coef[VEC_RSQRT_NCOEF] = {
+	817753277,
+	-1682537772,
+	1411245190,
+};
+
+void vec_sin_init(struct vec_sin_state *gen, uint32_t freq, uint32_t rate)
+{
+	/* Q16.16 Hz to Q0.32 cycles per sample */
+	gen->step = (uint32_t)(((uint64_t)freq << 16) / rate);
+	gen->phase = 0;
+}
@@ -0,0 +1,214 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+//
+// Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+
+#include <sof/math/vec.h>
+
+#if VEC_GENERIC
+
+#include <sof/audio/format.h>
+#include <sof/bit.h>
+#include <sof/common.h>
+#include <sof/math/trig.h>
+#include <stdint.h>
+
+#define ONE_Q30		Q_CONVERT_FLOAT(1.0, 30)
+#define HALF_Q31	Q_CONVERT_FLOAT(0.5, 31)
+#define C48_17_Q29	1515870810 /* 48 / 17 */
+#define C32_17_Q29	1010580540 /* 32 / 17 */
+
+/* Exponent of reciprocal, Q1.31 half of 1 / m times 2^(s - 21) is Q12.20 */
+#define INV_SHIFT	(61 - 2 * VEC_INV_QY)
+
+/* Fractional multiply, the result has the Q format of a if b is Q1.31 */
+static inline int32_t vec_mulf(int32_t a, int32_t b)
+{
+	return sat_int32(Q_MULTSR_32X32((int64_t)a, b, 31, 31, 31));
+}
+
+static inline int32_t vec_poly(const int32_t *coef, int ncoef, int32_t x)
+{
+	int32_t acc = coef[0];
+	int i;
+
+	for (i = 1; i < ncoef; i++)
+		acc = sat_int32((int64_t)vec_mulf(acc, x) + coef[i]);
+
+	return acc;
+}
+
+/* Shift of positive value to set bit 30 */
+static inline int vec_norm(int32_t x)
+{
+	return clz(x) - 1;
+}
+
+/*
+ * The input is normalized to m = 1 + f in [1, 2) and the result is
+ * log2(m) from a polynomial plus the exponent.
+ */
+void vec_log2_int32(const int32_t *x, int32_t *y, int n)
+{
+	int32_t f;
+	int32_t p;
+	int s;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		if (x[i] <= 0) {
+			y[i] = INT32_MIN;
+			continue;
+		}
+
+		s = vec_norm(x[i]);
+		f = (int32_t)((uint32_t)((x[i] << s) - ONE_Q30) << 1);
+		p = vec_poly(vec_log2_coef, VEC_LOG2_NCOEF, f);
+		y[i] = ((30 - s) << VEC_LOG2_OUTPUT_QY) +
+			Q_SHIFT_RND(p, 30, VEC_LOG2_OUTPUT_QY);
+	}
+}
+
+/*
+ * The exponent is split to integer and fraction parts, 2^f is from a
+ * polynomial and the integer part is applied as a shift.
+ */
+void vec_exp2_fixed(const int32_t *x, int32_t *y, int n)
+{
+	int32_t f;
+	int32_t p;
+	int e;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		e = x[i] >> VEC_EXP2_INPUT_QY;
+		f = (x[i] & ((1 << VEC_EXP2_INPUT_QY) - 1)) <<
+			(31 - VEC_EXP2_INPUT_QY);
+		p = vec_poly(vec_exp2_coef, VEC_EXP2_NCOEF, f);
+
+		/* Q2.30 mantissa times 2^e to Q12.20 */
+		if (e > 30 - VEC_EXP2_OUTPUT_QY)
+			y[i] = INT32_MAX;
+		else if (e == 30 - VEC_EXP2_OUTPUT_QY)
+			y[i] = p;
+		else if (e >= -VEC_EXP2_OUTPUT_QY - 1)
+			y[i] = Q_SHIFT_RND(p, 30 - e, VEC_EXP2_OUTPUT_QY);
+		else
+			y[i] = 0;
+	}
+}
+
+/*
+ * The input is normalized with an even shift to m in [0.25, 1). Half of
+ * 1 / sqrt(m) is refined with Newton-Raphson iterations h += h * (1 - e) / 2
+ * where e = m * (2 * h)^2, and then sqrt(m) = 2 * m * h.
+ */
+void vec_sqrt_fixed(const int32_t *x, int32_t *y, int n)
+{
+	int32_t m;
+	int32_t h;
+	int32_t e;
+	int s;
+	int i;
+	int j;
+
+	for (i = 0; i < n; i++) {
+		if (x[i] <= 0) {
+			y[i] = 0;
+			continue;
+		}
+
+		s = vec_norm(x[i]) & ~1;
+		m = x[i] << s;
+
+		/* Q3.29 initial 1 / sqrt(m) to Q1.31 half */
+		h = sat_int32((int64_t)vec_poly(vec_rsqrt_coef,
+						 VEC_RSQRT_NCOEF, m) << 1);
+		for (j = 0; j < VEC_RSQRT_ITERATIONS; j++) {
+			e = vec_mulf(vec_mulf(m, h), h);
+			h = sat_int32((int64_t)h +
+				      vec_mulf(h, HALF_Q31 - (e << 1)));
+		}
+
+		/* Shift back with half of normalization */
+		m = sat_int32((int64_t)vec_mulf(m, h) << 1);
+		y[i] = s ? Q_SHIFT_RND(m, 31 + (s >> 1), 31) : m;
+	}
+}
+
+/*
+ * The absolute value is normalized to m in [0.5, 1). Half of 1 / m is
+ * refined with Newton-Raphson iterations h += 2 * h * (0.5 - m * h) from
+ * the linear initial approximation 48 / 17 - 32 / 17 * m.
+ */
+void vec_inv_fixed(const int32_t *x, int32_t *y, int n)
+{
+	int32_t a;
+	int32_t m;
+	int32_t h;
+	int s;
+	int i;
+	int j;
+
+	for (i = 0; i < n; i++) {
+		if (!x[i]) {
+			y[i] = INT32_MAX;
+			continue;
+		}
+
+		a = x[i] > 0 ? x[i] : sat_int32(-(int64_t)x[i]);
+		s = vec_norm(a);
+		m = a << s;
+
+		h = sat_int32((int64_t)(C48_17_Q29 -
+					vec_mulf(C32_17_Q29, m)) << 1);
+		for (j = 0; j < VEC_INV_ITERATIONS; j++)
+			h = sat_int32((int64_t)h +
+				      ((int64_t)vec_mulf(h, HALF_Q31 -
+							 vec_mulf(m, h)) << 1));
+
+		if (s > INV_SHIFT)
+			a = INT32_MAX;
+		else if (s == INV_SHIFT)
+			a = h;
+		else
+			a = Q_SHIFT_RND(h, 31 + INV_SHIFT - s, 31);
+
+		y[i] = x[i] > 0 ? a : -a;
+	}
+}
+
+/*
+ * The quarter wave table is indexed with the top bits of phase and the
+ * remaining bits interpolate linearly between the table points.
+ */
+void vec_sin_fixed(struct vec_sin_state *gen, int32_t *y, int n)
+{
+	uint32_t phase = gen->phase;
+	uint32_t u;
+	int32_t s0;
+	int32_t s1;
+	int32_t frac;
+	int idx;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		/* Phase inside the quadrant, mirrored for falling quadrants */
+		u = phase & (BIT(30) - 1);
+		if (phase & BIT(30))
+			u = BIT(30) - u;
+
+		idx = u >> 21;
+		frac = (u & (BIT(21) - 1)) << 10;
+		s0 = sine_table[idx];
+		s1 = idx < SINE_NQUART ? sine_table[idx + 1] : s0;
+		s0 += vec_mulf(s1 - s0, frac);
+		y[i] = phase >> 31 ? -s0 : s0;
+		phase += gen->step;
+	}
+
+	gen->phase = phase;
+}
+
+#endif /* VEC_GENERIC */
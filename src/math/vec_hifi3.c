@@ -0,0 +1,289 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+//
+// Author: Seppo Ingalsuo <seppo.ingalsuo@linux.intel.com>
+
+#include <sof/math/vec.h>
+
+#if VEC_HIFI3
+
+#include <sof/audio/format.h>
+#include <sof/bit.h>
+#include <sof/math/trig.h>
+#include <xtensa/tie/xt_hifi3.h>
+#include <stdint.h>
+
+#define ONE_Q30		Q_CONVERT_FLOAT(1.0, 30)
+#define HALF_Q31	Q_CONVERT_FLOAT(0.5, 31)
+#define C48_17_Q29	1515870810 /* 48 / 17 */
+#define C32_17_Q29	1010580540 /* 32 / 17 */
+
+/* Exponent of reciprocal, Q1.31 half of 1 / m times 2^(s - 21) is Q12.20 */
+#define INV_SHIFT	(61 - 2 * VEC_INV_QY)
+
+/*
+ * The normalization, range reduction and final exponent shifts differ
+ * per sample and are done in AR registers. The polynomials and the
+ * Newton-Raphson iterations are computed for two samples at a time with
+ * the dual fractional multiply that rounds and saturates the same way as
+ * the generic version.
+ */
+
+/* Shift of positive value to set bit 30 */
+static inline int vec_norm(int32_t x)
+{
+	return AE_NSAZ32_L(AE_MOVDA32(x));
+}
+
+static inline ae_f32x2 vec_poly_x2(const int32_t *coef, int ncoef,
+				   ae_f32x2 x)
+{
+	ae_f32x2 acc = AE_MOVDA32(coef[0]);
+	int i;
+
+	for (i = 1; i < ncoef; i++)
+		acc = AE_ADD32S(AE_MULFP32X2RS(acc, x), AE_MOVDA32(coef[i]));
+
+	return acc;
+}
+
+static inline int32_t vec_log2_frac(int32_t x, int s)
+{
+	if (x <= 0)
+		return 0;
+
+	return (int32_t)((uint32_t)((x << s) - ONE_Q30) << 1);
+}
+
+static inline int32_t vec_log2_out(int32_t x, int s, int32_t p)
+{
+	if (x <= 0)
+		return INT32_MIN;
+
+	return ((30 - s) << VEC_LOG2_OUTPUT_QY) +
+		Q_SHIFT_RND(p, 30, VEC_LOG2_OUTPUT_QY);
+}
+
+void vec_log2_int32(const int32_t *x, int32_t *y, int n)
+{
+	ae_f32x2 p;
+	int32_t x0;
+	int32_t x1;
+	int s0;
+	int s1;
+	int i;
+
+	for (i = 0; i < n; i += 2) {
+		x0 = x[i];
+		x1 = i + 1 < n ? x[i + 1] : x0;
+		s0 = vec_norm(x0);
+		s1 = vec_norm(x1);
+		p = AE_MOVDA32X2(vec_log2_frac(x0, s0), vec_log2_frac(x1, s1));
+		p = vec_poly_x2(vec_log2_coef, VEC_LOG2_NCOEF, p);
+		y[i] = vec_log2_out(x0, s0, AE_MOVAD32_H(p));
+		if (i + 1 < n)
+			y[i + 1] = vec_log2_out(x1, s1, AE_MOVAD32_L(p));
+	}
+}
+
+static inline int32_t vec_exp2_frac(int32_t x)
+{
+	return (x & ((1 << VEC_EXP2_INPUT_QY) - 1)) <<
+		(31 - VEC_EXP2_INPUT_QY);
+}
+
+static inline int32_t vec_exp2_out(int32_t x, int32_t p)
+{
+	int e = x >> VEC_EXP2_INPUT_QY;
+
+	if (e > 30 - VEC_EXP2_OUTPUT_QY)
+		return INT32_MAX;
+	if (e == 30 - VEC_EXP2_OUTPUT_QY)
+		return p;
+	if (e >= -VEC_EXP2_OUTPUT_QY - 1)
+		return Q_SHIFT_RND(p, 30 - e, VEC_EXP2_OUTPUT_QY);
+
+	return 0;
+}
+
+void vec_exp2_fixed(const int32_t *x, int32_t *y, int n)
+{
+	ae_f32x2 p;
+	int32_t x0;
+	int32_t x1;
+	int i;
+
+	for (i = 0; i < n; i += 2) {
+		x0 = x[i];
+		x1 = i + 1 < n ? x[i + 1] : x0;
+		p = AE_MOVDA32X2(vec_exp2_frac(x0), vec_exp2_frac(x1));
+		p = vec_poly_x2(vec_exp2_coef, VEC_EXP2_NCOEF, p);
+		y[i] = vec_exp2_out(x0, AE_MOVAD32_H(p));
+		if (i + 1 < n)
+			y[i + 1] = vec_exp2_out(x1, AE_MOVAD32_L(p));
+	}
+}
+
+static inline int vec_sqrt_norm(int32_t x)
+{
+	return x > 0 ? vec_norm(x) & ~1 : 0;
+}
+
+static inline int32_t vec_sqrt_out(int32_t x, int s, int32_t r)
+{
+	if (x <= 0)
+		return 0;
+
+	return s ? Q_SHIFT_RND(r, 31 + (s >> 1), 31) : r;
+}
+
+void vec_sqrt_fixed(const int32_t *x, int32_t *y, int n)
+{
+	ae_f32x2 half = AE_MOVDA32(HALF_Q31);
+	ae_f32x2 m;
+	ae_f32x2 h;
+	ae_f32x2 e;
+	int32_t x0;
+	int32_t x1;
+	int s0;
+	int s1;
+	int i;
+	int j;
+
+	for (i = 0; i < n; i += 2) {
+		x0 = x[i];
+		x1 = i + 1 < n ? x[i + 1] : x0;
+		s0 = vec_sqrt_norm(x0);
+		s1 = vec_sqrt_norm(x1);
+		m = AE_MOVDA32X2(x0 > 0 ? x0 << s0 : HALF_Q31,
+				 x1 > 0 ? x1 << s1 : HALF_Q31);
+
+		/* Q3.29 initial 1 / sqrt(m) to Q1.31 half */
+		h = AE_SLAI32S(vec_poly_x2(vec_rsqrt_coef, VEC_RSQRT_NCOEF, m),
+			       1);
+		for (j = 0; j < VEC_RSQRT_ITERATIONS; j++) {
+			e = AE_MULFP32X2RS(AE_MULFP32X2RS(m, h), h);
+			e = AE_SUB32S(half, AE_SLAI32S(e, 1));
+			h = AE_ADD32S(h, AE_MULFP32X2RS(h, e));
+		}
+
+		m = AE_SLAI32S(AE_MULFP32X2RS(m, h), 1);
+		y[i] = vec_sqrt_out(x0, s0, AE_MOVAD32_H(m));
+		if (i + 1 < n)
+			y[i + 1] = vec_sqrt_out(x1, s1, AE_MOVAD32_L(m));
+	}
+}
+
+static inline int32_t vec_inv_abs(int32_t x)
+{
+	if (!x)
+		return HALF_Q31;
+
+	return x > 0 ? x : sat_int32(-(int64_t)x);
+}
+
+static inline int32_t vec_inv_out(int32_t x, int s, int32_t h)
+{
+	int32_t a;
+
+	if (!x)
+		return INT32_MAX;
+
+	if (s > INV_SHIFT)
+		a = INT32_MAX;
+	else if (s == INV_SHIFT)
+		a = h;
+	else
+		a = Q_SHIFT_RND(h, 31 + INV_SHIFT - s, 31);
+
+	return x > 0 ? a : -a;
+}
+
+void vec_inv_fixed(const int32_t *x, int32_t *y, int n)
+{
+	ae_f32x2 c48 = AE_MOVDA32(C48_17_Q29);
+	ae_f32x2 c32 = AE_MOVDA32(C32_17_Q29);
+	ae_f32x2 half = AE_MOVDA32(HALF_Q31);
+	ae_f32x2 m;
+	ae_f32x2 h;
+	ae_f32x2 e;
+	int32_t a0;
+	int32_t a1;
+	int32_t x0;
+	int32_t x1;
+	int s0;
+	int s1;
+	int i;
+	int j;
+
+	for (i = 0; i < n; i += 2) {
+		x0 = x[i];
+		x1 = i + 1 < n ? x[i + 1] : x0;
+		a0 = vec_inv_abs(x0);
+		a1 = vec_inv_abs(x1);
+		s0 = vec_norm(a0);
+		s1 = vec_norm(a1);
+		m = AE_MOVDA32X2(a0 << s0, a1 << s1);
+
+		h = AE_SLAI32S(AE_SUB32S(c48, AE_MULFP32X2RS(c32, m)), 1);
+		for (j = 0; j < VEC_INV_ITERATIONS; j++) {
+			e = AE_SUB32S(half, AE_MULFP32X2RS(m, h));
+			h = AE_ADD32S(h, AE_SLAI32S(AE_MULFP32X2RS(h, e), 1));
+		}
+
+		y[i] = vec_inv_out(x0, s0, AE_MOVAD32_H(h));
+		if (i + 1 < n)
+			y[i + 1] = vec_inv_out(x1, s1, AE_MOVAD32_L(h));
+	}
+}
+
+/* Quarter wave table point, next point and interpolation fraction */
+static inline void vec_sin_lookup(uint32_t phase, int32_t *s0, int32_t *d,
+				  int32_t *frac)
+{
+	uint32_t u = phase & (BIT(30) - 1);
+	int idx;
+
+	if (phase & BIT(30))
+		u = BIT(30) - u;
+
+	idx = u >> 21;
+	*frac = (u & (BIT(21) - 1)) << 10;
+	*s0 = sine_table[idx];
+	*d = idx < SINE_NQUART ? sine_table[idx + 1] - *s0 : 0;
+}
+
+void vec_sin_fixed(struct vec_sin_state *gen, int32_t *y, int n)
+{
+	ae_f32x2 s;
+	uint32_t phase = gen->phase;
+	int32_t s0;
+	int32_t s1;
+	int32_t d0;
+	int32_t d1;
+	int32_t f0;
+	int32_t f1;
+	int32_t v;
+	int i;
+
+	for (i = 0; i < n; i += 2) {
+		vec_sin_lookup(phase, &s0, &d0, &f0);
+		vec_sin_lookup(phase + gen->step, &s1, &d1, &f1);
+		s = AE_MULFP32X2RS(AE_MOVDA32X2(d0, d1), AE_MOVDA32X2(f0, f1));
+		s = AE_ADD32S(s, AE_MOVDA32X2(s0, s1));
+
+		v = AE_MOVAD32_H(s);
+		y[i] = phase >> 31 ? -v : v;
+		phase += gen->step;
+		if (i + 1 < n) {
+			v = AE_MOVAD32_L(s);
+			y[i + 1] = phase >> 31 ? -v : v;
+			phase += gen->step;
+		}
+	}
+
+	gen->phase = phase;
+}
+
+#endif /* VEC_HIFI3 */
@@ -1038,10 +1038,12 @@ int probe_point_add(uint32_t count, struct probe_point *probe)
 		_probe->probe_points[first_free].stream_tag =
 			probe[i].stream_tag;
 
-		notifier_register(_probe, dev->cb, NOTIFIER_ID_BUFFER_PRODUCE,
-				  &probe_cb_produce, 0);
-		notifier_register(_probe, dev->cb, NOTIFIER_ID_BUFFER_FREE,
-				  &probe_cb_free, 0);
+		buffer_notifier_register(_probe, dev->cb,
+					 NOTIFIER_ID_BUFFER_PRODUCE,
+					 &probe_cb_produce, 0);
+		buffer_notifier_register(_probe, dev->cb,
+					 NOTIFIER_ID_BUFFER_FREE,
+					 &probe_cb_free, 0);
 	}
 
 	return 0;
@@ -1106,10 +1108,10 @@ int probe_point_remove(uint32_t count, uint32_t *buffer_id)
 			    _probe->probe_points[j].buffer_id == buffer_id[i]) {
 				dev = ipc_get_comp_by_id(ipc_get(), buffer_id[i]);
 				if (dev) {
-					notifier_unregister(_probe, dev->cb,
-							    NOTIFIER_ID_BUFFER_PRODUCE);
-					notifier_unregister(_probe, dev->cb,
-							    NOTIFIER_ID_BUFFER_FREE);
+					buffer_notifier_unregister(_probe,
+						dev->cb, NOTIFIER_ID_BUFFER_PRODUCE);
+					buffer_notifier_unregister(_probe,
+						dev->cb, NOTIFIER_ID_BUFFER_FREE);
 				}
 
 				_probe->probe_points[j].stream_tag =
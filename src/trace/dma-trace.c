@@ -5,8 +5,10 @@
 // Author: Yan Wang <yan.wang@linux.intel.com>
 
 #include <sof/audio/buffer.h>
+#include <sof/atomic.h>
 #include <sof/common.h>
 #include <sof/debug/panic.h>
+#include <sof/drivers/interrupt.h>
 #include <sof/drivers/ipc.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/cache.h>
@@ -26,12 +28,34 @@
 #include <ipc/trace.h>
 #include <kernel/abi.h>
 #include <user/abi_dbg.h>
+#include <user/trace.h>
 #include <version.h>
 
 #include <errno.h>
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
+/* per-core ring size, power of 2 like DMA_TRACE_LOCAL_SIZE */
+#define DMA_TRACE_RING_SIZE	(DMA_TRACE_LOCAL_SIZE / 4)
+#define DMA_TRACE_RING_MASK	(DMA_TRACE_RING_SIZE - 1)
+
+/* ring records are a length word followed by the event, word aligned */
+#define DMA_TRACE_RING_RECORD(length) \
+	(sizeof(uint32_t) + ALIGN_UP(length, sizeof(uint32_t)))
+
+STATIC_ASSERT(!(DMA_TRACE_RING_SIZE & DMA_TRACE_RING_MASK),
+	      dma_trace_ring_size_not_power_of_2);
+STATIC_ASSERT(DMA_TRACE_RING_RECORD(DMA_TRACE_LOCAL_SIZE / 8) <=
+	      DMA_TRACE_RING_SIZE, dma_trace_ring_too_small);
+
+/* head record of a ring waiting to be merged */
+struct dtrace_ring_head {
+	uint64_t timestamp;
+	uint32_t length;
+	bool pending;
+};
+
 /* 58782c63-1326-4185-8459-22272e12d1f1 */
 DECLARE_SOF_UUID("dma-trace", dma_trace_uuid, 0x58782c63, 0x1326, 0x4185,
 		 0x84, 0x59, 0x22, 0x27, 0x2e, 0x12, 0xd1, 0xf1);
@@ -45,6 +69,7 @@ DECLARE_SOF_UUID("dma-trace-task", dma_trace_task_uuid, 0x2b972272, 0xc5b1,
 static int dma_trace_get_avail_data(struct dma_trace_data *d,
 				    struct dma_trace_buf *buffer,
 				    int avail);
+static void dtrace_merge(struct dma_trace_data *d);
 
 static enum task_state trace_work(void *data)
 {
@@ -52,10 +77,17 @@ static enum task_state trace_work(void *data)
 	struct dma_trace_buf *buffer = &d->dmatb;
 	struct dma_sg_config *config = &d->config;
 	unsigned long flags;
-	uint32_t avail = buffer->avail;
+	uint32_t avail;
 	int32_t size;
 	uint32_t overflow;
 
+	/* collect the new events of all cores */
+	spin_lock_irq(&d->lock, flags);
+	dtrace_merge(d);
+	spin_unlock_irq(&d->lock, flags);
+
+	avail = buffer->avail;
+
 	/* make sure we don't write more than buffer */
 	if (avail > DMA_TRACE_LOCAL_SIZE) {
 		overflow = avail - DMA_TRACE_LOCAL_SIZE;
@@ -184,12 +216,52 @@ int dma_trace_host_buffer(struct dma_trace_data *d,
 }
 #endif
 
+static struct dma_trace_ring *dma_trace_rings_init(void)
+{
+	struct dma_trace_ring *rings;
+	int i;
+
+	rings = rballoc(0, SOF_MEM_CAPS_RAM,
+			sizeof(*rings) * PLATFORM_CORE_COUNT);
+	if (!rings)
+		return NULL;
+
+	bzero(rings, sizeof(*rings) * PLATFORM_CORE_COUNT);
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		rings[i].addr = rballoc(0, SOF_MEM_CAPS_RAM,
+					DMA_TRACE_RING_SIZE);
+		if (!rings[i].addr)
+			goto err;
+	}
+
+	dcache_writeback_region(rings, sizeof(*rings) * PLATFORM_CORE_COUNT);
+
+	return rings;
+
+err:
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		rfree(rings[i].addr);
+	rfree(rings);
+
+	return NULL;
+}
+
 static int dma_trace_buffer_init(struct dma_trace_data *d)
 {
 	struct dma_trace_buf *buffer = &d->dmatb;
 	void *buf;
 	unsigned int flags;
 
+	/* per-core rings are kept with their events when re-enabled */
+	if (!d->rings) {
+		d->rings = dma_trace_rings_init();
+		if (!d->rings) {
+			tr_err(&dt_tr, "dma_trace_buffer_init(): rings alloc failed");
+			return -ENOMEM;
+		}
+	}
+
 	/* allocate new buffer */
 	buf = rballoc(0, SOF_MEM_CAPS_RAM | SOF_MEM_CAPS_DMA,
 		      DMA_TRACE_LOCAL_SIZE);
@@ -337,7 +409,7 @@ int dma_trace_enable(struct dma_trace_data *d)
 #endif
 
 	/* flush fw description message */
-	trace_flush();
+	trace_flush(false);
 
 	/* validate DMA context */
 	if (!d->dc.dmac || !d->dc.chan) {
@@ -355,13 +427,14 @@ out:
 	return err;
 }
 
-void dma_trace_flush(void *t)
+void dma_trace_flush(void *t, bool panic)
 {
 	struct dma_trace_data *trace_data = dma_trace_data_get();
 	struct dma_trace_buf *buffer = NULL;
 	uint32_t avail;
 	int32_t size;
 	int32_t wrap_count;
+	bool locked;
 	int ret;
 
 	if (!trace_data || !trace_data->dmatb.addr) {
@@ -370,6 +443,23 @@ void dma_trace_flush(void *t)
 	}
 
 	buffer = &trace_data->dmatb;
+
+	/*
+	 * Called with the trace lock held and interrupts disabled. On
+	 * panic the dma trace lock may be held by the interrupted code,
+	 * so it is only tried and the buffer is flushed without merging
+	 * the rings if that fails.
+	 */
+	if (panic) {
+		locked = spin_try_lock(&trace_data->lock);
+	} else {
+		spin_lock(&trace_data->lock);
+		locked = true;
+	}
+
+	if (locked)
+		dtrace_merge(trace_data);
+
 	avail = buffer->avail;
 
 	/* number of bytes to flush */
@@ -407,6 +497,9 @@ void dma_trace_flush(void *t)
 	/* writeback trace data */
 	dcache_writeback_region((void *)t, size);
 
+	if (locked)
+		spin_unlock(&trace_data->lock);
+
 	platform_shared_commit(trace_data, sizeof(*trace_data));
 }
 
@@ -464,109 +557,274 @@ static int dtrace_calc_buf_overflow(struct dma_trace_buf *buffer,
 	return overflow;
 }
 
-static void dtrace_add_event(const char *e, uint32_t length)
+static void dtrace_buf_put(struct dma_trace_buf *buffer, const char *e,
+			   uint32_t length)
 {
-	struct dma_trace_data *trace_data = dma_trace_data_get();
-	struct dma_trace_buf *buffer = &trace_data->dmatb;
-	uint32_t margin;
-	uint32_t overflow;
+	uint32_t margin = dtrace_calc_buf_margin(buffer);
 	int ret;
 
-	margin = dtrace_calc_buf_margin(buffer);
-	overflow = dtrace_calc_buf_overflow(buffer, length);
+	/* check for buffer wrap */
+	if (margin > length) {
+		/* no wrap */
+		dcache_invalidate_region(buffer->w_ptr, length);
+		ret = memcpy_s(buffer->w_ptr, length, e, length);
+		assert(!ret);
+		dcache_writeback_region(buffer->w_ptr, length);
+		buffer->w_ptr = (char *)buffer->w_ptr + length;
+	} else {
+		/* data is bigger than remaining margin so we wrap */
+		dcache_invalidate_region(buffer->w_ptr, margin);
+		ret = memcpy_s(buffer->w_ptr, margin, e, margin);
+		assert(!ret);
+		dcache_writeback_region(buffer->w_ptr, margin);
+		buffer->w_ptr = buffer->addr;
 
-	/* tracing dropped entries */
-	if (trace_data->dropped_entries) {
-		if (!overflow) {
-			/*
-			 * if any dropped entries have appeared and there
-			 * is not any overflow, their amount will be logged
-			 */
-			uint32_t tmp_dropped_entries =
-				trace_data->dropped_entries;
-			trace_data->dropped_entries = 0;
-			/*
-			 * this trace_error invocation causes recursion,
-			 * so after it we have to recalculate margin and
-			 * overflow
-			 */
-			tr_err(&dt_tr, "dtrace_add_event(): number of dropped logs = %u",
-			       tmp_dropped_entries);
-			margin = dtrace_calc_buf_margin(buffer);
-			overflow = dtrace_calc_buf_overflow(buffer, length);
-		}
+		dcache_invalidate_region(buffer->w_ptr, length - margin);
+		ret = memcpy_s(buffer->w_ptr, length - margin,
+			       e + margin, length - margin);
+		assert(!ret);
+		dcache_writeback_region(buffer->w_ptr, length - margin);
+		buffer->w_ptr = (char *)buffer->w_ptr + length - margin;
 	}
+}
 
-	/* checking overflow */
-	if (!overflow) {
-		/* check for buffer wrap */
-		if (margin > length) {
-			/* no wrap */
-			dcache_invalidate_region(buffer->w_ptr, length);
-			ret = memcpy_s(buffer->w_ptr, length, e, length);
-			assert(!ret);
-			dcache_writeback_region(buffer->w_ptr, length);
-			buffer->w_ptr = (char *)buffer->w_ptr + length;
-		} else {
-			/* data is bigger than remaining margin so we wrap */
-			dcache_invalidate_region(buffer->w_ptr, margin);
-			ret = memcpy_s(buffer->w_ptr, margin, e, margin);
-			assert(!ret);
-			dcache_writeback_region(buffer->w_ptr, margin);
-			buffer->w_ptr = buffer->addr;
-
-			dcache_invalidate_region(buffer->w_ptr,
-						 length - margin);
-			ret = memcpy_s(buffer->w_ptr, length - margin,
-				       e + margin, length - margin);
-			assert(!ret);
-			dcache_writeback_region(buffer->w_ptr,
-						length - margin);
-			buffer->w_ptr = (char *)buffer->w_ptr + length - margin;
+/* reads position published by the other side of the ring */
+static inline uint32_t dtrace_ring_pos(struct dma_trace_ring_pos *p)
+{
+	dcache_invalidate_region(p, sizeof(*p));
+
+	return atomic_read(&p->pos);
+}
+
+static inline void dtrace_ring_pos_set(struct dma_trace_ring_pos *p,
+				       uint32_t pos)
+{
+	/* data has to be in place before its position is published */
+	memory_barrier();
+
+	atomic_set(&p->pos, pos);
+
+	dcache_writeback_region(p, sizeof(*p));
+}
+
+static void dtrace_ring_write(struct dma_trace_ring *ring, uint32_t pos,
+			      const void *data, uint32_t bytes)
+{
+	uint32_t offset = pos & DMA_TRACE_RING_MASK;
+	uint32_t head = MIN(bytes, DMA_TRACE_RING_SIZE - offset);
+	int ret;
+
+	ret = memcpy_s(ring->addr + offset, head, data, head);
+	assert(!ret);
+	dcache_writeback_region(ring->addr + offset, head);
+
+	if (head < bytes) {
+		ret = memcpy_s(ring->addr, bytes - head,
+			       (const char *)data + head, bytes - head);
+		assert(!ret);
+		dcache_writeback_region(ring->addr, bytes - head);
+	}
+}
+
+static void dtrace_ring_read(struct dma_trace_ring *ring, uint32_t pos,
+			     void *data, uint32_t bytes)
+{
+	uint32_t offset = pos & DMA_TRACE_RING_MASK;
+	uint32_t head = MIN(bytes, DMA_TRACE_RING_SIZE - offset);
+	int ret;
+
+	dcache_invalidate_region(ring->addr + offset, head);
+	ret = memcpy_s(data, head, ring->addr + offset, head);
+	assert(!ret);
+
+	if (head < bytes) {
+		dcache_invalidate_region(ring->addr, bytes - head);
+		ret = memcpy_s((char *)data + head, bytes - head,
+			       ring->addr, bytes - head);
+		assert(!ret);
+	}
+}
+
+/* moves event from the ring to the DMA buffer without bouncing it */
+static void dtrace_ring_to_buf(struct dma_trace_ring *ring,
+			       struct dma_trace_buf *buffer, uint32_t pos,
+			       uint32_t length)
+{
+	uint32_t offset = pos & DMA_TRACE_RING_MASK;
+	uint32_t head = MIN(length, DMA_TRACE_RING_SIZE - offset);
+
+	dcache_invalidate_region(ring->addr + offset, head);
+	dtrace_buf_put(buffer, ring->addr + offset, head);
+
+	if (head < length) {
+		dcache_invalidate_region(ring->addr, length - head);
+		dtrace_buf_put(buffer, ring->addr, length - head);
+	}
+}
+
+static bool dtrace_ring_peek(struct dma_trace_ring *ring,
+			     struct dtrace_ring_head *head)
+{
+	uint32_t r = atomic_read(&ring->r_pos.pos);
+	struct log_entry_header hdr;
+
+	if (r == dtrace_ring_pos(&ring->w_pos))
+		return false;
+
+	dtrace_ring_read(ring, r, &head->length, sizeof(head->length));
+
+	/* events without a header go first */
+	head->timestamp = 0;
+	if (head->length >= sizeof(hdr)) {
+		dtrace_ring_read(ring, r + sizeof(uint32_t), &hdr, sizeof(hdr));
+		head->timestamp = hdr.timestamp;
+	}
+
+	return true;
+}
+
+/*
+ * Moves events from the per-core rings to the DMA buffer in timestamp
+ * order. Events that don't fit stay in their rings until the host has
+ * read enough of the DMA buffer.
+ */
+static void dtrace_merge(struct dma_trace_data *d)
+{
+	struct dtrace_ring_head heads[PLATFORM_CORE_COUNT];
+	struct dma_trace_buf *buffer = &d->dmatb;
+	struct dma_trace_ring *ring;
+	uint32_t r;
+	int next;
+	int i;
+
+	if (!d->rings || !buffer->addr)
+		return;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		heads[i].pending = false;
+
+	for (;;) {
+		next = -1;
+
+		for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+			if (!heads[i].pending)
+				heads[i].pending = dtrace_ring_peek(&d->rings[i],
+								    &heads[i]);
+
+			if (heads[i].pending &&
+			    (next < 0 ||
+			     heads[i].timestamp < heads[next].timestamp))
+				next = i;
 		}
 
-		buffer->avail += length;
-		trace_data->posn.messages++;
-	} else {
-		/* if there is not enough memory for new log, we drop it */
-		trace_data->dropped_entries++;
+		if (next < 0 ||
+		    dtrace_calc_buf_overflow(buffer, heads[next].length))
+			break;
+
+		ring = &d->rings[next];
+		r = atomic_read(&ring->r_pos.pos);
+		dtrace_ring_to_buf(ring, buffer, r + sizeof(uint32_t),
+				   heads[next].length);
+		dtrace_ring_pos_set(&ring->r_pos,
+				    r + DMA_TRACE_RING_RECORD(heads[next].length));
+		heads[next].pending = false;
+
+		buffer->avail += heads[next].length;
+		d->posn.messages++;
 	}
 
-	platform_shared_commit(trace_data, sizeof(*trace_data));
+	platform_shared_commit(d, sizeof(*d));
+}
+
+static uint32_t dtrace_ring_free(struct dma_trace_ring *ring, uint32_t w)
+{
+	return DMA_TRACE_RING_SIZE - (w - dtrace_ring_pos(&ring->r_pos));
+}
+
+/* called on the ring owner core with local interrupts disabled */
+static void dtrace_add_event(struct dma_trace_data *trace_data,
+			     const char *e, uint32_t length)
+{
+	struct dma_trace_ring *ring = &trace_data->rings[cpu_get_id()];
+	uint32_t size = DMA_TRACE_RING_RECORD(length);
+	uint32_t w = atomic_read(&ring->w_pos.pos);
+
+	/* tracing dropped entries */
+	if (ring->dropped_entries && dtrace_ring_free(ring, w) >= size) {
+		/*
+		 * if any dropped entries have appeared and there
+		 * is not any overflow, their amount will be logged
+		 */
+		uint32_t tmp_dropped_entries = ring->dropped_entries;
+
+		ring->dropped_entries = 0;
+		/*
+		 * this trace_error invocation causes recursion,
+		 * so after it we have to read write position again
+		 */
+		tr_err(&dt_tr, "dtrace_add_event(): number of dropped logs = %u",
+		       tmp_dropped_entries);
+		w = atomic_read(&ring->w_pos.pos);
+	}
+
+	/* if there is not enough memory for new log, we drop it */
+	if (dtrace_ring_free(ring, w) < size) {
+		ring->dropped_entries++;
+		return;
+	}
+
+	dtrace_ring_write(ring, w, &length, sizeof(length));
+	dtrace_ring_write(ring, w + sizeof(uint32_t), e, length);
+	dtrace_ring_pos_set(&ring->w_pos, w + size);
+}
+
+/* DMA buffer or any core ring is half full */
+static bool dtrace_copy_needed(struct dma_trace_data *trace_data)
+{
+	struct dma_trace_ring *ring;
+	int i;
+
+	if (trace_data->dmatb.avail >= DMA_TRACE_LOCAL_SIZE / 2)
+		return true;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++) {
+		ring = &trace_data->rings[i];
+		if (dtrace_ring_pos(&ring->w_pos) -
+		    dtrace_ring_pos(&ring->r_pos) >= DMA_TRACE_RING_SIZE / 2)
+			return true;
+	}
+
+	return false;
 }
 
 void dtrace_event(const char *e, uint32_t length)
 {
 	struct dma_trace_data *trace_data = dma_trace_data_get();
-	struct dma_trace_buf *buffer = NULL;
-	unsigned long flags;
+	uint32_t flags;
 
-	if (!trace_data || !trace_data->dmatb.addr ||
+	if (!trace_data || !trace_data->rings ||
 	    length > DMA_TRACE_LOCAL_SIZE / 8 || length == 0) {
 		platform_shared_commit(trace_data, sizeof(*trace_data));
 		return;
 	}
 
-	buffer = &trace_data->dmatb;
-
-	spin_lock_irq(&trace_data->lock, flags);
-	dtrace_add_event(e, length);
+	/* only this core writes its ring, no lock needed */
+	irq_local_disable(flags);
+	dtrace_add_event(trace_data, e, length);
+	irq_local_enable(flags);
 
 	/* if DMA trace copying is working or secondary core
-	 * don't check if local buffer is half full
+	 * don't check if local buffer is half full, secondary
+	 * core rings are checked on the primary core
 	 */
 	if (trace_data->copy_in_progress ||
 	    cpu_get_id() != PLATFORM_PRIMARY_CORE_ID) {
 		platform_shared_commit(trace_data, sizeof(*trace_data));
-		spin_unlock_irq(&trace_data->lock, flags);
 		return;
 	}
 
-	spin_unlock_irq(&trace_data->lock, flags);
-
 	/* schedule copy now if buffer > 50% full */
-	if (trace_data->enabled &&
-	    buffer->avail >= (DMA_TRACE_LOCAL_SIZE / 2)) {
+	if (trace_data->enabled && dtrace_copy_needed(trace_data)) {
 		reschedule_task(&trace_data->dmat_work,
 				DMA_TRACE_RESCHEDULE_TIME);
 		/* reschedule should not be interrupted
@@ -581,12 +839,15 @@ void dtrace_event(const char *e, uint32_t length)
 void dtrace_event_atomic(const char *e, uint32_t length)
 {
 	struct dma_trace_data *trace_data = dma_trace_data_get();
+	uint32_t flags;
 
-	if (!trace_data || !trace_data->dmatb.addr ||
+	if (!trace_data || !trace_data->rings ||
 	    length > DMA_TRACE_LOCAL_SIZE / 8 || length == 0) {
 		platform_shared_commit(trace_data, sizeof(*trace_data));
 		return;
 	}
 
-	dtrace_add_event(e, length);
+	irq_local_disable(flags);
+	dtrace_add_event(trace_data, e, length);
+	irq_local_enable(flags);
 }
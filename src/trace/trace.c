@@ -298,7 +298,8 @@ int trace_filter_update(const struct trace_filter *filter)
 	return ret > 0 ? ret : -EINVAL;
 }
 
-void trace_flush(void)
+/* On panic the dma trace lock is only tried, it may be held already */
+void trace_flush(bool panic)
 {
 	struct trace *trace = trace_get();
 	volatile uint64_t *t;
@@ -310,7 +311,7 @@ void trace_flush(void)
 	t = (volatile uint64_t *)(MAILBOX_TRACE_BASE + trace->pos);
 
 	/* flush dma trace messages */
-	dma_trace_flush((void *)t);
+	dma_trace_flush((void *)t, panic);
 
 	platform_shared_commit(trace, sizeof(*trace));
 
@@ -0,0 +1,174 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <sof/audio/asrc/asrc_farrow.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+
+#define NUM_CHANNELS		2
+#define NUM_FRAMES_IN		480
+#define NUM_FRAMES_OUT		1024
+
+/* A slight clock skew so that the time values don't repeat */
+#define TEST_SKEW		Q_CONVERT_FLOAT(1.0001, 30)
+
+struct test_rate {
+	int fs_in;
+	int fs_out;
+};
+
+static struct asrc_farrow *asrc_block_new(int fs_in, int fs_out)
+{
+	struct asrc_farrow *src_obj;
+	int size;
+
+	assert_int_equal(asrc_get_required_size(NULL, &size, NUM_CHANNELS,
+						32), ASRC_EC_OK);
+	src_obj = calloc(1, size);
+	assert_non_null(src_obj);
+
+	assert_int_equal(asrc_initialise(NULL, src_obj, NUM_CHANNELS,
+					 fs_in, fs_out,
+					 ASRC_IOF_INTERLEAVED,
+					 ASRC_IOF_INTERLEAVED,
+					 ASRC_BM_LINEAR, NUM_FRAMES_OUT, 32,
+					 ASRC_CM_FEEDBACK, ASRC_OM_PUSH),
+			 ASRC_EC_OK);
+	assert_int_equal(asrc_update_drift(NULL, src_obj, TEST_SKEW),
+			 ASRC_EC_OK);
+
+	return src_obj;
+}
+
+/* The block impulse responses must match the per frame ones bit exact */
+static void test_audio_asrc_block_impulse_response(void **state)
+{
+	const struct test_rate *rate = *state;
+	struct asrc_farrow *src_obj = asrc_block_new(rate->fs_in,
+						     rate->fs_out);
+	int32_t *ref;
+	int length = src_obj->filter_length;
+	int n;
+
+	ref = malloc(ASRC_BLOCK_LENGTH * length * sizeof(int32_t));
+	assert_non_null(ref);
+
+	for (n = 0; n < ASRC_BLOCK_LENGTH; n++) {
+		src_obj->time_value = n * src_obj->fs_ratio /
+			ASRC_BLOCK_LENGTH;
+		src_obj->block_time[n] = src_obj->time_value;
+		(*src_obj->calc_ir)(src_obj);
+		memcpy(&ref[n * length], src_obj->impulse_response,
+		       length * sizeof(int32_t));
+	}
+
+	asrc_calc_impulse_response_block(src_obj, ASRC_BLOCK_LENGTH);
+	assert_memory_equal(src_obj->impulse_response, ref,
+			    ASRC_BLOCK_LENGTH * length * sizeof(int32_t));
+
+	free(ref);
+	free(src_obj);
+}
+
+/* The output must not depend on how the input is split into process
+ * calls, the queued frames are flushed at the end of every call.
+ */
+static void test_audio_asrc_block_push32(void **state)
+{
+	const struct test_rate *rate = *state;
+	struct asrc_farrow *block_obj = asrc_block_new(rate->fs_in,
+						       rate->fs_out);
+	struct asrc_farrow *frame_obj = asrc_block_new(rate->fs_in,
+						       rate->fs_out);
+	int32_t in[NUM_FRAMES_IN * NUM_CHANNELS];
+	int32_t out[NUM_FRAMES_OUT * NUM_CHANNELS];
+	int32_t ref[NUM_FRAMES_OUT * NUM_CHANNELS];
+	int32_t *in_ch[NUM_CHANNELS];
+	int32_t *out_ch[NUM_CHANNELS];
+	int ref_frames = 0;
+	int in_frames;
+	int out_frames;
+	int idx;
+	int ch;
+	int i;
+
+	/* Full scale ramps, the channels in opposite directions */
+	for (i = 0; i < NUM_FRAMES_IN; i++) {
+		in[i * NUM_CHANNELS] = (i * 4649 % 65536 - 32768) * 4096;
+		in[i * NUM_CHANNELS + 1] = -in[i * NUM_CHANNELS];
+	}
+
+	/* reference with one input frame per call */
+	for (i = 0; i < NUM_FRAMES_IN; i++) {
+		for (ch = 0; ch < NUM_CHANNELS; ch++) {
+			in_ch[ch] = &in[i * NUM_CHANNELS + ch];
+			out_ch[ch] = &ref[ref_frames * NUM_CHANNELS + ch];
+		}
+
+		in_frames = 1;
+		assert_int_equal(asrc_process_push32(NULL, frame_obj,
+						     in_ch, &in_frames,
+						     out_ch, &out_frames,
+						     &idx, 0), ASRC_EC_OK);
+		assert_int_equal(in_frames, 1);
+		ref_frames += out_frames;
+		assert_true(ref_frames <= NUM_FRAMES_OUT);
+	}
+
+	/* all input at once, the filtering is done in full blocks */
+	for (ch = 0; ch < NUM_CHANNELS; ch++) {
+		in_ch[ch] = &in[ch];
+		out_ch[ch] = &out[ch];
+	}
+
+	in_frames = NUM_FRAMES_IN;
+	assert_int_equal(asrc_process_push32(NULL, block_obj,
+					     in_ch, &in_frames,
+					     out_ch, &out_frames,
+					     &idx, 0), ASRC_EC_OK);
+	assert_int_equal(in_frames, NUM_FRAMES_IN);
+	assert_int_equal(out_frames, ref_frames);
+	assert_memory_equal(out, ref,
+			    ref_frames * NUM_CHANNELS * sizeof(int32_t));
+
+	free(block_obj);
+	free(frame_obj);
+}
+
+static struct test_rate rates[] = {
+	{ 44100, 48000 },
+	{ 48000, 48000 },
+};
+
+int main(void)
+{
+	struct CMUnitTest tests[ARRAY_SIZE(rates) * 2];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(rates); i++) {
+		tests[2 * i].name = "test_audio_asrc_block_impulse_response";
+		tests[2 * i].test_func = test_audio_asrc_block_impulse_response;
+		tests[2 * i].initial_state = &rates[i];
+		tests[2 * i].setup_func = NULL;
+		tests[2 * i].teardown_func = NULL;
+
+		tests[2 * i + 1].name = "test_audio_asrc_block_push32";
+		tests[2 * i + 1].test_func = test_audio_asrc_block_push32;
+		tests[2 * i + 1].initial_state = &rates[i];
+		tests[2 * i + 1].setup_func = NULL;
+		tests[2 * i + 1].teardown_func = NULL;
+	}
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+static struct comp_buffer *test_alias_buffer_new(uint32_t size, bool spsc)
+{
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = size
+	};
+	struct comp_buffer *buf = buffer_new(&test_buf_desc);
+
+	if (buf)
+		buf->spsc = spsc;
+
+	return buf;
+}
+
+static void test_alias_produce(struct comp_buffer *buf, uint8_t first,
+			       uint32_t bytes)
+{
+	uint8_t *ptr = buf->stream.w_ptr;
+	uint32_t i;
+
+	for (i = 0; i < bytes; i++) {
+		*ptr++ = first + i;
+		if ((void *)ptr >= buf->stream.end_addr)
+			ptr = buf->stream.addr;
+	}
+
+	comp_update_buffer_produce(buf, bytes);
+}
+
+static void test_audio_buffer_alias_pass(bool spsc)
+{
+	struct comp_buffer *source = test_alias_buffer_new(16, spsc);
+	struct comp_buffer *sink = test_alias_buffer_new(16, spsc);
+	void *own_addr = sink->stream.addr;
+	uint8_t *last;
+
+	assert_non_null(source);
+	assert_non_null(sink);
+
+	test_alias_produce(source, 0, 8);
+	comp_update_buffer_consume(source, 4);
+
+	assert_int_equal(buffer_alias(sink, source), 0);
+	assert_ptr_equal(sink->stream.addr, source->stream.addr);
+	assert_ptr_equal(sink->stream.r_ptr, source->stream.r_ptr);
+	assert_int_equal(audio_stream_get_avail_bytes(&sink->stream), 0);
+
+	/* data produced to the source is passed on sync */
+	buffer_alias_sync(sink);
+	assert_int_equal(audio_stream_get_avail_bytes(&sink->stream), 4);
+	assert_int_equal(*(uint8_t *)sink->stream.r_ptr, 4);
+
+	/* data consumed from the sink is consumed from the source */
+	comp_update_buffer_consume(sink, 2);
+	assert_int_equal(audio_stream_get_avail_bytes(&source->stream), 2);
+	assert_ptr_equal(sink->stream.r_ptr, source->stream.r_ptr);
+
+	/* wraps around the end of the buffer */
+	test_alias_produce(source, 8, 12);
+	assert_int_equal(audio_stream_get_avail_bytes(&sink->stream), 2);
+	buffer_alias_sync(sink);
+	assert_int_equal(audio_stream_get_avail_bytes(&sink->stream), 14);
+	assert_ptr_equal(sink->stream.w_ptr, source->stream.w_ptr);
+
+	/* unread data moves to own memory and is drained from the source */
+	comp_update_buffer_consume(sink, 6);
+	test_alias_produce(source, 20, 2);
+	buffer_unalias(sink, true);
+	assert_ptr_equal(sink->stream.addr, own_addr);
+	assert_int_equal(audio_stream_get_avail_bytes(&sink->stream), 8);
+	assert_int_equal(audio_stream_get_avail_bytes(&source->stream), 2);
+	assert_int_equal(*(uint8_t *)sink->stream.r_ptr, 12);
+	last = audio_stream_wrap(&sink->stream, (char *)sink->stream.r_ptr + 7);
+	assert_int_equal(*last, 19);
+	assert_int_equal(*(uint8_t *)source->stream.r_ptr, 20);
+
+	buffer_free(sink);
+	buffer_free(source);
+}
+
+static void test_audio_buffer_alias_locked(void **state)
+{
+	(void)state;
+
+	test_audio_buffer_alias_pass(false);
+}
+
+static void test_audio_buffer_alias_spsc(void **state)
+{
+	(void)state;
+
+	test_audio_buffer_alias_pass(true);
+}
+
+static void test_audio_buffer_alias_busy(void **state)
+{
+	(void)state;
+
+	struct comp_buffer *source = test_alias_buffer_new(16, false);
+	struct comp_buffer *sink = test_alias_buffer_new(16, false);
+	struct comp_buffer *other = test_alias_buffer_new(16, false);
+	void *own_addr = sink->stream.addr;
+
+	assert_non_null(source);
+	assert_non_null(sink);
+	assert_non_null(other);
+
+	/* sink has to be drained first */
+	comp_update_buffer_produce(sink, 4);
+	assert_int_equal(buffer_alias(sink, source), -EBUSY);
+	comp_update_buffer_consume(sink, 4);
+	assert_int_equal(buffer_alias(sink, source), 0);
+
+	/* no chaining of aliases */
+	assert_int_equal(buffer_alias(other, sink), -EBUSY);
+
+	/* reset drops the data */
+	comp_update_buffer_produce(source, 8);
+	buffer_alias_sync(sink);
+	buffer_unalias(sink, false);
+	assert_ptr_equal(sink->stream.addr, own_addr);
+	assert_int_equal(audio_stream_get_avail_bytes(&sink->stream), 0);
+	assert_int_equal(audio_stream_get_avail_bytes(&source->stream), 8);
+
+	buffer_free(other);
+	buffer_free(sink);
+	buffer_free(source);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_audio_buffer_alias_locked),
+		cmocka_unit_test(test_audio_buffer_alias_spsc),
+		cmocka_unit_test(test_audio_buffer_alias_busy),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,95 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+#include <sof/drivers/ipc.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+#define ITER_CHANNELS	3
+#define ITER_FRAMES	10
+
+static struct comp_buffer *iter_buffer_new(uint32_t size, uint32_t offset)
+{
+	struct sof_ipc_buffer desc = {
+		.size = size
+	};
+	struct comp_buffer *buf = buffer_new(&desc);
+
+	assert_non_null(buf);
+	buf->stream.channels = ITER_CHANNELS;
+	buf->stream.frame_fmt = SOF_IPC_FRAME_S16_LE;
+
+	/* move both pointers so that frames get split by the buffer end */
+	comp_update_buffer_produce(buf, offset);
+	comp_update_buffer_consume(buf, offset);
+
+	return buf;
+}
+
+/* 6 byte frames split by the end of both 64 and 70 byte buffers */
+static void test_audio_buffer_iter_split_frames(void **state)
+{
+	struct audio_stream_iter in;
+	struct audio_stream_iter out;
+	struct comp_buffer *source = iter_buffer_new(64, 44);
+	struct comp_buffer *sink = iter_buffer_new(70, 30);
+	int16_t *ptr;
+	uint32_t n;
+	int blocks = 0;
+	int i;
+
+	(void)state;
+
+	for (i = 0; i < ITER_FRAMES * ITER_CHANNELS; i++) {
+		ptr = audio_stream_write_frag_s16(&source->stream, i);
+		*ptr = i + 1;
+	}
+	comp_update_buffer_produce(source, ITER_FRAMES * 6);
+
+	audio_stream_iter_init(&in, &source->stream, source->stream.r_ptr,
+			       ITER_FRAMES);
+	audio_stream_iter_init_sink(&out, &sink->stream, sink->stream.w_ptr,
+				    ITER_FRAMES);
+
+	while (out.frames) {
+		n = MIN(audio_stream_iter_frames(&in),
+			audio_stream_iter_frames(&out));
+		assert_true(n > 0);
+
+		for (i = 0; i < n * ITER_CHANNELS; i++)
+			((int16_t *)out.ptr)[i] = ((int16_t *)in.ptr)[i];
+
+		audio_stream_iter_next(&in, n);
+		audio_stream_iter_next(&out, n);
+		assert_true(++blocks <= ITER_FRAMES);
+	}
+
+	assert_int_equal(in.frames, 0);
+	comp_update_buffer_produce(sink, ITER_FRAMES * 6);
+
+	for (i = 0; i < ITER_FRAMES * ITER_CHANNELS; i++) {
+		ptr = audio_stream_read_frag_s16(&sink->stream, i);
+		assert_int_equal(*ptr, i + 1);
+	}
+
+	buffer_free(source);
+	buffer_free(sink);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_audio_buffer_iter_split_frames),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,191 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+#include <sof/lib/notifier.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+struct notify_count {
+	uint32_t events;
+	uint32_t amount;
+	void *begin;
+};
+
+static void test_cb(void *arg, enum notify_id type, void *data)
+{
+	struct notify_count *count = arg;
+	struct buffer_cb_transact *cb_data = data;
+
+	count->events++;
+	count->amount += cb_data->transaction_amount;
+	if (count->events == 1)
+		count->begin = cb_data->transaction_begin_address;
+}
+
+static void test_audio_buffer_notify_no_subscribers(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+
+	struct comp_buffer *buf = buffer_new(&test_buf_desc);
+
+	assert_non_null(buf);
+	assert_int_equal(buf->notify_mask, 0);
+
+	comp_update_buffer_produce(buf, 16);
+	comp_update_buffer_consume(buf, 16);
+
+	assert_int_equal(buf->tick_produce.transaction_amount, 0);
+	assert_int_equal(buf->tick_consume.transaction_amount, 0);
+
+	buffer_free(buf);
+}
+
+static void test_audio_buffer_notify_per_copy(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+	struct notify_count produce = { 0 };
+	struct notify_count consume = { 0 };
+
+	struct comp_buffer *buf = buffer_new(&test_buf_desc);
+
+	assert_non_null(buf);
+
+	buffer_notifier_register(&produce, buf, NOTIFIER_ID_BUFFER_PRODUCE,
+				 test_cb, 0);
+	buffer_notifier_register(&consume, buf, NOTIFIER_ID_BUFFER_CONSUME,
+				 test_cb, 0);
+	assert_int_equal(buf->notify_mask,
+			 BIT(NOTIFIER_ID_BUFFER_PRODUCE) |
+			 BIT(NOTIFIER_ID_BUFFER_CONSUME));
+
+	comp_update_buffer_produce(buf, 16);
+	comp_update_buffer_produce(buf, 8);
+	comp_update_buffer_consume(buf, 24);
+
+	assert_int_equal(produce.events, 2);
+	assert_int_equal(produce.amount, 24);
+	assert_ptr_equal(produce.begin, buf->stream.addr);
+	assert_int_equal(consume.events, 1);
+	assert_int_equal(consume.amount, 24);
+
+	buffer_notifier_unregister(&produce, buf, NOTIFIER_ID_BUFFER_PRODUCE);
+	assert_int_equal(buf->notify_mask, BIT(NOTIFIER_ID_BUFFER_CONSUME));
+
+	comp_update_buffer_produce(buf, 16);
+	assert_int_equal(produce.events, 2);
+
+	buffer_free(buf);
+}
+
+static void test_audio_buffer_notify_wildcard(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+	struct notify_count produce = { 0 };
+	struct notify_count consume = { 0 };
+
+	struct comp_buffer *buf = buffer_new(&test_buf_desc);
+
+	assert_non_null(buf);
+
+	/* listeners of all buffers bypass buffer_notifier_register() */
+	notifier_register(&produce, NULL, NOTIFIER_ID_BUFFER_PRODUCE,
+			  test_cb, 0);
+	notifier_register(&consume, NULL, NOTIFIER_ID_BUFFER_CONSUME,
+			  test_cb, 0);
+	assert_int_equal(buf->notify_mask, 0);
+
+	comp_update_buffer_produce(buf, 16);
+	comp_update_buffer_consume(buf, 8);
+
+	assert_int_equal(produce.events, 1);
+	assert_int_equal(produce.amount, 16);
+	assert_int_equal(consume.events, 1);
+	assert_int_equal(consume.amount, 8);
+
+	notifier_unregister(&produce, NULL, NOTIFIER_ID_BUFFER_PRODUCE);
+	notifier_unregister(&consume, NULL, NOTIFIER_ID_BUFFER_CONSUME);
+	assert_false(notifier_has_wildcard(NOTIFIER_ID_BUFFER_PRODUCE));
+	assert_false(notifier_has_wildcard(NOTIFIER_ID_BUFFER_CONSUME));
+
+	comp_update_buffer_produce(buf, 16);
+	assert_int_equal(produce.events, 1);
+
+	buffer_free(buf);
+}
+
+static void test_audio_buffer_notify_per_tick(void **state)
+{
+	(void)state;
+
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = 256
+	};
+	struct notify_count produce = { 0 };
+
+	struct comp_buffer *buf = buffer_new(&test_buf_desc);
+
+	assert_non_null(buf);
+
+	buffer_notifier_register(&produce, buf,
+				 NOTIFIER_ID_BUFFER_PRODUCE_TICK, test_cb, 0);
+	assert_int_equal(buf->notify_mask,
+			 BIT(NOTIFIER_ID_BUFFER_PRODUCE_TICK));
+
+	comp_update_buffer_produce(buf, 16);
+	comp_update_buffer_produce(buf, 8);
+	comp_update_buffer_consume(buf, 24);
+	assert_int_equal(produce.events, 0);
+
+	/* end of LL tick flushes one coalesced event */
+	notifier_event(NULL, NOTIFIER_ID_LL_POST_RUN,
+		       NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	assert_int_equal(produce.events, 1);
+	assert_int_equal(produce.amount, 24);
+	assert_ptr_equal(produce.begin, buf->stream.addr);
+
+	/* nothing produced, nothing sent */
+	notifier_event(NULL, NOTIFIER_ID_LL_POST_RUN,
+		       NOTIFIER_TARGET_CORE_LOCAL, NULL, 0);
+	assert_int_equal(produce.events, 1);
+
+	buffer_notifier_unregister(&produce, buf,
+				   NOTIFIER_ID_BUFFER_PRODUCE_TICK);
+	assert_int_equal(buf->notify_mask, 0);
+	assert_false(notifier_has_callbacks(NULL,
+					    NOTIFIER_ID_LL_POST_RUN));
+
+	buffer_free(buf);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_audio_buffer_notify_no_subscribers),
+		cmocka_unit_test(test_audio_buffer_notify_per_copy),
+		cmocka_unit_test(test_audio_buffer_notify_wildcard),
+		cmocka_unit_test(test_audio_buffer_notify_per_tick),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
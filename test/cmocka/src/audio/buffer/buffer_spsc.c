@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component.h>
+#include <sof/audio/buffer.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+
+static struct comp_buffer *test_spsc_buffer_new(uint32_t size)
+{
+	struct sof_ipc_buffer test_buf_desc = {
+		.size = size
+	};
+	struct comp_buffer *buf = buffer_new(&test_buf_desc);
+
+	if (buf)
+		buf->spsc = true;
+
+	return buf;
+}
+
+static void test_audio_buffer_spsc_fill_and_drain(void **state)
+{
+	(void)state;
+
+	struct comp_buffer *buf = test_spsc_buffer_new(16);
+
+	assert_non_null(buf);
+
+	comp_update_buffer_produce(buf, 16);
+
+	assert_int_equal(audio_stream_get_avail_bytes(&buf->stream), 16);
+	assert_int_equal(audio_stream_get_free_bytes(&buf->stream), 0);
+	assert_ptr_equal(buf->stream.w_ptr, buf->stream.r_ptr);
+
+	comp_update_buffer_consume(buf, 16);
+
+	assert_int_equal(audio_stream_get_avail_bytes(&buf->stream), 0);
+	assert_int_equal(audio_stream_get_free_bytes(&buf->stream), 16);
+	assert_ptr_equal(buf->stream.w_ptr, buf->stream.r_ptr);
+
+	buffer_free(buf);
+}
+
+static void test_audio_buffer_spsc_wrap(void **state)
+{
+	(void)state;
+
+	struct comp_buffer *buf = test_spsc_buffer_new(16);
+	int i;
+
+	assert_non_null(buf);
+
+	/* positions run over twice the buffer size several times */
+	for (i = 0; i < 10; i++) {
+		comp_update_buffer_produce(buf, 12);
+
+		assert_int_equal(audio_stream_get_avail_bytes(&buf->stream),
+				 12);
+		assert_int_equal(audio_stream_get_free_bytes(&buf->stream), 4);
+		assert_ptr_equal(buf->stream.w_ptr,
+				 (char *)buf->stream.addr + (i + 1) * 12 % 16);
+
+		comp_update_buffer_consume(buf, 12);
+
+		assert_int_equal(audio_stream_get_avail_bytes(&buf->stream),
+				 0);
+		assert_ptr_equal(buf->stream.r_ptr, buf->stream.w_ptr);
+	}
+
+	buffer_free(buf);
+}
+
+static void test_audio_buffer_spsc_sync(void **state)
+{
+	(void)state;
+
+	struct comp_buffer *buf = test_spsc_buffer_new(64);
+
+	assert_non_null(buf);
+
+	comp_update_buffer_produce(buf, 40);
+	comp_update_buffer_consume(buf, 8);
+
+	/* stream state left behind by the other side */
+	audio_stream_reset(&buf->stream);
+
+	buffer_spsc_sync(buf);
+
+	assert_int_equal(audio_stream_get_avail_bytes(&buf->stream), 32);
+	assert_int_equal(audio_stream_get_free_bytes(&buf->stream), 32);
+	assert_ptr_equal(buf->stream.w_ptr, (char *)buf->stream.addr + 40);
+	assert_ptr_equal(buf->stream.r_ptr, (char *)buf->stream.addr + 8);
+
+	buffer_free(buf);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_audio_buffer_spsc_fill_and_drain),
+		cmocka_unit_test(test_audio_buffer_spsc_wrap),
+		cmocka_unit_test(test_audio_buffer_spsc_sync),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/mixer.h>
+#include <sof/common.h>
+#include <sof/string.h>
+#include <ipc/stream.h>
+
+/* The generic kernels built under other names, see CMakeLists.txt */
+extern const struct mixer_func_map mixer_generic_func_map[];
+extern const size_t mixer_generic_func_count;
+
+#define MIX_TEST_SOURCES	4
+#define MIX_TEST_FRAMES		100
+
+/* odd buffer length and start so that blocks are split by the wrap and
+ * the vector loads and stores are unaligned
+ */
+#define MIX_TEST_BUF_FRAMES	67
+#define MIX_TEST_START		23
+
+struct mix_test_case {
+	enum sof_ipc_frame frame_fmt;
+	int num_sources;
+	int num_chans;
+	bool gains;
+};
+
+#define TEST_CASE(_fmt, _num_sources, _num_chans, _gains) \
+	{ \
+		.frame_fmt = (_fmt), \
+		.num_sources = (_num_sources), \
+		.num_chans = (_num_chans), \
+		.gains = (_gains), \
+	}
+
+/* unity, mute, about -6 dB and an odd value to check the rounding */
+static const int32_t test_gains[MIX_TEST_SOURCES] = {
+	MIXER_GAIN_UNITY, 0, 0x40000000, 0x2b3c4d5e,
+};
+
+static mixer_func mix_func_generic(enum sof_ipc_frame frame_fmt)
+{
+	int i;
+
+	for (i = 0; i < mixer_generic_func_count; i++) {
+		if (frame_fmt == mixer_generic_func_map[i].frame_fmt)
+			return mixer_generic_func_map[i].func;
+	}
+
+	return NULL;
+}
+
+static void stream_new(struct audio_stream *stream,
+		       const struct mix_test_case *tc)
+{
+	uint32_t frame_bytes;
+	void *addr;
+
+	stream->frame_fmt = tc->frame_fmt;
+	stream->channels = tc->num_chans;
+	frame_bytes = audio_stream_frame_bytes(stream);
+
+	addr = malloc(MIX_TEST_BUF_FRAMES * frame_bytes);
+	assert_non_null(addr);
+
+	audio_stream_init(stream, addr, MIX_TEST_BUF_FRAMES * frame_bytes);
+	stream->r_ptr = (char *)addr + MIX_TEST_START * frame_bytes;
+	stream->w_ptr = stream->r_ptr;
+}
+
+/* full scale noise, so that the sum of the sources also saturates */
+static void stream_fill(struct audio_stream *stream, uint32_t *seed)
+{
+	uint32_t bytes = stream->size;
+	uint8_t *data = stream->addr;
+	int i;
+
+	for (i = 0; i < bytes; i++) {
+		*seed = *seed * 1664525 + 1013904223;
+		data[i] = *seed >> 24;
+	}
+}
+
+static void check_samples(const struct mix_test_case *tc,
+			  const struct audio_stream *sink,
+			  const struct audio_stream *ref)
+{
+	uint32_t samples = sink->size / audio_stream_sample_bytes(sink);
+	const int16_t *out16 = sink->addr;
+	const int16_t *ref16 = ref->addr;
+	const int32_t *out32 = sink->addr;
+	const int32_t *ref32 = ref->addr;
+	int64_t diff;
+	int max_diff;
+	int i;
+
+	/* the gains are rounded once per source */
+	max_diff = tc->gains ? tc->num_sources : 0;
+
+	for (i = 0; i < samples; i++) {
+		if (tc->frame_fmt == SOF_IPC_FRAME_S16_LE)
+			diff = (int64_t)out16[i] - ref16[i];
+		else
+			diff = (int64_t)out32[i] - ref32[i];
+
+		assert_in_range(diff, -max_diff, max_diff);
+	}
+}
+
+static void test_audio_mixer_hifi3(void **state)
+{
+#if MIXER_HIFI3
+	const struct mix_test_case *tc = *state;
+	const struct audio_stream *sources[MIX_TEST_SOURCES];
+	struct audio_stream in[MIX_TEST_SOURCES];
+	struct audio_stream sink;
+	struct audio_stream ref;
+	mixer_func func_hifi3 = mixer_get_processing_function(tc->frame_fmt);
+	mixer_func func_generic = mix_func_generic(tc->frame_fmt);
+	const int32_t *gains = tc->gains ? test_gains : NULL;
+	uint32_t seed = 1;
+	int i;
+
+	assert_non_null(func_hifi3);
+	assert_non_null(func_generic);
+
+	for (i = 0; i < tc->num_sources; i++) {
+		stream_new(&in[i], tc);
+		stream_fill(&in[i], &seed);
+		sources[i] = &in[i];
+	}
+
+	/* unwritten samples must match too */
+	stream_new(&sink, tc);
+	stream_new(&ref, tc);
+	stream_fill(&sink, &seed);
+	memcpy_s(ref.addr, ref.size, sink.addr, sink.size);
+
+	func_hifi3(NULL, &sink, sources, gains, tc->num_sources,
+		   MIX_TEST_FRAMES);
+	func_generic(NULL, &ref, sources, gains, tc->num_sources,
+		     MIX_TEST_FRAMES);
+
+	check_samples(tc, &sink, &ref);
+
+	for (i = 0; i < tc->num_sources; i++)
+		free(in[i].addr);
+	free(sink.addr);
+	free(ref.addr);
+#else
+	skip();
+#endif /* MIXER_HIFI3 */
+}
+
+static struct mix_test_case test_cases[] = {
+#if CONFIG_FORMAT_S16LE
+	TEST_CASE(SOF_IPC_FRAME_S16_LE, 1, 1, false),
+	TEST_CASE(SOF_IPC_FRAME_S16_LE, 2, 2, false),
+	TEST_CASE(SOF_IPC_FRAME_S16_LE, 3, 3, false),
+	TEST_CASE(SOF_IPC_FRAME_S16_LE, 4, 2, true),
+	TEST_CASE(SOF_IPC_FRAME_S16_LE, 4, 3, true),
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S32LE
+	TEST_CASE(SOF_IPC_FRAME_S32_LE, 1, 1, false),
+	TEST_CASE(SOF_IPC_FRAME_S32_LE, 2, 2, false),
+	TEST_CASE(SOF_IPC_FRAME_S32_LE, 3, 3, false),
+	TEST_CASE(SOF_IPC_FRAME_S32_LE, 4, 2, true),
+	TEST_CASE(SOF_IPC_FRAME_S32_LE, 4, 3, true),
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+int main(void)
+{
+	struct CMUnitTest tests[ARRAY_SIZE(test_cases)];
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(test_cases); i++) {
+		tests[i].name = "test_audio_mixer_hifi3";
+		tests[i].test_func = test_audio_mixer_hifi3;
+		tests[i].initial_state = &test_cases[i];
+		tests[i].setup_func = NULL;
+		tests[i].teardown_func = NULL;
+	}
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
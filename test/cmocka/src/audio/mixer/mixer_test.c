@@ -9,6 +9,7 @@
 #include <math.h>
 #include <setjmp.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <malloc.h>
 #include <cmocka.h>
 #include <sof/list.h>
@@ -297,9 +298,134 @@ static void test_audio_mixer_copy(void **state)
 	}
 }
 
+/* two sources, both signs and close to full scale so that sums saturate */
+static struct mix_test_case gain_test_case = TEST_CASE(2, 2);
+
+static void fill_gain_sources(struct mix_test_case *tc)
+{
+	int src_idx;
+	int smp;
+
+	for (src_idx = 0; src_idx < tc->num_sources; ++src_idx) {
+		int32_t *samples = tc->sources[src_idx].buf->stream.addr;
+
+		for (smp = 0; smp < MIX_TEST_SAMPLES; ++smp)
+			samples[smp] = (int32_t)((uint32_t)((smp * 7919 *
+				(src_idx + 1)) % 65536) << 16) ^ INT32_MIN;
+
+		audio_stream_produce(&tc->sources[src_idx].buf->stream,
+				     sizeof(uint32_t) * MIX_TEST_SAMPLES);
+	}
+}
+
+static void set_source_gains(struct mix_test_case *tc, const int32_t *gains)
+{
+	struct sof_ipc_ctrl_data *cdata;
+	int src_idx;
+
+	cdata = calloc(1, sizeof(*cdata) + tc->num_sources *
+		       sizeof(struct sof_ipc_ctrl_value_chan));
+	cdata->cmd = SOF_CTRL_CMD_VOLUME;
+	cdata->num_elems = tc->num_sources;
+
+	/* gains are addressed by the pipeline of the source */
+	for (src_idx = 0; src_idx < tc->num_sources; ++src_idx) {
+		dev_comp(tc->sources[src_idx].comp)->pipeline_id = src_idx + 1;
+		cdata->chanv[src_idx].channel = src_idx + 1;
+		cdata->chanv[src_idx].value = gains[src_idx];
+	}
+
+	assert_int_equal(mixer_drv_mock.ops.cmd(mixer_dev_mock,
+						COMP_CMD_SET_VALUE, cdata, 0),
+			 0);
+
+	free(cdata);
+}
+
+/* mixes and returns the number of saturated output samples */
+static int check_gain_mix(struct mix_test_case *tc, const int32_t *gains)
+{
+	int32_t *out_samples = post_mixer_buf->stream.addr;
+	int saturated = 0;
+	int src_idx;
+	int smp;
+
+	mixer_drv_mock.ops.copy(mixer_dev_mock);
+
+	for (smp = 0; smp < MIX_TEST_SAMPLES; ++smp) {
+		int64_t sum = 0;
+
+		for (src_idx = 0; src_idx < tc->num_sources; ++src_idx) {
+			int32_t *samples =
+				tc->sources[src_idx].buf->stream.addr;
+
+			sum += q_multsr_32x32(samples[smp], gains[src_idx],
+					      MIXER_GAIN_QY);
+		}
+
+		if (sum != sat_int32(sum))
+			saturated++;
+
+		assert_int_equal(out_samples[smp], sat_int32(sum));
+	}
+
+	return saturated;
+}
+
+static void test_audio_mixer_gain_unity(void **state)
+{
+	struct mix_test_case *tc = *((struct mix_test_case **)state);
+	const int32_t gains[] = { MIXER_GAIN_UNITY, MIXER_GAIN_UNITY };
+	int32_t *out_samples = post_mixer_buf->stream.addr;
+	int32_t *samples0 = tc->sources[0].buf->stream.addr;
+	int32_t *samples1 = tc->sources[1].buf->stream.addr;
+	int smp;
+
+	fill_gain_sources(tc);
+	set_source_gains(tc, gains);
+
+	/* unity gains are bypassed, output is the plain sum */
+	mixer_drv_mock.ops.copy(mixer_dev_mock);
+
+	for (smp = 0; smp < MIX_TEST_SAMPLES; ++smp)
+		assert_int_equal(out_samples[smp],
+				 sat_int32((int64_t)samples0[smp] +
+					   samples1[smp]));
+}
+
+static void test_audio_mixer_gain_mute(void **state)
+{
+	struct mix_test_case *tc = *((struct mix_test_case **)state);
+	const int32_t gains[] = { 0, MIXER_GAIN_UNITY };
+	int32_t *out_samples = post_mixer_buf->stream.addr;
+	int32_t *samples1 = tc->sources[1].buf->stream.addr;
+	int smp;
+
+	fill_gain_sources(tc);
+	set_source_gains(tc, gains);
+
+	check_gain_mix(tc, gains);
+
+	/* unity gain in Q1.31 is one LSB short of one */
+	for (smp = 0; smp < MIX_TEST_SAMPLES; ++smp)
+		assert_true(abs(out_samples[smp] - samples1[smp]) <= 1);
+}
+
+static void test_audio_mixer_gain_saturation(void **state)
+{
+	struct mix_test_case *tc = *((struct mix_test_case **)state);
+	const int32_t gains[] = { Q_CONVERT_FLOAT(0.75, MIXER_GAIN_QY),
+				  MIXER_GAIN_UNITY };
+
+	fill_gain_sources(tc);
+	set_source_gains(tc, gains);
+
+	assert_true(check_gain_mix(tc, gains) > 0);
+}
+
 int main(void)
 {
-	struct CMUnitTest tests[ARRAY_SIZE(mix_test_cases) + 2];
+	struct CMUnitTest tests[ARRAY_SIZE(mix_test_cases) + 5];
 
 	int i;
 	int cur_test_case = 0;
@@ -316,7 +442,25 @@ int main(void)
 	tests[1].teardown_func = test_teardown;
 	tests[1].name = "test_audio_mixer_prepare_no_sources";
 
-	for (i = 2; i < ARRAY_SIZE(tests); (++i, ++cur_test_case)) {
+	tests[2].test_func = test_audio_mixer_gain_unity;
+	tests[2].initial_state = &gain_test_case;
+	tests[2].setup_func = test_setup;
+	tests[2].teardown_func = test_teardown;
+	tests[2].name = "test_audio_mixer_gain_unity";
+
+	tests[3].test_func = test_audio_mixer_gain_mute;
+	tests[3].initial_state = &gain_test_case;
+	tests[3].setup_func = test_setup;
+	tests[3].teardown_func = test_teardown;
+	tests[3].name = "test_audio_mixer_gain_mute";
+
+	tests[4].test_func = test_audio_mixer_gain_saturation;
+	tests[4].initial_state = &gain_test_case;
+	tests[4].setup_func = test_setup;
+	tests[4].teardown_func = test_teardown;
+	tests[4].name = "test_audio_mixer_gain_saturation";
+
+	for (i = 5; i < ARRAY_SIZE(tests); (++i, ++cur_test_case)) {
 		tests[i].test_func = test_audio_mixer_copy;
 		tests[i].initial_state = &mix_test_cases[cur_test_case];
 		tests[i].setup_func = test_setup;
@@ -130,3 +130,15 @@ int comp_verify_params(struct comp_dev *dev, uint32_t flag,
 	(void)params;
 	return 0;
 }
+
+bool comp_transparent_copy(struct comp_dev *dev)
+{
+	(void)dev;
+
+	return false;
+}
+
+void comp_transparent_reset(struct comp_dev *dev)
+{
+	(void)dev;
+}
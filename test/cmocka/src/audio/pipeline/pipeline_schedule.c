@@ -0,0 +1,154 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <sof/audio/component.h>
+#include <sof/audio/pipeline.h>
+#include "pipeline_mocks.h"
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <malloc.h>
+#include <cmocka.h>
+
+#define PIPELINE_ID	1
+#define MAX_COMPS	4
+
+struct schedule_test_data {
+	struct pipeline p;
+	struct comp_driver drv;
+	struct comp_dev *comps[MAX_COMPS];
+	struct comp_buffer *buffers[MAX_COMPS];
+};
+
+static struct comp_dev *test_comp_new(struct schedule_test_data *data,
+				      int index)
+{
+	struct comp_dev *dev = calloc(sizeof(*dev), 1);
+
+	dev_comp(dev)->id = index;
+	dev_comp(dev)->pipeline_id = PIPELINE_ID;
+	dev->direction = SOF_IPC_STREAM_PLAYBACK;
+	dev->drv = &data->drv;
+	dev->pipeline = &data->p;
+	list_init(&dev->bsource_list);
+	list_init(&dev->bsink_list);
+	data->comps[index] = dev;
+
+	return dev;
+}
+
+/* connects source to sink through a new buffer */
+static void test_comp_connect(struct schedule_test_data *data, int index,
+			      struct comp_dev *source, struct comp_dev *sink)
+{
+	struct comp_buffer *buffer = calloc(sizeof(*buffer), 1);
+
+	list_init(&buffer->source_list);
+	list_init(&buffer->sink_list);
+	data->buffers[index] = buffer;
+
+	pipeline_connect(source, buffer, PPL_CONN_DIR_COMP_TO_BUFFER);
+	pipeline_connect(sink, buffer, PPL_CONN_DIR_BUFFER_TO_COMP);
+}
+
+static int setup(void **state)
+{
+	struct schedule_test_data *data = calloc(sizeof(*data), 1);
+
+	pipeline_posn_init(sof_get());
+
+	data->p.ipc_pipe.pipeline_id = PIPELINE_ID;
+	data->p.status = COMP_STATE_READY;
+	data->p.pipe_task = calloc(sizeof(struct task), 1);
+
+	/* host -> b0 -> volume -> b1 -> dai playback */
+	test_comp_new(data, 0);
+	test_comp_new(data, 1);
+	test_comp_new(data, 2);
+	test_comp_connect(data, 0, data->comps[0], data->comps[1]);
+	test_comp_connect(data, 1, data->comps[1], data->comps[2]);
+
+	data->p.source_comp = data->comps[0];
+	data->p.sink_comp = data->comps[2];
+	data->p.sched_comp = data->comps[2];
+
+	*state = data;
+
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct schedule_test_data *data = *state;
+	int i;
+
+	for (i = 0; i < MAX_COMPS; i++) {
+		free(data->comps[i]);
+		free(data->buffers[i]);
+	}
+
+	free(data->p.steps);
+	free(data->p.pipe_task);
+	free(data);
+
+	return 0;
+}
+
+static void test_audio_pipeline_schedule_build(void **state)
+{
+	struct schedule_test_data *data = *state;
+	struct pipeline *p = &data->p;
+
+	assert_false(p->steps_valid);
+	assert_int_equal(pipeline_prepare(p, data->comps[0]), 0);
+
+	/* playback is copied upstream from the dai, host goes first */
+	assert_true(p->steps_valid);
+	assert_int_equal(p->steps_count, 3);
+	assert_ptr_equal(p->steps[0].comp, data->comps[0]);
+	assert_ptr_equal(p->steps[1].comp, data->comps[1]);
+	assert_ptr_equal(p->steps[2].comp, data->comps[2]);
+	assert_int_equal(p->steps[2].subtree, 2);
+}
+
+static void test_audio_pipeline_schedule_rebuild(void **state)
+{
+	struct schedule_test_data *data = *state;
+	struct pipeline *p = &data->p;
+
+	assert_int_equal(pipeline_prepare(p, data->comps[0]), 0);
+	assert_true(p->steps_valid);
+
+	/* new source in front of the host: d -> b2 -> host */
+	test_comp_new(data, 3);
+	test_comp_connect(data, 2, data->comps[3], data->comps[0]);
+	p->source_comp = data->comps[3];
+	assert_false(p->steps_valid);
+
+	assert_int_equal(pipeline_prepare(p, data->comps[3]), 0);
+	assert_true(p->steps_valid);
+	assert_int_equal(p->steps_count, 4);
+	assert_ptr_equal(p->steps[0].comp, data->comps[3]);
+	assert_ptr_equal(p->steps[3].comp, data->comps[2]);
+	assert_int_equal(p->steps[3].subtree, 3);
+
+	/* freed component or buffer leaves the schedule outdated */
+	pipeline_schedule_invalidate(data->comps[3]->pipeline);
+	assert_false(p->steps_valid);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_audio_pipeline_schedule_build,
+						setup, teardown),
+		cmocka_unit_test_setup_teardown(test_audio_pipeline_schedule_rebuild,
+						setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,225 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2021 Intel Corporation. All rights reserved.
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+
+#include <sof/audio/src/src.h>
+#include <sof/audio/src/src_config.h>
+#include <sof/common.h>
+
+/* Frequency response test points per band */
+#define NUM_POINTS		256
+
+/* Passband gain is -1 dB for the conversion, stopband from Kaiser A = 70 */
+#define PASSBAND_GAIN_DB	-1.0
+#define PASSBAND_TOLERANCE_DB	0.05
+#define STOPBAND_MAX_DB		-65.0
+
+/* A bit less than the 20 kHz per 44.1 kHz of the design */
+#define PASSBAND_FRACTION	0.45
+
+#if SRC_SHORT
+typedef int16_t coef_t;
+#define COEF_QY			15
+#else
+typedef int32_t coef_t;
+#define COEF_QY			31
+#endif
+
+struct src_coef_rates {
+	int fs_in;
+	int fs_out;
+};
+
+static const struct src_coef_rates rates[] = {
+	{ 48000, 44100 },
+	{ 44100, 48000 },
+	{ 16000, 48000 },
+	{ 48000, 8000 },
+	{ 48000, 24000 },
+	{ 96000, 48000 },
+	{ 32000, 44100 },
+};
+
+static int setup(void **state)
+{
+	(void)state;
+
+	src_coef_init();
+	return 0;
+}
+
+/* Magnitude in dB of the prototype filter at f normalized to the rate
+ * of the polyphase filter, relative to the interpolation gain L
+ */
+static double stage_response_db(const struct src_stage *s, double f)
+{
+	const coef_t *coef = s->coefs;
+	int sub_length = s->subfilter_length;
+	double scale = ldexp(1.0, -(COEF_QY + s->shift));
+	double re = 0;
+	double im = 0;
+	double h;
+	int i;
+	int j;
+
+	for (j = 0; j < s->num_of_subfilters; j++) {
+		for (i = 0; i < sub_length; i++) {
+			h = coef[j * sub_length + i] * scale;
+			re += h * cos(2 * M_PI * f * (j + i * s->num_of_subfilters));
+			im -= h * sin(2 * M_PI * f * (j + i * s->num_of_subfilters));
+		}
+	}
+
+	return 20 * log10(sqrt(re * re + im * im) / s->num_of_subfilters);
+}
+
+static int stage_count(const struct src_coef_bank *bank)
+{
+	if (bank->stage1.filter_length == 1)
+		return 0;
+
+	return bank->stage2.filter_length == 1 ? 1 : 2;
+}
+
+static void check_stage(const struct src_stage *s, int fs, double f_pb,
+			double gain_db)
+{
+	double fs_up = (double)fs * s->num_of_subfilters;
+	double f_sb = fmin(fs, (double)fs * s->blk_out / s->blk_in) / 2;
+	double f;
+	double db;
+	int i;
+
+	/* polyphase layout and the constraints of the filter cores */
+	assert_int_equal(s->filter_length,
+			 s->num_of_subfilters * s->subfilter_length);
+	assert_int_equal(s->subfilter_length & 3, 0);
+	assert_int_equal(s->blk_out, s->num_of_subfilters);
+	if (s->blk_out > 1 && s->blk_in > 1)
+		assert_int_equal(-s->idm * s->blk_out + s->odm * s->blk_in, 1);
+	assert_true(s->shift >= 0);
+
+	for (i = 0; i <= NUM_POINTS; i++) {
+		f = f_pb * i / NUM_POINTS;
+		db = stage_response_db(s, f / fs_up);
+		assert_true(fabs(db - gain_db) < PASSBAND_TOLERANCE_DB);
+	}
+
+	for (i = 0; i <= NUM_POINTS; i++) {
+		f = f_sb + (fs_up / 2 - f_sb) * i / NUM_POINTS;
+		db = stage_response_db(s, f / fs_up);
+		assert_true(db < STOPBAND_MAX_DB);
+	}
+}
+
+static void test_audio_src_coef_response(void **state)
+{
+	struct src_coef_bank *bank;
+	double f_pb;
+	int fs3;
+	int i;
+
+	(void)state;
+
+	for (i = 0; i < ARRAY_SIZE(rates); i++) {
+		bank = src_coef_bank_get(rates[i].fs_in, rates[i].fs_out);
+		assert_non_null(bank);
+		assert_int_equal(bank->fs_in, rates[i].fs_in);
+		assert_int_equal(bank->fs_out, rates[i].fs_out);
+
+		f_pb = PASSBAND_FRACTION * fmin(rates[i].fs_in, rates[i].fs_out);
+		fs3 = rates[i].fs_in * bank->stage1.blk_out /
+			bank->stage1.blk_in;
+
+		switch (stage_count(bank)) {
+		case 1:
+			assert_int_equal(fs3, rates[i].fs_out);
+			check_stage(&bank->stage1, rates[i].fs_in, f_pb,
+				    PASSBAND_GAIN_DB);
+			break;
+		case 2:
+			assert_int_equal(fs3 * bank->stage2.blk_out /
+					 bank->stage2.blk_in, rates[i].fs_out);
+			check_stage(&bank->stage1, rates[i].fs_in, f_pb,
+				    PASSBAND_GAIN_DB / 2);
+			check_stage(&bank->stage2, fs3, f_pb,
+				    PASSBAND_GAIN_DB / 2);
+			break;
+		default:
+			fail();
+		}
+
+		src_coef_bank_put(bank);
+	}
+}
+
+static void test_audio_src_coef_one_to_one(void **state)
+{
+	struct src_coef_bank *bank;
+
+	(void)state;
+
+	bank = src_coef_bank_get(48000, 48000);
+	assert_non_null(bank);
+	assert_int_equal(stage_count(bank), 0);
+	assert_int_equal(bank->stage2.filter_length, 1);
+	src_coef_bank_put(bank);
+}
+
+static void test_audio_src_coef_shared(void **state)
+{
+	struct src_coef_bank *bank1;
+	struct src_coef_bank *bank2;
+	struct src_coef_bank *bank3;
+
+	(void)state;
+
+	bank1 = src_coef_bank_get(48000, 16000);
+	bank2 = src_coef_bank_get(48000, 16000);
+	bank3 = src_coef_bank_get(16000, 48000);
+	assert_non_null(bank1);
+	assert_non_null(bank3);
+	assert_ptr_equal(bank1, bank2);
+	assert_ptr_not_equal(bank1, bank3);
+	assert_int_equal(bank1->refs, 2);
+	assert_int_equal(bank3->refs, 1);
+
+	/* a released bank stays in cache for the next stream */
+	src_coef_bank_put(bank2);
+	src_coef_bank_put(bank1);
+	bank2 = src_coef_bank_get(48000, 16000);
+	assert_ptr_equal(bank1, bank2);
+	assert_int_equal(bank2->refs, 1);
+
+	src_coef_bank_put(bank2);
+	src_coef_bank_put(bank3);
+}
+
+static void test_audio_src_coef_unsupported(void **state)
+{
+	(void)state;
+
+	/* 48001 = 23 * 2087 can't be done with a reasonable filter */
+	assert_null(src_coef_bank_get(44100, 48001));
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_audio_src_coef_response),
+		cmocka_unit_test(test_audio_src_coef_one_to_one),
+		cmocka_unit_test(test_audio_src_coef_shared),
+		cmocka_unit_test(test_audio_src_coef_unsupported),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, setup, NULL);
+}
@@ -52,6 +52,21 @@ void WEAK rfree(void *ptr)
 	free(ptr);
 }
 
+void WEAK *rpool_zalloc(struct mm_pool *pool)
+{
+	return calloc(pool->size, 1);
+}
+
+void WEAK rpool_free(struct mm_pool *pool, void *ptr)
+{
+	free(ptr);
+}
+
+void WEAK heap_owner_set(const struct sof_uuid_entry *uid)
+{
+	(void)uid;
+}
+
 int WEAK memcpy_s(void *dest, size_t dest_size,
 		  const void *src, size_t src_size)
 {
@@ -14,6 +14,8 @@
 #include <sof/sof.h>
 #include <sof/lib/alloc.h>
 #include <sof/lib/mm_heap.h>
+#include <sof/lib/uuid.h>
+#include <ipc/debug.h>
 #include <ipc/header.h>
 #include <ipc/topology.h>
 
@@ -332,9 +334,141 @@ static void test_lib_alloc(void **state)
 	}
 }
 
+static void test_lib_alloc_pool(void **state)
+{
+	static struct mm_pool pool =
+		MM_POOL_DEF(SOF_MEM_POOL_BUFFER, 100, 4, 0);
+	char *mem[8];
+	int i;
+	int j;
+
+	(void)state;
+
+	for (i = 0; i < ARRAY_SIZE(mem); ++i) {
+		mem[i] = rpool_zalloc(&pool);
+		assert_non_null(mem[i]);
+
+		for (j = 0; j < pool.size; ++j)
+			assert_int_equal(mem[i][j], 0);
+	}
+
+	assert_int_equal(pool.slabs, 2);
+	assert_int_equal(pool.peak, ARRAY_SIZE(mem));
+
+	for (i = 0; i < ARRAY_SIZE(mem); ++i)
+		rpool_free(&pool, mem[i]);
+
+	/* freed objects are handed out again without growing the pool */
+	for (i = 0; i < ARRAY_SIZE(mem); ++i) {
+		mem[i] = rpool_alloc(&pool);
+		assert_non_null(mem[i]);
+	}
+
+	assert_int_equal(pool.slabs, 2);
+	assert_int_equal(pool.peak, ARRAY_SIZE(mem));
+
+	for (i = 0; i < ARRAY_SIZE(mem); ++i)
+		rpool_free(&pool, mem[i]);
+}
+
+static void test_lib_alloc_pool_small_slab(void **state)
+{
+	/* no runtime heap block fits a full slab */
+	static struct mm_pool pool =
+		MM_POOL_DEF(SOF_MEM_POOL_BUFFER, 100, 1024, 0);
+	void *mem;
+
+	(void)state;
+
+	mem = rpool_alloc(&pool);
+	assert_non_null(mem);
+	assert_int_equal(pool.slabs, 1);
+	assert_int_equal(pool.peak, 1);
+
+	rpool_free(&pool, mem);
+}
+
+static uint32_t owner_used(const struct sof_uuid_entry *uid,
+			   uint32_t *used_peak)
+{
+	struct sof_ipc_dbg_mem_owner_elem elems[HEAP_OWNER_COUNT];
+	int count;
+	int i;
+
+	count = heap_owners_get(elems, ARRAY_SIZE(elems));
+
+	for (i = 0; i < count; ++i) {
+		if (elems[i].uuid_key == (uint32_t)(uintptr_t)uid) {
+			*used_peak = elems[i].used_peak;
+			return elems[i].used;
+		}
+	}
+
+	fail_msg("owner not found");
+	return 0;
+}
+
+static uint32_t heaps_fails(void)
+{
+	struct sof_ipc_dbg_mem_usage_elem elems[16];
+	uint32_t fails = 0;
+	int count;
+	int i;
+
+	count = heap_usage_get(elems, ARRAY_SIZE(elems));
+
+	for (i = 0; i < count; ++i)
+		fails += elems[i].alloc_fails;
+
+	return fails;
+}
+
+static void test_lib_alloc_usage(void **state)
+{
+	static const struct sof_uuid_entry owner = { .name = "test" };
+	struct sof_ipc_dbg_mem_usage_elem elems[16];
+	uint32_t used_peak;
+	uint32_t fails;
+	uint32_t used;
+	void *mem;
+	int count;
+	int i;
+
+	(void)state;
+
+	heap_owner_set(&owner);
+	mem = rmalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, 128);
+	heap_owner_set(NULL);
+	assert_non_null(mem);
+
+	used = owner_used(&owner, &used_peak);
+	assert_true(used >= 128);
+	assert_int_equal(used_peak, used);
+
+	count = heap_usage_get(elems, ARRAY_SIZE(elems));
+	assert_true(count > 0);
+
+	for (i = 0; i < count; ++i) {
+		assert_true(elems[i].used_peak >= elems[i].used);
+		assert_true(elems[i].largest_free <=
+			    elems[i].size - elems[i].used);
+	}
+
+	rfree(mem);
+
+	/* memory is returned but the high-water mark stays */
+	assert_int_equal(owner_used(&owner, &used_peak), 0);
+	assert_int_equal(used_peak, used);
+
+	/* a request no buffer heap can serve is counted once */
+	fails = heaps_fails();
+	assert_null(rballoc(0, SOF_MEM_CAPS_RAM, HEAP_BUFFER_SIZE * 2));
+	assert_int_equal(heaps_fails(), fails + 1);
+}
+
 int main(void)
 {
-	struct CMUnitTest tests[ARRAY_SIZE(test_cases)];
+	struct CMUnitTest tests[ARRAY_SIZE(test_cases) + 3];
 
 	int i;
 
@@ -348,6 +482,26 @@ int main(void)
 		t->teardown_func = NULL;
 	}
 
+	tests[i].name = "test_lib_alloc_pool";
+	tests[i].test_func = test_lib_alloc_pool;
+	tests[i].initial_state = NULL;
+	tests[i].setup_func = NULL;
+	tests[i].teardown_func = NULL;
+	i++;
+
+	tests[i].name = "test_lib_alloc_pool_small_slab";
+	tests[i].test_func = test_lib_alloc_pool_small_slab;
+	tests[i].initial_state = NULL;
+	tests[i].setup_func = NULL;
+	tests[i].teardown_func = NULL;
+	i++;
+
+	tests[i].name = "test_lib_alloc_usage";
+	tests[i].test_func = test_lib_alloc_usage;
+	tests[i].initial_state = NULL;
+	tests[i].setup_func = NULL;
+	tests[i].teardown_func = NULL;
+
 	cmocka_set_message_output(CM_OUTPUT_TAP);
 
 	return cmocka_run_group_tests(tests, setup, teardown);
@@ -29,7 +29,7 @@ int rstrlen(const char *s)
 	return 0;
 }
 
-void trace_flush(void)
+void trace_flush(bool panic)
 {
 }
 
@@ -0,0 +1,71 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <cmocka.h>
+
+#include <sof/audio/format.h>
+#include <sof/math/decibels.h>
+
+/* Max. errors of natural logarithm and decibels */
+#define LOG_TOLERANCE	0.0000001
+#define DB_TOLERANCE	0.000002
+
+static void test_math_decibels_log_fixed(void **state)
+{
+	double ref;
+	double y;
+	int32_t x;
+	int i;
+
+	(void)state;
+
+	/* Sweep over the whole Q12.20 input range in 1/8 octave steps */
+	for (i = 0; i < 31 * 8; i++) {
+		x = (int32_t)(pow(2.0, i / 8.0) + 0.5);
+		ref = log((double)x / (1 << LOG_FIXED_INPUT_QY));
+		y = (double)log_fixed(x) / (1 << LOG_FIXED_OUTPUT_QY);
+		assert_true(fabs(y - ref) < LOG_TOLERANCE);
+	}
+
+	assert_int_equal(log_fixed(0), INT32_MIN);
+	assert_int_equal(log_fixed(-1), INT32_MIN);
+}
+
+static void test_math_decibels_lin2db_fixed(void **state)
+{
+	double ref;
+	double y;
+	int32_t x;
+	int i;
+
+	(void)state;
+
+	for (i = 0; i < 31 * 8; i++) {
+		x = (int32_t)(pow(2.0, i / 8.0) + 0.5);
+		ref = 20 * log10((double)x / (1 << LIN2DB_FIXED_INPUT_QY));
+		y = (double)lin2db_fixed(x) / (1 << LIN2DB_FIXED_OUTPUT_QY);
+		assert_true(fabs(y - ref) < DB_TOLERANCE);
+	}
+
+	/* 0 dB exactly for unity gain */
+	assert_int_equal(lin2db_fixed(1 << LIN2DB_FIXED_INPUT_QY), 0);
+	assert_int_equal(lin2db_fixed(0), INT32_MIN);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_decibels_log_fixed),
+		cmocka_unit_test(test_math_decibels_lin2db_fixed),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
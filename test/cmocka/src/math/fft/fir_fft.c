@@ -0,0 +1,184 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/math/fft.h>
+#include <sof/math/fir_fft.h>
+#include <sof/math/trig.h>
+#include <user/fir.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#define TEST_FFT_SIZE		256
+#define TEST_SINE_BIN		8
+#define TEST_TAPS		1000
+#define TEST_SAMPLES		(8 * FIR_FFT_BLOCK_SIZE + 37)
+
+/* Error limits as fraction of full scale */
+#define TEST_FFT_TOLERANCE	0.000001
+#define TEST_FIR_TOLERANCE	0.000001
+
+static uint32_t test_rand_state;
+
+/* Deterministic pseudo random Q1.31 value with amplitude 1/2^shift */
+static int32_t test_rand(int shift)
+{
+	test_rand_state = test_rand_state * 1664525 + 1013904223;
+	return (int32_t)test_rand_state >> shift;
+}
+
+static double test_abs_error(int32_t a, double b)
+{
+	double d = (double)a / 2147483648.0 - b;
+
+	return d < 0 ? -d : d;
+}
+
+static void test_math_rfft_sine(void **state)
+{
+	struct rfft_plan *plan = rfft_plan_new(TEST_FFT_SIZE);
+	struct icomplex32 buf[TEST_FFT_SIZE / 2 + 1];
+	int32_t *x = (int32_t *)buf;
+	int32_t w;
+	int k;
+	int i;
+
+	(void)state;
+
+	assert_non_null(plan);
+
+	/* Sine of amplitude 0.5 exactly at a bin */
+	for (i = 0; i < TEST_FFT_SIZE; i++) {
+		w = (int32_t)(((int64_t)PI_MUL2_Q4_28 * TEST_SINE_BIN *
+			       (i % (TEST_FFT_SIZE / TEST_SINE_BIN))) /
+			      TEST_FFT_SIZE);
+		x[i] = sin_fixed(w) >> 1;
+	}
+
+	rfft_execute_32(plan, buf);
+
+	/* The spectrum is scaled by 1/size, so the sine bin is -j * 0.25 */
+	for (k = 0; k <= TEST_FFT_SIZE / 2; k++) {
+		if (k == TEST_SINE_BIN) {
+			assert_true(test_abs_error(buf[k].real, 0) <
+				    TEST_FFT_TOLERANCE);
+			assert_true(test_abs_error(buf[k].imag, -0.25) <
+				    TEST_FFT_TOLERANCE);
+		} else {
+			assert_true(test_abs_error(buf[k].real, 0) <
+				    TEST_FFT_TOLERANCE);
+			assert_true(test_abs_error(buf[k].imag, 0) <
+				    TEST_FFT_TOLERANCE);
+		}
+	}
+
+	rfft_plan_free(plan);
+}
+
+static void test_math_rfft_inverse(void **state)
+{
+	struct rfft_plan *plan = rfft_plan_new(TEST_FFT_SIZE);
+	struct icomplex32 buf[TEST_FFT_SIZE / 2 + 1];
+	int32_t ref[TEST_FFT_SIZE];
+	int32_t *x = (int32_t *)buf;
+	int i;
+
+	(void)state;
+
+	assert_non_null(plan);
+
+	test_rand_state = 1;
+	for (i = 0; i < TEST_FFT_SIZE; i++) {
+		ref[i] = test_rand(1);
+		x[i] = ref[i];
+	}
+
+	rfft_execute_32(plan, buf);
+	irfft_execute_32(plan, buf);
+
+	for (i = 0; i < TEST_FFT_SIZE; i++)
+		assert_true(test_abs_error(x[i], (double)ref[i] / 2147483648.0) <
+			    TEST_FFT_TOLERANCE);
+
+	rfft_plan_free(plan);
+}
+
+static void test_math_fir_fft_convolution(void **state)
+{
+	struct sof_fir_coef_data *config;
+	struct fir_fft_coef coef;
+	struct fir_fft_state fft;
+	struct rfft_plan *plan;
+	int32_t *x;
+	double ref;
+	int32_t y;
+	int n;
+	int k;
+
+	(void)state;
+
+	config = calloc(1, sizeof(*config) + TEST_TAPS * sizeof(int16_t));
+	x = calloc(TEST_SAMPLES, sizeof(int32_t));
+	plan = fir_fft_plan_new();
+	assert_non_null(config);
+	assert_non_null(x);
+	assert_non_null(plan);
+
+	/* Decaying noise impulse response that spans many partitions */
+	test_rand_state = 2;
+	config->length = TEST_TAPS;
+	config->out_shift = 1;
+	for (k = 0; k < TEST_TAPS; k++)
+		config->coef[k] = (test_rand(2) >> 16) * (TEST_TAPS - k) /
+			TEST_TAPS;
+
+	for (n = 0; n < TEST_SAMPLES; n++)
+		x[n] = test_rand(3);
+
+	memset(&coef, 0, sizeof(coef));
+	memset(&fft, 0, sizeof(fft));
+	assert_int_equal(fir_fft_init_coef(&coef, plan, config), 0);
+	assert_int_equal(coef.partitions,
+			 (TEST_TAPS + FIR_FFT_BLOCK_SIZE - 1) /
+			 FIR_FFT_BLOCK_SIZE);
+	assert_int_equal(fir_fft_init(&fft, plan, &coef), 0);
+
+	/* Output is the direct form convolution delayed by one block */
+	for (n = 0; n < TEST_SAMPLES; n++) {
+		y = fir_fft_32(&fft, x[n]);
+		ref = 0;
+		for (k = 0; k < TEST_TAPS; k++)
+			if (n - FIR_FFT_BLOCK_SIZE - k >= 0)
+				ref += (double)config->coef[k] / 32768.0 *
+					x[n - FIR_FFT_BLOCK_SIZE - k] /
+					2147483648.0;
+
+		ref /= 1 << config->out_shift;
+		assert_true(test_abs_error(y, ref) < TEST_FIR_TOLERANCE);
+	}
+
+	fir_fft_free(&fft);
+	fir_fft_free_coef(&coef);
+	rfft_plan_free(plan);
+	free(config);
+	free(x);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_rfft_sine),
+		cmocka_unit_test(test_math_rfft_inverse),
+		cmocka_unit_test(test_math_fir_fft_convolution),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
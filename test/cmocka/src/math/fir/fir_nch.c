@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/math/fir_config.h>
+#include <sof/math/fir_generic.h>
+#include <sof/math/fir_nch.h>
+#include <user/fir.h>
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmocka.h>
+
+#define TEST_TAPS	37
+#define TEST_SAMPLES	(5 * TEST_TAPS + 3)
+
+static uint32_t test_rand_state;
+
+/* Deterministic pseudo random Q1.31 value with amplitude 1/2^shift */
+static int32_t test_rand(int shift)
+{
+	test_rand_state = test_rand_state * 1664525 + 1013904223;
+	return (int32_t)test_rand_state >> shift;
+}
+
+/* The shared response group must give exactly the same output as
+ * individual per channel filters for every group size.
+ */
+static void test_math_fir_nch_bit_exact(void **state)
+{
+	struct fir_state_32x16 fir[FIR_NCH_MAX_CHANNELS];
+	struct fir_nch_state_32x16 nch;
+	struct sof_fir_coef_data *config;
+	int32_t x[FIR_NCH_MAX_CHANNELS];
+	int32_t y[FIR_NCH_MAX_CHANNELS];
+	int32_t *delay;
+	int32_t *data;
+	int channels;
+	int size;
+	int ch;
+	int n;
+
+	(void)state;
+
+	config = calloc(1, sizeof(*config) + TEST_TAPS * sizeof(int16_t));
+	assert_non_null(config);
+
+	test_rand_state = 1;
+	config->length = TEST_TAPS;
+	config->out_shift = 1;
+	for (n = 0; n < TEST_TAPS; n++)
+		config->coef[n] = test_rand(0) >> 16;
+
+	for (channels = 1; channels <= FIR_NCH_MAX_CHANNELS; channels++) {
+		size = fir_nch_delay_size(config, channels);
+		assert_true(size > 0);
+
+		delay = calloc(1, size + channels * fir_delay_size(config));
+		assert_non_null(delay);
+
+		fir_nch_reset(&nch);
+		assert_int_equal(fir_nch_init_coef(&nch, config, channels), 0);
+		data = delay;
+		fir_nch_init_delay(&nch, &data);
+		for (ch = 0; ch < channels; ch++) {
+			fir_reset(&fir[ch]);
+			assert_int_equal(fir_init_coef(&fir[ch], config), 0);
+			fir_init_delay(&fir[ch], &data);
+		}
+
+		for (n = 0; n < TEST_SAMPLES; n++) {
+			for (ch = 0; ch < channels; ch++)
+				x[ch] = test_rand(ch & 1);
+
+			fir_32x16_nch(&nch, x, y);
+			for (ch = 0; ch < channels; ch++)
+				assert_int_equal(y[ch],
+						 fir_32x16(&fir[ch], x[ch]));
+		}
+
+		free(delay);
+	}
+
+	assert_int_equal(fir_nch_delay_size(config, 0), -EINVAL);
+	assert_int_equal(fir_nch_delay_size(config,
+					    FIR_NCH_MAX_CHANNELS + 1),
+			 -EINVAL);
+	free(config);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_fir_nch_bit_exact),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
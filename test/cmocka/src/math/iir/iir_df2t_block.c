@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <sof/math/iir_df2t.h>
+#include <user/eq.h>
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <string.h>
+#include <cmocka.h>
+
+#define TEST_FRAMES		301
+#define TEST_MAX_CHANNELS	6
+#define TEST_MAX_BIQUADS	4
+
+/* Stable low pass biquad {a2, a1, b2, b1, b0, shift, gain}, Q2.30 and
+ * Q2.14 gain, varied per channel and section.
+ */
+static const int32_t test_biquad[SOF_EQ_IIR_NBIQUAD_DF2T] = {
+	-193273528, 536870912, 214748365, 429496730, 214748365, 0, 16384
+};
+
+/* Filters of all channels, states are kept in an array of their own as
+ * iir_df2t_block_nch() expects.
+ */
+struct test_filters {
+	struct iir_state_df2t iir[TEST_MAX_CHANNELS];
+	int32_t coef[TEST_MAX_CHANNELS][TEST_MAX_BIQUADS *
+					SOF_EQ_IIR_NBIQUAD_DF2T];
+	int64_t delay[TEST_MAX_CHANNELS][TEST_MAX_BIQUADS *
+					 IIR_DF2T_NUM_DELAYS];
+};
+
+static void test_filter_init(struct test_filters *f, int ch, int biquads,
+			     int in_series)
+{
+	int32_t *c;
+	int i;
+
+	for (i = 0; i < biquads; i++) {
+		c = &f->coef[ch][i * SOF_EQ_IIR_NBIQUAD_DF2T];
+		memcpy(c, test_biquad, sizeof(test_biquad));
+		c[1] -= (ch + i) * 10000000;
+		c[4] += ch * 1000000;
+		c[5] = i & 1;
+		c[6] -= ch * 1000;
+	}
+
+	memset(f->delay[ch], 0, sizeof(f->delay[ch]));
+	f->iir[ch].biquads = biquads;
+	f->iir[ch].biquads_in_series = in_series;
+	f->iir[ch].coef = f->coef[ch];
+	f->iir[ch].delay = f->delay[ch];
+}
+
+static void test_signal(int32_t *x, int samples)
+{
+	uint32_t seed = 1;
+	int i;
+
+	/* Noise with some full scale samples to exercise saturation */
+	for (i = 0; i < samples; i++) {
+		seed = seed * 1664525 + 1013904223;
+		x[i] = i % 97 ? (int32_t)seed >> 2 : (int32_t)seed;
+	}
+}
+
+/* Reference output by filtering sample by sample */
+static void test_reference(struct test_filters *f, const int32_t *x,
+			   int32_t *y, int frames, int nch)
+{
+	int ch;
+	int i;
+
+	for (ch = 0; ch < nch; ch++)
+		for (i = 0; i < frames; i++)
+			y[i * nch + ch] = iir_df2t(&f->iir[ch],
+						   x[i * nch + ch]);
+}
+
+static void test_block_nch(int nch, const int *biquads,
+			   const int *in_series, int in_place)
+{
+	struct test_filters ref;
+	struct test_filters dut;
+	int32_t x[TEST_FRAMES * TEST_MAX_CHANNELS];
+	int32_t y_ref[TEST_FRAMES * TEST_MAX_CHANNELS];
+	int32_t y[TEST_FRAMES * TEST_MAX_CHANNELS];
+	int32_t *out = in_place ? x : y;
+	int ch;
+
+	for (ch = 0; ch < nch; ch++) {
+		test_filter_init(&ref, ch, biquads[ch], in_series[ch]);
+		test_filter_init(&dut, ch, biquads[ch], in_series[ch]);
+	}
+
+	test_signal(x, TEST_FRAMES * nch);
+	test_reference(&ref, x, y_ref, TEST_FRAMES, nch);
+
+	/* Two calls to check state is carried over */
+	iir_df2t_block_nch(dut.iir, x, out, 100, nch);
+	iir_df2t_block_nch(dut.iir, x + 100 * nch, out + 100 * nch,
+			   TEST_FRAMES - 100, nch);
+
+	assert_memory_equal(out, y_ref, TEST_FRAMES * nch * sizeof(int32_t));
+}
+
+static void test_math_iir_df2t_block_series(void **state)
+{
+	struct test_filters ref;
+	struct test_filters dut;
+	int32_t x[TEST_FRAMES * 2];
+	int32_t y_ref[TEST_FRAMES];
+	int32_t y[TEST_FRAMES * 2];
+	int i;
+
+	(void)state;
+
+	test_filter_init(&ref, 0, 3, 3);
+	test_filter_init(&dut, 0, 3, 3);
+	test_signal(x, TEST_FRAMES * 2);
+
+	/* Filter only the first of two interleaved channels */
+	for (i = 0; i < TEST_FRAMES; i++)
+		y_ref[i] = iir_df2t(&ref.iir[0], x[2 * i]);
+
+	iir_df2t_block(&dut.iir[0], x, y, TEST_FRAMES, 2);
+
+	for (i = 0; i < TEST_FRAMES; i++)
+		assert_int_equal(y[2 * i], y_ref[i]);
+}
+
+static void test_math_iir_df2t_block_sections(void **state)
+{
+	const int biquads[] = {4};
+	const int in_series[] = {2};
+
+	(void)state;
+
+	test_block_nch(1, biquads, in_series, 0);
+}
+
+static void test_math_iir_df2t_block_nch_lanes(void **state)
+{
+	const int biquads[] = {2, 2, 2, 2, 2, 2};
+	const int in_series[] = {2, 2, 2, 2, 2, 2};
+
+	(void)state;
+
+	/* Groups of four and two channels */
+	test_block_nch(6, biquads, in_series, 0);
+}
+
+static void test_math_iir_df2t_block_nch_mixed(void **state)
+{
+	const int biquads[] = {4, 4, 0, 2, 2, 2};
+	const int in_series[] = {2, 2, 0, 2, 2, 1};
+
+	(void)state;
+
+	/* Multiple sections, bypass and unequal filters in place */
+	test_block_nch(6, biquads, in_series, 1);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_iir_df2t_block_series),
+		cmocka_unit_test(test_math_iir_df2t_block_sections),
+		cmocka_unit_test(test_math_iir_df2t_block_nch_lanes),
+		cmocka_unit_test(test_math_iir_df2t_block_nch_mixed),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,298 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2020 Intel Corporation. All rights reserved.
+
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <math.h>
+#include <time.h>
+#include <cmocka.h>
+
+#include <sof/audio/format.h>
+#include <sof/math/decibels.h>
+#include <sof/math/trig.h>
+#include <sof/math/vec.h>
+
+#if defined __XCC__
+#include <xtensa/tie/xt_timer.h>
+#endif
+
+#define NUM_SAMPLES	1024
+#define BENCH_ROUNDS	64
+
+/* Max. absolute errors */
+#define LOG2_TOLERANCE	0.00000004
+#define SQRT_TOLERANCE	0.000000002
+#define SIN_TOLERANCE	0.0000015
+
+/* Max. relative errors */
+#define EXP2_TOLERANCE	0.00000001
+#define INV_TOLERANCE	0.00000001
+
+static int32_t in[NUM_SAMPLES];
+static int32_t out[NUM_SAMPLES];
+
+/* Processor cycles in simulator, nanoseconds in host */
+static uint64_t bench_time(void)
+{
+#if defined __XCC__
+	return XT_RSR_CCOUNT();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+static double fixed_to_double(int32_t x, int qy)
+{
+	return (double)x / ((int64_t)1 << qy);
+}
+
+static void test_math_vec_log2_int32(void **state)
+{
+	double ref;
+	double y;
+	int i;
+
+	(void)state;
+
+	/* Sweep over the whole positive range in 1/32 octave steps */
+	for (i = 0; i < NUM_SAMPLES; i++)
+		in[i] = (int32_t)fmin(pow(2.0, 31.0 * i / NUM_SAMPLES) + 0.5,
+				      INT32_MAX);
+
+	vec_log2_int32(in, out, NUM_SAMPLES);
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ref = log2(in[i]);
+		y = fixed_to_double(out[i], VEC_LOG2_OUTPUT_QY);
+		assert_true(fabs(y - ref) < LOG2_TOLERANCE);
+	}
+
+	/* Exact for powers of two */
+	in[0] = 1;
+	in[1] = 1 << 20;
+	in[2] = 0;
+	in[3] = -1;
+	vec_log2_int32(in, out, 4);
+	assert_int_equal(out[0], 0);
+	assert_int_equal(out[1], 20 << VEC_LOG2_OUTPUT_QY);
+	assert_int_equal(out[2], INT32_MIN);
+	assert_int_equal(out[3], INT32_MIN);
+}
+
+static void test_math_vec_exp2_fixed(void **state)
+{
+	double ref;
+	double y;
+	int i;
+
+	(void)state;
+
+	/* Exponents from -20 to 11 where the result fits to Q12.20 */
+	for (i = 0; i < NUM_SAMPLES; i++)
+		in[i] = Q_CONVERT_FLOAT(-20.0 + 31.0 * i / NUM_SAMPLES,
+					VEC_EXP2_INPUT_QY);
+
+	vec_exp2_fixed(in, out, NUM_SAMPLES);
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ref = exp2(fixed_to_double(in[i], VEC_EXP2_INPUT_QY));
+		y = fixed_to_double(out[i], VEC_EXP2_OUTPUT_QY);
+		assert_true(fabs(y - ref) < EXP2_TOLERANCE * ref +
+			    1.0 / (1 << VEC_EXP2_OUTPUT_QY));
+	}
+
+	in[0] = 0;
+	in[1] = Q_CONVERT_FLOAT(11.0, VEC_EXP2_INPUT_QY);
+	in[2] = Q_CONVERT_FLOAT(-30.0, VEC_EXP2_INPUT_QY);
+	vec_exp2_fixed(in, out, 3);
+	assert_int_equal(out[0], 1 << VEC_EXP2_OUTPUT_QY);
+	assert_int_equal(out[1], INT32_MAX);
+	assert_int_equal(out[2], 0);
+}
+
+static void test_math_vec_sqrt_fixed(void **state)
+{
+	double ref;
+	double y;
+	int i;
+
+	(void)state;
+
+	for (i = 0; i < NUM_SAMPLES; i++)
+		in[i] = (int32_t)fmin(pow(2.0, 31.0 * i / NUM_SAMPLES) + 0.5,
+				      INT32_MAX);
+
+	vec_sqrt_fixed(in, out, NUM_SAMPLES);
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ref = sqrt(fixed_to_double(in[i], 31));
+		y = fixed_to_double(out[i], 31);
+		assert_true(fabs(y - ref) < SQRT_TOLERANCE);
+	}
+
+	in[0] = Q_CONVERT_FLOAT(0.25, 31);
+	in[1] = 0;
+	in[2] = INT32_MIN;
+	vec_sqrt_fixed(in, out, 3);
+	assert_int_equal(out[0], Q_CONVERT_FLOAT(0.5, 31));
+	assert_int_equal(out[1], 0);
+	assert_int_equal(out[2], 0);
+}
+
+static void test_math_vec_inv_fixed(void **state)
+{
+	double ref;
+	double y;
+	int i;
+
+	(void)state;
+
+	/* Magnitudes from 2^-11 to 2^11 with alternating sign */
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		in[i] = (int32_t)(pow(2.0, 9.0 + 22.0 * i / NUM_SAMPLES) + 0.5);
+		if (i & 1)
+			in[i] = -in[i];
+	}
+
+	vec_inv_fixed(in, out, NUM_SAMPLES);
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		ref = 1.0 / fixed_to_double(in[i], VEC_INV_QY);
+		y = fixed_to_double(out[i], VEC_INV_QY);
+		assert_true(fabs(y - ref) < INV_TOLERANCE * fabs(ref) +
+			    1.0 / (1 << VEC_INV_QY));
+	}
+
+	in[0] = 1 << VEC_INV_QY;
+	in[1] = -(2 << VEC_INV_QY);
+	in[2] = 0;
+	in[3] = 1;
+	vec_inv_fixed(in, out, 4);
+	assert_int_equal(out[0], 1 << VEC_INV_QY);
+	assert_int_equal(out[1], -(1 << (VEC_INV_QY - 1)));
+	assert_int_equal(out[2], INT32_MAX);
+	assert_int_equal(out[3], INT32_MAX);
+}
+
+static void test_math_vec_sin_fixed(void **state)
+{
+	struct vec_sin_state gen;
+	double w;
+	double y;
+	int i;
+
+	(void)state;
+
+	/* 997 Hz at 48 kHz, generated in two blocks to check the phase
+	 * continuity across calls.
+	 */
+	vec_sin_init(&gen, 997 << 16, 48000);
+	vec_sin_fixed(&gen, out, NUM_SAMPLES / 4);
+	vec_sin_fixed(&gen, out + NUM_SAMPLES / 4,
+		      NUM_SAMPLES - NUM_SAMPLES / 4);
+
+	w = 2 * M_PI * (double)gen.step / 4294967296.0;
+	for (i = 0; i < NUM_SAMPLES; i++) {
+		y = fixed_to_double(out[i], 31);
+		assert_true(fabs(y - sin(w * i)) < SIN_TOLERANCE);
+	}
+}
+
+/* Prints the time per sample of block functions and per sample calls of
+ * the scalar functions with similar use. The timings are informative
+ * only and are not checked.
+ */
+static void test_math_vec_benchmark(void **state)
+{
+	struct vec_sin_state gen;
+	uint64_t t0;
+	uint64_t t;
+	int i;
+	int j;
+
+	(void)state;
+
+	for (i = 0; i < NUM_SAMPLES; i++)
+		in[i] = Q_CONVERT_FLOAT(-10.0 + 10.0 * i / NUM_SAMPLES, 26);
+
+	t0 = bench_time();
+	for (j = 0; j < BENCH_ROUNDS; j++)
+		vec_exp2_fixed(in, out, NUM_SAMPLES);
+
+	t = bench_time() - t0;
+	print_message("vec_exp2_fixed %.1f per sample\n",
+		      (double)t / (BENCH_ROUNDS * NUM_SAMPLES));
+
+	/* Same range in Q5.27 for scalar exp_fixed() */
+	t0 = bench_time();
+	for (j = 0; j < BENCH_ROUNDS; j++)
+		for (i = 0; i < NUM_SAMPLES; i++)
+			out[i] = exp_fixed(in[i] >> 1);
+
+	t = bench_time() - t0;
+	print_message("exp_fixed %.1f per sample\n",
+		      (double)t / (BENCH_ROUNDS * NUM_SAMPLES));
+
+	t0 = bench_time();
+	for (j = 0; j < BENCH_ROUNDS; j++)
+		vec_log2_int32(out, in, NUM_SAMPLES);
+
+	t = bench_time() - t0;
+	print_message("vec_log2_int32 %.1f per sample\n",
+		      (double)t / (BENCH_ROUNDS * NUM_SAMPLES));
+
+	t0 = bench_time();
+	for (j = 0; j < BENCH_ROUNDS; j++)
+		vec_sqrt_fixed(out, in, NUM_SAMPLES);
+
+	t = bench_time() - t0;
+	print_message("vec_sqrt_fixed %.1f per sample\n",
+		      (double)t / (BENCH_ROUNDS * NUM_SAMPLES));
+
+	t0 = bench_time();
+	for (j = 0; j < BENCH_ROUNDS; j++)
+		vec_inv_fixed(out, in, NUM_SAMPLES);
+
+	t = bench_time() - t0;
+	print_message("vec_inv_fixed %.1f per sample\n",
+		      (double)t / (BENCH_ROUNDS * NUM_SAMPLES));
+
+	vec_sin_init(&gen, 997 << 16, 48000);
+	t0 = bench_time();
+	for (j = 0; j < BENCH_ROUNDS; j++)
+		vec_sin_fixed(&gen, out, NUM_SAMPLES);
+
+	t = bench_time() - t0;
+	print_message("vec_sin_fixed %.1f per sample\n",
+		      (double)t / (BENCH_ROUNDS * NUM_SAMPLES));
+
+	/* Q4.28 phase in radians for sin_fixed() */
+	t0 = bench_time();
+	for (j = 0; j < BENCH_ROUNDS; j++)
+		for (i = 0; i < NUM_SAMPLES; i++)
+			out[i] = sin_fixed((int32_t)(((int64_t)i *
+						      PI_MUL2_Q4_28) /
+						     NUM_SAMPLES));
+
+	t = bench_time() - t0;
+	print_message("sin_fixed %.1f per sample\n",
+		      (double)t / (BENCH_ROUNDS * NUM_SAMPLES));
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_math_vec_log2_int32),
+		cmocka_unit_test(test_math_vec_exp2_fixed),
+		cmocka_unit_test(test_math_vec_sqrt_fixed),
+		cmocka_unit_test(test_math_vec_inv_fixed),
+		cmocka_unit_test(test_math_vec_sin_fixed),
+		cmocka_unit_test(test_math_vec_benchmark),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -4,6 +4,7 @@
 //
 // Author: Artur Kloniecki <arturx.kloniecki@linux.intel.com>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <sof/lib/alloc.h>
@@ -25,7 +26,7 @@ struct notify **arch_notify_get(void)
 	int i;
 
 	if (!_notify) {
-		_notify = malloc(sizeof(*_notify));
+		_notify = calloc(1, sizeof(*_notify));
 
 		for (i = 0; i < NOTIFIER_ID_COUNT; i++)
 			list_init(&_notify->list[i]);
@@ -70,6 +71,9 @@ int notifier_register(void *receiver, void *caller, enum notify_id type,
 
 	list_item_append(&handle->list, &notify->list[type]);
 
+	if (!caller)
+		notify->wildcards[type]++;
+
 	return 0;
 }
 
@@ -87,12 +91,29 @@ void notifier_unregister(void *receiver, void *caller, enum notify_id type)
 		handle = container_of(wlist, struct callback_handle, list);
 		if ((!receiver || handle->receiver == receiver) &&
 		    (!caller || handle->caller == caller)) {
+			if (!handle->caller)
+				notify->wildcards[type]--;
 			list_item_del(&handle->list);
 			free(handle);
 		}
 	}
 }
 
+bool notifier_has_callbacks(const void *caller, enum notify_id type)
+{
+	struct notify *notify = *arch_notify_get();
+	struct list_item *wlist;
+	struct callback_handle *handle;
+
+	list_for_item(wlist, &notify->list[type]) {
+		handle = container_of(wlist, struct callback_handle, list);
+		if (!handle->caller || handle->caller == caller)
+			return true;
+	}
+
+	return false;
+}
+
 void notifier_unregister_all(void *receiver, void *caller)
 {
 	int i;
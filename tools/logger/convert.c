@@ -6,6 +6,7 @@
 //	   Artur Kloniecki	<arturx.kloniecki@linux.intel.com>
 
 #include <endian.h>
+#include <inttypes.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -13,7 +14,12 @@
 #include <errno.h>
 #include <unistd.h>
 #include <math.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <ipc/debug.h>
 #include <sof/lib/uuid.h>
+#include <sof/math/numbers.h>
 #include <user/abi_dbg.h>
 #include <user/trace.h>
 #include "convert.h"
@@ -29,6 +35,17 @@
 #define TRACE_IDS_MASK			((1 << TRACE_ID_LENGTH) - 1)
 #define INVALID_TRACE_ID		(-1 & TRACE_IDS_MASK)
 
+/* buckets of parsed ldc entries, hashed by log entry address */
+#define LDC_HASH_BITS			12
+#define LDC_HASH_SIZE			(1 << LDC_HASH_BITS)
+
+/* input chunk limits of parallel decoding */
+#define DECODE_CHUNK_MIN		(64 * 1024)
+#define DECODE_CHUNK_MAX		(4 * 1024 * 1024)
+
+/* consecutive records that must be valid to resynchronize on a chunk */
+#define DECODE_RESYNC_RECORDS		8
+
 struct ldc_entry_header {
 	uint32_t level;
 	uint32_t component_class;
@@ -38,21 +55,71 @@ struct ldc_entry_header {
 	uint32_t text_len;
 };
 
+/*
+ * Entry of the ldc dictionary parsed on first use, the format is ready
+ * for printf() and the uuid arguments are described by the masks.
+ */
 struct ldc_entry {
 	struct ldc_entry_header header;
+	uint32_t address;
 	char *file_name;
-	char *text;
-	uint32_t *params;
+	const char *location;	/* file name as printed */
+	char *text;		/* format with %pU replaced by %s */
+	uint32_t uid_mask;	/* params printed as uuid */
+	uint32_t uid_be;	/* uuid params in big endian */
+	uint32_t uid_upper;	/* uuid params in upper case */
+	struct ldc_entry *next;	/* next entry in hash bucket */
 };
 
 struct proc_ldc_entry {
 	int subst_mask;
-	struct ldc_entry_header header;
-	char *file_name;
-	char *text;
 	uintptr_t params[TRACE_MAX_PARAMS_COUNT];
 };
 
+/* ldc file mapped once and its entries parsed so far */
+struct ldc_dict {
+	const uint8_t *map;
+	size_t size;
+	pthread_rwlock_t lock;	/* protects hash from decoding threads */
+	struct ldc_entry *hash[LDC_HASH_SIZE];
+};
+
+static struct ldc_dict ldc_dict = {
+	.lock = PTHREAD_RWLOCK_INITIALIZER,
+};
+
+/* log record decoded from memory mapped input */
+struct log_record {
+	struct log_entry_header dma_log;
+	const struct ldc_entry *entry;
+	uint32_t params[TRACE_MAX_PARAMS_COUNT];
+};
+
+/* part of the input decoded by one thread into its own buffer */
+struct decode_chunk {
+	size_t begin;		/* first record after resynchronization */
+	size_t end;		/* records starting before end belong here */
+	size_t next;		/* input offset after the last record */
+	uint64_t last_timestamp;
+	int records;
+	int ret;
+	bool done;
+	char *buf;
+	size_t buf_size;
+};
+
+struct decode_ctx {
+	const uint8_t *data;
+	size_t size;
+	struct decode_chunk *chunks;
+	int num_chunks;
+	int next_chunk;		/* next chunk to pick by a thread */
+	int merged;		/* chunks written to output */
+	int window;		/* max chunks decoded ahead of output */
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+};
+
 static const char *BAD_PTR_STR = "<bad uid ptr %x>";
 
 #define UUID_LOWER "%s%s%s<%08x-%04x-%04x-%02x%02x-%02x%02x%02x%02x%02x%02x>%s%s%s"
@@ -131,47 +198,43 @@ static const char *format_uid(uint32_t uid_ptr, int use_colors, bool be, bool up
 	return str;
 }
 
-static void process_params(struct proc_ldc_entry *pe,
-			   const struct ldc_entry *e,
-			   int use_colors)
+/*
+ * Scan the text for possible replacements. We follow the Linux kernel
+ * that uses %pUx formats for UUID / GUID printing, where 'x' is
+ * optional and can be one of 'b', 'B', 'l' (default), and 'L'.
+ */
+static void parse_format(struct ldc_entry *e)
 {
 	char *p = e->text;
 	const char *t_end = p + strlen(e->text);
-	unsigned int par_bit = 1, be = 0, upper = 0;
-	int i;
+	unsigned int par_bit = 1;
 
-	pe->subst_mask = 0;
-	pe->header =  e->header;
-	pe->file_name = e->file_name;
-	pe->text = e->text;
+	e->uid_mask = 0;
+	e->uid_be = 0;
+	e->uid_upper = 0;
 
-	/*
-	 * Scan the text for possible replacements. We follow the Linux kernel
-	 * that uses %pUx formats for UUID / GUID printing, where 'x' is
-	 * optional and can be one of 'b', 'B', 'l' (default), and 'L'.
-	 */
 	while ((p = strchr(p, '%'))) {
 		if (p < t_end - 2 && *(p + 1) == 'p' && *(p + 2) == 'U') {
 			unsigned int skip;
 			char *s = p + 2;
 
-			pe->subst_mask += par_bit;
+			e->uid_mask |= par_bit;
 			p[1] = 's';
 			switch (p[2]) {
 			case 'b':
-				be |= par_bit;
+				e->uid_be |= par_bit;
 				skip = 2;
 				break;
 			case 'B':
-				be |= par_bit;
-				upper |= par_bit;
+				e->uid_be |= par_bit;
+				e->uid_upper |= par_bit;
 				skip = 2;
 				break;
 			case 'l':
 				skip = 2;
 				break;
 			case 'L':
-				upper |= par_bit;
+				e->uid_upper |= par_bit;
 				skip = 2;
 				break;
 			default:
@@ -191,13 +254,22 @@ static void process_params(struct proc_ldc_entry *pe,
 			par_bit <<= 1;
 		}
 	}
+}
+
+static void process_params(struct proc_ldc_entry *pe,
+			   const struct ldc_entry *e,
+			   const uint32_t *params, int use_colors)
+{
+	int i;
+
+	pe->subst_mask = e->uid_mask;
 
 	for (i = 0; i < e->header.params_num; i++) {
-		pe->params[i] = e->params[i];
+		pe->params[i] = params[i];
 		if (pe->subst_mask & (1 << i))
-			pe->params[i] = (uintptr_t)format_uid(e->params[i], use_colors,
-							      (be >> i) & 1,
-							      (upper >> i) & 1);
+			pe->params[i] = (uintptr_t)format_uid(params[i], use_colors,
+							      (e->uid_be >> i) & 1,
+							      (e->uid_upper >> i) & 1);
 	}
 }
 
@@ -226,6 +298,15 @@ static inline void print_table_header(void)
 	int time_precision = global_config->time_precision;
 	char time_fmt[32];
 
+	if (global_config->out_format == OUT_FORMAT_CSV) {
+		fprintf(out_fd, "timestamp,time_us,core,level,component,uuid,id_0,id_1,file,line,params,message\n");
+		fflush(out_fd);
+		return;
+	}
+
+	if (global_config->out_format == OUT_FORMAT_JSON)
+		return;
+
 	if (time_precision >= 0) {
 		snprintf(time_fmt, sizeof(time_fmt), "%%%ds %%%ds ",
 			 time_precision + 12, time_precision + 12);
@@ -263,6 +344,23 @@ static const char *get_level_name(uint32_t level)
 	}
 }
 
+/* level names in structured output */
+static const char *get_level_str(uint32_t level)
+{
+	switch (level) {
+	case LOG_LEVEL_CRITICAL:
+		return "error";
+	case LOG_LEVEL_WARNING:
+		return "warning";
+	case LOG_LEVEL_INFO:
+		return "info";
+	case LOG_LEVEL_DEBUG:
+		return "debug";
+	default:
+		return "unknown";
+	}
+}
+
 static const char *get_component_name(uint32_t trace_class, uint32_t uid_ptr)
 {
 	const struct snd_sof_uids_header *uids_dict = global_config->uids_dict;
@@ -310,10 +408,10 @@ static char *format_file_name(char *file_name_raw, int full_name)
 		return name;
 }
 
-static void print_entry_params(const struct log_entry_header *dma_log,
-			       const struct ldc_entry *entry, uint64_t last_timestamp)
+static void print_entry_params(FILE *out_fd, const struct log_entry_header *dma_log,
+			       const struct ldc_entry *entry,
+			       const uint32_t *params, uint64_t last_timestamp)
 {
-	FILE *out_fd = global_config->out_fd;
 	int use_colors = global_config->use_colors;
 	int raw_output = global_config->raw_output;
 	int hide_location = global_config->hide_location;
@@ -322,7 +420,7 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 	char ids[TRACE_MAX_IDS_STR];
 	float dt = to_usecs(dma_log->timestamp - last_timestamp);
 	struct proc_ldc_entry proc_entry;
-	static char time_fmt[32];
+	char time_fmt[32];
 
 	if (raw_output)
 		use_colors = 0;
@@ -355,8 +453,7 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 		if (time_precision >= 0)
 			fprintf(out_fd, time_fmt, to_usecs(dma_log->timestamp), dt);
 		if (!hide_location)
-			fprintf(out_fd, "(%s:%u) ",
-				format_file_name(entry->file_name, raw_output),
+			fprintf(out_fd, "(%s:%u) ", entry->location,
 				entry->header.line_idx);
 	} else {
 		/* timestamp */
@@ -387,8 +484,7 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 
 		/* location */
 		if (!hide_location)
-			fprintf(out_fd, "%24s:%-4u ",
-				format_file_name(entry->file_name, raw_output),
+			fprintf(out_fd, "%24s:%-4u ", entry->location,
 				entry->header.line_idx);
 
 		/* level name */
@@ -397,24 +493,24 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 			get_level_name(entry->header.level));
 	}
 
-	process_params(&proc_entry, entry, use_colors);
+	process_params(&proc_entry, entry, params, use_colors);
 
-	switch (proc_entry.header.params_num) {
+	switch (entry->header.params_num) {
 	case 0:
-		fprintf(out_fd, "%s", proc_entry.text);
+		fprintf(out_fd, "%s", entry->text);
 		break;
 	case 1:
-		fprintf(out_fd, proc_entry.text, proc_entry.params[0]);
+		fprintf(out_fd, entry->text, proc_entry.params[0]);
 		break;
 	case 2:
-		fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1]);
+		fprintf(out_fd, entry->text, proc_entry.params[0], proc_entry.params[1]);
 		break;
 	case 3:
-		fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1],
+		fprintf(out_fd, entry->text, proc_entry.params[0], proc_entry.params[1],
 			proc_entry.params[2]);
 		break;
 	case 4:
-		fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1],
+		fprintf(out_fd, entry->text, proc_entry.params[0], proc_entry.params[1],
 			proc_entry.params[2], proc_entry.params[3]);
 		break;
 	}
@@ -423,67 +519,256 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 	fflush(out_fd);
 }
 
+/* message text of structured output, without colors */
+static char *format_message(const struct ldc_entry *entry, const uint32_t *params)
+{
+	struct proc_ldc_entry proc_entry;
+	char *msg = NULL;
+
+	process_params(&proc_entry, entry, params, 0);
+
+	switch (entry->header.params_num) {
+	case 0:
+		msg = asprintf("%s", entry->text);
+		break;
+	case 1:
+		msg = asprintf(entry->text, proc_entry.params[0]);
+		break;
+	case 2:
+		msg = asprintf(entry->text, proc_entry.params[0], proc_entry.params[1]);
+		break;
+	case 3:
+		msg = asprintf(entry->text, proc_entry.params[0], proc_entry.params[1],
+			       proc_entry.params[2]);
+		break;
+	case 4:
+		msg = asprintf(entry->text, proc_entry.params[0], proc_entry.params[1],
+			       proc_entry.params[2], proc_entry.params[3]);
+		break;
+	}
+	free_proc_ldc_entry(&proc_entry);
+
+	return msg;
+}
+
+/* uuid of the component without the name, empty when unknown */
+static void format_uuid_str(char *str, size_t size, uint32_t uid_ptr)
+{
+	const struct snd_sof_uids_header *uids_dict = global_config->uids_dict;
+	const struct sof_uuid *uid_val;
+
+	str[0] = '\0';
+	if (uid_ptr < uids_dict->base_address ||
+	    uid_ptr >= uids_dict->base_address + uids_dict->data_length)
+		return;
+
+	uid_val = &get_uuid_entry(uid_ptr)->id;
+	snprintf(str, size, "%08x-%04x-%04x-%02x%02x-%02x%02x%02x%02x%02x%02x",
+		 uid_val->a, uid_val->b, uid_val->c,
+		 uid_val->d[0], uid_val->d[1], uid_val->d[2], uid_val->d[3],
+		 uid_val->d[4], uid_val->d[5], uid_val->d[6], uid_val->d[7]);
+}
+
+static void print_csv_string(FILE *out_fd, const char *str)
+{
+	fputc('"', out_fd);
+	for (; *str; str++) {
+		if (*str == '"')
+			fputc('"', out_fd);
+		fputc(*str, out_fd);
+	}
+	fputc('"', out_fd);
+}
+
+static void print_json_string(FILE *out_fd, const char *str)
+{
+	fputc('"', out_fd);
+	for (; *str; str++) {
+		switch (*str) {
+		case '"':
+			fputs("\\\"", out_fd);
+			break;
+		case '\\':
+			fputs("\\\\", out_fd);
+			break;
+		case '\n':
+			fputs("\\n", out_fd);
+			break;
+		case '\t':
+			fputs("\\t", out_fd);
+			break;
+		default:
+			if ((unsigned char)*str < 0x20)
+				fprintf(out_fd, "\\u%04x", *str);
+			else
+				fputc(*str, out_fd);
+			break;
+		}
+	}
+	fputc('"', out_fd);
+}
+
+static void print_entry_csv(FILE *out_fd, const struct log_entry_header *dma_log,
+			    const struct ldc_entry *entry, const uint32_t *params,
+			    const char *uuid, const char *msg)
+{
+	int precision = global_config->time_precision >= 0 ?
+			global_config->time_precision : 6;
+	int i;
+
+	fprintf(out_fd, "%" PRIu64 ",%.*f,%u,%s,",
+		(uint64_t)dma_log->timestamp, precision,
+		to_usecs(dma_log->timestamp), dma_log->core_id,
+		get_level_str(entry->header.level));
+	print_csv_string(out_fd, get_component_name(entry->header.component_class,
+						    dma_log->uid));
+	fprintf(out_fd, ",%s,", uuid);
+
+	if (dma_log->id_0 != INVALID_TRACE_ID &&
+	    dma_log->id_1 != INVALID_TRACE_ID)
+		fprintf(out_fd, "%u,%u,", dma_log->id_0 & TRACE_IDS_MASK,
+			dma_log->id_1 & TRACE_IDS_MASK);
+	else
+		fprintf(out_fd, ",,");
+
+	print_csv_string(out_fd, entry->location);
+	fprintf(out_fd, ",%u,", entry->header.line_idx);
+
+	/* raw params separated by space */
+	for (i = 0; i < entry->header.params_num; i++)
+		fprintf(out_fd, "%s0x%x", i ? " " : "", params[i]);
+
+	fprintf(out_fd, ",");
+	print_csv_string(out_fd, msg ? msg : "");
+	fprintf(out_fd, "\n");
+}
+
+static void print_entry_json(FILE *out_fd, const struct log_entry_header *dma_log,
+			     const struct ldc_entry *entry, const uint32_t *params,
+			     const char *uuid, const char *msg)
+{
+	int precision = global_config->time_precision >= 0 ?
+			global_config->time_precision : 6;
+	int i;
+
+	fprintf(out_fd, "{\"timestamp\":%" PRIu64 ",\"time_us\":%.*f,\"core\":%u,\"level\":\"%s\",\"component\":",
+		(uint64_t)dma_log->timestamp, precision,
+		to_usecs(dma_log->timestamp), dma_log->core_id,
+		get_level_str(entry->header.level));
+	print_json_string(out_fd, get_component_name(entry->header.component_class,
+						     dma_log->uid));
+
+	if (uuid[0])
+		fprintf(out_fd, ",\"uuid\":\"%s\"", uuid);
+	else
+		fprintf(out_fd, ",\"uuid\":null");
+
+	if (dma_log->id_0 != INVALID_TRACE_ID &&
+	    dma_log->id_1 != INVALID_TRACE_ID)
+		fprintf(out_fd, ",\"id_0\":%u,\"id_1\":%u",
+			dma_log->id_0 & TRACE_IDS_MASK,
+			dma_log->id_1 & TRACE_IDS_MASK);
+	else
+		fprintf(out_fd, ",\"id_0\":null,\"id_1\":null");
+
+	fprintf(out_fd, ",\"file\":");
+	print_json_string(out_fd, entry->location);
+	fprintf(out_fd, ",\"line\":%u,\"params\":[", entry->header.line_idx);
+
+	for (i = 0; i < entry->header.params_num; i++)
+		fprintf(out_fd, "%s%u", i ? "," : "", params[i]);
+
+	fprintf(out_fd, "],\"message\":");
+	print_json_string(out_fd, msg ? msg : "");
+	fprintf(out_fd, "}\n");
+}
+
+static void print_entry(FILE *out_fd, const struct log_entry_header *dma_log,
+			const struct ldc_entry *entry, const uint32_t *params,
+			uint64_t last_timestamp)
+{
+	char uuid[40];
+	char *msg;
+
+	if (global_config->out_format == OUT_FORMAT_TEXT) {
+		print_entry_params(out_fd, dma_log, entry, params, last_timestamp);
+		return;
+	}
+
+	format_uuid_str(uuid, sizeof(uuid), dma_log->uid);
+	msg = format_message(entry, params);
+
+	if (global_config->out_format == OUT_FORMAT_CSV)
+		print_entry_csv(out_fd, dma_log, entry, params, uuid, msg);
+	else
+		print_entry_json(out_fd, dma_log, entry, params, uuid, msg);
+
+	free(msg);
+	fflush(out_fd);
+}
+
 static int read_entry_from_ldc_file(struct ldc_entry *entry, uint32_t log_entry_address)
 {
 	uint32_t base_address = global_config->logs_header->base_address;
 	uint32_t data_offset = global_config->logs_header->data_offset;
-
+	const uint8_t *data;
 	int ret;
 
 	/* evaluate entry offset in input file */
-	uint32_t entry_offset = (log_entry_address - base_address) + data_offset;
+	size_t entry_offset = (size_t)(log_entry_address - base_address) + data_offset;
 
+	entry->address = log_entry_address;
 	entry->file_name = NULL;
 	entry->text = NULL;
-	entry->params = NULL;
-
-	/* set file position to beginning of processed entry */
-	fseek(global_config->ldc_fd, entry_offset, SEEK_SET);
 
 	/* fetching elf header params */
-	ret = fread(&entry->header, sizeof(entry->header), 1, global_config->ldc_fd);
-	if (!ret) {
-		ret = -ferror(global_config->ldc_fd);
-		goto out;
+	if (entry_offset + sizeof(entry->header) > ldc_dict.size) {
+		log_err("Entry 0x%x is outside of ldc file\n", log_entry_address);
+		return -EINVAL;
 	}
+	data = ldc_dict.map + entry_offset;
+	memcpy(&entry->header, data, sizeof(entry->header));
+	data += sizeof(entry->header);
+
 	if (entry->header.file_name_len > TRACE_MAX_FILENAME_LEN) {
 		log_err("Invalid filename length or ldc file does not match firmware\n");
-		ret = -EINVAL;
-		goto out;
+		return -EINVAL;
+	}
+	if (entry->header.text_len > TRACE_MAX_TEXT_LEN) {
+		log_err("Invalid text length.\n");
+		return -EINVAL;
+	}
+	if (entry->header.params_num > TRACE_MAX_PARAMS_COUNT) {
+		log_err("Invalid number of parameters.\n");
+		return -EINVAL;
+	}
+	if (entry_offset + sizeof(entry->header) + entry->header.file_name_len +
+	    entry->header.text_len > ldc_dict.size) {
+		log_err("Entry 0x%x is truncated in ldc file\n", log_entry_address);
+		return -EINVAL;
 	}
-	entry->file_name = (char *)malloc(entry->header.file_name_len);
 
+	entry->file_name = strndup((const char *)data, entry->header.file_name_len);
 	if (!entry->file_name) {
 		log_err("can't allocate %d byte for entry.file_name\n",
 			entry->header.file_name_len);
 		ret = -ENOMEM;
 		goto out;
 	}
-
-	ret = fread(entry->file_name, sizeof(char), entry->header.file_name_len,
-		    global_config->ldc_fd);
-	if (ret != entry->header.file_name_len) {
-		ret = -ferror(global_config->ldc_fd);
-		goto out;
-	}
+	data += entry->header.file_name_len;
 
 	/* fetching text */
-	if (entry->header.text_len > TRACE_MAX_TEXT_LEN) {
-		log_err("Invalid text length.\n");
-		ret = -EINVAL;
-		goto out;
-	}
-	entry->text = (char *)malloc(entry->header.text_len);
+	entry->text = strndup((const char *)data, entry->header.text_len);
 	if (!entry->text) {
 		log_err("can't allocate %d byte for entry.text\n", entry->header.text_len);
 		ret = -ENOMEM;
 		goto out;
 	}
-	ret = fread(entry->text, sizeof(char), entry->header.text_len, global_config->ldc_fd);
-	if (ret != entry->header.text_len) {
-		ret = -ferror(global_config->ldc_fd);
-		goto out;
-	}
+
+	entry->location = format_file_name(entry->file_name,
+					   global_config->raw_output ||
+					   global_config->out_format != OUT_FORMAT_TEXT);
+	parse_format(entry);
 
 	return 0;
 
@@ -496,66 +781,155 @@ out:
 	return ret;
 }
 
-static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_timestamp)
+static unsigned int ldc_hash(uint32_t log_entry_address)
 {
-	struct ldc_entry entry;
-	int ret;
+	return (log_entry_address * 2654435761u) >> (32 - LDC_HASH_BITS);
+}
 
-	ret = read_entry_from_ldc_file(&entry, dma_log->log_entry_address);
-	if (ret < 0)
+static struct ldc_entry *find_entry(struct ldc_entry *bucket, uint32_t log_entry_address)
+{
+	struct ldc_entry *e;
+
+	for (e = bucket; e; e = e->next)
+		if (e->address == log_entry_address)
+			return e;
+
+	return NULL;
+}
+
+/* returns entry from the hash, parsing it from the ldc file on first use */
+static int get_entry(uint32_t log_entry_address, const struct ldc_entry **entry)
+{
+	struct ldc_entry **bucket = &ldc_dict.hash[ldc_hash(log_entry_address)];
+	struct ldc_entry *e;
+	int ret = 0;
+
+	pthread_rwlock_rdlock(&ldc_dict.lock);
+	e = find_entry(*bucket, log_entry_address);
+	pthread_rwlock_unlock(&ldc_dict.lock);
+	if (e) {
+		*entry = e;
+		return 0;
+	}
+
+	/* another thread may have parsed it in the meantime */
+	pthread_rwlock_wrlock(&ldc_dict.lock);
+	e = find_entry(*bucket, log_entry_address);
+	if (e)
 		goto out;
 
-	/* fetching entry params from dma dump */
-	if (entry.header.params_num > TRACE_MAX_PARAMS_COUNT) {
-		log_err("Invalid number of parameters.\n");
-		ret = -EINVAL;
+	e = malloc(sizeof(*e));
+	if (!e) {
+		log_err("can't allocate %d byte for ldc entry\n", (int)sizeof(*e));
+		ret = -ENOMEM;
 		goto out;
 	}
-	entry.params = (uint32_t *)malloc(sizeof(uint32_t) * entry.header.params_num);
-	if (!entry.params) {
-		log_err("can't allocate %d byte for entry.params\n",
-			(int)(sizeof(uint32_t) * entry.header.params_num));
-		ret = -ENOMEM;
+
+	ret = read_entry_from_ldc_file(e, log_entry_address);
+	if (ret < 0) {
+		free(e);
+		e = NULL;
 		goto out;
 	}
 
+	e->next = *bucket;
+	*bucket = e;
+out:
+	pthread_rwlock_unlock(&ldc_dict.lock);
+	*entry = e;
+
+	return ret;
+}
+
+static int ldc_dict_map(void)
+{
+	struct stat st;
+	void *map;
+
+	if (fstat(fileno(global_config->ldc_fd), &st) < 0) {
+		log_err("can't stat %s: %s\n", global_config->ldc_file,
+			strerror(errno));
+		return -errno;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+		   fileno(global_config->ldc_fd), 0);
+	if (map == MAP_FAILED) {
+		log_err("can't map %s: %s\n", global_config->ldc_file,
+			strerror(errno));
+		return -errno;
+	}
+
+	ldc_dict.map = map;
+	ldc_dict.size = st.st_size;
+
+	return 0;
+}
+
+static void ldc_dict_free(void)
+{
+	struct ldc_entry *e;
+	int i;
+
+	for (i = 0; i < LDC_HASH_SIZE; i++) {
+		while (ldc_dict.hash[i]) {
+			e = ldc_dict.hash[i];
+			ldc_dict.hash[i] = e->next;
+			free(e->text);
+			free(e->file_name);
+			free(e);
+		}
+	}
+
+	munmap((void *)ldc_dict.map, ldc_dict.size);
+	ldc_dict.map = NULL;
+	ldc_dict.size = 0;
+}
+
+static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_timestamp)
+{
+	const struct ldc_entry *entry;
+	uint32_t params[TRACE_MAX_PARAMS_COUNT];
+	int ret;
+
+	ret = get_entry(dma_log->log_entry_address, &entry);
+	if (ret < 0)
+		return ret;
+
+	/* fetching entry params from dma dump */
 	if (global_config->serial_fd < 0) {
-		ret = fread(entry.params, sizeof(uint32_t), entry.header.params_num,
+		ret = fread(params, sizeof(uint32_t), entry->header.params_num,
 			    global_config->in_fd);
-		if (ret != entry.header.params_num) {
-			ret = -ferror(global_config->in_fd);
-			goto out;
-		}
+		if (ret != entry->header.params_num)
+			return -ferror(global_config->in_fd);
 	} else {
-		size_t size = sizeof(uint32_t) * entry.header.params_num;
+		size_t size = sizeof(uint32_t) * entry->header.params_num;
 		uint8_t *n;
 
-		for (n = (uint8_t *)entry.params; size; n += ret, size -= ret) {
+		for (n = (uint8_t *)params; size; n += ret, size -= ret) {
 			ret = read(global_config->serial_fd, n, size);
-			if (ret < 0) {
-				ret = -errno;
-				goto out;
-			}
+			if (ret < 0)
+				return -errno;
 			if (ret != size)
 				log_err("Partial read of %u bytes of %lu.\n", ret, size);
 		}
 	}
 
 	/* printing entry content */
-	print_entry_params(dma_log, &entry, *last_timestamp);
+	print_entry(global_config->out_fd, dma_log, entry, params, *last_timestamp);
 	*last_timestamp = dma_log->timestamp;
 
-	/* set f_ldc file position to the beginning */
-	rewind(global_config->ldc_fd);
+	return 0;
+}
 
-	ret = 0;
-out:
-	/* free alocated memory */
-	free(entry.params);
-	free(entry.text);
-	free(entry.file_name);
+/* checking if trace address is located in entry section in elf file */
+static bool is_entry_address(uint32_t log_entry_address)
+{
+	uint32_t base_address = global_config->logs_header->base_address;
 
-	return ret;
+	return log_entry_address >= base_address &&
+	       log_entry_address <= base_address +
+	       global_config->logs_header->data_length;
 }
 
 static int serial_read(uint64_t *last_timestamp)
@@ -578,9 +952,7 @@ static int serial_read(uint64_t *last_timestamp)
 	}
 
 	/* Skip all trace_point() values, although this test isn't 100% reliable */
-	while ((dma_log.log_entry_address < global_config->logs_header->base_address) ||
-	       dma_log.log_entry_address > global_config->logs_header->base_address +
-	       global_config->logs_header->data_length) {
+	while (!is_entry_address(dma_log.log_entry_address)) {
 		/*
 		 * 8 characters and a '\n' come from the serial port, append a
 		 * '\0'
@@ -609,13 +981,296 @@ static int serial_read(uint64_t *last_timestamp)
 	return fetch_entry(&dma_log, last_timestamp);
 }
 
+/* params count of a valid ldc entry, checked without logging errors */
+static int entry_params_num(uint32_t log_entry_address)
+{
+	const struct snd_sof_logs_header *logs_header = global_config->logs_header;
+	struct ldc_entry_header header;
+	size_t entry_offset = (size_t)(log_entry_address - logs_header->base_address) +
+			      logs_header->data_offset;
+
+	if (entry_offset + sizeof(header) > ldc_dict.size)
+		return -EINVAL;
+
+	memcpy(&header, ldc_dict.map + entry_offset, sizeof(header));
+	if (header.file_name_len > TRACE_MAX_FILENAME_LEN ||
+	    header.text_len > TRACE_MAX_TEXT_LEN ||
+	    header.params_num > TRACE_MAX_PARAMS_COUNT ||
+	    entry_offset + sizeof(header) + header.file_name_len +
+	    header.text_len > ldc_dict.size)
+		return -EINVAL;
+
+	return header.params_num;
+}
+
+/*
+ * Reads the next record starting before end, skipping a DWORD at a time
+ * over data without a valid entry address like logger_read() does.
+ * Returns 1 for a record, 0 when there are no more records.
+ */
+static int read_record(const struct decode_ctx *ctx, size_t *pos, size_t end,
+		       struct log_record *rec)
+{
+	size_t params_size;
+	int ret;
+
+	while (*pos < end && *pos + sizeof(rec->dma_log) <= ctx->size) {
+		memcpy(&rec->dma_log, ctx->data + *pos, sizeof(rec->dma_log));
+		if (!is_entry_address(rec->dma_log.log_entry_address)) {
+			*pos += sizeof(uint32_t);
+			continue;
+		}
+
+		ret = get_entry(rec->dma_log.log_entry_address, &rec->entry);
+		if (ret < 0)
+			return ret;
+
+		params_size = sizeof(uint32_t) * rec->entry->header.params_num;
+		if (*pos + sizeof(rec->dma_log) + params_size > ctx->size)
+			return 0;
+
+		memcpy(rec->params, ctx->data + *pos + sizeof(rec->dma_log),
+		       params_size);
+		*pos += sizeof(rec->dma_log) + params_size;
+		return 1;
+	}
+
+	return 0;
+}
+
+static bool is_record_chain(const struct decode_ctx *ctx, size_t pos)
+{
+	struct log_entry_header dma_log;
+	int params_num;
+	int i;
+
+	for (i = 0; i < DECODE_RESYNC_RECORDS; i++) {
+		if (pos + sizeof(dma_log) > ctx->size)
+			return i > 0;
+
+		memcpy(&dma_log, ctx->data + pos, sizeof(dma_log));
+		if (!is_entry_address(dma_log.log_entry_address))
+			return false;
+
+		params_num = entry_params_num(dma_log.log_entry_address);
+		if (params_num < 0)
+			return false;
+
+		pos += sizeof(dma_log) + sizeof(uint32_t) * params_num;
+	}
+
+	return true;
+}
+
+static void decode_chunk(struct decode_ctx *ctx, int index)
+{
+	struct decode_chunk *c = &ctx->chunks[index];
+	struct log_record rec;
+	size_t pos;
+	FILE *out;
+	int ret;
+
+	/* find a record boundary followed by a run of valid records */
+	if (index) {
+		while (c->begin < c->end && !is_record_chain(ctx, c->begin))
+			c->begin += sizeof(uint32_t);
+	}
+	c->next = c->begin;
+
+	out = open_memstream(&c->buf, &c->buf_size);
+	if (!out) {
+		log_err("can't open memory stream for chunk %d\n", index);
+		c->ret = -errno;
+		return;
+	}
+
+	for (pos = c->begin; (ret = read_record(ctx, &pos, c->end, &rec)) > 0;) {
+		/* delta of the first record needs the previous chunk */
+		if (index == 0 || c->records)
+			print_entry(out, &rec.dma_log, rec.entry, rec.params,
+				    c->last_timestamp);
+		c->last_timestamp = rec.dma_log.timestamp;
+		c->records++;
+	}
+
+	c->ret = ret;
+	c->next = pos;
+	fclose(out);
+}
+
+static void *decode_thread(void *arg)
+{
+	struct decode_ctx *ctx = arg;
+	int index;
+
+	pthread_mutex_lock(&ctx->lock);
+	for (;;) {
+		/* don't run too far ahead of the output */
+		while (ctx->next_chunk < ctx->num_chunks &&
+		       ctx->next_chunk >= ctx->merged + ctx->window)
+			pthread_cond_wait(&ctx->cond, &ctx->lock);
+
+		if (ctx->next_chunk >= ctx->num_chunks)
+			break;
+
+		index = ctx->next_chunk++;
+		pthread_mutex_unlock(&ctx->lock);
+
+		decode_chunk(ctx, index);
+
+		pthread_mutex_lock(&ctx->lock);
+		ctx->chunks[index].done = true;
+		pthread_cond_broadcast(&ctx->cond);
+	}
+	pthread_mutex_unlock(&ctx->lock);
+
+	return NULL;
+}
+
+/*
+ * Writes the decoded chunk to output. A chunk is used only when its thread
+ * synchronized on the same record the previous chunk ended at, otherwise it
+ * is decoded again here from there, so output matches sequential decoding.
+ */
+static int merge_chunk(struct decode_ctx *ctx, int index, size_t *next,
+		       uint64_t *last_timestamp)
+{
+	struct decode_chunk *c = &ctx->chunks[index];
+	FILE *out_fd = global_config->out_fd;
+	struct log_record rec;
+	size_t pos = *next;
+	int ret;
+
+	if (c->begin != *next) {
+		while ((ret = read_record(ctx, &pos, c->end, &rec)) > 0) {
+			print_entry(out_fd, &rec.dma_log, rec.entry, rec.params,
+				    *last_timestamp);
+			*last_timestamp = rec.dma_log.timestamp;
+		}
+		*next = pos;
+		return ret;
+	}
+
+	if (c->records) {
+		if (index) {
+			read_record(ctx, &pos, c->end, &rec);
+			print_entry(out_fd, &rec.dma_log, rec.entry, rec.params,
+				    *last_timestamp);
+		}
+		fwrite(c->buf, 1, c->buf_size, out_fd);
+		fflush(out_fd);
+		*last_timestamp = c->last_timestamp;
+	}
+	*next = c->next;
+
+	return c->ret;
+}
+
+/*
+ * Decodes an offline dump with multiple threads, each one over its own
+ * chunk of the input. Chunks are written to output in order as they
+ * complete, at most window chunks are kept in memory.
+ */
+static int logger_read_parallel(size_t size)
+{
+	struct decode_ctx ctx;
+	pthread_t *threads;
+	uint64_t last_timestamp = 0;
+	size_t chunk_size;
+	size_t next = 0;
+	void *map;
+	int threads_num;
+	int ret = 0;
+	int i;
+
+	map = mmap(NULL, size, PROT_READ, MAP_PRIVATE,
+		   fileno(global_config->in_fd), 0);
+	if (map == MAP_FAILED) {
+		log_err("can't map %s: %s\n", global_config->in_file,
+			strerror(errno));
+		return -errno;
+	}
+
+	/* a few chunks per thread to balance the load */
+	chunk_size = size / (global_config->jobs * 4);
+	chunk_size = MIN(MAX(chunk_size, DECODE_CHUNK_MIN), DECODE_CHUNK_MAX);
+	chunk_size &= ~(sizeof(uint32_t) - 1);
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.data = map;
+	ctx.size = size;
+	ctx.num_chunks = CEIL(size, chunk_size);
+	ctx.window = 2 * global_config->jobs;
+	ctx.chunks = calloc(ctx.num_chunks, sizeof(*ctx.chunks));
+	threads_num = MIN(global_config->jobs, ctx.num_chunks);
+	threads = calloc(threads_num, sizeof(*threads));
+	if (!ctx.chunks || !threads) {
+		log_err("can't allocate decoding of %d chunks\n", ctx.num_chunks);
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	for (i = 0; i < ctx.num_chunks; i++) {
+		ctx.chunks[i].begin = i * chunk_size;
+		ctx.chunks[i].end = MIN((i + 1) * chunk_size, size);
+	}
+
+	pthread_mutex_init(&ctx.lock, NULL);
+	pthread_cond_init(&ctx.cond, NULL);
+
+	for (i = 0; i < threads_num; i++) {
+		ret = -pthread_create(&threads[i], NULL, decode_thread, &ctx);
+		if (ret < 0) {
+			log_err("can't create decoding thread, %d\n", ret);
+			threads_num = i;
+			ctx.next_chunk = ctx.num_chunks;
+			break;
+		}
+	}
+
+	for (i = 0; !ret && i < ctx.num_chunks; i++) {
+		pthread_mutex_lock(&ctx.lock);
+		while (!ctx.chunks[i].done)
+			pthread_cond_wait(&ctx.cond, &ctx.lock);
+		pthread_mutex_unlock(&ctx.lock);
+
+		ret = merge_chunk(&ctx, i, &next, &last_timestamp);
+		free(ctx.chunks[i].buf);
+		ctx.chunks[i].buf = NULL;
+
+		pthread_mutex_lock(&ctx.lock);
+		ctx.merged++;
+		if (ret)
+			ctx.next_chunk = ctx.num_chunks;
+		pthread_cond_broadcast(&ctx.cond);
+		pthread_mutex_unlock(&ctx.lock);
+	}
+
+	for (i = 0; i < threads_num; i++)
+		pthread_join(threads[i], NULL);
+
+	for (i = 0; i < ctx.num_chunks; i++)
+		free(ctx.chunks[i].buf);
+
+	pthread_cond_destroy(&ctx.cond);
+	pthread_mutex_destroy(&ctx.lock);
+out:
+	free(threads);
+	free(ctx.chunks);
+	munmap(map, size);
+
+	return ret;
+}
+
 static int logger_read(void)
 {
 	struct log_entry_header dma_log;
+	struct stat st;
 	int ret = 0;
 	uint64_t last_timestamp = 0;
 
-	if (!global_config->raw_output)
+	if (!global_config->raw_output ||
+	    global_config->out_format != OUT_FORMAT_TEXT)
 		print_table_header();
 
 	if (global_config->serial_fd >= 0)
@@ -626,6 +1281,13 @@ static int logger_read(void)
 				return ret;
 		}
 
+	/* offline dump can be decoded in parallel */
+	if (global_config->jobs > 1 && !global_config->trace &&
+	    !global_config->input_std &&
+	    !fstat(fileno(global_config->in_fd), &st) &&
+	    S_ISREG(st.st_mode) && st.st_size > 0)
+		return logger_read_parallel(st.st_size);
+
 	while (!ferror(global_config->in_fd)) {
 		/* getting entry parameters from dma dump */
 		ret = fread(&dma_log, sizeof(dma_log), 1, global_config->in_fd);
@@ -649,9 +1311,7 @@ static int logger_read(void)
 		/* checking if received trace address is located in
 		 * entry section in elf file.
 		 */
-		if (dma_log.log_entry_address < global_config->logs_header->base_address ||
-		    dma_log.log_entry_address > global_config->logs_header->base_address +
-		    global_config->logs_header->data_length) {
+		if (!is_entry_address(dma_log.log_entry_address)) {
 			/* in case the address is not correct input fd should be
 			 * move forward by one DWORD, not entire struct dma_log
 			 */
@@ -742,6 +1402,123 @@ static int dump_ldc_info(void)
 	return 0;
 }
 
+/* names of enum mem_zone from firmware sof/lib/alloc.h */
+static const char *heap_zone_name(uint32_t zone)
+{
+	static const char * const names[] = {
+		"sys", "sys_runtime", "runtime", "buffer",
+	};
+
+	return zone < ARRAY_SIZE(names) ? names[zone] : "unknown";
+}
+
+static void dump_mem_usage(const struct sof_ipc_dbg_mem_usage *usage)
+{
+	const struct sof_ipc_dbg_mem_usage_elem *elem;
+	FILE *out_fd = global_config->out_fd;
+	uint32_t i;
+
+	fprintf(out_fd, "%-12s %3s %6s %9s %9s %9s %9s %12s %6s\n",
+		"ZONE", "ID", "CAPS", "SIZE", "USED", "PEAK", "HEADROOM",
+		"LARGEST FREE", "FAILS");
+
+	for (i = 0; i < usage->num_elems; i++) {
+		elem = &usage->elems[i];
+		fprintf(out_fd, "%-12s %3u %#6x %9u %9u %9u %9u %12u %6u\n",
+			heap_zone_name(elem->zone), elem->id, elem->caps,
+			elem->size, elem->used, elem->used_peak,
+			elem->size - elem->used_peak, elem->largest_free,
+			elem->alloc_fails);
+	}
+}
+
+static void dump_mem_owners(const struct sof_ipc_dbg_mem_owners *owners)
+{
+	const struct sof_ipc_dbg_mem_owner_elem *elem;
+	FILE *out_fd = global_config->out_fd;
+	const char *name;
+	uint32_t i;
+
+	fprintf(out_fd, "%9s %9s %6s  %s\n", "USED", "PEAK", "FAILS", "OWNER");
+
+	for (i = 0; i < owners->num_elems; i++) {
+		elem = &owners->elems[i];
+		name = elem->uuid_key ?
+		       format_uid(elem->uuid_key, 0, false, false) : NULL;
+		fprintf(out_fd, "%9u %9u %6u  %s\n", elem->used,
+			elem->used_peak, elem->alloc_fails,
+			name ? name : "unattributed");
+		free((void *)name);
+	}
+}
+
+/*
+ * Decode heap telemetry replies captured from the DSP, the input holds
+ * SOF_IPC_DEBUG_MEM_USAGE and SOF_IPC_DEBUG_MEM_OWNERS replies in any order.
+ */
+static int dump_heap_report(void)
+{
+	const struct sof_ipc_dbg_mem_usage *usage;
+	FILE *in_fd = global_config->in_fd;
+	uint32_t buf[SOF_IPC_MSG_MAX_SIZE / sizeof(uint32_t)];
+	struct sof_ipc_reply *rhdr = (struct sof_ipc_reply *)buf;
+	size_t elem_size;
+	int count = 0;
+
+	/* both replies share the header layout, only elements differ */
+	usage = (const struct sof_ipc_dbg_mem_usage *)buf;
+
+	while (fread(rhdr, sizeof(*rhdr), 1, in_fd) == 1) {
+		if (rhdr->hdr.size < sizeof(*usage) ||
+		    rhdr->hdr.size > sizeof(buf) ||
+		    (rhdr->hdr.cmd & SOF_GLB_TYPE_MASK) != SOF_IPC_GLB_DEBUG) {
+			log_err("invalid heap report header cmd 0x%x size %u\n",
+				rhdr->hdr.cmd, rhdr->hdr.size);
+			return -EINVAL;
+		}
+
+		if (fread(rhdr + 1, rhdr->hdr.size - sizeof(*rhdr), 1,
+			  in_fd) != 1) {
+			log_err("truncated heap report\n");
+			return -EINVAL;
+		}
+
+		switch (rhdr->hdr.cmd & SOF_CMD_TYPE_MASK) {
+		case SOF_IPC_DEBUG_MEM_USAGE:
+			elem_size = sizeof(struct sof_ipc_dbg_mem_usage_elem);
+			break;
+		case SOF_IPC_DEBUG_MEM_OWNERS:
+			elem_size = sizeof(struct sof_ipc_dbg_mem_owner_elem);
+			break;
+		default:
+			log_err("unknown heap report cmd 0x%x\n", rhdr->hdr.cmd);
+			return -EINVAL;
+		}
+
+		if (sizeof(*usage) + usage->num_elems * elem_size !=
+		    rhdr->hdr.size) {
+			log_err("heap report num_elems %u inconsistent with size %u\n",
+				usage->num_elems, rhdr->hdr.size);
+			return -EINVAL;
+		}
+
+		if (elem_size == sizeof(struct sof_ipc_dbg_mem_usage_elem))
+			dump_mem_usage(usage);
+		else
+			dump_mem_owners((const struct sof_ipc_dbg_mem_owners *)buf);
+
+		fprintf(global_config->out_fd, "\n");
+		count++;
+	}
+
+	if (!count) {
+		log_err("no heap report found in %s\n", global_config->in_file);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
 int convert(struct convert_config *config)
 {
 	struct snd_sof_logs_header snd;
@@ -810,6 +1587,9 @@ int convert(struct convert_config *config)
 	if (config->dump_ldc)
 		return dump_ldc_info();
 
+	if (config->heap_report)
+		return dump_heap_report();
+
 	if (config->filter_config) {
 		ret = filter_update_firmware();
 		if (ret) {
@@ -818,5 +1598,12 @@ int convert(struct convert_config *config)
 		}
 	}
 
-	return logger_read();
+	ret = ldc_dict_map();
+	if (ret)
+		return ret;
+
+	ret = logger_read();
+	ldc_dict_free();
+
+	return ret;
 }
@@ -21,6 +21,11 @@
 #define KYEL	"\x1B[33m"
 #define KBLU	"\x1B[34m"
 
+/* output formats */
+#define OUT_FORMAT_TEXT	0	/* human readable table */
+#define OUT_FORMAT_CSV	1	/* comma separated values */
+#define OUT_FORMAT_JSON	2	/* one JSON object per line */
+
 struct convert_config {
 	const char *out_file;
 	const char *in_file;
@@ -39,8 +44,11 @@ struct convert_config {
 	int serial_fd;
 	int raw_output;
 	int dump_ldc;
+	int heap_report;
 	int hide_location;
 	int time_precision;
+	int out_format;
+	int jobs;
 	struct snd_sof_uids_header *uids_dict;
 	struct snd_sof_logs_header *logs_header;
 };
@@ -62,6 +62,12 @@ static void usage(void)
 		APP_NAME);
 	fprintf(stdout, "%s:\t -F path\t\tUpdate trace filtering\n",
 		APP_NAME);
+	fprintf(stdout, "%s:\t -m heap_file\t\tDecode heap usage report\n",
+		APP_NAME);
+	fprintf(stdout, "%s:\t -e csv|json\t\tStructured output, one record "
+		"per line\n", APP_NAME);
+	fprintf(stdout, "%s:\t -j jobs\t\tThreads decoding an input file, "
+		"default is number of CPUs\n", APP_NAME);
 	exit(0);
 }
 
@@ -161,7 +167,7 @@ static int append_filter_config(struct convert_config *config, const char *input
 
 int main(int argc, char *argv[])
 {
-	static const char optstring[] = "ho:i:l:ps:c:u:tv:rd:Lf:gFn";
+	static const char optstring[] = "ho:i:l:ps:c:u:tv:rd:Lf:gFnm:e:j:";
 	struct convert_config config;
 	unsigned int baud = 0;
 	const char *snapshot_file = 0;
@@ -184,9 +190,12 @@ int main(int argc, char *argv[])
 	config.serial_fd = -EINVAL;
 	config.raw_output = 0;
 	config.dump_ldc = 0;
+	config.heap_report = 0;
 	config.hide_location = 0;
 	config.time_precision = 6;
 	config.filter_config = NULL;
+	config.out_format = OUT_FORMAT_TEXT;
+	config.jobs = sysconf(_SC_NPROCESSORS_ONLN);
 
 	while ((opt = getopt(argc, argv, optstring)) != -1) {
 		switch (opt) {
@@ -254,6 +263,28 @@ int main(int argc, char *argv[])
 			if (ret < 0)
 				return ret;
 			break;
+		case 'm':
+			config.heap_report = 1;
+			config.in_file = optarg;
+			break;
+		case 'e':
+			if (!strcmp(optarg, "csv")) {
+				config.out_format = OUT_FORMAT_CSV;
+			} else if (!strcmp(optarg, "json")) {
+				config.out_format = OUT_FORMAT_JSON;
+			} else {
+				fprintf(stderr, "error: Unknown output format %s\n",
+					optarg);
+				usage();
+			}
+			break;
+		case 'j':
+			config.jobs = atoi(optarg);
+			if (config.jobs < 1) {
+				usage();
+				return -EINVAL;
+			}
+			break;
 		case 'h':
 		default: /* '?' */
 			usage();
@@ -323,7 +354,8 @@ int main(int argc, char *argv[])
 			goto out;
 		}
 	}
-	if (isatty(fileno(config.out_fd)) != 1)
+	if (isatty(fileno(config.out_fd)) != 1 ||
+	    config.out_format != OUT_FORMAT_TEXT)
 		config.use_colors = 0;
 
 	ret = -convert(&config);
@@ -44,6 +44,25 @@ void *rbrealloc_align(void *ptr, uint32_t flags, uint32_t caps, size_t bytes,
 	return realloc(ptr, bytes);
 }
 
+void *rpool_alloc(struct mm_pool *pool)
+{
+	return malloc(pool->size);
+}
+
+void *rpool_zalloc(struct mm_pool *pool)
+{
+	return calloc(pool->size, 1);
+}
+
+void rpool_free(struct mm_pool *pool, void *ptr)
+{
+	free(ptr);
+}
+
+void heap_owner_set(const struct sof_uuid_entry *uid)
+{
+}
+
 void heap_trace(struct mm_heap *heap, int size)
 {
 	malloc_info(0, stdout);
@@ -28,11 +28,19 @@
 
 int tb_pipeline_setup(struct sof *sof)
 {
-	/* init components */
-	sys_comp_init(sof);
+	/*
+	 * Components are registered once by the caller into the driver list
+	 * shared by all instances. Pipeline positions are per instance since
+	 * batch jobs run in parallel.
+	 */
+	sof->pipeline_posn = calloc(1, sizeof(*sof->pipeline_posn));
+	if (!sof->pipeline_posn) {
+		fprintf(stderr, "error: pipeline posn alloc\n");
+		return -ENOMEM;
+	}
+	spinlock_init(&sof->pipeline_posn->lock);
 
 	/* other necessary initializations, todo: follow better SOF init */
-	pipeline_posn_init(sof);
 	init_system_notify(sof);
 	scheduler_init_edf();
 	sa_init(sof, CONFIG_SYSTICK_PERIOD);
@@ -40,18 +48,58 @@ int tb_pipeline_setup(struct sof *sof)
 	/* init IPC */
 	if (ipc_init(sof) < 0) {
 		fprintf(stderr, "error: IPC init\n");
-		return -EINVAL;
+		goto err;
 	}
 
 	/* init scheduler */
 	if (scheduler_init_edf() < 0) {
 		fprintf(stderr, "error: edf scheduler init\n");
-		return -EINVAL;
+		goto err;
 	}
 
 	debug_print("ipc and scheduler initialized\n");
 
 	return 0;
+
+err:
+	free(sof->pipeline_posn);
+	sof->pipeline_posn = NULL;
+	return -EINVAL;
+}
+
+/* free the per instance contexts from tb_pipeline_setup() */
+void tb_pipeline_free(struct sof *sof)
+{
+	struct schedulers **schedulers = arch_schedulers_get();
+	struct notify **notify = arch_notify_get();
+	struct schedule_data *sch;
+	struct list_item *slist;
+	struct list_item *temp;
+
+	if (sof->ipc) {
+		ipc_free(sof->ipc);
+		sof->ipc = NULL;
+	}
+
+	rfree(sof->sa);
+	sof->sa = NULL;
+
+	if (*schedulers) {
+		schedule_free();
+		list_for_item_safe(slist, temp, &(*schedulers)->list) {
+			sch = container_of(slist, struct schedule_data, list);
+			list_item_del(slist);
+			free(sch);
+		}
+		free(*schedulers);
+		*schedulers = NULL;
+	}
+
+	rfree(*notify);
+	*notify = NULL;
+
+	free(sof->pipeline_posn);
+	sof->pipeline_posn = NULL;
 }
 
 /* set up pcm params, prepare and trigger pipeline */
@@ -252,7 +300,10 @@ void pipeline_xrun(struct pipeline *p, struct comp_dev *dev, int32_t bytes)
 
 uint64_t platform_timer_get(struct timer *timer)
 {
-	return 0;
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
 }
 
 uint64_t clock_ms_to_ticks(int clock, uint64_t ms)
@@ -8,7 +8,11 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <inttypes.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sof/sof.h>
 #include <sof/list.h>
 #include <sof/audio/stream.h>
@@ -29,285 +33,554 @@ DECLARE_TR_CTX(file_tr, SOF_UUID(file_uuid), LOG_LEVEL_INFO);
 static const struct comp_driver comp_file_dai;
 static const struct comp_driver comp_file_host;
 
-static inline void buffer_check_wrap_32(int32_t **ptr, int32_t *end,
-					size_t size)
+/* wav header chunks and formats */
+#define WAV_RIFF_HEADER_SIZE	12
+#define WAV_CHUNK_HEADER_SIZE	8
+#define WAV_FMT_SIZE		16
+#define WAV_FMT_EXT_SIZE	40
+#define WAV_FORMAT_PCM		0x0001
+#define WAV_FORMAT_EXTENSIBLE	0xfffe
+
+/* written wav files always use the extensible format header */
+#define WAV_HEADER_SIZE		(WAV_RIFF_HEADER_SIZE + \
+				 WAV_CHUNK_HEADER_SIZE + WAV_FMT_EXT_SIZE + \
+				 WAV_CHUNK_HEADER_SIZE)
+
+/* mapped output files grow at least this much at a time */
+#define FILE_MAP_GROW_MIN	(1 << 20)
+
+static uint16_t wav_get_le16(const uint8_t *p)
+{
+	return p[0] | p[1] << 8;
+}
+
+static uint32_t wav_get_le32(const uint8_t *p)
 {
-	if (*ptr >= end)
-		*ptr = (int32_t *)((size_t)*ptr - size);
+	return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24;
 }
 
-static inline void buffer_check_wrap_16(int16_t **ptr, int16_t *end,
-					size_t size)
+static void wav_put_le16(uint8_t *p, uint16_t val)
 {
-	if (*ptr >= end)
-		*ptr = (int16_t *)((size_t)*ptr - size);
+	p[0] = val;
+	p[1] = val >> 8;
+}
+
+static void wav_put_le32(uint8_t *p, uint32_t val)
+{
+	wav_put_le16(p, val);
+	wav_put_le16(p + 2, val >> 16);
+}
+
+/* parse the fmt chunk of a wav file */
+static int wav_parse_fmt(const uint8_t *fmt, uint32_t size,
+			 struct file_wav_params *wav)
+{
+	uint16_t format;
+	uint16_t block_align;
+	uint16_t bits;
+	uint16_t valid_bits;
+
+	if (size < WAV_FMT_SIZE)
+		return -EINVAL;
+
+	format = wav_get_le16(fmt);
+	wav->channels = wav_get_le16(fmt + 2);
+	wav->rate = wav_get_le32(fmt + 4);
+	block_align = wav_get_le16(fmt + 12);
+	bits = wav_get_le16(fmt + 14);
+	valid_bits = bits;
+
+	/* extensible format carries valid bits and the PCM subformat GUID */
+	if (format == WAV_FORMAT_EXTENSIBLE) {
+		if (size < WAV_FMT_EXT_SIZE)
+			return -EINVAL;
+		valid_bits = wav_get_le16(fmt + 18);
+		format = wav_get_le16(fmt + 24);
+	}
+
+	if (format != WAV_FORMAT_PCM || !wav->channels || !wav->rate)
+		return -EINVAL;
+
+	wav->sample_bytes = bits / 8;
+	if (block_align != wav->sample_bytes * wav->channels)
+		return -EINVAL;
+
+	wav->msb_aligned = 0;
+	switch (bits) {
+	case 16:
+		wav->frame_fmt = SOF_IPC_FRAME_S16_LE;
+		break;
+	case 24:
+		wav->frame_fmt = SOF_IPC_FRAME_S24_4LE;
+		break;
+	case 32:
+		if (valid_bits == 24) {
+			wav->frame_fmt = SOF_IPC_FRAME_S24_4LE;
+			wav->msb_aligned = 1;
+		} else {
+			wav->frame_fmt = SOF_IPC_FRAME_S32_LE;
+		}
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+/* find PCM format and data of a mapped wav file */
+static int wav_parse(const uint8_t *addr, size_t size,
+		     struct file_wav_params *wav)
+{
+	size_t pos = WAV_RIFF_HEADER_SIZE;
+	uint32_t chunk_size;
+	int fmt_found = 0;
+
+	if (size < WAV_RIFF_HEADER_SIZE || memcmp(addr, "RIFF", 4) ||
+	    memcmp(addr + 8, "WAVE", 4))
+		return -EINVAL;
+
+	while (pos + WAV_CHUNK_HEADER_SIZE <= size) {
+		chunk_size = wav_get_le32(addr + pos + 4);
+		pos += WAV_CHUNK_HEADER_SIZE;
+
+		if (!memcmp(addr + pos - WAV_CHUNK_HEADER_SIZE, "fmt ", 4)) {
+			if (pos + chunk_size > size ||
+			    wav_parse_fmt(addr + pos, chunk_size, wav) < 0)
+				return -EINVAL;
+			fmt_found = 1;
+		} else if (!memcmp(addr + pos - WAV_CHUNK_HEADER_SIZE,
+				   "data", 4)) {
+			if (!fmt_found)
+				return -EINVAL;
+
+			/* size of a streamed wav may be left unset */
+			wav->data_offset = pos;
+			wav->data_size = MIN(chunk_size, size - pos);
+			return 0;
+		}
+
+		/* chunks are word aligned */
+		pos += chunk_size + (chunk_size & 1);
+	}
+
+	return -EINVAL;
+}
+
+/* write header of a wav file, always in the extensible format */
+static void wav_write_header(uint8_t *hdr, const struct file_wav_params *wav)
+{
+	uint32_t bits = wav->sample_bytes * 8;
+	uint32_t valid_bits = wav->frame_fmt == SOF_IPC_FRAME_S24_4LE ?
+		24 : bits;
+
+	memcpy(hdr, "RIFF", 4);
+	wav_put_le32(hdr + 4, WAV_HEADER_SIZE - 8 + wav->data_size);
+	memcpy(hdr + 8, "WAVE", 4);
+	memcpy(hdr + 12, "fmt ", 4);
+	wav_put_le32(hdr + 16, WAV_FMT_EXT_SIZE);
+	wav_put_le16(hdr + 20, WAV_FORMAT_EXTENSIBLE);
+	wav_put_le16(hdr + 22, wav->channels);
+	wav_put_le32(hdr + 24, wav->rate);
+	wav_put_le32(hdr + 28, wav->rate * wav->channels * wav->sample_bytes);
+	wav_put_le16(hdr + 32, wav->channels * wav->sample_bytes);
+	wav_put_le16(hdr + 34, bits);
+	wav_put_le16(hdr + 36, 22);	/* extension size */
+	wav_put_le16(hdr + 38, valid_bits);
+	wav_put_le32(hdr + 40, 0);	/* no channel mask */
+
+	/* KSDATAFORMAT_SUBTYPE_PCM */
+	memcpy(hdr + 44, "\x01\x00\x00\x00\x00\x00\x10\x00"
+	       "\x80\x00\x00\xaa\x00\x38\x9b\x71", 16);
+	memcpy(hdr + 60, "data", 4);
+	wav_put_le32(hdr + 64, wav->data_size);
+}
+
+/* map the whole input file, PCM data of wav files starts after the header */
+static int file_map_read_open(struct file_state *fs)
+{
+	struct file_map *map = &fs->map;
+	struct stat st;
+
+	map->fd = open(fs->fn, O_RDONLY);
+	if (map->fd < 0)
+		return -errno;
+
+	if (fstat(map->fd, &st) < 0 || !st.st_size) {
+		close(map->fd);
+		return -EINVAL;
+	}
+
+	map->size = st.st_size;
+	map->addr = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, map->fd, 0);
+	if (map->addr == MAP_FAILED) {
+		close(map->fd);
+		return -errno;
+	}
+
+	/* input is consumed once from start to end */
+	madvise(map->addr, map->size, MADV_SEQUENTIAL);
+
+	map->pos = 0;
+	map->end = map->size;
+
+	if (fs->f_format == FILE_WAV) {
+		if (wav_parse(map->addr, map->size, &fs->wav) < 0) {
+			munmap(map->addr, map->size);
+			close(map->fd);
+			return -EINVAL;
+		}
+
+		map->pos = fs->wav.data_offset;
+		map->end = fs->wav.data_offset + fs->wav.data_size;
+	}
+
+	return 0;
+}
+
+/* output file is mapped in growing steps, space for wav header is skipped */
+static int file_map_write_open(struct file_state *fs)
+{
+	struct file_map *map = &fs->map;
+
+	map->fd = open(fs->fn, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (map->fd < 0)
+		return -errno;
+
+	map->addr = NULL;
+	map->size = 0;
+	map->pos = fs->f_format == FILE_WAV ? WAV_HEADER_SIZE : 0;
+	map->end = map->pos;
+
+	return 0;
+}
+
+/* make room for bytes at the write offset of the output file */
+static int file_map_reserve(struct file_map *map, size_t bytes)
+{
+	size_t size;
+
+	if (map->pos + bytes <= map->size)
+		return 0;
+
+	size = MAX(map->size * 2, map->pos + bytes);
+	size = MAX(size, FILE_MAP_GROW_MIN);
+
+	if (map->addr)
+		munmap(map->addr, map->size);
+
+	if (ftruncate(map->fd, size) < 0) {
+		map->addr = NULL;
+		map->size = 0;
+		return -errno;
+	}
+
+	map->addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+			 map->fd, 0);
+	if (map->addr == MAP_FAILED) {
+		map->addr = NULL;
+		map->size = 0;
+		return -errno;
+	}
+
+	map->size = size;
+	return 0;
+}
+
+static void file_map_close(struct file_state *fs)
+{
+	struct file_map *map = &fs->map;
+
+	if (fs->mode == FILE_WRITE) {
+		if (fs->f_format == FILE_WAV) {
+			fs->wav.data_size = map->pos - WAV_HEADER_SIZE;
+			if (!file_map_reserve(map, 0))
+				wav_write_header(map->addr, &fs->wav);
+		}
+
+		if (map->addr)
+			munmap(map->addr, map->size);
+
+		/* drop unused space left from the last grow step */
+		if (ftruncate(map->fd, map->pos) < 0)
+			fprintf(stderr, "error: truncating file %s\n", fs->fn);
+	} else {
+		munmap(map->addr, map->size);
+	}
+
+	close(map->fd);
+}
+
+/**
+ * \brief Reads PCM parameters from header of a wav file.
+ * \param[in] fn File name.
+ * \param[out] wav PCM parameters and position of PCM data in file.
+ * \return Error code.
+ */
+int file_wav_get_params(const char *fn, struct file_wav_params *wav)
+{
+	struct file_state fs = {
+		.fn = (char *)fn,
+		.mode = FILE_READ,
+		.f_format = FILE_WAV,
+	};
+	int ret;
+
+	ret = file_map_read_open(&fs);
+	if (ret < 0)
+		return ret;
+
+	*wav = fs.wav;
+	file_map_close(&fs);
+
+	return 0;
+}
+
+/*
+ * Read samples from a mapped raw or wav file
+ * the file is copied to sink with one memcpy per contiguous buffer block,
+ * only 24 bit samples need conversion
+ */
+static int read_samples_map(struct comp_dev *dev,
+			    const struct audio_stream *sink,
+			    int n, int fmt, int nch)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	struct file_map *map = &cd->fs.map;
+	struct audio_stream_iter out;
+	uint32_t sample_bytes = audio_stream_sample_bytes(sink);
+	uint32_t file_sample_bytes = sample_bytes;
+	const uint8_t *src;
+	int32_t *dest;
+	size_t avail;
+	int samples;
+	int i;
+
+	if (cd->fs.f_format == FILE_WAV)
+		file_sample_bytes = cd->fs.wav.sample_bytes;
+
+	/* whole frames left in file */
+	avail = (map->end - map->pos) / (file_sample_bytes * nch) * nch;
+	if (avail <= n) {
+		n = avail;
+		cd->fs.reached_eof = 1;
+	}
+
+	audio_stream_iter_init(&out, sink, sink->w_ptr, n / nch);
+
+	while (out.frames) {
+		samples = audio_stream_iter_frames(&out) * nch;
+		src = map->addr + map->pos;
+		dest = out.ptr;
+
+		if (file_sample_bytes == 3) {
+			/* packed 24 bit wav samples */
+			for (i = 0; i < samples; i++, src += 3)
+				dest[i] = src[0] | src[1] << 8 | src[2] << 16;
+		} else {
+			memcpy(dest, src, samples * sample_bytes);
+
+			/* 24 bit samples are kept in the low bits */
+			if (fmt == SOF_IPC_FRAME_S24_4LE) {
+				if (cd->fs.wav.msb_aligned)
+					for (i = 0; i < samples; i++)
+						dest[i] = (uint32_t)dest[i] >> 8;
+				else
+					for (i = 0; i < samples; i++)
+						dest[i] &= 0x00ffffff;
+			}
+		}
+
+		map->pos += samples * file_sample_bytes;
+		audio_stream_iter_next(&out, samples / nch);
+	}
+
+	return n;
 }
 
 /*
- * Read 32-bit samples from file
- * currently only supports txt files
+ * Write samples to a mapped raw or wav file
+ * sink data is copied with one memcpy per contiguous buffer block,
+ * 24 bit samples are sign extended for raw and MSB aligned for wav files
  */
+static int write_samples_map(struct comp_dev *dev,
+			     const struct audio_stream *source,
+			     int n, int fmt, int nch)
+{
+	struct file_comp_data *cd = comp_get_drvdata(dev);
+	struct file_map *map = &cd->fs.map;
+	struct audio_stream_iter in;
+	uint32_t sample_bytes = audio_stream_sample_bytes(source);
+	int32_t *dest;
+	int samples;
+	int i;
+
+	if (file_map_reserve(map, n * sample_bytes) < 0) {
+		fprintf(stderr, "error: writing file %s\n", cd->fs.fn);
+		return 0;
+	}
+
+	audio_stream_iter_init(&in, source, source->r_ptr, n / nch);
+
+	while (in.frames) {
+		samples = audio_stream_iter_frames(&in) * nch;
+		dest = (int32_t *)(map->addr + map->pos);
+		memcpy(dest, in.ptr, samples * sample_bytes);
+
+		if (fmt == SOF_IPC_FRAME_S24_4LE) {
+			if (cd->fs.f_format == FILE_WAV)
+				for (i = 0; i < samples; i++)
+					dest[i] = (uint32_t)dest[i] << 8;
+			else
+				for (i = 0; i < samples; i++)
+					dest[i] = (int32_t)((uint32_t)dest[i]
+							    << 8) >> 8;
+		}
+
+		map->pos += samples * sample_bytes;
+		audio_stream_iter_next(&in, samples / nch);
+	}
+
+	return n;
+}
+
+/* Read 32-bit samples from text file */
 static int read_samples_32(struct comp_dev *dev,
 			   const struct audio_stream *sink,
 			   int n, int fmt, int nch)
 {
 	struct file_comp_data *cd = comp_get_drvdata(dev);
-	int32_t *dest = (int32_t *)sink->w_ptr;
+	struct audio_stream_iter out;
+	int32_t *dest;
 	int32_t sample;
-	int n_wrap;
-	int n_min;
+	int samples;
 	int i;
 	int n_samples = 0;
 	int ret = 0;
 
-	while (n > 0) {
-		n_wrap = (int32_t *)sink->end_addr - dest;
-
-		/* check for buffer wrap and copy to the end of the buffer */
-		n_min = (n < n_wrap) ? n : n_wrap;
-		while (n_min > 0) {
-			n -= nch;
-			n_min -= nch;
-
-			/* copy sample per channel */
-			for (i = 0; i < nch; i++) {
-				/* read sample from file */
-				switch (cd->fs.f_format) {
-				/* text input file */
-				case FILE_TEXT:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fscanf(cd->fs.rfh, "%d",
-							     dest);
-
-					/* mask bits if 24-bit samples */
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						ret = fscanf(cd->fs.rfh, "%d",
-							     &sample);
-						*dest = sample & 0x00ffffff;
-					}
-					/* quit if eof is reached */
-					if (ret == EOF) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-
-				/* raw input file */
-				default:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fread(dest,
-							    sizeof(int32_t),
-							    1, cd->fs.rfh);
-
-					/* mask bits if 24-bit samples */
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						ret = fread(&sample,
-							    sizeof(int32_t),
-							    1, cd->fs.rfh);
-						*dest = sample & 0x00ffffff;
-					}
-					/* quit if eof is reached */
-					if (ret != 1) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-				}
-				dest++;
-				n_samples++;
+	audio_stream_iter_init(&out, sink, sink->w_ptr, n / nch);
+
+	while (out.frames) {
+		samples = audio_stream_iter_frames(&out) * nch;
+		dest = out.ptr;
+
+		for (i = 0; i < samples; i++) {
+			ret = fscanf(cd->fs.rfh, "%d", &sample);
+
+			/* quit if eof is reached */
+			if (ret == EOF) {
+				cd->fs.reached_eof = 1;
+				goto quit;
 			}
+
+			/* mask bits if 24-bit samples */
+			if (fmt == SOF_IPC_FRAME_S24_4LE)
+				sample &= 0x00ffffff;
+
+			dest[i] = sample;
+			n_samples++;
 		}
-		/* check for buffer wrap and update pointer */
-		buffer_check_wrap_32(&dest, sink->end_addr,
-				     sink->size);
+
+		audio_stream_iter_next(&out, samples / nch);
 	}
 quit:
 	return n_samples;
 }
 
-/*
- * Read 16-bit samples from file
- * currently only supports txt files
- */
+/* Read 16-bit samples from text file */
 static int read_samples_16(struct comp_dev *dev,
 			   const struct audio_stream *sink,
 			   int n, int nch)
 {
 	struct file_comp_data *cd = comp_get_drvdata(dev);
-	int16_t *dest = (int16_t *)sink->w_ptr;
-	int i, n_wrap, n_min, ret;
+	struct audio_stream_iter out;
+	int16_t *dest;
+	int samples;
+	int i, ret;
 	int n_samples = 0;
 
-	/* copy samples */
-	while (n > 0) {
-		n_wrap = (int16_t *)sink->end_addr - dest;
-
-		/* check for buffer wrap and copy to the end of the buffer */
-		n_min = (n < n_wrap) ? n : n_wrap;
-		while (n_min > 0) {
-			n -= nch;
-			n_min -= nch;
-
-			/* copy sample per channel */
-			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text input file */
-				case FILE_TEXT:
-					ret = fscanf(cd->fs.rfh, "%hd", dest);
-					if (ret == EOF) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-
-				/* rw pcm input file */
-				default:
-					ret = fread(dest, sizeof(int16_t), 1,
-						    cd->fs.rfh);
-					if (ret != 1) {
-						cd->fs.reached_eof = 1;
-						goto quit;
-					}
-					break;
-				}
-
-				dest++;
-				n_samples++;
+	audio_stream_iter_init(&out, sink, sink->w_ptr, n / nch);
+
+	while (out.frames) {
+		samples = audio_stream_iter_frames(&out) * nch;
+		dest = out.ptr;
+
+		for (i = 0; i < samples; i++) {
+			ret = fscanf(cd->fs.rfh, "%hd", &dest[i]);
+			if (ret == EOF) {
+				cd->fs.reached_eof = 1;
+				goto quit;
 			}
+			n_samples++;
 		}
-		/* check for buffer wrap and update pointer */
-		buffer_check_wrap_16(&dest, sink->end_addr,
-				     sink->size);
+
+		audio_stream_iter_next(&out, samples / nch);
 	}
 
 quit:
 	return n_samples;
 }
 
-/*
- * Write 16-bit samples from file
- * currently only supports txt files
- */
+/* Write 16-bit samples to text file */
 static int write_samples_16(struct comp_dev *dev, struct audio_stream *source,
 			    int n, int nch)
 {
 	struct file_comp_data *cd = comp_get_drvdata(dev);
-	int16_t *src = (int16_t *)source->r_ptr;
-	int i, n_wrap, n_min, ret;
+	struct audio_stream_iter in;
+	int16_t *src;
+	int samples;
+	int i, ret;
 	int n_samples = 0;
 
-	/* copy samples */
-	while (n > 0) {
-		n_wrap = (int16_t *)source->end_addr - src;
-
-		/* check for buffer wrap and copy to the end of the buffer */
-		n_min = (n < n_wrap) ? n : n_wrap;
-		while (n_min > 0) {
-			n -= nch;
-			n_min -= nch;
-
-			/* copy sample per channel */
-			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text output file */
-				case FILE_TEXT:
-					ret = fprintf(cd->fs.wfh,
-						      "%d\n", *src);
-					if (ret < 0)
-						goto quit;
-					break;
-
-				/* raw pcm output file */
-				default:
-					ret = fwrite(src,
-						     sizeof(int16_t),
-						     1, cd->fs.wfh);
-					if (ret != 1)
-						goto quit;
-					break;
-				}
-
-				src++;
-				n_samples++;
-			}
+	audio_stream_iter_init(&in, source, source->r_ptr, n / nch);
+
+	while (in.frames) {
+		samples = audio_stream_iter_frames(&in) * nch;
+		src = in.ptr;
+
+		for (i = 0; i < samples; i++) {
+			ret = fprintf(cd->fs.wfh, "%d\n", src[i]);
+			if (ret < 0)
+				goto quit;
+			n_samples++;
 		}
-		/* check for buffer wrap and update pointer */
-		buffer_check_wrap_16(&src, source->end_addr,
-				     source->size);
+
+		audio_stream_iter_next(&in, samples / nch);
 	}
 quit:
 	return n_samples;
 }
 
-/*
- * Write 32-bit samples from file
- * currently only supports txt files
- */
+/* Write 32-bit samples to text file, 24-bit samples are sign extended */
 static int write_samples_32(struct comp_dev *dev, struct audio_stream *source,
 			    int n, int fmt, int nch)
 {
 	struct file_comp_data *cd = comp_get_drvdata(dev);
-	int32_t *src = (int32_t *)source->r_ptr;
-	int i, n_wrap, n_min, ret;
-	int n_samples = 0;
+	struct audio_stream_iter in;
+	int32_t *src;
 	int32_t sample;
+	int samples;
+	int i, ret;
+	int n_samples = 0;
 
-	/* copy samples */
-	while (n > 0) {
-		n_wrap = (int32_t *)source->end_addr - src;
-
-		/* check for buffer wrap and copy to the end of the buffer */
-		n_min = (n < n_wrap) ? n : n_wrap;
-		while (n_min > 0) {
-			n -= nch;
-			n_min -= nch;
-
-			/* copy sample per channel */
-			for (i = 0; i < nch; i++) {
-				switch (cd->fs.f_format) {
-				/* text output file */
-				case FILE_TEXT:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fprintf(cd->fs.wfh,
-							      "%d\n", *src);
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						sample = *src << 8;
-						ret = fprintf(cd->fs.wfh,
-							      "%d\n",
-							      sample >> 8);
-					}
-					if (ret < 0)
-						goto quit;
-					break;
-
-				/* raw pcm output file */
-				default:
-					if (fmt == SOF_IPC_FRAME_S32_LE)
-						ret = fwrite(src,
-							     sizeof(int32_t),
-							     1, cd->fs.wfh);
-					if (fmt == SOF_IPC_FRAME_S24_4LE) {
-						sample = *src << 8;
-						sample >>= 8;
-						ret = fwrite(&sample,
-							     sizeof(int32_t),
-							     1, cd->fs.wfh);
-					}
-					if (ret != 1)
-						goto quit;
-					break;
-				}
-
-				/* increment read pointer */
-				src++;
-
-				/* increment number of samples written */
-				n_samples++;
-			}
+	audio_stream_iter_init(&in, source, source->r_ptr, n / nch);
+
+	while (in.frames) {
+		samples = audio_stream_iter_frames(&in) * nch;
+		src = in.ptr;
+
+		for (i = 0; i < samples; i++) {
+			sample = src[i];
+			if (fmt == SOF_IPC_FRAME_S24_4LE)
+				sample = (int32_t)((uint32_t)sample << 8) >> 8;
+
+			ret = fprintf(cd->fs.wfh, "%d\n", sample);
+			if (ret < 0)
+				goto quit;
+			n_samples++;
 		}
-		/* check for buffer wrap and update pointer */
-		buffer_check_wrap_32(&src, source->end_addr,
-				     source->size);
+
+		audio_stream_iter_next(&in, samples / nch);
 	}
 quit:
 	return n_samples;
@@ -325,14 +598,23 @@ static int file_s32_default(struct comp_dev *dev, struct audio_stream *sink,
 	case FILE_READ:
 		/* read samples */
 		nch = sink->channels;
-		n_samples = read_samples_32(dev, sink, frames * nch,
-					    SOF_IPC_FRAME_S32_LE, nch);
+		if (cd->fs.f_format == FILE_TEXT)
+			n_samples = read_samples_32(dev, sink, frames * nch,
+						    SOF_IPC_FRAME_S32_LE, nch);
+		else
+			n_samples = read_samples_map(dev, sink, frames * nch,
+						     SOF_IPC_FRAME_S32_LE, nch);
 		break;
 	case FILE_WRITE:
 		/* write samples */
 		nch = source->channels;
-		n_samples = write_samples_32(dev, source, frames * nch,
-					     SOF_IPC_FRAME_S32_LE, nch);
+		if (cd->fs.f_format == FILE_TEXT)
+			n_samples = write_samples_32(dev, source, frames * nch,
+						     SOF_IPC_FRAME_S32_LE, nch);
+		else
+			n_samples = write_samples_map(dev, source, frames * nch,
+						      SOF_IPC_FRAME_S32_LE,
+						      nch);
 		break;
 	default:
 		/* TODO: duplex mode */
@@ -355,12 +637,23 @@ static int file_s16(struct comp_dev *dev, struct audio_stream *sink,
 	case FILE_READ:
 		/* read samples */
 		nch = sink->channels;
-		n_samples = read_samples_16(dev, sink, frames * nch, nch);
+		if (cd->fs.f_format == FILE_TEXT)
+			n_samples = read_samples_16(dev, sink, frames * nch,
+						    nch);
+		else
+			n_samples = read_samples_map(dev, sink, frames * nch,
+						     SOF_IPC_FRAME_S16_LE, nch);
 		break;
 	case FILE_WRITE:
 		/* write samples */
 		nch = source->channels;
-		n_samples = write_samples_16(dev, source, frames * nch, nch);
+		if (cd->fs.f_format == FILE_TEXT)
+			n_samples = write_samples_16(dev, source, frames * nch,
+						     nch);
+		else
+			n_samples = write_samples_map(dev, source, frames * nch,
+						      SOF_IPC_FRAME_S16_LE,
+						      nch);
 		break;
 	default:
 		/* TODO: duplex mode */
@@ -383,14 +676,25 @@ static int file_s24(struct comp_dev *dev, struct audio_stream *sink,
 	case FILE_READ:
 		/* read samples */
 		nch = sink->channels;
-		n_samples = read_samples_32(dev, sink, frames * nch,
-					    SOF_IPC_FRAME_S24_4LE, nch);
+		if (cd->fs.f_format == FILE_TEXT)
+			n_samples = read_samples_32(dev, sink, frames * nch,
+						    SOF_IPC_FRAME_S24_4LE, nch);
+		else
+			n_samples = read_samples_map(dev, sink, frames * nch,
+						     SOF_IPC_FRAME_S24_4LE,
+						     nch);
 		break;
 	case FILE_WRITE:
 		/* write samples */
 		nch = source->channels;
-		n_samples = write_samples_32(dev, source, frames * nch,
-					     SOF_IPC_FRAME_S24_4LE, nch);
+		if (cd->fs.f_format == FILE_TEXT)
+			n_samples = write_samples_32(dev, source, frames * nch,
+						     SOF_IPC_FRAME_S24_4LE,
+						     nch);
+		else
+			n_samples = write_samples_map(dev, source, frames * nch,
+						      SOF_IPC_FRAME_S24_4LE,
+						      nch);
 		break;
 	default:
 		/* TODO: duplex mode */
@@ -405,9 +709,12 @@ static enum file_format get_file_format(char *filename)
 {
 	char *ext = strrchr(filename, '.');
 
-	if (!strcmp(ext, ".txt"))
+	if (ext && !strcmp(ext, ".txt"))
 		return FILE_TEXT;
 
+	if (ext && !strcmp(ext, ".wav"))
+		return FILE_WAV;
+
 	return FILE_RAW;
 }
 
@@ -419,6 +726,7 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 	struct sof_ipc_comp_file *ipc_file =
 		(struct sof_ipc_comp_file *)comp;
 	struct file_comp_data *cd;
+	int ret = 0;
 
 	debug_print("file_new()\n");
 
@@ -460,24 +768,22 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 	cd->channels = ipc_file->channels;
 	cd->frame_fmt = ipc_file->frame_fmt;
 
-	/* open file handle(s) depending on mode */
+	/* open file handle(s) depending on mode, raw and wav are mapped */
 	switch (cd->fs.mode) {
 	case FILE_READ:
-		cd->fs.rfh = fopen(cd->fs.fn, "r");
-		if (!cd->fs.rfh) {
-			fprintf(stderr, "error: opening file %s\n", cd->fs.fn);
-			free(cd);
-			free(dev);
-			return NULL;
+		if (cd->fs.f_format == FILE_TEXT) {
+			cd->fs.rfh = fopen(cd->fs.fn, "r");
+			ret = cd->fs.rfh ? 0 : -errno;
+		} else {
+			ret = file_map_read_open(&cd->fs);
 		}
 		break;
 	case FILE_WRITE:
-		cd->fs.wfh = fopen(cd->fs.fn, "w");
-		if (!cd->fs.wfh) {
-			fprintf(stderr, "error: opening file %s\n", cd->fs.fn);
-			free(cd);
-			free(dev);
-			return NULL;
+		if (cd->fs.f_format == FILE_TEXT) {
+			cd->fs.wfh = fopen(cd->fs.fn, "w");
+			ret = cd->fs.wfh ? 0 : -errno;
+		} else {
+			ret = file_map_write_open(&cd->fs);
 		}
 		break;
 	default:
@@ -485,6 +791,21 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 		break;
 	}
 
+	if (ret < 0) {
+		fprintf(stderr, "error: opening file %s\n", cd->fs.fn);
+		free(cd->fs.fn);
+		free(cd);
+		free(dev);
+		return NULL;
+	}
+
+	/* PCM parameters of wav input come from the file */
+	if (cd->fs.mode == FILE_READ && cd->fs.f_format == FILE_WAV) {
+		cd->rate = cd->fs.wav.rate;
+		cd->channels = cd->fs.wav.channels;
+		cd->frame_fmt = cd->fs.wav.frame_fmt;
+	}
+
 	cd->fs.reached_eof = 0;
 	cd->fs.n = 0;
 
@@ -499,7 +820,9 @@ static void file_free(struct comp_dev *dev)
 
 	comp_dbg(dev, "file_free()");
 
-	if (cd->fs.mode == FILE_READ)
+	if (cd->fs.f_format != FILE_TEXT)
+		file_map_close(&cd->fs);
+	else if (cd->fs.mode == FILE_READ)
 		fclose(cd->fs.rfh);
 	else
 		fclose(cd->fs.wfh);
@@ -669,6 +992,14 @@ static int file_prepare(struct comp_dev *dev)
 	else
 		cd->sample_container_bytes = 4;
 
+	/* wav output header is written from the stream parameters */
+	if (cd->fs.mode == FILE_WRITE && cd->fs.f_format == FILE_WAV) {
+		cd->fs.wav.rate = stream->rate;
+		cd->fs.wav.channels = stream->channels;
+		cd->fs.wav.frame_fmt = stream->frame_fmt;
+		cd->fs.wav.sample_bytes = cd->sample_container_bytes;
+	}
+
 	/* calculate period size based on config */
 	cd->period_bytes = dev->frames * cd->sample_container_bytes *
 		stream->channels;
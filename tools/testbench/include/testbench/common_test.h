@@ -23,7 +23,7 @@
 #define MAX_OUTPUT_FILE_NUM	4
 
 /* number of widgets types supported in testbench */
-#define NUM_WIDGETS_SUPPORTED	9
+#define NUM_WIDGETS_SUPPORTED	10
 
 struct testbench_prm {
 	char *tplg_file; /* topology file to use */
@@ -66,6 +66,8 @@ void sys_comp_filewrite_init(void);
 
 int tb_pipeline_setup(struct sof *sof);
 
+void tb_pipeline_free(struct sof *sof);
+
 int tb_pipeline_start(struct ipc *ipc, struct sof_ipc_pipe_new *ipc_pipe,
 		      struct testbench_prm *tp);
 
@@ -85,4 +87,6 @@ int get_index_by_uuid(struct sof_ipc_comp_ext *comp_ext,
 
 int parse_topology(struct sof *sof, struct shared_lib_table *library_table,
 		   struct testbench_prm *tp, char *pipeline_msg);
+
+int register_all_comps(struct shared_lib_table *library_table);
 #endif
@@ -21,12 +21,35 @@ enum file_mode {
 enum file_format {
 	FILE_TEXT = 0,
 	FILE_RAW,
+	FILE_WAV,
+};
+
+/* PCM layout of a wav file */
+struct file_wav_params {
+	uint32_t rate;
+	uint32_t channels;
+	enum sof_ipc_frame frame_fmt;
+	uint32_t sample_bytes;	/* sample size in file, 3 for packed 24 bit */
+	int msb_aligned;	/* 24 bit samples in upper bits of 32 bit */
+	size_t data_offset;	/* PCM data position and size in file */
+	size_t data_size;
+};
+
+/* memory mapped raw or wav file */
+struct file_map {
+	int fd;
+	uint8_t *addr;
+	size_t size;	/* mapped size */
+	size_t pos;	/* current read or write offset */
+	size_t end;	/* end of PCM data */
 };
 
 /* file component state */
 struct file_state {
 	char *fn;
-	FILE *rfh, *wfh; /* read/write file handle */
+	FILE *rfh, *wfh; /* read/write file handle of text files */
+	struct file_map map; /* raw and wav files */
+	struct file_wav_params wav;
 	int reached_eof;
 	int n;
 	enum file_mode mode;
@@ -57,4 +80,6 @@ struct sof_ipc_comp_file {
 	enum file_mode mode;
 	enum sof_ipc_frame frame_fmt;
 } __attribute__((packed));
+
+int file_wav_get_params(const char *fn, struct file_wav_params *wav);
 #endif
@@ -11,8 +11,8 @@
 #include <sof/drivers/ipc.h>
 #include <stdlib.h>
 
-/* testbench ipc */
-struct ipc *_ipc;
+/* testbench ipc, one per firmware instance */
+__thread struct ipc *_ipc;
 
 /* private data for IPC */
 struct ipc_data {
@@ -46,6 +46,23 @@ int platform_ipc_init(struct ipc *ipc)
 	return 0;
 }
 
+/* free the ipc_init() context, the job's components are already freed */
+void ipc_free(struct ipc *ipc)
+{
+	struct ipc_data *iipc = ipc_get_drvdata(ipc);
+
+	if (iipc) {
+		free(iipc->dh_buffer.page_table);
+		free(iipc);
+	}
+
+	rfree(ipc->comp_data);
+	rfree(ipc);
+
+	if (_ipc == ipc)
+		_ipc = NULL;
+}
+
 /* The following definition is to satisfy libsof linker errors */
 
 void ipc_msg_send(struct ipc_msg *msg, void *data, bool high_priority)
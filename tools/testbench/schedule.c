@@ -13,7 +13,7 @@
 #include <sof/lib/wait.h>
 #include <stdlib.h>
 
-static struct schedulers *testbench_schedulers_ptr; /* Initialized as NULL */
+static __thread struct schedulers *testbench_schedulers_ptr; /* Initialized as NULL */
 
 struct schedulers **arch_schedulers_get(void)
 {
@@ -9,6 +9,9 @@
 #include <sof/list.h>
 #include <getopt.h>
 #include <dlfcn.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <unistd.h>
 #include "testbench/common_test.h"
 #include <tplg_parser/topology.h>
 #include "testbench/trace.h"
@@ -27,11 +30,17 @@
 DECLARE_SOF_TB_UUID("crossover", crossover_uuid, 0x948c9ad1, 0x806a, 0x4131,
 		    0xad, 0x6c, 0xb2, 0xbd, 0xa9, 0xe3, 0x5a, 0x9f);
 
+DECLARE_SOF_TB_UUID("drc", drc_uuid, 0x2c7bbec9, 0x0d01, 0x4a22,
+		    0xb8, 0xad, 0x3f, 0x2e, 0xa1, 0x6c, 0x52, 0x49);
+
 DECLARE_SOF_TB_UUID("tdfb", tdfb_uuid,  0xdd511749, 0xd9fa, 0x455c,
 		    0xb3, 0xa7, 0x13, 0x58, 0x56, 0x93, 0xf1, 0xaf);
 
 #define TESTBENCH_NCH 2 /* Stereo */
 
+#define MANIFEST_FIELDS_MIN	5
+#define MANIFEST_FIELDS_MAX	7
+
 /* shared library look up table */
 struct shared_lib_table lib_table[NUM_WIDGETS_SUPPORTED] = {
 	{"file", "", SOF_COMP_HOST, NULL, 0, NULL}, /* File must be first */
@@ -42,11 +51,33 @@ struct shared_lib_table lib_table[NUM_WIDGETS_SUPPORTED] = {
 	{"eq-iir", "libsof_eq-iir.so", SOF_COMP_EQ_IIR, NULL, 0, NULL},
 	{"dcblock", "libsof_dcblock.so", SOF_COMP_DCBLOCK, NULL, 0, NULL},
 	{"crossover", "libsof_crossover.so", SOF_COMP_NONE, SOF_TB_UUID(crossover_uuid), 0, NULL},
+	{"drc", "libsof_drc.so", SOF_COMP_NONE, SOF_TB_UUID(drc_uuid), 0, NULL},
 	{"tdfb", "libsof_tdfb.so", SOF_COMP_NONE, SOF_TB_UUID(tdfb_uuid), 0, NULL},
 };
 
-/* main firmware context */
-static struct sof sof;
+/* main firmware context, each job thread has its own instance */
+static __thread struct sof sof;
+
+/* component drivers are registered once and shared by all instances */
+static struct comp_driver_list *comp_drivers;
+
+/* one run of a topology, from command line or a batch manifest line */
+struct tb_job {
+	struct testbench_prm tp;
+	pthread_t thread;
+	FILE *out;		/* job report */
+	char *report;		/* buffered report of a batch job */
+	size_t report_size;
+	bool trace;		/* keep traces on outside of processing */
+	double t_exec;		/* wall time of processing in seconds */
+	double c_realtime;	/* processed audio time per wall time */
+	int ret;
+};
+
+/* batch jobs in flight, bounded by the number of workers */
+static pthread_mutex_t jobs_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobs_done = PTHREAD_COND_INITIALIZER;
+static int jobs_running;
 
 /* compatible variables, not used */
 intptr_t _comp_init_start, _comp_init_end;
@@ -141,10 +172,45 @@ static void print_usage(char *executable)
 	printf("-t <tplg_file> -b <input_format> -c <channels>");
 	printf("-a <comp1=comp1_library,comp2=comp2_library>\n");
 	printf("input_format should be S16_LE, S32_LE, S24_LE or FLOAT_LE\n");
+	printf("rate, channels and format of a .wav input come from the file\n");
 	printf("Example Usage:\n");
 	printf("%s -i in.txt -o out.txt -t test.tplg ", executable);
 	printf("-r 48000 -R 96000 -c 2");
 	printf("-b S16_LE -a vol=libsof_volume.so\n");
+	printf("Batch Usage: %s -m <manifest> [-j <jobs>]\n", executable);
+	printf("Each manifest line is a job, empty lines and lines starting\n");
+	printf("with # are skipped:\n");
+	printf("<tplg_file> <input_file> <output_file1,...> <rate> ");
+	printf("<input_format> [<output_rate> [<channels>]]\n");
+	printf("Jobs run in parallel, by default one per online CPU.\n");
+}
+
+static void init_prm(struct testbench_prm *tp)
+{
+	int i;
+
+	/* initialize input and output sample rates, files, etc. */
+	tp->fs_in = 0;
+	tp->fs_out = 0;
+	tp->bits_in = 0;
+	tp->input_file = NULL;
+	tp->tplg_file = NULL;
+	for (i = 0; i < MAX_OUTPUT_FILE_NUM; i++)
+		tp->output_file[i] = NULL;
+	tp->output_file_num = 0;
+	tp->channels = TESTBENCH_NCH;
+	tp->max_pipeline_id = 0;
+}
+
+static void free_prm(struct testbench_prm *tp)
+{
+	int i;
+
+	free(tp->bits_in);
+	free(tp->input_file);
+	free(tp->tplg_file);
+	for (i = 0; i < tp->output_file_num; i++)
+		free(tp->output_file[i]);
 }
 
 /* free components */
@@ -159,92 +225,104 @@ static void free_comps(void)
 		switch (icd->type) {
 		case COMP_TYPE_COMPONENT:
 			comp_free(icd->cd);
-			list_item_del(&icd->list);
+			ipc_comp_dev_del(icd);
 			rfree(icd);
 			break;
 		case COMP_TYPE_BUFFER:
 			rfree(icd->cb->stream.addr);
 			rfree(icd->cb);
-			list_item_del(&icd->list);
+			ipc_comp_dev_del(icd);
 			rfree(icd);
 			break;
 		default:
 			rfree(icd->pipeline);
-			list_item_del(&icd->list);
+			ipc_comp_dev_del(icd);
 			rfree(icd);
 			break;
 		}
 	}
 }
 
-static void parse_input_args(int argc, char **argv, struct testbench_prm *tp)
+#if CONFIG_PERFORMANCE_COUNTERS
+/* print copy load of each component, host arch timer ticks are ns */
+static void print_comp_perf(FILE *out)
 {
-	int option = 0;
-	int ret = 0;
+	struct sof_ipc_comp_perf perf;
+	struct list_item *clist;
+	struct ipc_comp_dev *icd;
 
-	while ((option = getopt(argc, argv, "hdi:o:t:b:a:r:R:c:")) != -1) {
-		switch (option) {
-		/* input sample file */
-		case 'i':
-			tp->input_file = strdup(optarg);
-			break;
+	fprintf(out, "Component copy load (ns):\n");
+	fprintf(out, "%6s %6s %6s %8s %10s %10s %10s %12s\n", "comp", "pipe",
+		"type", "copies", "last", "avg", "peak", "frames");
 
-		/* output sample files */
-		case 'o':
-			ret = parse_output_files(optarg, tp);
-			break;
+	list_for_item(clist, &sof.ipc->comp_list) {
+		icd = container_of(clist, struct ipc_comp_dev, list);
+		if (icd->type != COMP_TYPE_COMPONENT)
+			continue;
+
+		comp_perf_get(icd->cd, &perf);
+		fprintf(out, "%6u %6u %6u %8u %10u %10u %10u %12" PRIu64 "\n",
+			icd->id, icd->cd->comp.pipeline_id, icd->cd->comp.type,
+			perf.copies, perf.cycles_last, perf.cycles_avg,
+			perf.cycles_peak, perf.frames_total);
+	}
+}
+#endif
 
-		/* topology file */
-		case 't':
-			tp->tplg_file = strdup(optarg);
-			break;
+static bool is_wav_file(const char *fn)
+{
+	const char *ext = fn ? strrchr(fn, '.') : NULL;
 
-		/* input samples bit format */
-		case 'b':
-			tp->bits_in = strdup(optarg);
-			tp->frame_fmt = find_format(tp->bits_in);
-			break;
+	return ext && !strcmp(ext, ".wav");
+}
 
-		/* override default libraries */
-		case 'a':
-			ret = parse_libraries(optarg);
-			break;
+/* rate, channels and format of a wav input come from the file header */
+static int set_wav_input_params(struct testbench_prm *tp)
+{
+	struct file_wav_params wav;
+	const char *bits;
+	int ret;
 
-		/* input sample rate */
-		case 'r':
-			tp->fs_in = atoi(optarg);
-			break;
+	ret = file_wav_get_params(tp->input_file, &wav);
+	if (ret < 0) {
+		fprintf(stderr, "error: invalid wav file %s\n",
+			tp->input_file);
+		return ret;
+	}
 
-		/* output sample rate */
-		case 'R':
-			tp->fs_out = atoi(optarg);
-			break;
+	switch (wav.frame_fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		bits = "S16_LE";
+		break;
+	case SOF_IPC_FRAME_S24_4LE:
+		bits = "S24_LE";
+		break;
+	default:
+		bits = "S32_LE";
+		break;
+	}
 
-		/* input/output channels */
-		case 'c':
-			tp->channels = atoi(optarg);
-			break;
+	free(tp->bits_in);
+	tp->bits_in = strdup(bits);
+	tp->frame_fmt = wav.frame_fmt;
+	tp->fs_in = wav.rate;
+	tp->channels = wav.channels;
 
-		/* enable debug prints */
-		case 'd':
-			debug = 1;
-			break;
+	return 0;
+}
 
-		/* print usage */
-		case 'h':
-		default:
-			print_usage(argv[0]);
-			exit(EXIT_FAILURE);
-		}
+static double wall_time(void)
+{
+	struct timespec ts;
 
-		if (ret < 0)
-			exit(EXIT_FAILURE);
-	}
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
 }
 
-int main(int argc, char **argv)
+/* set up the job's firmware instance, run the pipeline until EOF */
+static int run_job(struct tb_job *job)
 {
-	struct testbench_prm tp;
+	struct testbench_prm *tp = &job->tp;
 	struct ipc_comp_dev *pcm_dev;
 	struct pipeline *p;
 	struct pipeline *curr_p;
@@ -252,82 +330,70 @@ int main(int argc, char **argv)
 	struct comp_dev *cd;
 	struct file_comp_data *frcd, *fwcd;
 	char pipeline[DEBUG_MSG_LEN];
-	clock_t tic, toc;
-	double c_realtime, t_exec;
+	double tic, toc;
 	int n_in, n_out, ret;
 	int i;
 
-	/* initialize input and output sample rates, files, etc. */
-	tp.fs_in = 0;
-	tp.fs_out = 0;
-	tp.bits_in = 0;
-	tp.input_file = NULL;
-	tp.tplg_file = NULL;
-	for (i = 0; i < MAX_OUTPUT_FILE_NUM; i++)
-		tp.output_file[i] = NULL;
-	tp.output_file_num = 0;
-	tp.channels = TESTBENCH_NCH;
-	tp.max_pipeline_id = 0;
+	sof.comp_drivers = comp_drivers;
 
-	/* command line arguments*/
-	parse_input_args(argc, argv, &tp);
-
-	/* check args */
-	if (!tp.tplg_file || !tp.input_file || !tp.output_file_num ||
-	    !tp.bits_in) {
-		print_usage(argv[0]);
-		exit(EXIT_FAILURE);
-	}
+	if (is_wav_file(tp->input_file) && set_wav_input_params(tp) < 0)
+		return -EINVAL;
 
 	/* initialize ipc and scheduler */
 	if (tb_pipeline_setup(&sof) < 0) {
 		fprintf(stderr, "error: pipeline init\n");
-		exit(EXIT_FAILURE);
+		tb_pipeline_free(&sof);
+		return -EINVAL;
 	}
 
 	/* parse topology file and create pipeline */
-	if (parse_topology(&sof, lib_table, &tp, pipeline) < 0) {
+	if (parse_topology(&sof, lib_table, tp, pipeline) < 0) {
 		fprintf(stderr, "error: parsing topology\n");
-		exit(EXIT_FAILURE);
+		ret = -EINVAL;
+		goto out;
 	}
 
 	/* Get pointer to filewrite */
-	pcm_dev = ipc_get_comp_by_id(sof.ipc, tp.fw_id);
+	pcm_dev = ipc_get_comp_by_id(sof.ipc, tp->fw_id);
 	if (!pcm_dev) {
 		fprintf(stderr, "error: failed to get pointers to filewrite\n");
-		exit(EXIT_FAILURE);
+		ret = -EINVAL;
+		goto out;
 	}
 	fwcd = comp_get_drvdata(pcm_dev->cd);
 
 	/* Get pointer to fileread */
-	pcm_dev = ipc_get_comp_by_id(sof.ipc, tp.fr_id);
+	pcm_dev = ipc_get_comp_by_id(sof.ipc, tp->fr_id);
 	if (!pcm_dev) {
 		fprintf(stderr, "error: failed to get pointers to fileread\n");
-		exit(EXIT_FAILURE);
+		ret = -EINVAL;
+		goto out;
 	}
 	frcd = comp_get_drvdata(pcm_dev->cd);
 
 	/* Run pipeline until EOF from fileread */
-	pcm_dev = ipc_get_comp_by_id(sof.ipc, tp.sched_id);
+	pcm_dev = ipc_get_comp_by_id(sof.ipc, tp->sched_id);
 	p = pcm_dev->cd->pipeline;
 	ipc_pipe = &p->ipc_pipe;
 
 	/* input and output sample rate */
-	if (!tp.fs_in)
-		tp.fs_in = ipc_pipe->period * ipc_pipe->frames_per_sched;
+	if (!tp->fs_in)
+		tp->fs_in = ipc_pipe->period * ipc_pipe->frames_per_sched;
 
-	if (!tp.fs_out)
-		tp.fs_out = ipc_pipe->period * ipc_pipe->frames_per_sched;
+	if (!tp->fs_out)
+		tp->fs_out = ipc_pipe->period * ipc_pipe->frames_per_sched;
 
 	/* set pipeline params and trigger start */
-	if (tb_pipeline_start(sof.ipc, ipc_pipe, &tp) < 0) {
+	if (tb_pipeline_start(sof.ipc, ipc_pipe, tp) < 0) {
 		fprintf(stderr, "error: pipeline params\n");
-		exit(EXIT_FAILURE);
+		ret = -EINVAL;
+		goto out;
 	}
 
 	cd = pcm_dev->cd;
-	tb_enable_trace(false); /* reduce trace output */
-	tic = clock();
+	if (job->trace)
+		tb_enable_trace(false); /* reduce trace output */
+	tic = wall_time();
 
 	while (frcd->fs.reached_eof == 0) {
 		/*
@@ -338,7 +404,7 @@ int main(int argc, char **argv)
 		 * increasing IDs started from 1, we could take care of it in
 		 * test topologies so this for-loop will walk all pipelines.
 		 */
-		for (i = 1; i <= tp.max_pipeline_id; i++) {
+		for (i = 1; i <= tp->max_pipeline_id; i++) {
 			pcm_dev = ipc_get_comp_by_ppl_id(sof.ipc,
 							 COMP_TYPE_PIPELINE, i);
 			if (pcm_dev) {
@@ -350,50 +416,355 @@ int main(int argc, char **argv)
 	}
 
 	if (!frcd->fs.reached_eof)
-		printf("warning: possible pipeline xrun\n");
+		fprintf(job->out, "warning: possible pipeline xrun\n");
 
 	/* reset and free pipeline */
-	toc = clock();
-	tb_enable_trace(true);
+	toc = wall_time();
+	if (job->trace)
+		tb_enable_trace(true);
 	pipeline_trigger(p, cd, COMP_TRIGGER_STOP);
 	ret = pipeline_reset(p, cd);
 	if (ret < 0) {
 		fprintf(stderr, "error: pipeline reset\n");
-		exit(EXIT_FAILURE);
+		goto out;
 	}
 
 	n_in = frcd->fs.n;
 	n_out = fwcd->fs.n;
-	t_exec = (double)(toc - tic) / CLOCKS_PER_SEC;
-	c_realtime = (double)n_out / tp.channels / tp.fs_out / t_exec;
+	job->t_exec = toc - tic;
+	job->c_realtime = (double)n_out / tp->channels / tp->fs_out /
+			  job->t_exec;
 
-	/* free all components/buffers in pipeline */
+	/* print test summary */
+	fprintf(job->out, "==========================================================\n");
+	fprintf(job->out, "		           Test Summary\n");
+	fprintf(job->out, "==========================================================\n");
+	fprintf(job->out, "Test Pipeline:\n");
+	fprintf(job->out, "%s\n", pipeline);
+	fprintf(job->out, "Input bit format: %s\n", tp->bits_in);
+	fprintf(job->out, "Input sample rate: %d\n", tp->fs_in);
+	fprintf(job->out, "Output sample rate: %d\n", tp->fs_out);
+	for (i = 0; i < tp->output_file_num; i++) {
+		fprintf(job->out, "Output[%d] written to file: \"%s\"\n",
+			i, tp->output_file[i]);
+	}
+	fprintf(job->out, "Input sample count: %d\n", n_in);
+	fprintf(job->out, "Output sample count: %d\n", n_out);
+	fprintf(job->out, "Total execution time: %.2f ms, %.2f x realtime\n",
+		1e3 * job->t_exec, job->c_realtime);
+#if CONFIG_PERFORMANCE_COUNTERS
+	print_comp_perf(job->out);
+#endif
+
+out:
+	/* free all components/buffers in pipeline, then the instance */
 	free_comps();
+	tb_pipeline_free(&sof);
+
+	return ret;
+}
+
+static void *batch_job_thread(void *arg)
+{
+	struct tb_job *job = arg;
+
+	job->out = open_memstream(&job->report, &job->report_size);
+	if (job->out) {
+		job->ret = run_job(job);
+		fclose(job->out);
+	} else {
+		job->ret = -ENOMEM;
+	}
+
+	pthread_mutex_lock(&jobs_lock);
+	jobs_running--;
+	pthread_cond_signal(&jobs_done);
+	pthread_mutex_unlock(&jobs_lock);
+
+	return NULL;
+}
+
+/*
+ * Parse one manifest line into job parameters, the line is split in place:
+ * <tplg_file> <input_file> <output_file1,...> <rate> <input_format>
+ * [<output_rate> [<channels>]]
+ */
+static int parse_manifest_line(char *line, struct testbench_prm *tp)
+{
+	char *field[MANIFEST_FIELDS_MAX];
+	char *saveptr = NULL;
+	char *token;
+	int n = 0;
+
+	for (token = strtok_r(line, " \t\r\n", &saveptr); token;
+	     token = strtok_r(NULL, " \t\r\n", &saveptr)) {
+		if (n == MANIFEST_FIELDS_MAX)
+			return -EINVAL;
+		field[n++] = token;
+	}
+
+	if (n < MANIFEST_FIELDS_MIN)
+		return -EINVAL;
+
+	tp->tplg_file = strdup(field[0]);
+	tp->input_file = strdup(field[1]);
+	if (parse_output_files(field[2], tp) < 0)
+		return -EINVAL;
+	tp->fs_in = atoi(field[3]);
+	tp->bits_in = strdup(field[4]);
+	tp->frame_fmt = find_format(tp->bits_in);
+	if (n > 5)
+		tp->fs_out = atoi(field[5]);
+	if (n > 6)
+		tp->channels = atoi(field[6]);
+
+	return 0;
+}
+
+static int parse_manifest(const char *manifest, struct tb_job **jobs)
+{
+	struct tb_job *job;
+	FILE *fd;
+	char *line = NULL;
+	size_t line_size = 0;
+	int line_num = 0;
+	int count = 0;
+	int ret = 0;
+	int i;
+
+	*jobs = NULL;
+
+	fd = fopen(manifest, "r");
+	if (!fd) {
+		fprintf(stderr, "error: unable to open manifest %s\n",
+			manifest);
+		return -errno;
+	}
+
+	while (getline(&line, &line_size, fd) > 0) {
+		line_num++;
+		if (strspn(line, " \t\r\n") == strlen(line) || line[0] == '#')
+			continue;
+
+		job = realloc(*jobs, (count + 1) * sizeof(*job));
+		if (!job) {
+			ret = -ENOMEM;
+			break;
+		}
+		*jobs = job;
+
+		job = &(*jobs)[count++];
+		memset(job, 0, sizeof(*job));
+		init_prm(&job->tp);
+
+		if (parse_manifest_line(line, &job->tp) < 0) {
+			fprintf(stderr, "error: manifest %s line %d\n",
+				manifest, line_num);
+			ret = -EINVAL;
+			break;
+		}
+	}
+
+	free(line);
+	fclose(fd);
+
+	if (ret < 0) {
+		for (i = 0; i < count; i++)
+			free_prm(&(*jobs)[i].tp);
+		free(*jobs);
+		return ret;
+	}
+
+	return count;
+}
+
+/* run manifest jobs in parallel threads, keeping at most workers in flight */
+static int run_batch(const char *manifest, int workers)
+{
+	struct tb_job *jobs = NULL;
+	struct tb_job *job;
+	double tic, toc;
+	int count;
+	int failed = 0;
+	int i;
+
+	count = parse_manifest(manifest, &jobs);
+	if (count < 0)
+		return count;
+
+	/* drivers can't be registered once jobs run in parallel */
+	if (register_all_comps(lib_table) < 0)
+		return -EINVAL;
+
+	tb_enable_trace(false);
+	tic = wall_time();
+
+	for (i = 0; i < count; i++) {
+		pthread_mutex_lock(&jobs_lock);
+		while (jobs_running == workers)
+			pthread_cond_wait(&jobs_done, &jobs_lock);
+		jobs_running++;
+		pthread_mutex_unlock(&jobs_lock);
+
+		if (pthread_create(&jobs[i].thread, NULL, batch_job_thread,
+				   &jobs[i])) {
+			fprintf(stderr, "error: unable to start job %d\n", i);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	for (i = 0; i < count; i++)
+		pthread_join(jobs[i].thread, NULL);
+
+	toc = wall_time();
+	tb_enable_trace(true);
+
+	/* reports in manifest order */
+	for (i = 0; i < count; i++) {
+		job = &jobs[i];
+		printf("Job %d: %s %s\n", i, job->tp.tplg_file,
+		       job->tp.input_file);
+		if (job->report)
+			fwrite(job->report, 1, job->report_size, stdout);
+	}
 
-	/* print test summary */
 	printf("==========================================================\n");
-	printf("		           Test Summary\n");
+	printf("		           Batch Summary\n");
 	printf("==========================================================\n");
-	printf("Test Pipeline:\n");
-	printf("%s\n", pipeline);
-	printf("Input bit format: %s\n", tp.bits_in);
-	printf("Input sample rate: %d\n", tp.fs_in);
-	printf("Output sample rate: %d\n", tp.fs_out);
-	for (i = 0; i < tp.output_file_num; i++) {
-		printf("Output[%d] written to file: \"%s\"\n",
-		       i, tp.output_file[i]);
+	printf("%5s %6s %12s %12s  %s\n", "job", "status", "time (ms)",
+	       "x realtime", "topology");
+	for (i = 0; i < count; i++) {
+		job = &jobs[i];
+		if (job->ret < 0)
+			failed++;
+		printf("%5d %6s %12.2f %12.2f  %s\n", i,
+		       job->ret < 0 ? "FAIL" : "OK", 1e3 * job->t_exec,
+		       job->c_realtime, job->tp.tplg_file);
+		free(job->report);
+		free_prm(&job->tp);
+	}
+	printf("%d jobs, %d failed, %d workers, total wall time %.2f ms\n",
+	       count, failed, workers, 1e3 * (toc - tic));
+
+	free(jobs);
+
+	return failed ? -EINVAL : 0;
+}
+
+static void parse_input_args(int argc, char **argv, struct testbench_prm *tp,
+			     char **manifest, int *workers)
+{
+	int option = 0;
+	int ret = 0;
+
+	while ((option = getopt(argc, argv, "hdi:o:t:b:a:r:R:c:m:j:")) != -1) {
+		switch (option) {
+		/* input sample file */
+		case 'i':
+			tp->input_file = strdup(optarg);
+			break;
+
+		/* output sample files */
+		case 'o':
+			ret = parse_output_files(optarg, tp);
+			break;
+
+		/* topology file */
+		case 't':
+			tp->tplg_file = strdup(optarg);
+			break;
+
+		/* input samples bit format */
+		case 'b':
+			tp->bits_in = strdup(optarg);
+			tp->frame_fmt = find_format(tp->bits_in);
+			break;
+
+		/* override default libraries */
+		case 'a':
+			ret = parse_libraries(optarg);
+			break;
+
+		/* input sample rate */
+		case 'r':
+			tp->fs_in = atoi(optarg);
+			break;
+
+		/* output sample rate */
+		case 'R':
+			tp->fs_out = atoi(optarg);
+			break;
+
+		/* input/output channels */
+		case 'c':
+			tp->channels = atoi(optarg);
+			break;
+
+		/* enable debug prints */
+		case 'd':
+			debug = 1;
+			break;
+
+		/* batch manifest */
+		case 'm':
+			*manifest = optarg;
+			break;
+
+		/* number of parallel batch jobs */
+		case 'j':
+			*workers = atoi(optarg);
+			if (*workers < 1)
+				ret = -EINVAL;
+			break;
+
+		/* print usage */
+		case 'h':
+		default:
+			print_usage(argv[0]);
+			exit(EXIT_FAILURE);
+		}
+
+		if (ret < 0)
+			exit(EXIT_FAILURE);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	struct tb_job job;
+	char *manifest = NULL;
+	int workers = sysconf(_SC_NPROCESSORS_ONLN);
+	int ret;
+	int i;
+
+	memset(&job, 0, sizeof(job));
+	init_prm(&job.tp);
+
+	/* command line arguments*/
+	parse_input_args(argc, argv, &job.tp, &manifest, &workers);
+
+	/* check args */
+	if (!manifest && (!job.tp.tplg_file || !job.tp.input_file ||
+			  !job.tp.output_file_num ||
+			  (!job.tp.bits_in && !is_wav_file(job.tp.input_file)))) {
+		print_usage(argv[0]);
+		exit(EXIT_FAILURE);
+	}
+
+	/* driver list of the main instance is used by all jobs */
+	sys_comp_init(&sof);
+	comp_drivers = sof.comp_drivers;
+
+	if (manifest) {
+		ret = run_batch(manifest, MAX(workers, 1));
+	} else {
+		job.out = stdout;
+		job.trace = true;
+		ret = run_job(&job);
 	}
-	printf("Input sample count: %d\n", n_in);
-	printf("Output sample count: %d\n", n_out);
-	printf("Total execution time: %.2f us, %.2f x realtime\n",
-	       1e3 * t_exec, c_realtime);
 
 	/* free all other data */
-	free(tp.bits_in);
-	free(tp.input_file);
-	free(tp.tplg_file);
-	for (i = 0; i < tp.output_file_num; i++)
-		free(tp.output_file[i]);
+	free_prm(&job.tp);
 
 	/* close shared library objects */
 	for (i = 0; i < NUM_WIDGETS_SUPPORTED; i++) {
@@ -401,5 +772,5 @@ int main(int argc, char **argv)
 			dlclose(lib_table[i].handle);
 	}
 
-	return EXIT_SUCCESS;
+	return ret < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -19,10 +19,11 @@
 #include "testbench/common_test.h"
 #include "testbench/file.h"
 
-FILE *file;
-char pipeline_string[DEBUG_MSG_LEN];
-struct shared_lib_table *lib_table;
-int output_file_index;
+/* parser state is per thread, batch jobs parse topologies in parallel */
+static __thread FILE *file;
+static __thread char pipeline_string[DEBUG_MSG_LEN];
+static __thread struct shared_lib_table *lib_table;
+static __thread int output_file_index;
 
 const struct sof_dai_types sof_dais[] = {
 	{"SSP", SOF_DAI_INTEL_SSP},
@@ -43,6 +44,26 @@ enum sof_ipc_dai_type find_dai(const char *name)
 	return SOF_DAI_INTEL_NONE;
 }
 
+/* open shared library object, comp init is executed on lib load */
+static void load_comp_lib(struct shared_lib_table *lib)
+{
+	char message[DEBUG_MSG_LEN + MAX_LIB_NAME_LEN];
+
+	sprintf(message, "registered comp driver for %s\n", lib->comp_name);
+	debug_print(message);
+
+	sprintf(message, "opening shared lib %s\n", lib->library_name);
+	debug_print(message);
+
+	lib->handle = dlopen(lib->library_name, RTLD_LAZY);
+	if (!lib->handle) {
+		fprintf(stderr, "error: %s\n", dlerror());
+		exit(EXIT_FAILURE);
+	}
+
+	lib->register_drv = 1;
+}
+
 /*
  * Register component driver
  * Only needed once per component type
@@ -50,7 +71,6 @@ enum sof_ipc_dai_type find_dai(const char *name)
 void register_comp(int comp_type, struct sof_ipc_comp_ext *comp_ext)
 {
 	int index;
-	char message[DEBUG_MSG_LEN + MAX_LIB_NAME_LEN];
 
 	/* register file comp driver (no shared library needed) */
 	if (comp_type == SOF_COMP_HOST || comp_type == SOF_COMP_DAI) {
@@ -71,27 +91,29 @@ void register_comp(int comp_type, struct sof_ipc_comp_ext *comp_ext)
 	}
 
 	/* register comp driver if not already registered */
-	if (!lib_table[index].register_drv) {
-		sprintf(message, "registered comp driver for %s\n",
-			lib_table[index].comp_name);
-		debug_print(message);
+	if (!lib_table[index].register_drv)
+		load_comp_lib(&lib_table[index]);
+}
 
-		/* open shared library object */
-		sprintf(message, "opening shared lib %s\n",
-			lib_table[index].library_name);
-		debug_print(message);
+/*
+ * Register all component drivers in the library table up front, the shared
+ * driver list can't be modified once topologies are parsed in parallel.
+ */
+int register_all_comps(struct shared_lib_table *library_table)
+{
+	int i;
 
-		lib_table[index].handle = dlopen(lib_table[index].library_name,
-						 RTLD_LAZY);
-		if (!lib_table[index].handle) {
-			fprintf(stderr, "error: %s\n", dlerror());
-			exit(EXIT_FAILURE);
-		}
+	if (!library_table[0].register_drv) {
+		sys_comp_file_init();
+		library_table[0].register_drv = 1;
+	}
 
-		/* comp init is executed on lib load */
-		lib_table[index].register_drv = 1;
+	for (i = 1; i < NUM_WIDGETS_SUPPORTED; i++) {
+		if (!library_table[i].register_drv)
+			load_comp_lib(&library_table[i]);
 	}
 
+	return 0;
 }
 
 int find_widget(struct comp_info *temp_comp_list, int count, char *name)
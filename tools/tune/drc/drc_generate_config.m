@@ -0,0 +1,55 @@
+function config = drc_generate_config(band, lookahead_time, drc_bqs);
+
+% Refer to sof/src/include/user/drc.h for the config struct
+max_bands = 3;
+num_bands = length(band);
+if num_bands < 1 || num_bands > max_bands
+	error("Number of bands must be 1..%d", max_bands);
+end
+
+config.num_bands = num_bands;
+config.lookahead_time = round(lookahead_time);
+
+% Disabled bands are filled with pass through parameters
+config.params = zeros(max_bands, 7);
+for i = 1:num_bands
+	b = band(i);
+	if b.threshold < -100 || b.threshold > 0
+		error("Band %d threshold must be -100 .. 0 dB", i);
+	end
+	if b.knee < 0 || b.knee > 40
+		error("Band %d knee must be 0 .. 40 dB", i);
+	end
+	if b.ratio < 1
+		error("Band %d ratio must be 1 or larger", i);
+	end
+	config.params(i, :) = [b.enabled ...
+			       quant(b.threshold, 24) ...
+			       quant(b.knee, 24) ...
+			       quant(1 - 1 / b.ratio, 30) ...
+			       quant(b.makeup_gain, 24) ...
+			       round(1e3 * b.attack) ...
+			       round(1e3 * b.release)];
+end
+
+% Interleave the coefficients for the low and high pass filters as in
+% crossover. For 2 bands we have 1 pair of LR4s, for 3 bands 3 pairs.
+config.all_coef = [];
+n = length(drc_bqs.lp_coef) / 7;
+j = 1;
+for i = 1:n
+	config.all_coef = [config.all_coef ...
+			   drc_bqs.lp_coef(j:j+6) drc_bqs.hp_coef(j:j+6)];
+	j = j + 7;
+end
+
+if num_bands > 1 && n != 2 * num_bands - 3
+	error("Band split coefficients do not match number of bands");
+end
+
+end
+
+function q = quant(x, qy)
+	q = round(x * 2^qy);
+	q = max(min(q, 2^31 - 1), -2^31);
+end
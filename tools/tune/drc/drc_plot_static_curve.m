@@ -0,0 +1,39 @@
+function drc_plot_static_curve(config)
+
+% Plots the output level vs. input level of each enabled band with the
+% same soft knee curve as the firmware gain computer.
+in_db = -100:0.1:0;
+
+figure;
+hold on;
+legends = {};
+for i = 1:config.num_bands
+	p = config.params(i, :);
+	if p(1) == 0
+		continue;
+	end
+	threshold = p(2) / 2^24;
+	knee = p(3) / 2^24;
+	slope = p(4) / 2^30;
+	makeup = p(5) / 2^24;
+
+	over = in_db - threshold;
+	reduction = zeros(size(in_db));
+	idx = 2 * over >= knee;
+	reduction(idx) = -slope * over(idx);
+	idx = 2 * abs(over) < knee;
+	reduction(idx) = -slope * (over(idx) + knee / 2).^2 / (2 * knee);
+	plot(in_db, in_db + reduction + makeup);
+	legends{end + 1} = sprintf('band %d', i);
+end
+plot(in_db, in_db, 'k--');
+legends{end + 1} = 'unity';
+hold off;
+grid on;
+axis([-100 0 -100 max(0, max(config.params(:, 5)) / 2^24)]);
+xlabel('Input level (dBFS)');
+ylabel('Output level (dBFS)');
+legend(legends, 'Location', 'southeast');
+title('DRC static curve');
+
+end
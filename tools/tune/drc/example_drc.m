@@ -0,0 +1,75 @@
+function example_drc();
+
+% Set the parameters here
+tplg_fn = "../../topology/m4/drc_coef_default.m4" % Control Bytes File
+% Use those files with sof-ctl to update the component's configuration
+blob_fn = "../../ctl/drc_coef.blob" % Blob binary file
+alsa_fn = "../../ctl/drc_coef.txt" % ALSA CSV format file
+
+endian = "little";
+
+% Sampling frequency and band split frequencies
+fs = 48e3;
+fc_low = 200;
+fc_high = 3000;
+
+% Look-ahead in microseconds, 2 ms is 96 frames at 48 kHz and longer than
+% the two 32 frames gain computation blocks needed by a limiter.
+lookahead_time = 2000;
+
+% 3 band compressor. The low band is compressed gently, the mid band
+% is left untouched and the high band is limited to -3 dBFS.
+num_bands = 3;
+band(1) = drc_band(-24, 6, 3, 4, 10, 200);
+band(2) = drc_band(0, 0, 1, 0, 0, 0);
+band(2).enabled = 0;
+band(3) = drc_band(-3, 0, inf, 0, 0, 50);
+
+% A full band limiter can be created by omitting the band split
+% num_bands = 1;
+% band(1) = drc_band(-1, 0, inf, 0, 0, 50);
+
+% Generate the band split LR4 filters as in 2 or 3 way crossover
+addpath ./../crossover
+switch num_bands
+	case 1, bqs.lp_coef = []; bqs.hp_coef = [];
+	case 2, bqs = crossover_coef_quant_split(fs, fc_low);
+	case 3, bqs = crossover_coef_quant_split(fs, fc_low, fc_high);
+	otherwise, error("Invalid number of bands");
+end
+rmpath ./../crossover
+
+% Convert parameters to sof_drc_config struct
+config = drc_generate_config(band(1:num_bands), lookahead_time, bqs);
+
+% Convert struct to binary blob
+blob8 = drc_build_blob(config, endian);
+
+% Generate output files
+addpath ./../common
+
+tplg_write(tplg_fn, blob8, "DRC");
+blob_write(blob_fn, blob8);
+alsactl_write(alsa_fn, blob8);
+
+% Plot the static curve of each band
+drc_plot_static_curve(config);
+rmpath ./../common
+
+endfunction
+
+% Parameters of one band, levels in dB, times in ms
+function b = drc_band(threshold, knee, ratio, makeup_gain, attack, release)
+	b.enabled = 1;
+	b.threshold = threshold;
+	b.knee = knee;
+	b.ratio = ratio;
+	b.makeup_gain = makeup_gain;
+	b.attack = attack;
+	b.release = release;
+end
+
+function bqs = crossover_coef_quant_split(fs, varargin)
+	crossover = crossover_gen_coefs(fs, varargin{:});
+	bqs = crossover_coef_quant(crossover.lp, crossover.hp);
+end